@@ -3350,6 +3350,7 @@ static Bool gpac_expand_alias(int argc, char **argv)
 #include <gpac/avparse.h>
 #include <gpac/mpegts.h>
 #include <gpac/rtp_streamer.h>
+#include <gpac/crypt.h>
 #include <gpac/internal/odf_dev.h>
 #include <gpac/internal/media_dev.h>
 #include <gpac/internal/isomedia_dev.h>
@@ -3599,6 +3600,55 @@ static u32 gpac_unit_tests(GF_MemTrackerType mem_track)
 	v.x = v.y = v.z = 0;
 	gf_vec_scale_p(&v, 2*FIX_ONE);
 
+#ifndef GPAC_DISABLE_CRYPTO
+	//AES-128 CBC and CTR vectors from NIST SP 800-38A F.2.1 and F.5.1, 2 blocks, with and without 1:1 pattern
+	u8 aes_key[16] = {0x2b,0x7e,0x15,0x16,0x28,0xae,0xd2,0xa6,0xab,0xf7,0x15,0x88,0x09,0xcf,0x4f,0x3c};
+	u8 aes_cbc_iv[16] = {0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f};
+	u8 aes_ctr_iv[16] = {0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,0xf9,0xfa,0xfb,0xfc,0xfd,0xfe,0xff};
+	u8 aes_plain[32] = {0x6b,0xc1,0xbe,0xe2,0x2e,0x40,0x9f,0x96,0xe9,0x3d,0x7e,0x11,0x73,0x93,0x17,0x2a,
+		0xae,0x2d,0x8a,0x57,0x1e,0x03,0xac,0x9c,0x9e,0xb7,0x6f,0xac,0x45,0xaf,0x8e,0x51};
+	u8 aes_cbc_res[32] = {0x76,0x49,0xab,0xac,0x81,0x19,0xb2,0x46,0xce,0xe9,0x8e,0x9b,0x12,0xe9,0x19,0x7d,
+		0x50,0x86,0xcb,0x9b,0x50,0x72,0x19,0xee,0x95,0xdb,0x11,0x3a,0x91,0x76,0x78,0xb2};
+	u8 aes_ctr_res[32] = {0x87,0x4d,0x61,0x91,0xb6,0x20,0xe3,0x26,0x1b,0xef,0x68,0x64,0x99,0x0d,0xb6,0xce,
+		0x98,0x06,0xf6,0x6b,0x79,0x70,0xfd,0xff,0x86,0x17,0x18,0x7b,0xb9,0xff,0xfd,0xff};
+	u8 aes_buf[32];
+	u32 aes_i;
+	for (aes_i=0; aes_i<4; aes_i++) {
+		Bool is_ctr = (aes_i%2) ? GF_TRUE : GF_FALSE;
+		Bool use_pattern = (aes_i>=2) ? GF_TRUE : GF_FALSE;
+		u8 *aes_res = is_ctr ? aes_ctr_res : aes_cbc_res;
+		GF_Crypt *gc = gf_crypt_open(GF_AES_128, is_ctr ? GF_CTR : GF_CBC);
+		if (!gc || gf_crypt_init(gc, aes_key, is_ctr ? aes_ctr_iv : aes_cbc_iv)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[CoreUnitTests] AES init fail\n"));
+			return 1;
+		}
+		memcpy(aes_buf, aes_plain, 32);
+		if (use_pattern) e = gf_crypt_encrypt_pattern(gc, aes_buf, 32, 1, 1);
+		else e = gf_crypt_encrypt(gc, aes_buf, 32);
+		//with 1:1 pattern, first block matches the vector and second block is left in the clear
+		if (e || memcmp(aes_buf, aes_res, 16) || memcmp(aes_buf+16, use_pattern ? aes_plain+16 : aes_res+16, 16)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[CoreUnitTests] AES %s%s encrypt vector fail\n", is_ctr ? "CTR" : "CBC", use_pattern ? " pattern" : ""));
+			gf_crypt_close(gc);
+			return 1;
+		}
+		if (is_ctr) {
+			u8 ctr_state[17];
+			ctr_state[0] = 0;
+			memcpy(ctr_state+1, aes_ctr_iv, 16);
+			gf_crypt_set_IV(gc, ctr_state, 17);
+		} else {
+			gf_crypt_set_IV(gc, aes_cbc_iv, 16);
+		}
+		if (use_pattern) e = gf_crypt_decrypt_pattern(gc, aes_buf, 32, 1, 1);
+		else e = gf_crypt_decrypt(gc, aes_buf, 32);
+		gf_crypt_close(gc);
+		if (e || memcmp(aes_buf, aes_plain, 32)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[CoreUnitTests] AES %s%s decrypt vector fail\n", is_ctr ? "CTR" : "CBC", use_pattern ? " pattern" : ""));
+			return 1;
+		}
+	}
+#endif
+
 	//token.c
 	char container[1024];
 	gf_token_get_strip("12 34{ 56 : }", 0, "{:", " ", container, 1024);
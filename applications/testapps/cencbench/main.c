@@ -0,0 +1,259 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / CENC encryption benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures the throughput of the cecrypt filter for the cenc, cbcs (constant IV) and cens schemes. The input is either a
+generated MP4 with one video track of large random samples (full sample encryption), or a file given with -i (use an
+AVC/HEVC file to benchmark subsample and pattern encryption). Each scheme is run with threads=0 and with the requested
+number of worker threads, after a plain remux run giving the session overhead. Throughput is the media payload size divided
+by the run time, the remux time being reported separately. The test fails if a session fails or if the encrypted file
+produced with worker threads differs from the single-threaded one*/
+
+#include <gpac/filters.h>
+#include <gpac/isomedia.h>
+#include <gpac/constants.h>
+
+static const char *schemes[] =
+{
+	"cenc", "<CrypTrack IsEncrypted=\"1\" IV_size=\"16\" first_IV=\"0x0a610676cb88f302d10ac8bc66e039ed\" saiSavedBox=\"senc\">",
+	"cbcs", "<CrypTrack IsEncrypted=\"1\" IV_size=\"0\" constant_IV_size=\"16\" constant_IV=\"0x0a610676cb88f302d10ac8bc66e039ed\" saiSavedBox=\"senc\">",
+	"cens", "<CrypTrack IsEncrypted=\"1\" IV_size=\"16\" first_IV=\"0x0a610676cb88f302d10ac8bc66e039ed\" saiSavedBox=\"senc\">",
+};
+
+static GF_Err create_input(const char *path, u32 total_size, u32 sample_size)
+{
+	GF_Err e;
+	u32 i, track, di, nb_samples;
+	GF_ISOSample samp;
+	GF_ESD *esd;
+	u8 *data;
+	GF_ISOFile *file = gf_isom_open(path, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return gf_isom_last_error(NULL);
+
+	track = gf_isom_new_track(file, 1, GF_ISOM_MEDIA_VISUAL, 25000);
+	if (!track) {
+		gf_isom_delete(file);
+		return GF_IO_ERR;
+	}
+	gf_isom_set_track_enabled(file, track, GF_TRUE);
+	esd = gf_odf_desc_esd_new(2);
+	esd->decoderConfig->streamType = GF_STREAM_VISUAL;
+	esd->decoderConfig->objectTypeIndication = GF_CODECID_MPEG4_PART2;
+	esd->slConfig->timestampResolution = 25000;
+	e = gf_isom_new_mpeg4_description(file, track, esd, NULL, NULL, &di);
+	gf_odf_desc_del((GF_Descriptor *) esd);
+	if (!e) e = gf_isom_set_visual_info(file, track, di, 1920, 1080);
+
+	data = gf_malloc(sample_size);
+	nb_samples = total_size / sample_size;
+	if (!nb_samples) nb_samples = 1;
+	memset(&samp, 0, sizeof(GF_ISOSample));
+	samp.data = data;
+	samp.dataLength = sample_size;
+	for (i=0; !e && (i<nb_samples); i++) {
+		u32 j;
+		for (j=0; j<sample_size; j++) data[j] = (u8) gf_rand();
+		samp.DTS = i * 1000;
+		samp.IsRAP = (i % 25) ? 0 : RAP;
+		e = gf_isom_add_sample(file, track, di, &samp);
+	}
+	gf_free(data);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+static u64 get_payload_size(const char *path)
+{
+	u64 size = 0;
+	u32 i, j;
+	GF_ISOFile *file = gf_isom_open(path, GF_ISOM_OPEN_READ, NULL);
+	if (!file) return 0;
+	for (i=0; i<gf_isom_get_track_count(file); i++) {
+		u32 nb_samples = gf_isom_get_sample_count(file, i+1);
+		for (j=0; j<nb_samples; j++)
+			size += gf_isom_get_sample_size(file, i+1, j+1);
+	}
+	gf_isom_close(file);
+	return size;
+}
+
+static GF_Err write_drm(const char *path, u32 scheme_idx)
+{
+	FILE *f = gf_fopen(path, "wt");
+	if (!f) return GF_IO_ERR;
+	gf_fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	gf_fprintf(f, "<GPACDRM type=\"%s\">\n", schemes[2*scheme_idx]);
+	gf_fprintf(f, "%s\n", schemes[2*scheme_idx+1]);
+	gf_fprintf(f, "<key KID=\"0x279926496a7f5d25da69f2b3b2799a7f\" value=\"0xcc00f9df3ea9bc75d2ecf7ae1ba46a9e\"/>\n");
+	gf_fprintf(f, "</CrypTrack>\n</GPACDRM>\n");
+	gf_fclose(f);
+	return GF_OK;
+}
+
+//runs the session and returns the elapsed time in microseconds, 0 on error
+static u64 run_session(const char *src, const char *drm, u32 threads, const char *dst)
+{
+	GF_Err e;
+	u64 start;
+	char szArgs[GF_MAX_PATH+100];
+	GF_FilterSession *fs = gf_fs_new(0, GF_FS_SCHEDULER_LOCK_FREE, 0, NULL);
+	if (!fs) return 0;
+
+	start = gf_sys_clock_high_res();
+	gf_fs_load_source(fs, src, NULL, NULL, &e);
+	if (!e && drm) {
+		sprintf(szArgs, "cecrypt:cfile=%s:threads=%d", drm, threads);
+		gf_fs_load_filter(fs, szArgs, &e);
+	}
+	if (!e) gf_fs_load_destination(fs, dst, NULL, NULL, &e);
+	if (!e) e = gf_fs_run(fs);
+	if (e==GF_EOS) e = GF_OK;
+	if (!e) e = gf_fs_get_last_connect_error(fs);
+	if (!e) e = gf_fs_get_last_process_error(fs);
+	gf_fs_del(fs);
+	if (e) {
+		fprintf(stderr, "Session failed: %s\n", gf_error_to_string(e));
+		return 0;
+	}
+	return gf_sys_clock_high_res() - start;
+}
+
+static Bool same_files(const char *path1, const char *path2)
+{
+	u8 *data1, *data2;
+	u32 size1, size2;
+	Bool res = GF_FALSE;
+	if (gf_file_load_data(path1, &data1, &size1) != GF_OK) return GF_FALSE;
+	if (gf_file_load_data(path2, &data2, &size2) == GF_OK) {
+		res = ((size1==size2) && !memcmp(data1, data2, size1)) ? GF_TRUE : GF_FALSE;
+		gf_free(data2);
+	}
+	gf_free(data1);
+	return res;
+}
+
+static Double get_rate(u64 size, u64 us)
+{
+	if (!us) return 0;
+	return ((Double) size) / us;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, size_mb = 64, sample_kb = 256, threads = 4;
+	u64 payload, t_remux, t_single, t_mt;
+	char *input = NULL;
+	char szSrc[GF_MAX_PATH], szDRM[GF_MAX_PATH], szOut1[GF_MAX_PATH], szOut2[GF_MAX_PATH];
+	const char *test_args[] = {"cencbench", "-for-test", "-noprog"};
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strncmp(arg, "-i=", 3)) input = arg+3;
+		else if (!strncmp(arg, "-size=", 6)) size_mb = atoi(arg+6);
+		else if (!strncmp(arg, "-sample=", 8)) sample_kb = atoi(arg+8);
+		else if (!strncmp(arg, "-threads=", 9)) threads = atoi(arg+9);
+		else {
+			fprintf(stderr, "usage: cencbench [-i=FILE] [-size=MB] [-sample=KB] [-threads=N]\n"
+			        "Measures cecrypt throughput in MB/s for cenc, cbcs and cens with and without worker threads\n");
+			return 1;
+		}
+	}
+	if (!size_mb || !sample_kb || !threads) {
+		fprintf(stderr, "invalid parameters\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	//no creation dates in output files so that runs can be compared, no progress
+	gf_sys_set_args(3, test_args);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+
+	szDRM[0] = szOut1[0] = szOut2[0] = 0;
+	if (input) {
+		strcpy(szSrc, input);
+	} else {
+		sprintf(szSrc, "%s/cencbench_%08x_src.mp4", gf_get_default_cache_directory(), gf_rand());
+		e = create_input(szSrc, size_mb*1024*1024, sample_kb*1024);
+		if (e) {
+			fprintf(stderr, "Failed to create test file %s: %s\n", szSrc, gf_error_to_string(e));
+			gf_file_delete(szSrc);
+			gf_sys_close();
+			return 1;
+		}
+	}
+	payload = get_payload_size(szSrc);
+	if (!payload) {
+		fprintf(stderr, "No media samples in %s\n", szSrc);
+		ret = 1;
+		goto exit;
+	}
+	sprintf(szDRM, "%s/cencbench_%08x_drm.xml", gf_get_default_cache_directory(), gf_rand());
+	sprintf(szOut1, "%s/cencbench_%08x_st.mp4", gf_get_default_cache_directory(), gf_rand());
+	sprintf(szOut2, "%s/cencbench_%08x_mt.mp4", gf_get_default_cache_directory(), gf_rand());
+
+	fprintf(stdout, "payload %.2f MB - worker threads %d\n", ((Double) payload) / 1000000, threads);
+	t_remux = run_session(szSrc, NULL, 0, szOut1);
+	if (!t_remux) {
+		ret = 1;
+		goto exit;
+	}
+	fprintf(stdout, "remux: %.2f ms\n", ((Double) t_remux) / 1000);
+
+	for (i=0; i<3; i++) {
+		Bool same;
+		e = write_drm(szDRM, i);
+		if (e) {
+			fprintf(stderr, "Failed to create DRM file %s\n", szDRM);
+			ret = 1;
+			break;
+		}
+		t_single = run_session(szSrc, szDRM, 0, szOut1);
+		t_mt = t_single ? run_session(szSrc, szDRM, threads, szOut2) : 0;
+		if (!t_single || !t_mt) {
+			fprintf(stderr, "%s: encryption failed\n", schemes[2*i]);
+			ret = 1;
+			continue;
+		}
+		same = same_files(szOut1, szOut2);
+		fprintf(stdout, "%s: threads=0 %.2f MB/s (%.2f ms) - threads=%d %.2f MB/s (%.2f ms) - output %s\n", schemes[2*i],
+			get_rate(payload, t_single), ((Double) t_single) / 1000,
+			threads, get_rate(payload, t_mt), ((Double) t_mt) / 1000,
+			same ? "identical" : "MISMATCH");
+		if (!same) ret = 1;
+	}
+
+exit:
+	if (!input) gf_file_delete(szSrc);
+	if (szDRM[0]) gf_file_delete(szDRM);
+	if (szOut1[0]) gf_file_delete(szOut1);
+	if (szOut2[0]) gf_file_delete(szOut2);
+	gf_sys_close();
+	fprintf(stdout, "%s\n", ret ? "FAIL" : "PASS");
+	return ret;
+}
@@ -0,0 +1,242 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / AES pattern encryption benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures the cost in cycles per byte of the crypto API for CBC and CTR, without pattern and with the 1:9 pattern used
+by cbcs and cens. Each case is run on the same random buffer with one gf_crypt_encrypt call per encrypted block group
+(the loop used before the batched API), with gf_crypt_encrypt_pattern over the whole range and with gf_crypt_encrypt_sample
+over a subsample map of NAL-like units. Cycles are read from the time stamp counter on x86, otherwise they are derived from
+the elapsed time and the frequency given with -freq. The test fails if the batched calls do not produce the same output as
+the per-group loop, or if decryption does not restore the input*/
+
+#include <gpac/crypt.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define HAS_TSC
+#endif
+
+#define NB_SUBS_MAX	64
+
+static u8 key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+static u8 iv[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+
+static u32 freq_mhz = 0;
+
+static u64 get_cycles()
+{
+#ifdef HAS_TSC
+	if (!freq_mhz) return __rdtsc();
+#endif
+	//in microseconds, converted by the caller
+	return gf_sys_clock_high_res();
+}
+
+static Double cycles_per_byte(u64 start, u64 end, u64 nb_bytes)
+{
+	Double cycles = (Double) (end - start);
+#ifdef HAS_TSC
+	if (!freq_mhz) return cycles / nb_bytes;
+#endif
+	return cycles * freq_mhz / nb_bytes;
+}
+
+//reference: one call per encrypted block group, as done before the batched API
+static GF_Err encrypt_groups(GF_Crypt *gc, u8 *data, u32 size, u32 crypt_block, u32 skip_block)
+{
+	if (!crypt_block || !skip_block)
+		return gf_crypt_encrypt(gc, data, size);
+
+	while (size) {
+		GF_Err e;
+		u32 len = (size >= 16*crypt_block) ? 16*crypt_block : size;
+		e = gf_crypt_encrypt(gc, data, len);
+		if (e) return e;
+		if (size < 16 * (crypt_block + skip_block)) break;
+		data += 16 * (crypt_block + skip_block);
+		size -= 16 * (crypt_block + skip_block);
+	}
+	return GF_OK;
+}
+
+//CTR state is the keystream position followed by the counter block
+static void reset_iv(GF_Crypt *gc, GF_CRYPTO_MODE mode)
+{
+	u8 state[17];
+	if (mode==GF_CBC) {
+		gf_crypt_set_IV(gc, iv, 16);
+		return;
+	}
+	state[0] = 0;
+	memcpy(state+1, iv, 16);
+	gf_crypt_set_IV(gc, state, 17);
+}
+
+static GF_Crypt *open_crypt(GF_CRYPTO_MODE mode)
+{
+	GF_Crypt *gc = gf_crypt_open(GF_AES_128, mode);
+	if (!gc) return NULL;
+	if (gf_crypt_init(gc, key, iv) != GF_OK) return NULL;
+	return gc;
+}
+
+static Bool run_case(const char *name, GF_CRYPTO_MODE mode, u32 crypt_block, u32 skip_block, u8 *src, u32 size, u32 nb_iter, u8 *ref, u8 *buf)
+{
+	u32 i, nb_subs, pos;
+	u64 start, end;
+	Double c_groups, c_pattern, c_sample;
+	GF_CryptSubsample subs[NB_SUBS_MAX];
+	GF_Crypt *gc = open_crypt(mode);
+	Bool ok = GF_TRUE;
+	if (!gc) {
+		fprintf(stderr, "%s: cannot open AES-128 context\n", name);
+		return GF_FALSE;
+	}
+	//CBC only processes full blocks
+	if (mode==GF_CBC) size -= size % 16;
+
+	start = get_cycles();
+	for (i=0; i<nb_iter; i++) {
+		memcpy(ref, src, size);
+		reset_iv(gc, mode);
+		encrypt_groups(gc, ref, size, crypt_block, skip_block);
+	}
+	end = get_cycles();
+	c_groups = cycles_per_byte(start, end, (u64) size * nb_iter);
+
+	start = get_cycles();
+	for (i=0; i<nb_iter; i++) {
+		memcpy(buf, src, size);
+		reset_iv(gc, mode);
+		gf_crypt_encrypt_pattern(gc, buf, size, crypt_block, skip_block);
+	}
+	end = get_cycles();
+	c_pattern = cycles_per_byte(start, end, (u64) size * nb_iter);
+	if (memcmp(ref, buf, size)) {
+		fprintf(stderr, "%s: gf_crypt_encrypt_pattern output differs from per-group encryption\n", name);
+		ok = GF_FALSE;
+	}
+
+	reset_iv(gc, mode);
+	gf_crypt_decrypt_pattern(gc, buf, size, crypt_block, skip_block);
+	if (memcmp(src, buf, size)) {
+		fprintf(stderr, "%s: gf_crypt_decrypt_pattern does not restore the input\n", name);
+		ok = GF_FALSE;
+	}
+
+	//split the buffer in subsamples with a 5-byte clear header each, encrypted parts block aligned
+	nb_subs = 0;
+	pos = 0;
+	while ((pos < size) && (nb_subs < NB_SUBS_MAX)) {
+		u32 len = size / NB_SUBS_MAX;
+		if ((nb_subs+1 == NB_SUBS_MAX) || (pos + len > size)) len = size - pos;
+		subs[nb_subs].clear_bytes = (len > 5) ? 5 : len;
+		subs[nb_subs].crypted_bytes = len - subs[nb_subs].clear_bytes;
+		subs[nb_subs].crypted_bytes -= subs[nb_subs].crypted_bytes % 16;
+		subs[nb_subs].clear_bytes = len - subs[nb_subs].crypted_bytes;
+		pos += len;
+		nb_subs++;
+	}
+	//reference for the sample call: per-group encryption of each subsample, chaining across subsamples
+	memcpy(ref, src, size);
+	reset_iv(gc, mode);
+	for (i=0, pos=0; i<nb_subs; i++) {
+		pos += subs[i].clear_bytes;
+		encrypt_groups(gc, ref+pos, subs[i].crypted_bytes, crypt_block, skip_block);
+		pos += subs[i].crypted_bytes;
+	}
+
+	start = get_cycles();
+	for (i=0; i<nb_iter; i++) {
+		memcpy(buf, src, size);
+		reset_iv(gc, mode);
+		gf_crypt_encrypt_sample(gc, buf, size, subs, nb_subs, crypt_block, skip_block, NULL, 0);
+	}
+	end = get_cycles();
+	c_sample = cycles_per_byte(start, end, (u64) size * nb_iter);
+	if (memcmp(ref, buf, size)) {
+		fprintf(stderr, "%s: gf_crypt_encrypt_sample output differs from per-group encryption\n", name);
+		ok = GF_FALSE;
+	}
+	reset_iv(gc, mode);
+	gf_crypt_decrypt_sample(gc, buf, size, subs, nb_subs, crypt_block, skip_block, NULL, 0);
+	if (memcmp(src, buf, size)) {
+		fprintf(stderr, "%s: gf_crypt_decrypt_sample does not restore the input\n", name);
+		ok = GF_FALSE;
+	}
+	gf_crypt_close(gc);
+
+	fprintf(stdout, "%-12s per-group %6.2f c/B - pattern %6.2f c/B - sample %6.2f c/B%s\n", name, c_groups, c_pattern, c_sample, ok ? "" : " - FAILED");
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, size_kb = 256, nb_iter = 200;
+	u8 *src, *ref, *buf;
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strncmp(arg, "-size=", 6)) size_kb = atoi(arg+6);
+		else if (!strncmp(arg, "-n=", 3)) nb_iter = atoi(arg+3);
+		else if (!strncmp(arg, "-freq=", 6)) freq_mhz = atoi(arg+6);
+		else {
+			fprintf(stderr, "usage: cryptbench [-size=KB] [-n=NB_ITER] [-freq=MHZ]\n"
+			        "Measures AES-128 CBC/CTR cost in cycles per byte with and without 1:9 pattern\n");
+			return 1;
+		}
+	}
+	if (!size_kb || !nb_iter) {
+		fprintf(stderr, "invalid parameters\n");
+		return 1;
+	}
+#ifndef HAS_TSC
+	if (!freq_mhz) {
+		fprintf(stderr, "no cycle counter on this platform, set the CPU frequency with -freq=MHZ\n");
+		return 1;
+	}
+#endif
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+
+	src = gf_malloc(size_kb*1024);
+	ref = gf_malloc(size_kb*1024);
+	buf = gf_malloc(size_kb*1024);
+	for (i=0; i<size_kb*1024; i++) src[i] = (u8) gf_rand();
+
+	fprintf(stdout, "buffer %d kB - %d iterations - cycles from %s\n", size_kb, nb_iter, freq_mhz ? "clock and -freq" : "TSC");
+	if (!run_case("cbc", GF_CBC, 0, 0, src, size_kb*1024, nb_iter, ref, buf)) ret = 1;
+	if (!run_case("cbc 1:9", GF_CBC, 1, 9, src, size_kb*1024, nb_iter, ref, buf)) ret = 1;
+	if (!run_case("ctr", GF_CTR, 0, 0, src, size_kb*1024, nb_iter, ref, buf)) ret = 1;
+	if (!run_case("ctr 1:9", GF_CTR, 1, 9, src, size_kb*1024, nb_iter, ref, buf)) ret = 1;
+
+	gf_free(src);
+	gf_free(ref);
+	gf_free(buf);
+	gf_sys_close();
+	fprintf(stdout, "%s\n", ret ? "FAIL" : "PASS");
+	return ret;
+}
@@ -0,0 +1,521 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / ROUTE FEC test application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*sends a DASH session over ROUTE with Reed-Solomon repair symbols, captures the source and repair flows, and for each
+source block received in full erases source symbols and recovers them from the repair symbols with an RFC 5510 decoder
+(FEC encoding ID 5, block partitioning of RFC 5052). The test fails if a recovered symbol differs from the erased one*/
+
+#include <gpac/filters.h>
+#include <gpac/network.h>
+#include <gpac/thread.h>
+
+#define UDP_BUFFER_SIZE	0x10000
+#define MAX_K	255
+
+typedef struct
+{
+	GF_Socket *sk;
+	volatile Bool run;
+	u8 *data;
+	u32 size, alloc;
+} RecvCtx;
+
+typedef struct
+{
+	u32 tsi, toi, tol;
+	//source data, and received flag for each byte
+	u8 *data, *rcv;
+	//repair symbols indexed by SBN and ESI
+	GF_List *repairs;
+} FECObject;
+
+typedef struct
+{
+	u32 sbn, esi;
+	u8 *data;
+} RepairSymbol;
+
+static u8 gexp[512], glog[256];
+
+static u8 gmul(u8 a, u8 b)
+{
+	if (!a || !b) return 0;
+	return gexp[glog[a] + glog[b]];
+}
+
+static u8 ginv(u8 a)
+{
+	return gexp[255 - glog[a]];
+}
+
+static void gf256_init()
+{
+	u32 i, x = 1;
+	for (i=0; i<255; i++) {
+		gexp[i] = gexp[i+255] = (u8) x;
+		glog[x] = i;
+		x <<= 1;
+		if (x & 0x100) x ^= 0x11D;
+	}
+	gexp[510] = gexp[0];
+	gexp[511] = gexp[1];
+}
+
+//alpha^(i*e)
+static u8 vdm(u32 i, u32 e)
+{
+	return gexp[(i*e) % 255];
+}
+
+static u32 recv_thread(void *par)
+{
+	u8 buffer[UDP_BUFFER_SIZE];
+	RecvCtx *rc = (RecvCtx *)par;
+	while (rc->run) {
+		u32 read=0;
+		GF_Err e = gf_sk_receive(rc->sk, buffer, UDP_BUFFER_SIZE, &read);
+		if (e || !read) continue;
+		if (rc->size + read + 4 > rc->alloc) {
+			rc->alloc = 2*rc->alloc + read + 4;
+			rc->data = gf_realloc(rc->data, rc->alloc);
+			if (!rc->data) return 1;
+		}
+		rc->data[rc->size] = (read>>24) & 0xFF;
+		rc->data[rc->size+1] = (read>>16) & 0xFF;
+		rc->data[rc->size+2] = (read>>8) & 0xFF;
+		rc->data[rc->size+3] = read & 0xFF;
+		memcpy(rc->data + rc->size + 4, buffer, read);
+		rc->size += read + 4;
+	}
+	return 0;
+}
+
+static Bool start_recv(RecvCtx *rc, GF_Thread **th, u32 port)
+{
+	memset(rc, 0, sizeof(RecvCtx));
+	rc->sk = gf_sk_new(GF_SOCK_TYPE_UDP);
+	if (!rc->sk) return GF_FALSE;
+	if (gf_sk_bind(rc->sk, "127.0.0.1", port, "127.0.0.1", 0, GF_SOCK_REUSE_PORT)) {
+		gf_sk_del(rc->sk);
+		rc->sk = NULL;
+		return GF_FALSE;
+	}
+	gf_sk_set_buffer_size(rc->sk, 0, 0x2000000);
+	gf_sk_set_usec_wait(rc->sk, 1000);
+	rc->run = GF_TRUE;
+	*th = gf_th_new("RouteFECRecv");
+	gf_th_run(*th, recv_thread, rc);
+	return GF_TRUE;
+}
+
+static void stop_recv(RecvCtx *rc, GF_Thread *th)
+{
+	rc->run = GF_FALSE;
+	if (th) {
+		gf_th_stop(th);
+		gf_th_del(th);
+	}
+	if (rc->sk) gf_sk_del(rc->sk);
+}
+
+static FECObject *get_object(GF_List *objects, u32 tsi, u32 toi, u32 tol)
+{
+	u32 i, count = gf_list_count(objects);
+	FECObject *obj;
+	for (i=0; i<count; i++) {
+		obj = gf_list_get(objects, i);
+		if ((obj->tsi==tsi) && (obj->toi==toi) && (obj->tol==tol)) return obj;
+	}
+	GF_SAFEALLOC(obj, FECObject);
+	if (!obj) return NULL;
+	obj->tsi = tsi;
+	obj->toi = toi;
+	obj->tol = tol;
+	obj->data = gf_malloc(tol);
+	obj->rcv = gf_malloc(tol);
+	obj->repairs = gf_list_new();
+	memset(obj->rcv, 0, tol);
+	gf_list_add(objects, obj);
+	return obj;
+}
+
+//parse LCT packets of the source or repair flow, returns the repair symbol size
+static u32 parse_dgrams(RecvCtx *rc, GF_List *objects, Bool is_repair)
+{
+	u32 pos = 0, T = 0;
+	while (pos + 4 <= rc->size) {
+		u32 i, hdr_len, tsi, toi, tol = 0, fpi;
+		u8 *p = rc->data + pos + 4;
+		u32 size = ((u32) rc->data[pos]<<24) | ((u32) rc->data[pos+1]<<16) | ((u32) rc->data[pos+2]<<8) | rc->data[pos+3];
+		FECObject *obj;
+		pos += size + 4;
+
+		if (size < 16) continue;
+		hdr_len = 4 * p[2];
+		if (hdr_len + 4 > size) continue;
+		tsi = ((u32) p[8]<<24) | ((u32) p[9]<<16) | ((u32) p[10]<<8) | p[11];
+		toi = ((u32) p[12]<<24) | ((u32) p[13]<<16) | ((u32) p[14]<<8) | p[15];
+		//header extensions, looking for TOL
+		i = 16;
+		while (i < hdr_len) {
+			u8 het = p[i];
+			u32 hel = (het >= 128) ? 4 : 4*p[i+1];
+			if (!hel) break;
+			if (het==194) tol = ((u32) p[i+1]<<16) | ((u32) p[i+2]<<8) | p[i+3];
+			else if (het==67) tol = ((u32) p[i+4]<<24) | ((u32) p[i+5]<<16) | ((u32) p[i+6]<<8) | p[i+7];
+			i += hel;
+		}
+		if (!tol || !tsi) continue;
+		obj = get_object(objects, tsi, toi, tol);
+		if (!obj) continue;
+		fpi = ((u32) p[hdr_len]<<24) | ((u32) p[hdr_len+1]<<16) | ((u32) p[hdr_len+2]<<8) | p[hdr_len+3];
+		p += hdr_len + 4;
+		size -= hdr_len + 4;
+
+		if (!is_repair) {
+			if (fpi + size > tol) continue;
+			memcpy(obj->data + fpi, p, size);
+			memset(obj->rcv + fpi, 1, size);
+		} else {
+			RepairSymbol *rs;
+			GF_SAFEALLOC(rs, RepairSymbol);
+			if (!rs) continue;
+			rs->sbn = fpi >> 8;
+			rs->esi = fpi & 0xFF;
+			rs->data = gf_malloc(size);
+			memcpy(rs->data, p, size);
+			gf_list_add(obj->repairs, rs);
+			T = size;
+		}
+	}
+	return T;
+}
+
+//source block partitioning of RFC 5052 section 9.1
+static u32 get_block(u32 tol, u32 T, u32 B, u32 sbn, u32 *first_symbol)
+{
+	u32 N, Z, A_large, A_small, I_large;
+	N = (tol + T - 1) / T;
+	Z = (N + B - 1) / B;
+	if (sbn >= Z) return 0;
+	A_large = (N + Z - 1) / Z;
+	A_small = N / Z;
+	I_large = N - A_small * Z;
+	if (sbn < I_large) {
+		*first_symbol = sbn * A_large;
+		return A_large;
+	}
+	*first_symbol = I_large * A_large + (sbn - I_large) * A_small;
+	return A_small;
+}
+
+static RepairSymbol *get_repair(FECObject *obj, u32 sbn, u32 esi)
+{
+	u32 i, count = gf_list_count(obj->repairs);
+	for (i=0; i<count; i++) {
+		RepairSymbol *rs = gf_list_get(obj->repairs, i);
+		if ((rs->sbn==sbn) && (rs->esi==esi)) return rs;
+	}
+	return NULL;
+}
+
+/*decodes a block of k source symbols from k received symbols of ESIs esis: the symbols are the values at alpha^esi
+of a polynomial u of degree k-1, solve the Vandermonde system for the coefficients of u then evaluate u at alpha^j for
+the erased source symbols*/
+static Bool decode_block(u32 k, u32 T, u32 *esis, u8 **symbols, u32 nb_erased, u32 *erased, u8 **recovered)
+{
+	u32 i, j, r, b;
+	u8 *mat = gf_malloc(k*k);
+	for (r=0; r<k; r++) {
+		for (i=0; i<k; i++) {
+			mat[r*k + i] = vdm(i, esis[r]);
+		}
+	}
+	//Gauss-Jordan elimination, applied to the symbols
+	for (i=0; i<k; i++) {
+		u8 inv;
+		for (r=i; r<k; r++) {
+			if (mat[r*k + i]) break;
+		}
+		if (r==k) {
+			gf_free(mat);
+			return GF_FALSE;
+		}
+		if (r != i) {
+			u8 *tmp = symbols[r];
+			symbols[r] = symbols[i];
+			symbols[i] = tmp;
+			for (j=0; j<k; j++) {
+				u8 v = mat[r*k + j];
+				mat[r*k + j] = mat[i*k + j];
+				mat[i*k + j] = v;
+			}
+		}
+		inv = ginv(mat[i*k + i]);
+		for (j=0; j<k; j++) mat[i*k + j] = gmul(mat[i*k + j], inv);
+		for (b=0; b<T; b++) symbols[i][b] = gmul(symbols[i][b], inv);
+		for (r=0; r<k; r++) {
+			u8 f = mat[r*k + i];
+			if ((r==i) || !f) continue;
+			for (j=0; j<k; j++) mat[r*k + j] ^= gmul(f, mat[i*k + j]);
+			for (b=0; b<T; b++) symbols[r][b] ^= gmul(f, symbols[i][b]);
+		}
+	}
+	gf_free(mat);
+	//symbols now hold the coefficients of u
+	for (j=0; j<nb_erased; j++) {
+		memset(recovered[j], 0, T);
+		for (i=0; i<k; i++) {
+			u8 c = vdm(i, erased[j]);
+			for (b=0; b<T; b++) recovered[j][b] ^= gmul(c, symbols[i][b]);
+		}
+	}
+	return GF_TRUE;
+}
+
+//returns the number of verified blocks, or -1 if a recovered symbol is wrong
+static s32 check_object(FECObject *obj, u32 T, u32 B, u32 nb_repair)
+{
+	u32 sbn = 0;
+	s32 nb_ok = 0;
+	u32 esis[MAX_K];
+	u8 *symbols[MAX_K], *recovered[MAX_K], *orig[MAX_K];
+	u32 erased[MAX_K];
+
+	while (1) {
+		u32 i, k, first=0, nb_erased, nb_rcv = 0, start, len;
+		Bool complete = GF_TRUE;
+		k = get_block(obj->tol, T, B, sbn, &first);
+		if (!k) break;
+		start = first*T;
+		len = MIN(k*T, obj->tol - start);
+		//only check fully received blocks so that erased symbols are known
+		for (i=0; i<len; i++) {
+			if (!obj->rcv[start+i]) complete = GF_FALSE;
+		}
+		for (i=0; i<nb_repair; i++) {
+			if (!get_repair(obj, sbn, k+i)) complete = GF_FALSE;
+		}
+		if (!complete) {
+			sbn++;
+			continue;
+		}
+		//source symbols, the last one zero-padded
+		for (i=0; i<k; i++) {
+			u32 slen = MIN(T, len - i*T);
+			orig[i] = gf_malloc(T);
+			memset(orig[i], 0, T);
+			memcpy(orig[i], obj->data + start + i*T, slen);
+		}
+		//erase as many source symbols as there are repair symbols, spread over the block and varying with the block
+		nb_erased = MIN(nb_repair, k);
+		for (i=0; i<nb_erased; i++) {
+			erased[i] = (sbn + i * k / nb_erased) % k;
+		}
+		for (i=0; i<k; i++) {
+			u32 j;
+			Bool is_erased = GF_FALSE;
+			for (j=0; j<nb_erased; j++) {
+				if (erased[j]==i) is_erased = GF_TRUE;
+			}
+			if (is_erased) continue;
+			esis[nb_rcv] = i;
+			symbols[nb_rcv] = gf_malloc(T);
+			memcpy(symbols[nb_rcv], orig[i], T);
+			nb_rcv++;
+		}
+		for (i=0; nb_rcv<k; i++) {
+			RepairSymbol *rs = get_repair(obj, sbn, k+i);
+			esis[nb_rcv] = k+i;
+			symbols[nb_rcv] = gf_malloc(T);
+			memcpy(symbols[nb_rcv], rs->data, T);
+			nb_rcv++;
+		}
+		for (i=0; i<nb_erased; i++) recovered[i] = gf_malloc(T);
+
+		if (!decode_block(k, T, esis, symbols, nb_erased, erased, recovered)) {
+			fprintf(stderr, "TSI %u TOI %u block %u: singular system\n", obj->tsi, obj->toi, sbn);
+			nb_ok = -1;
+		} else {
+			for (i=0; i<nb_erased; i++) {
+				if (memcmp(recovered[i], orig[erased[i]], T)) {
+					fprintf(stderr, "TSI %u TOI %u block %u (k=%u): symbol %u not recovered\n", obj->tsi, obj->toi, sbn, k, erased[i]);
+					nb_ok = -1;
+					break;
+				}
+			}
+		}
+		for (i=0; i<k; i++) {
+			gf_free(orig[i]);
+			gf_free(symbols[i]);
+		}
+		for (i=0; i<nb_erased; i++) gf_free(recovered[i]);
+		if (nb_ok<0) return -1;
+		nb_ok++;
+		sbn++;
+	}
+	return nb_ok;
+}
+
+static void on_progress(const void *cbck, const char *title, u64 done, u64 total)
+{
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	FILE *f;
+	u8 *frame;
+	u32 i, port = 7700, fecn = 32, fecr = 4, nb_frames = 200, T;
+	s32 nb_blocks = 0;
+	char szFile[GF_MAX_PATH], szURL[GF_MAX_PATH+100];
+	RecvCtx src, rpr;
+	GF_Thread *th_src=NULL, *th_rpr=NULL;
+	GF_FilterSession *fs;
+	GF_List *objects;
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strncmp(arg, "-port=", 6)) port = atoi(arg+6);
+		else if (!strncmp(arg, "-fecn=", 6)) fecn = atoi(arg+6);
+		else if (!strncmp(arg, "-fecr=", 6)) fecr = atoi(arg+6);
+		else if (!strncmp(arg, "-n=", 3)) nb_frames = atoi(arg+3);
+		else {
+			fprintf(stderr, "usage: routefec [-port=PORT] [-fecn=NB_SRC] [-fecr=NB_REPAIR] [-n=NB_FRAMES]\n"
+			        "Checks recovery of ROUTE objects from Reed-Solomon repair symbols\n");
+			return 1;
+		}
+	}
+	if (!fecn || !fecr || (fecn + fecr > 255)) {
+		fprintf(stderr, "invalid FEC parameters\n");
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+	gf_set_progress_callback(NULL, on_progress);
+	gf256_init();
+
+	//ADTS stream with random payloads, only the headers are parsed by the session
+	sprintf(szFile, "%s/routefec_%08x.aac", gf_get_default_cache_directory(), gf_rand());
+	f = gf_fopen(szFile, "wb");
+	if (!f) {
+		fprintf(stderr, "Failed to create test file %s\n", szFile);
+		gf_sys_close();
+		return 1;
+	}
+	frame = gf_malloc(6000);
+	for (i=0; i<nb_frames; i++) {
+		u32 j, len = 1000 + (gf_rand() % 5000);
+		frame[0] = 0xFF;
+		frame[1] = 0xF1;
+		frame[2] = (1<<6) | (3<<2);
+		frame[3] = (2<<6) | ((len>>11) & 3);
+		frame[4] = (len>>3) & 0xFF;
+		frame[5] = ((len & 7)<<5) | 0x1F;
+		frame[6] = 0xFC;
+		for (j=7; j<len; j++) frame[j] = (u8) gf_rand();
+		gf_fwrite(frame, len, f);
+	}
+	gf_fclose(f);
+	gf_free(frame);
+
+	if (!start_recv(&src, &th_src, port) || !start_recv(&rpr, &th_rpr, port+1)) {
+		fprintf(stderr, "Failed to bind receive sockets on port %d\n", port);
+		stop_recv(&src, th_src);
+		stop_recv(&rpr, th_rpr);
+		gf_file_delete(szFile);
+		gf_sys_close();
+		return 1;
+	}
+
+	fs = gf_fs_new(0, GF_FS_SCHEDULER_LOCK_FREE, 0, NULL);
+	e = fs ? GF_OK : GF_OUT_OF_MEM;
+	if (!e) {
+		sprintf(szURL, "%s:#Bitrate=1000000", szFile);
+		gf_fs_load_source(fs, szURL, NULL, NULL, &e);
+	}
+	if (!e) {
+		sprintf(szURL, "route://127.0.0.1:%d/routefec_live.mpd:fec=rs:fecn=%d:fecr=%d:rate=50m", port, fecn, fecr);
+		gf_fs_load_destination(fs, szURL, NULL, NULL, &e);
+	}
+	if (!e) e = gf_fs_run(fs);
+	if (e==GF_EOS) e = GF_OK;
+	if (fs) gf_fs_del(fs);
+	gf_file_delete(szFile);
+	//let the last datagrams arrive
+	gf_sleep(50);
+	stop_recv(&src, th_src);
+	stop_recv(&rpr, th_rpr);
+
+	objects = gf_list_new();
+	if (e) {
+		fprintf(stderr, "Session error: %s\n", gf_error_to_string(e));
+		ret = 1;
+	} else {
+		parse_dgrams(&src, objects, GF_FALSE);
+		T = parse_dgrams(&rpr, objects, GF_TRUE);
+		if (!T) {
+			fprintf(stderr, "FAIL: no repair symbols received\n");
+			ret = 1;
+		}
+		for (i=0; !ret && i<gf_list_count(objects); i++) {
+			FECObject *obj = gf_list_get(objects, i);
+			s32 nb = check_object(obj, T, fecn, fecr);
+			if (nb<0) ret = 1;
+			else nb_blocks += nb;
+		}
+		if (!ret) {
+			fprintf(stdout, "%d objects - %d source blocks recovered from %d repair symbols each\n", gf_list_count(objects), nb_blocks, fecr);
+			if (!nb_blocks) {
+				fprintf(stderr, "FAIL: no complete source block received\n");
+				ret = 1;
+			} else {
+				fprintf(stdout, "PASS\n");
+			}
+		} else {
+			fprintf(stderr, "FAIL: repair symbols do not match RFC 5510 encoding\n");
+		}
+	}
+
+	while (gf_list_count(objects)) {
+		FECObject *obj = gf_list_pop_back(objects);
+		while (gf_list_count(obj->repairs)) {
+			RepairSymbol *rs = gf_list_pop_back(obj->repairs);
+			gf_free(rs->data);
+			gf_free(rs);
+		}
+		gf_list_del(obj->repairs);
+		gf_free(obj->data);
+		gf_free(obj->rcv);
+		gf_free(obj);
+	}
+	gf_list_del(objects);
+	if (src.data) gf_free(src.data);
+	if (rpr.data) gf_free(rpr.data);
+	gf_sys_close();
+	return ret;
+}
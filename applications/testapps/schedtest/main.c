@@ -0,0 +1,228 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / filter scheduler test application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*runs a rate-paced UDP output next to a UTSource/UTFilter/UTSink chain in the same session, once with the default
+FIFO scheduler and once with the deadline scheduler, and checks the lateness of datagram arrivals against the pacing schedule.
+The test fails if datagrams are lost or if the deadline scheduler is noticeably later than the FIFO scheduler*/
+
+#include <gpac/filters.h>
+#include <gpac/network.h>
+#include <gpac/thread.h>
+
+#define DGRAM_SIZE	5000
+#define UDP_BUFFER_SIZE	0x10000
+
+typedef struct
+{
+	GF_Socket *sk;
+	volatile Bool run;
+	u64 *arrivals;
+	u32 nb_arrivals, nb_alloc;
+} RecvCtx;
+
+typedef struct
+{
+	u32 nb_dgrams;
+	u64 p50, p99, max;
+} SchedResult;
+
+static u32 recv_thread(void *par)
+{
+	u8 buffer[UDP_BUFFER_SIZE];
+	RecvCtx *rc = (RecvCtx *)par;
+	while (rc->run) {
+		u32 read=0;
+		GF_Err e = gf_sk_receive(rc->sk, buffer, UDP_BUFFER_SIZE, &read);
+		if (e || !read) continue;
+		if (rc->nb_arrivals == rc->nb_alloc) {
+			rc->nb_alloc = rc->nb_alloc ? 2*rc->nb_alloc : 1024;
+			rc->arrivals = gf_realloc(rc->arrivals, sizeof(u64)*rc->nb_alloc);
+			if (!rc->arrivals) return 1;
+		}
+		rc->arrivals[rc->nb_arrivals++] = gf_sys_clock_high_res();
+	}
+	return 0;
+}
+
+static void on_progress(const void *cbck, const char *title, u64 done, u64 total)
+{
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	u64 va = *(const u64 *)a;
+	u64 vb = *(const u64 *)b;
+	return (va<vb) ? -1 : ((va>vb) ? 1 : 0);
+}
+
+static GF_Err run_session(const char *src, u32 port, u32 rate, u32 nb_bg_pck, Bool deadline, SchedResult *res)
+{
+	GF_Err e;
+	u32 i;
+	s64 min_offset;
+	u64 *lateness;
+	char szURL[GF_MAX_PATH], szArgs[100];
+	RecvCtx rc;
+	GF_Thread *th;
+	GF_FilterSession *fs;
+	Double period;
+
+	memset(res, 0, sizeof(SchedResult));
+	memset(&rc, 0, sizeof(RecvCtx));
+	rc.sk = gf_sk_new(GF_SOCK_TYPE_UDP);
+	if (!rc.sk) return GF_OUT_OF_MEM;
+	e = gf_sk_bind(rc.sk, "127.0.0.1", port, "127.0.0.1", 0, GF_SOCK_REUSE_PORT);
+	if (e) {
+		gf_sk_del(rc.sk);
+		return e;
+	}
+	gf_sk_set_buffer_size(rc.sk, 0, 0x800000);
+	gf_sk_set_usec_wait(rc.sk, 1000);
+	rc.run = GF_TRUE;
+	th = gf_th_new("SchedTestRecv");
+	gf_th_run(th, recv_thread, &rc);
+
+	fs = gf_fs_new(0, GF_FS_SCHEDULER_LOCK_FREE, deadline ? GF_FS_FLAG_DEADLINE_SCHED : 0, NULL);
+	if (!fs) {
+		e = GF_OUT_OF_MEM;
+		goto exit;
+	}
+	gf_fs_register_test_filters(fs);
+	sprintf(szArgs, "block_size=%d", DGRAM_SIZE);
+	gf_fs_load_source(fs, src, szArgs, NULL, &e);
+	if (!e) {
+		sprintf(szURL, "udp://127.0.0.1:%d/:rate=%d:ext=ts", port, rate);
+		gf_fs_load_destination(fs, szURL, NULL, NULL, &e);
+	}
+	if (!e) {
+		//background load: UTSource packets consumed by UTSink
+		sprintf(szArgs, "UTSource:max_pck=%d", nb_bg_pck);
+		gf_fs_load_filter(fs, szArgs, &e);
+	}
+	if (!e) gf_fs_load_filter(fs, "UTSink", &e);
+	if (!e) e = gf_fs_run(fs);
+	if (e==GF_EOS) e = GF_OK;
+	gf_fs_del(fs);
+	//let the last datagrams arrive
+	gf_sleep(50);
+
+exit:
+	rc.run = GF_FALSE;
+	gf_th_stop(th);
+	gf_th_del(th);
+	gf_sk_del(rc.sk);
+	if (e || !rc.nb_arrivals) {
+		if (rc.arrivals) gf_free(rc.arrivals);
+		return e;
+	}
+
+	//offset of each arrival to the pacing schedule, lateness relative to the earliest datagram
+	period = DGRAM_SIZE * 8 * 1000000.0 / rate;
+	lateness = gf_malloc(sizeof(u64) * rc.nb_arrivals);
+	min_offset = 0;
+	for (i=0; i<rc.nb_arrivals; i++) {
+		s64 offset = (s64) (rc.arrivals[i] - rc.arrivals[0]) - (s64) (i * period);
+		if (!i || (offset < min_offset)) min_offset = offset;
+	}
+	for (i=0; i<rc.nb_arrivals; i++) {
+		s64 offset = (s64) (rc.arrivals[i] - rc.arrivals[0]) - (s64) (i * period);
+		lateness[i] = (u64) (offset - min_offset);
+	}
+	qsort(lateness, rc.nb_arrivals, sizeof(u64), cmp_u64);
+	res->nb_dgrams = rc.nb_arrivals;
+	res->p50 = lateness[rc.nb_arrivals/2];
+	res->p99 = lateness[rc.nb_arrivals*99/100];
+	res->max = lateness[rc.nb_arrivals-1];
+	gf_free(lateness);
+	gf_free(rc.arrivals);
+	return GF_OK;
+}
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	FILE *f;
+	u8 *data;
+	u32 i, nb_dgrams = 500, rate = 2000000, port = 12345, nb_bg_pck = 200000;
+	char szFile[GF_MAX_PATH];
+	SchedResult fifo, edf;
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strncmp(arg, "-n=", 3)) nb_dgrams = atoi(arg+3);
+		else if (!strncmp(arg, "-rate=", 6)) rate = atoi(arg+6);
+		else if (!strncmp(arg, "-port=", 6)) port = atoi(arg+6);
+		else if (!strncmp(arg, "-bg=", 4)) nb_bg_pck = atoi(arg+4);
+		else {
+			fprintf(stderr, "usage: schedtest [-n=NB_DGRAMS] [-rate=BPS] [-port=PORT] [-bg=NB_BG_PACKETS]\n"
+			        "Compares datagram pacing of a rate-limited UDP output with FIFO and deadline scheduling under background filter load\n");
+			return 1;
+		}
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+	gf_set_progress_callback(NULL, on_progress);
+
+	//payload, TS sync bytes are not needed by the socket output
+	sprintf(szFile, "%s/schedtest_%08x.ts", gf_get_default_cache_directory(), gf_rand());
+	f = gf_fopen(szFile, "wb");
+	if (!f) {
+		fprintf(stderr, "Failed to create test file %s\n", szFile);
+		gf_sys_close();
+		return 1;
+	}
+	data = gf_malloc(DGRAM_SIZE);
+	memset(data, 0x47, DGRAM_SIZE);
+	for (i=0; i<nb_dgrams; i++) gf_fwrite(data, DGRAM_SIZE, f);
+	gf_fclose(f);
+	gf_free(data);
+
+	e = run_session(szFile, port, rate, nb_bg_pck, GF_FALSE, &fifo);
+	if (!e) e = run_session(szFile, port, rate, nb_bg_pck, GF_TRUE, &edf);
+	gf_file_delete(szFile);
+
+	if (e) {
+		fprintf(stderr, "Session error: %s\n", gf_error_to_string(e));
+		ret = 1;
+	} else {
+		fprintf(stdout, "FIFO: %d/%d datagrams - lateness p50 "LLU" us p99 "LLU" us max "LLU" us\n", fifo.nb_dgrams, nb_dgrams, fifo.p50, fifo.p99, fifo.max);
+		fprintf(stdout, "EDF:  %d/%d datagrams - lateness p50 "LLU" us p99 "LLU" us max "LLU" us\n", edf.nb_dgrams, nb_dgrams, edf.p50, edf.p99, edf.max);
+		if ((fifo.nb_dgrams != nb_dgrams) || (edf.nb_dgrams != nb_dgrams)) {
+			fprintf(stderr, "FAIL: datagrams lost\n");
+			ret = 1;
+		}
+		//allow 2 ms of measurement noise, arrival times are taken by a thread competing with the session one
+		else if (edf.p99 > fifo.p99 + 2000) {
+			fprintf(stderr, "FAIL: deadline scheduling later than FIFO scheduling\n");
+			ret = 1;
+		} else {
+			fprintf(stdout, "PASS\n");
+		}
+	}
+	gf_sys_close();
+	return ret;
+}
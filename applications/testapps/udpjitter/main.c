@@ -0,0 +1,273 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / UDP TS jitter analyzer application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/network.h>
+#include <math.h>
+
+#define UDP_BUFFER_SIZE	0x10000
+#define MPEGTS_PKT_SIZE 188
+
+typedef struct
+{
+	u64 arrival;
+	u64 pcr;
+	u64 pos;
+	u32 offset;
+} PCRSample;
+
+static u64 *arrivals = NULL;
+static u32 nb_arrivals = 0, nb_alloc_arrivals = 0;
+static PCRSample *pcrs = NULL;
+static u32 nb_pcrs = 0, nb_alloc_pcrs = 0;
+static u32 pcr_pid = 0, nb_pcr_disc = 0;
+
+void usage()
+{
+	fprintf(stderr, "usage: udpjitter [options] udp://address:port\n"
+	        "Receives a UDP stream and reports datagram inter-arrival jitter, and PCR jitter and accuracy for MPEG-2 TS content\n"
+	        "-idle=MS   stop after MS milliseconds without datagrams once reception started (default 2000)\n"
+	        "-n=N       stop after N datagrams\n"
+	        "-ifce=IP   network interface for multicast reception\n"
+	        "\n");
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	u64 v1 = *(const u64 *)a;
+	u64 v2 = *(const u64 *)b;
+	if (v1<v2) return -1;
+	if (v1>v2) return 1;
+	return 0;
+}
+
+static void push_arrival(u64 time)
+{
+	if (nb_arrivals == nb_alloc_arrivals) {
+		nb_alloc_arrivals = nb_alloc_arrivals ? 2*nb_alloc_arrivals : 10000;
+		arrivals = gf_realloc(arrivals, sizeof(u64) * nb_alloc_arrivals);
+	}
+	arrivals[nb_arrivals++] = time;
+}
+
+static void push_pcrs(u8 *data, u32 size, u64 time, u64 pos)
+{
+	u32 i;
+	for (i=0; i+MPEGTS_PKT_SIZE<=size; i+=MPEGTS_PKT_SIZE) {
+		u32 pid;
+		u64 pcr;
+		u8 *ts = data+i;
+		if (ts[0] != 0x47) return;
+		if (!(ts[3] & 0x20) || (ts[4] < 7) || !(ts[5] & 0x10)) continue;
+		pid = ((ts[1] & 0x1f) << 8) | ts[2];
+		if (!pcr_pid) pcr_pid = pid;
+		else if (pid != pcr_pid) continue;
+
+		pcr = ((u64)ts[6] << 25) | ((u64)ts[7] << 17) | ((u64)ts[8] << 9) | ((u64)ts[9] << 1) | ((u64)ts[10] >> 7);
+		pcr = pcr * 300 + (((ts[10] & 1) << 8) | ts[11]);
+		//discontinuity or wrap, only analyze the last continuous segment
+		if (nb_pcrs && (pcr <= pcrs[nb_pcrs-1].pcr)) {
+			nb_pcr_disc++;
+			nb_pcrs = 0;
+		}
+		if (nb_pcrs == nb_alloc_pcrs) {
+			nb_alloc_pcrs = nb_alloc_pcrs ? 2*nb_alloc_pcrs : 1000;
+			pcrs = gf_realloc(pcrs, sizeof(PCRSample) * nb_alloc_pcrs);
+		}
+		pcrs[nb_pcrs].arrival = time;
+		pcrs[nb_pcrs].pcr = pcr;
+		pcrs[nb_pcrs].pos = pos + i;
+		pcrs[nb_pcrs].offset = i;
+		nb_pcrs++;
+	}
+}
+
+static void report_arrivals(u64 nb_bytes)
+{
+	u32 i, nb_gaps;
+	u64 *gaps, dur;
+	Double mean, var;
+	if (nb_arrivals<2) {
+		fprintf(stdout, "Not enough datagrams received\n");
+		return;
+	}
+	nb_gaps = nb_arrivals-1;
+	dur = arrivals[nb_gaps] - arrivals[0];
+	gaps = gf_malloc(sizeof(u64) * nb_gaps);
+	mean = 0;
+	for (i=0; i<nb_gaps; i++) {
+		gaps[i] = arrivals[i+1] - arrivals[i];
+		mean += (Double) gaps[i];
+	}
+	mean /= nb_gaps;
+	var = 0;
+	for (i=0; i<nb_gaps; i++) {
+		Double d = (Double) gaps[i] - mean;
+		var += d*d;
+	}
+	var /= nb_gaps;
+	qsort(gaps, nb_gaps, sizeof(u64), cmp_u64);
+
+	fprintf(stdout, "Datagrams: %d - "LLU" bytes in %.3f s - %.3f kbps\n", nb_arrivals, nb_bytes, ((Double)dur)/1000000, dur ? ((Double)nb_bytes)*8000/dur : 0);
+	fprintf(stdout, "Inter-arrival (us): mean %.1f stddev %.1f min "LLU" p50 "LLU" p99 "LLU" max "LLU"\n",
+		mean, sqrt(var), gaps[0], gaps[nb_gaps/2], gaps[(u32) (((u64)nb_gaps)*99/100)], gaps[nb_gaps-1]);
+	gf_free(gaps);
+}
+
+static void report_pcrs()
+{
+	u32 i;
+	u64 max_int=0;
+	Double sx=0, sy=0, sxx=0, sxy=0, a, b, n, rate, us_per_byte;
+	Double oj_max=0, oj_var=0, ac_max=0;
+
+	if (pcr_pid) fprintf(stdout, "PCR PID %d - %d PCRs analyzed - %d discontinuities\n", pcr_pid, nb_pcrs, nb_pcr_disc);
+	if (nb_pcrs<3) return;
+
+	for (i=1; i<nb_pcrs; i++) {
+		u64 diff = pcrs[i].pcr - pcrs[i-1].pcr;
+		if (diff>max_int) max_int = diff;
+	}
+	fprintf(stdout, "PCR interval (ms): mean %.2f max %.2f\n", ((Double) (pcrs[nb_pcrs-1].pcr - pcrs[0].pcr)) / 27000 / (nb_pcrs-1), ((Double) max_int)/27000);
+
+	//PCR overall jitter: arrival time vs PCR time, after removing the sender/receiver clock drift
+	//with a least-square linear fit. Datagrams are assumed to be sent at the time of their first byte,
+	//the arrival time of the PCR packet is extrapolated from its position in the datagram at the TS rate
+	n = nb_pcrs;
+	us_per_byte = ((Double) (pcrs[nb_pcrs-1].pcr - pcrs[0].pcr)) / 27 / (pcrs[nb_pcrs-1].pos - pcrs[0].pos);
+	for (i=0; i<nb_pcrs; i++) {
+		Double x = ((Double) (pcrs[i].pcr - pcrs[0].pcr)) / 27;
+		Double y = (Double) (pcrs[i].arrival - pcrs[0].arrival) + us_per_byte * pcrs[i].offset;
+		sx += x;
+		sy += y;
+		sxx += x*x;
+		sxy += x*y;
+	}
+	a = (n*sxy - sx*sy) / (n*sxx - sx*sx);
+	b = (sy - a*sx) / n;
+	for (i=0; i<nb_pcrs; i++) {
+		Double x = ((Double) (pcrs[i].pcr - pcrs[0].pcr)) / 27;
+		Double y = (Double) (pcrs[i].arrival - pcrs[0].arrival) + us_per_byte * pcrs[i].offset;
+		Double d = y - (a*x + b);
+		oj_var += d*d;
+		if (fabs(d) > oj_max) oj_max = fabs(d);
+	}
+	oj_var /= n;
+	fprintf(stdout, "PCR overall jitter (us): stddev %.1f max %.1f - clock drift %.1f ppm\n", sqrt(oj_var), oj_max, (a-1)*1000000);
+
+	//PCR accuracy: PCR value vs PCR expected at the PCR packet position for a constant rate stream
+	rate = ((Double) (pcrs[nb_pcrs-1].pos - pcrs[0].pos)) / (pcrs[nb_pcrs-1].pcr - pcrs[0].pcr);
+	if (rate>0) {
+		for (i=0; i<nb_pcrs; i++) {
+			Double exp_pcr = ((Double) (pcrs[i].pos - pcrs[0].pos)) / rate;
+			Double d = (Double) (pcrs[i].pcr - pcrs[0].pcr) - exp_pcr;
+			if (fabs(d) > ac_max) ac_max = fabs(d);
+		}
+		fprintf(stdout, "TS rate from PCRs %.3f kbps - PCR accuracy vs constant rate: max %.0f ns\n", rate*8*27000, ac_max*1000/27);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, idle = 2000, max_pck = 0;
+	char *src = NULL, *ifce = NULL;
+	char *ip, *sep;
+	u16 port = 1234;
+	u8 *buffer;
+	u64 last_time = 0, nb_bytes = 0;
+	GF_Socket *sk;
+	GF_Err e;
+
+	for (i = 1; i < (u32) argc ; i++) {
+		char *arg = argv[i];
+		if (!strnicmp(arg, "-idle=", 6)) idle = atoi(arg+6);
+		else if (!strnicmp(arg, "-n=", 3)) max_pck = atoi(arg+3);
+		else if (!strnicmp(arg, "-ifce=", 6)) ifce = arg+6;
+		else if (!strnicmp(arg, "udp://", 6)) src = arg+6;
+		else {
+			usage();
+			return 1;
+		}
+	}
+	if (!src) {
+		usage();
+		return 1;
+	}
+	gf_sys_init(GF_MemTrackerNone, NULL);
+
+	ip = gf_strdup(src);
+	sep = strrchr(ip, ':');
+	if (sep) {
+		port = atoi(sep+1);
+		sep[0] = 0;
+	}
+	sep = strchr(ip, '/');
+	if (sep) sep[0] = 0;
+
+	sk = gf_sk_new(GF_SOCK_TYPE_UDP);
+	if (gf_sk_is_multicast_address(ip)) {
+		e = gf_sk_setup_multicast(sk, ip, port, 0, 0, ifce);
+	} else {
+		e = gf_sk_bind(sk, ifce, port, ip, 0, GF_SOCK_REUSE_PORT);
+	}
+	if (e) {
+		fprintf(stderr, "Error initializing UDP socket for %s:%d : %s\n", ip, port, gf_error_to_string(e));
+		gf_sk_del(sk);
+		gf_free(ip);
+		gf_sys_close();
+		return 1;
+	}
+	gf_sk_set_buffer_size(sk, 0, 0x800000);
+	gf_sk_set_usec_wait(sk, 1000);
+	buffer = gf_malloc(UDP_BUFFER_SIZE);
+
+	fprintf(stderr, "Listening on %s:%d\n", ip, port);
+	while (1) {
+		u32 read = 0;
+		u64 now;
+		e = gf_sk_receive(sk, buffer, UDP_BUFFER_SIZE, &read);
+		now = gf_sys_clock_high_res();
+		if (e || !read) {
+			if (last_time && (now - last_time > idle*1000)) break;
+			continue;
+		}
+		last_time = now;
+		push_arrival(now);
+		push_pcrs(buffer, read, now, nb_bytes);
+		nb_bytes += read;
+		if (max_pck && (nb_arrivals >= max_pck)) break;
+	}
+
+	report_arrivals(nb_bytes);
+	report_pcrs();
+
+	if (arrivals) gf_free(arrivals);
+	if (pcrs) gf_free(pcrs);
+	gf_free(buffer);
+	gf_free(ip);
+	gf_sk_del(sk);
+	gf_sys_close();
+	return 0;
+}
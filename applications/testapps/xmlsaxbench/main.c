@@ -0,0 +1,257 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / XML parser benchmark application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*measures the XML parser on large documents: a TTML document (50 MB by default) with styled paragraphs, line breaks and
+entities, and an MPD (14 MB by default) with a long SegmentTimeline, or the files given with -i. For each document the
+SAX parse of the file, the DOM parse of the file, the DOM parse of the document loaded in memory and the serialization of
+the DOM tree are timed, keeping the best of several runs. The test fails on any parse error, if the DOM tree does not have
+as many elements as reported by the SAX parser, or if the trees parsed from the file and from memory do not serialize to the
+same document*/
+
+#include <gpac/xml.h>
+
+typedef struct
+{
+	u32 nb_nodes;
+	u64 nb_text;
+} SAXStats;
+
+static void on_node_start(void *sax_cbck, const char *node_name, const char *name_space, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	((SAXStats *)sax_cbck)->nb_nodes++;
+}
+
+static void on_text(void *sax_cbck, const char *content, Bool is_cdata)
+{
+	((SAXStats *)sax_cbck)->nb_text += strlen(content);
+}
+
+static GF_Err gen_ttml(const char *path, u32 size)
+{
+	u32 i = 0;
+	u64 written = 0;
+	FILE *f = gf_fopen(path, "wt");
+	if (!f) return GF_IO_ERR;
+	written += gf_fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<tt xmlns=\"http://www.w3.org/ns/ttml\" xmlns:tts=\"http://www.w3.org/ns/ttml#styling\" xml:lang=\"en\">\n"
+		"<head>\n<styling>\n<style xml:id=\"s1\" tts:color=\"white\" tts:fontFamily=\"proportionalSansSerif\"/>\n</styling>\n"
+		"<layout>\n<region xml:id=\"bottom\" tts:origin=\"10% 80%\" tts:extent=\"80% 20%\"/>\n</layout>\n</head>\n"
+		"<body style=\"s1\" region=\"bottom\">\n<div>\n");
+	while (written < size) {
+		u32 s = i % 3600, ms = (i * 40) % 1000;
+		written += gf_fprintf(f, "<p begin=\"%02d:%02d:%02d.%03d\" end=\"%02d:%02d:%02d.%03d\" xml:id=\"p%d\">Caption line %d &amp; speaker<br/>"
+			"second &lt;line&gt; of text</p>\n", s/3600, (s/60)%60, s%60, ms, s/3600, (s/60)%60, s%60, ms, i, i);
+		i++;
+	}
+	gf_fprintf(f, "</div>\n</body>\n</tt>\n");
+	gf_fclose(f);
+	return GF_OK;
+}
+
+static GF_Err gen_mpd(const char *path, u32 size)
+{
+	u32 i = 0;
+	u64 written = 0, t = 0;
+	FILE *f = gf_fopen(path, "wt");
+	if (!f) return GF_IO_ERR;
+	written += gf_fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"dynamic\" minimumUpdatePeriod=\"PT2S\" availabilityStartTime=\"2026-01-01T00:00:00Z\" "
+		"profiles=\"urn:mpeg:dash:profile:isoff-live:2011\" minBufferTime=\"PT2S\">\n"
+		"<Period id=\"p0\" start=\"PT0S\">\n<AdaptationSet segmentAlignment=\"true\" mimeType=\"video/mp4\">\n"
+		"<SegmentTemplate timescale=\"90000\" media=\"video_$Time$.m4s\" initialization=\"video_init.mp4\">\n<SegmentTimeline>\n");
+	while (written < size) {
+		//irregular durations so that timeline entries cannot be merged with r
+		u32 d = 180000 + (i % 7) * 3000;
+		written += gf_fprintf(f, "<S t=\""LLU"\" d=\"%u\"/>\n", t, d);
+		t += d;
+		i++;
+	}
+	gf_fprintf(f, "</SegmentTimeline>\n</SegmentTemplate>\n"
+		"<Representation id=\"v1\" bandwidth=\"3000000\" width=\"1920\" height=\"1080\" codecs=\"avc1.640028\"/>\n"
+		"</AdaptationSet>\n</Period>\n</MPD>\n");
+	gf_fclose(f);
+	return GF_OK;
+}
+
+static u32 count_elements(GF_XMLNode *node)
+{
+	u32 i = 0, count = 1;
+	GF_XMLNode *child;
+	while ((child = gf_list_enum(node->content, &i))) {
+		if (child->type == GF_XML_NODE_TYPE) count += count_elements(child);
+	}
+	return count;
+}
+
+static Bool bench_doc(const char *path, u32 nb_runs)
+{
+	u32 i, doc_size, nb_dom_nodes = 0;
+	u64 t, best_sax = (u64) -1, best_dom = (u64) -1, best_str = (u64) -1, best_ser = (u64) -1;
+	u8 *doc = NULL;
+	char *ser = NULL, *ser_file = NULL;
+	SAXStats stats;
+	Bool same;
+	GF_Err e;
+
+	e = gf_file_load_data(path, &doc, &doc_size);
+	if (e) {
+		fprintf(stderr, "%s: cannot load file: %s\n", path, gf_error_to_string(e));
+		return GF_FALSE;
+	}
+
+	for (i=0; i<nb_runs; i++) {
+		GF_DOMParser *dom;
+		GF_SAXParser *sax;
+		char *str;
+
+		memset(&stats, 0, sizeof(SAXStats));
+		sax = gf_xml_sax_new(on_node_start, NULL, on_text, &stats);
+		t = gf_sys_clock_high_res();
+		e = gf_xml_sax_parse_file(sax, path, NULL);
+		t = gf_sys_clock_high_res() - t;
+		gf_xml_sax_del(sax);
+		if (e<0) break;
+		e = GF_OK;
+		if (t < best_sax) best_sax = t;
+
+		dom = gf_xml_dom_new();
+		t = gf_sys_clock_high_res();
+		e = gf_xml_dom_parse(dom, path, NULL, NULL);
+		t = gf_sys_clock_high_res() - t;
+		if (!e) {
+			nb_dom_nodes = count_elements(gf_xml_dom_get_root(dom));
+			if (!ser_file) ser_file = gf_xml_dom_serialize(gf_xml_dom_get_root(dom), GF_FALSE);
+		}
+		gf_xml_dom_del(dom);
+		if (e) break;
+		if (t < best_dom) best_dom = t;
+
+		//the string is modified in place by the parser
+		str = gf_strdup((char *) doc);
+		dom = gf_xml_dom_new();
+		t = gf_sys_clock_high_res();
+		e = gf_xml_dom_parse_string(dom, str);
+		t = gf_sys_clock_high_res() - t;
+		gf_free(str);
+		if (e) {
+			gf_xml_dom_del(dom);
+			break;
+		}
+		if (t < best_str) best_str = t;
+
+		if (ser) gf_free(ser);
+		t = gf_sys_clock_high_res();
+		ser = gf_xml_dom_serialize(gf_xml_dom_get_root(dom), GF_FALSE);
+		t = gf_sys_clock_high_res() - t;
+		gf_xml_dom_del(dom);
+		if (!ser) {
+			e = GF_OUT_OF_MEM;
+			break;
+		}
+		if (t < best_ser) best_ser = t;
+	}
+	gf_free(doc);
+	if (e) {
+		fprintf(stderr, "%s: parse failed: %s\n", path, gf_error_to_string(e));
+		if (ser) gf_free(ser);
+		if (ser_file) gf_free(ser_file);
+		return GF_FALSE;
+	}
+	same = (ser && ser_file && !strcmp(ser, ser_file)) ? GF_TRUE : GF_FALSE;
+	if (ser) gf_free(ser);
+	if (ser_file) gf_free(ser_file);
+
+	fprintf(stdout, "%s: %.2f MB, %u elements, "LLU" text bytes\n", gf_file_basename(path), ((Double) doc_size) / 1000000, stats.nb_nodes, stats.nb_text);
+	fprintf(stdout, "\tSAX from file:   %8.2f ms (%.2f MB/s)\n", ((Double) best_sax) / 1000, ((Double) doc_size) / best_sax);
+	fprintf(stdout, "\tDOM from file:   %8.2f ms (%.2f MB/s)\n", ((Double) best_dom) / 1000, ((Double) doc_size) / best_dom);
+	fprintf(stdout, "\tDOM from string: %8.2f ms (%.2f MB/s)\n", ((Double) best_str) / 1000, ((Double) doc_size) / best_str);
+	fprintf(stdout, "\tDOM serialize:   %8.2f ms\n", ((Double) best_ser) / 1000);
+
+	if (nb_dom_nodes != stats.nb_nodes) {
+		fprintf(stderr, "%s: DOM has %u elements, SAX reported %u\n", path, nb_dom_nodes, stats.nb_nodes);
+		return GF_FALSE;
+	}
+	if (!same) {
+		fprintf(stderr, "%s: DOM parsed from file and from memory serialize differently\n", path);
+		return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, ttml_mb = 50, mpd_mb = 14, nb_runs = 3, nb_inputs = 0;
+	char szTTML[GF_MAX_PATH], szMPD[GF_MAX_PATH];
+	int ret = 0;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strncmp(arg, "-ttml=", 6)) ttml_mb = atoi(arg+6);
+		else if (!strncmp(arg, "-mpd=", 5)) mpd_mb = atoi(arg+5);
+		else if (!strncmp(arg, "-n=", 3)) nb_runs = atoi(arg+3);
+		else if (!strncmp(arg, "-i=", 3)) nb_inputs++;
+		else {
+			fprintf(stderr, "usage: xmlsaxbench [-ttml=MB] [-mpd=MB] [-n=NB_RUNS] [-i=FILE]*\n"
+			        "Times SAX and DOM parsing and DOM serialization of large XML documents, generated TTML and MPD unless files are given\n");
+			return 1;
+		}
+	}
+	if (!nb_runs) nb_runs = 1;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+
+	if (nb_inputs) {
+		for (i=1; i<(u32) argc; i++) {
+			if (strncmp(argv[i], "-i=", 3)) continue;
+			if (!bench_doc(argv[i]+3, nb_runs)) ret = 1;
+		}
+	} else {
+		sprintf(szTTML, "%s/xmlsaxbench_%08x.ttml", gf_get_default_cache_directory(), gf_rand());
+		sprintf(szMPD, "%s/xmlsaxbench_%08x.mpd", gf_get_default_cache_directory(), gf_rand());
+		if (ttml_mb) {
+			if (gen_ttml(szTTML, ttml_mb*1000000) != GF_OK) {
+				fprintf(stderr, "Failed to create %s\n", szTTML);
+				ret = 1;
+			} else if (!bench_doc(szTTML, nb_runs)) {
+				ret = 1;
+			}
+			gf_file_delete(szTTML);
+		}
+		if (mpd_mb) {
+			if (gen_mpd(szMPD, mpd_mb*1000000) != GF_OK) {
+				fprintf(stderr, "Failed to create %s\n", szMPD);
+				ret = 1;
+			} else if (!bench_doc(szMPD, nb_runs)) {
+				ret = 1;
+			}
+			gf_file_delete(szMPD);
+		}
+	}
+
+	gf_sys_close();
+	fprintf(stdout, "%s\n", ret ? "FAIL" : "PASS");
+	return ret;
+}
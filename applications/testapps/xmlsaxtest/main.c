@@ -0,0 +1,206 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / SAX parser chunking test application
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+/*feeds a document to the SAX parser in one call, then in chunks of every size from 1 byte up, so that entities, CDATA
+sections, comments, tags and attributes are split across gf_xml_sax_parse calls and the input buffer is compacted while
+nodes are pending. The callbacks are serialized to a transcript, consecutive text callbacks being merged, and each chunked
+transcript must be identical to the single-call one. The test fails on any parse error or transcript mismatch*/
+
+#include <gpac/xml.h>
+
+#define NB_REPEAT	200
+
+typedef struct
+{
+	char *str;
+	u32 size, alloc;
+	//type of the last text callback: 0 none, 1 text, 2 CDATA
+	u32 last_text;
+} Transcript;
+
+static void tr_append(Transcript *tr, const char *str)
+{
+	u32 len = (u32) strlen(str);
+	if (tr->size + len + 1 > tr->alloc) {
+		tr->alloc = MAX(2*tr->alloc, tr->size + len + 1);
+		tr->str = gf_realloc(tr->str, tr->alloc);
+	}
+	memcpy(tr->str + tr->size, str, len+1);
+	tr->size += len;
+}
+
+static void on_node_start(void *sax_cbck, const char *node_name, const char *name_space, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	Transcript *tr = (Transcript *)sax_cbck;
+	if (tr->last_text) tr_append(tr, "]");
+	tr->last_text = 0;
+	tr_append(tr, "<");
+	if (name_space) {
+		tr_append(tr, name_space);
+		tr_append(tr, ":");
+	}
+	tr_append(tr, node_name);
+	for (i=0; i<nb_attributes; i++) {
+		tr_append(tr, " ");
+		tr_append(tr, attributes[i].name);
+		tr_append(tr, "=[");
+		tr_append(tr, attributes[i].value);
+		tr_append(tr, "]");
+	}
+	tr_append(tr, ">");
+}
+
+static void on_node_end(void *sax_cbck, const char *node_name, const char *name_space)
+{
+	Transcript *tr = (Transcript *)sax_cbck;
+	if (tr->last_text) tr_append(tr, "]");
+	tr->last_text = 0;
+	tr_append(tr, "</");
+	tr_append(tr, node_name);
+	tr_append(tr, ">");
+}
+
+static void on_text(void *sax_cbck, const char *content, Bool is_cdata)
+{
+	Transcript *tr = (Transcript *)sax_cbck;
+	u32 type = is_cdata ? 2 : 1;
+	//text may be delivered in several callbacks depending on chunking, merge them
+	if (tr->last_text != type) {
+		if (tr->last_text) tr_append(tr, "]");
+		tr_append(tr, is_cdata ? "C[" : "T[");
+		tr->last_text = type;
+	}
+	tr_append(tr, content);
+}
+
+static GF_Err parse_doc(const char *doc, u32 chunk_size, Transcript *tr)
+{
+	GF_Err e;
+	u32 pos, len = (u32) strlen(doc);
+	char *chunk;
+	GF_SAXParser *sax = gf_xml_sax_new(on_node_start, on_node_end, on_text, tr);
+	if (!sax) return GF_OUT_OF_MEM;
+
+	memset(tr, 0, sizeof(Transcript));
+	tr_append(tr, "");
+	chunk = gf_malloc(chunk_size+1);
+	e = gf_xml_sax_init(sax, NULL);
+	for (pos=0; !e && (pos<len); pos+=chunk_size) {
+		u32 size = MIN(chunk_size, len - pos);
+		memcpy(chunk, doc+pos, size);
+		chunk[size] = 0;
+		e = gf_xml_sax_parse(sax, chunk);
+	}
+	if (tr->last_text) tr_append(tr, "]");
+	if (!e) {
+		const char *err = gf_xml_sax_get_error(sax);
+		if (err && err[0]) {
+			fprintf(stderr, "SAX error: %s\n", err);
+			e = GF_NON_COMPLIANT_BITSTREAM;
+		}
+	}
+	gf_free(chunk);
+	gf_xml_sax_del(sax);
+	return e;
+}
+
+static const char *doc_item =
+	"<item id=\"a&amp;b\" name='&#x41;&#66;&lt;&gt;' quot=\"&quot;&apos;\">"
+	"text &amp; more &#x263A; &lt;tag&gt;"
+	"<![CDATA[raw <data> & ]] stuff]]>"
+	"<!-- a comment with <tags> & entities -->"
+	"<sub:child xmlns:sub=\"urn:test\" v=\"1\"/>"
+	"tail&#32;text"
+	"</item>\n";
+
+int main(int argc, char **argv)
+{
+	GF_Err e;
+	u32 i, len, max_chunk = 0, nb_fail = 0;
+	char *doc;
+	Transcript ref, tr;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strncmp(arg, "-max=", 5)) max_chunk = atoi(arg+5);
+		else {
+			fprintf(stderr, "usage: xmlsaxtest [-max=MAX_CHUNK_SIZE]\n"
+			        "Checks that SAX parsing gives the same result whatever the size of the chunks passed to the parser\n");
+			return 1;
+		}
+	}
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_ERROR);
+
+	len = (u32) strlen(doc_item);
+	doc = gf_malloc(len*NB_REPEAT + 100);
+	strcpy(doc, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<root>\n");
+	for (i=0; i<NB_REPEAT; i++) strcat(doc, doc_item);
+	strcat(doc, "</root>\n");
+	len = (u32) strlen(doc);
+	if (!max_chunk) max_chunk = 2*(u32) strlen(doc_item);
+
+	e = parse_doc(doc, len, &ref);
+	if (e) {
+		fprintf(stderr, "FAIL: single call parsing error %s\n", gf_error_to_string(e));
+		gf_free(doc);
+		if (ref.str) gf_free(ref.str);
+		gf_sys_close();
+		return 1;
+	}
+	//sanity check of the reference against the expected entity and CDATA translation
+	if (!strstr(ref.str, "id=[a&b] name=[AB<>] quot=[\"']")
+	        || !strstr(ref.str, "T[text & more \xE2\x98\xBA <tag>]C[raw <data> & ]] stuff]")
+	        || !strstr(ref.str, "tail text]")) {
+		fprintf(stderr, "FAIL: unexpected single call parsing result\n");
+		nb_fail++;
+	}
+
+	for (i=1; i<=max_chunk; i++) {
+		e = parse_doc(doc, i, &tr);
+		if (e) {
+			fprintf(stderr, "FAIL: chunk size %d parsing error %s\n", i, gf_error_to_string(e));
+			nb_fail++;
+		} else if ((tr.size != ref.size) || strcmp(tr.str, ref.str)) {
+			u32 j=0;
+			while (tr.str[j] && (tr.str[j]==ref.str[j])) j++;
+			fprintf(stderr, "FAIL: chunk size %d transcript differs at byte %d: %.40s\n", i, j, tr.str + j);
+			nb_fail++;
+		}
+		gf_free(tr.str);
+	}
+	gf_free(ref.str);
+	gf_free(doc);
+
+	if (nb_fail) {
+		fprintf(stderr, "FAIL: %d errors\n", nb_fail);
+	} else {
+		fprintf(stdout, "%d bytes parsed with chunk sizes 1 to %d - PASS\n", len, max_chunk);
+	}
+	gf_sys_close();
+	return nb_fail ? 1 : 0;
+}
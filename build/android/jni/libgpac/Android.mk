@@ -221,6 +221,7 @@ LOCAL_SRC_FILES := \
 	../../../../src/filters/out_audio.c \
 	../../../../src/filters/out_file.c \
 	../../../../src/filters/out_http.c \
+	../../../../src/filters/out_route.c \
 	../../../../src/filters/out_rtp.c \
 	../../../../src/filters/out_rtsp.c \
 	../../../../src/filters/out_sock.c \
@@ -241,6 +242,7 @@ LOCAL_SRC_FILES := \
 	../../../../src/filters/reframe_rawvid.c \
 	../../../../src/filters/reframer.c \
 	../../../../src/filters/resample_audio.c \
+	../../../../src/filters/rescale_video.c \
 	../../../../src/filters/rewind.c \
 	../../../../src/filters/rewrite_adts.c \
 	../../../../src/filters/rewrite_mp4v.c \
@@ -402,6 +404,7 @@ LOCAL_SRC_FILES := \
 	../../../../src/utils/os_file.c \
 	../../../../src/utils/os_module.c \
 	../../../../src/utils/os_net.c \
+	../../../../src/utils/net_pacer.c \
 	../../../../src/utils/os_thread.c \
 	../../../../src/utils/path2d.c \
 	../../../../src/utils/path2d_stroker.c \
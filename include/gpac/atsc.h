@@ -128,6 +128,14 @@ GF_Err gf_atsc3_set_max_objects_store(GF_ATSCDmx *atscd, u32 max_segs);
  */
 GF_Err gf_atsc3_set_reorder(GF_ATSCDmx *atscd, Bool force_reorder, u32 timeout_ms);
 
+/*! Sets threaded reception mode. In this mode, each ROUTE session socket is read by a dedicated thread fetching several datagrams per call, and the demultiplexing of the received datagrams is done in \ref gf_atsc3_dmx_process. This avoids datagram losses when the demultiplexer thread is busy. The LLS socket is always read from the demultiplexer thread.
+\note This must be called before any service is found, i.e. before the first call to \ref gf_atsc3_dmx_process
+\param atscd the ATSC demultiplexer
+\param threaded if TRUE, sockets are read by reception threads
+\return error code if any
+ */
+GF_Err gf_atsc3_set_threaded(GF_ATSCDmx *atscd, Bool threaded);
+
 /*! Sets the maximum number of objects to store on disk per TSI
 \param atscd the ATSC demultiplexer
 \param service_id ID of the service to tune in. 0 means no service, 0xFFFFFFFF means all services and 0xFFFFFFFE means first service found
@@ -174,6 +182,19 @@ Bool gf_atsc3_dmx_find_service(GF_ATSCDmx *atscd, u32 service_id);
 void gf_atsc3_dmx_purge_objects(GF_ATSCDmx *atscd, u32 service_id);
 
 
+/*! Takes ownership of the data of an object being dispatched, avoiding a copy of the object data by the user. This can only be called from the user callback of \ref GF_ATSC_EVT_INIT_SEG and \ref GF_ATSC_EVT_SEG events, in disk-less mode. The demultiplexer will use a new buffer for the object.
+\param atscd the ATSC demultiplexer
+\param finfo the file info passed to the user callback
+\return the object data (same as finfo->data), or NULL if the data cannot be held. The returned data must be released using \ref gf_atsc3_dmx_release_object_data. If the demultiplexer is destroyed before the data is released, the data shall be freed using gf_free.
+ */
+u8 *gf_atsc3_dmx_hold_object_data(GF_ATSCDmx *atscd, GF_ATSCEventFileInfo *finfo);
+
+/*! Releases object data previously held by the user. The buffer is recycled for reception of new objects. This function can be called from any thread.
+\param atscd the ATSC demultiplexer
+\param data the object data returned by \ref gf_atsc3_dmx_hold_object_data
+ */
+void gf_atsc3_dmx_release_object_data(GF_ATSCDmx *atscd, u8 *data);
+
 /*! Gets high resolution system time clock of the first packet received
 \param atscd the ATSC demultiplexer
 \return system clock in microseconds of first packet received
@@ -141,6 +141,66 @@ GF_Err gf_crypt_encrypt(GF_Crypt *gfc, void *plaintext, u32 size);
 */
 GF_Err gf_crypt_decrypt(GF_Crypt *gfc, void *ciphertext, u32 size);
 
+/*! encrypts a protected range using a crypt/skip pattern, as used by CENC cens and cbcs schemes. The encryption is done inplace.
+The range is split in groups of crypt_block+skip_block 16-byte blocks, the first crypt_block blocks of each group are encrypted and the chaining state continues across encrypted blocks.
+This is equivalent to calling \ref gf_crypt_encrypt for each encrypted block group, but the whole range is processed in a single call to the underlying crypto library when possible.
+\param gfc the target crytpo context
+\param plaintext the clear buffer
+\param size the size of the clear buffer
+\param crypt_block number of encrypted 16-byte blocks in pattern. If 0, the whole range is encrypted
+\param skip_block number of clear 16-byte blocks in pattern. If 0, the whole range is encrypted
+\return error if any
+*/
+GF_Err gf_crypt_encrypt_pattern(GF_Crypt *gfc, void *plaintext, u32 size, u32 crypt_block, u32 skip_block);
+
+/*! decrypts a protected range using a crypt/skip pattern, as used by CENC cens and cbcs schemes. The decryption is done inplace.
+\param gfc the target crytpo context
+\param ciphertext the encrypted buffer
+\param size the size of the encrypted buffer
+\param crypt_block number of encrypted 16-byte blocks in pattern. If 0, the whole range is decrypted
+\param skip_block number of clear 16-byte blocks in pattern. If 0, the whole range is decrypted
+\return error if any
+*/
+GF_Err gf_crypt_decrypt_pattern(GF_Crypt *gfc, void *ciphertext, u32 size, u32 crypt_block, u32 skip_block);
+
+/*! subsample description of a sample*/
+typedef struct
+{
+	/*! number of bytes in the clear at the begining of the subsample*/
+	u32 clear_bytes;
+	/*! number of protected bytes following the clear bytes*/
+	u32 crypted_bytes;
+} GF_CryptSubsample;
+
+/*! encrypts a complete sample in place given its subsample map and pattern.
+In CBC mode, trailing bytes of each protected range not forming a complete 16-byte block are left in the clear.
+\param gfc the target crytpo context
+\param data the sample buffer
+\param size the size of the sample buffer
+\param subsamples the subsample map, or NULL to process the whole sample as a single protected range
+\param nb_subsamples the number of entries in the subsample map
+\param crypt_block number of encrypted 16-byte blocks in pattern, 0 if no pattern
+\param skip_block number of clear 16-byte blocks in pattern, 0 if no pattern
+\param const_IV constant IV to restore at the begining of each subsample, or NULL if the chaining state continues across subsamples
+\param const_IV_size size of the constant IV, 8 or 16 bytes
+\return error if any
+*/
+GF_Err gf_crypt_encrypt_sample(GF_Crypt *gfc, u8 *data, u32 size, const GF_CryptSubsample *subsamples, u32 nb_subsamples, u32 crypt_block, u32 skip_block, const u8 *const_IV, u32 const_IV_size);
+
+/*! decrypts a complete sample in place given its subsample map and pattern.
+\param gfc the target crytpo context
+\param data the sample buffer
+\param size the size of the sample buffer
+\param subsamples the subsample map, or NULL to process the whole sample as a single protected range
+\param nb_subsamples the number of entries in the subsample map
+\param crypt_block number of encrypted 16-byte blocks in pattern, 0 if no pattern
+\param skip_block number of clear 16-byte blocks in pattern, 0 if no pattern
+\param const_IV constant IV to restore at the begining of each subsample, or NULL if the chaining state continues across subsamples
+\param const_IV_size size of the constant IV, 8 or 16 bytes
+\return error if any
+*/
+GF_Err gf_crypt_decrypt_sample(GF_Crypt *gfc, u8 *data, u32 size, const GF_CryptSubsample *subsamples, u32 nb_subsamples, u32 crypt_block, u32 skip_block, const u8 *const_IV, u32 const_IV_size);
+
 
 /*! @} */
 
@@ -372,6 +372,14 @@ GF_Err gf_evg_surface_attach_to_buffer(GF_EVGSurface *surf, u8 *pixels, u32 widt
 */
 GF_Err gf_evg_surface_set_raster_level(GF_EVGSurface *surf, GF_RasterQuality level);
 
+/*! sets the number of worker threads used by the 2D rasterizer. The scanlines of a path are split in horizontal bands of similar complexity, the first band being rasterized by the calling thread and the other ones by the workers. The output is identical to single-threaded rendering.
+\note band-parallel rendering is only used for large paths filled with a solid color on non-subsampled pixel formats and without alpha callback, other fills are rasterized by the calling thread
+\param surf the surface object
+\param nb_threads number of worker threads, 0 disables band-parallel rendering. The value is limited to the number of cores minus one
+\return error if any
+*/
+GF_Err gf_evg_surface_set_threads(GF_EVGSurface *surf, u32 nb_threads);
+
 /*! sets the given matrix as the current transformations for all drawn paths
 \note this is only used for 2D rasterizer, and ignored in 3D mode
 \param surf the surface object
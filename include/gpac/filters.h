@@ -227,6 +227,8 @@ When set, all subfilters are exposed. This should only be set when inspecting fi
 #define GF_FS_FLAG_NO_RESERVOIR (1<<10)
 /*! Throws an error if any PID in the filter graph cannot be linked. The default behaviour is tu run the session even when some PIDs are not connected*/
 #define GF_FS_FLAG_FULL_LINK (1<<11)
+/*! Uses earliest deadline first scheduling of tasks: tasks are executed by increasing deadline, computed from the task schedule time and the latency budget or deadline declared by the filter, see \ref gf_filter_set_latency_budget and \ref gf_filter_set_deadline. Task lists are always mutex-protected in this mode*/
+#define GF_FS_FLAG_DEADLINE_SCHED (1<<12)
 
 /*! Creates a new filter session. This will also load all available filter registers not blacklisted.
 \param nb_threads number of extra threads to allocate. A negative value means all core used by session (eg nb_cores-1 extra threads)
@@ -507,7 +509,7 @@ typedef struct
 	u64 nb_bytes_processed;
 	/*!number of packets sent by this filter*/
 	u64 nb_pck_sent;
-	/*!number of hardware frames packets sent by this filter*/
+	/*!number of hardware frames packets sent by this filter, including frame views*/
 	u64 nb_hw_pck_sent;
 	/*!number of processing errors in the lifetime of the filter*/
 	u32 nb_errors;
@@ -1020,6 +1022,7 @@ enum
 	GF_PROP_PCK_FRAG_RANGE = GF_4CC('P','F','R','R'),
 	GF_PROP_PCK_SIDX_RANGE = GF_4CC('P','F','S','R'),
 	GF_PROP_PCK_MOOF_TEMPLATE = GF_4CC('M','F','T','P'),
+	GF_PROP_PCK_DIRTY_RECTS = GF_4CC('P','D','R','C'),
 	GF_PROP_PID_RAWGRAB = GF_4CC('P','G','R','B'),
 	GF_PROP_PID_KEEP_AFTER_EOS = GF_4CC('P','K','A','E'),
 	GF_PROP_PID_COVER_ART = GF_4CC('P','C','O','V'),
@@ -1736,6 +1739,9 @@ typedef enum
 	GF_FS_REG_DYNAMIC_REDIRECT = 1<<10,
 	/*! Indicates the filter requires graph resolver (typically because it creates new destinations/sinks at run time)*/
 	GF_FS_REG_REQUIRES_RESOLVER = 1<<11,
+	/*! Indicates the filter may fetch or drop input packets from threads other than the one calling its process function (typically audio output callbacks).
+	Input packet queues of such filters are always safe for concurrent access*/
+	GF_FS_REG_ASYNC_PULL = 1<<12,
 
 	/*! flag dynamically set at runtime for registries loaded through shared libraries*/
 	GF_FS_REG_DYNLIB = 0x80000000
@@ -1978,6 +1984,22 @@ struct _gf_ft_mgr *gf_filter_get_font_manager(GF_Filter *filter);
 */
 void gf_filter_ask_rt_reschedule(GF_Filter *filter, u32 us_until_next);
 
+/*! Sets the latency budget of a filter, used by the deadline scheduler (see \ref GF_FS_FLAG_DEADLINE_SCHED) - ignored otherwise.
+The deadline of a task of the filter is the time at which the task is due (now or the time set by \ref gf_filter_ask_rt_reschedule) plus the latency budget.
+Latency-sensitive filters such as paced outputs should use a small budget, bulk processing filters may use a larger budget than the session default.
+\param filter target filter
+\param budget_us latency budget in microseconds, 0 means session default (see -sched-slack option)
+*/
+void gf_filter_set_latency_budget(GF_Filter *filter, u32 budget_us);
+
+/*! Sets the deadline of the next task of the filter, used by the deadline scheduler (see \ref GF_FS_FLAG_DEADLINE_SCHED) - ignored otherwise.
+This is typically used by filters mapping packet timestamps to the system clock. The deadline is reset before each call to the filter process function, and overrides the latency budget of the filter.
+A deadline earlier than the time the task is queued is treated as the queuing time.
+\param filter target filter
+\param deadline_us deadline in microseconds in system clock, see \ref gf_sys_clock_high_res
+*/
+void gf_filter_set_deadline(GF_Filter *filter, u64 deadline_us);
+
 /*! Posts a filter process task to the parent session. This is needed for some filters not having any input packets to process but still needing to work
 such as decoder flushes, servers, etc... The filter session will ignore this call if the filter is already scheduled for processing
 \param filter target filter
@@ -2888,6 +2910,12 @@ typedef struct
 	u64 buffer_time;
 	/*! number of units in input buffer of the filter - only set when querying decoder stats*/
 	u32 nb_buffer_units;
+	/*! max number of units in buffer, 0 if the buffer is limited by duration - only set when querying decoder stats*/
+	u32 max_buffer_units;
+	/*! total time in us the PID was blocked because of full buffer - only set when querying decoder stats*/
+	u64 block_time;
+	/*! number of times the PID was blocked because of full buffer - only set when querying decoder stats*/
+	u32 nb_blocks;
 } GF_FilterPidStatistics;
 
 /*! Direction for stats querying*/
@@ -3066,6 +3094,22 @@ Bool gf_filter_pid_get_first_packet_cts(GF_FilterPid *PID, u64 *cts);
 */
 void gf_filter_pid_drop_packet(GF_FilterPid *PID);
 
+/*! Gets several packets at once from the input PID buffer, starting with the first packet.
+The first packet is fetched as with \ref gf_filter_pid_get_packet. The following packets are only returned if they don't carry property or info changes, end of stream or clock signaling, so that the returned packets can be processed in a row without checking PID state.
+The packets are still present in the PID buffer until explicitly removed by \ref gf_filter_pid_drop_packets
+\param PID the target filter PID
+\param pcks array receiving the packets
+\param max_pcks number of entries in the array
+\return number of packets fetched
+*/
+u32 gf_filter_pid_get_packets(GF_FilterPid *PID, GF_FilterPacket **pcks, u32 max_pcks);
+
+/*! Drops the first packets in the input PID buffer. PID buffer occupancy and unblocking of the source are only evaluated once for the batch.
+\param PID the target filter PID
+\param nb_pcks number of packets to drop
+*/
+void gf_filter_pid_drop_packets(GF_FilterPid *PID, u32 nb_pcks);
+
 /*! Gets the number of packets in input PID buffer.
 \param PID the target filter PID
 \return the number of packets
@@ -3350,6 +3394,13 @@ However, packets don't have to be sent in their allocation order.
 */
 GF_Err gf_filter_pck_send(GF_FilterPacket *pck);
 
+/*! Sends several packets in a row, in the given order. Packets are dispatched as with \ref gf_filter_pck_send, but PID buffer occupancy, blocking state and destination scheduling are only updated once per batch rather than once per packet. This is useful for filters producing many small packets per process call.
+\param pcks the output packets to send
+\param nb_pcks the number of packets to send
+\return error if any
+*/
+GF_Err gf_filter_pck_send_batch(GF_FilterPacket **pcks, u32 nb_pcks);
+
 /*! Destructs a packet allocated but that cannot be sent. Shall not be used on packet references.
 \param pck the target output packet to send
 */
@@ -3784,6 +3835,20 @@ The packet has by default no DTS, no CTS, no duration framing set to full frame
 */
 GF_FilterPacket *gf_filter_pck_new_frame_interface(GF_FilterPid *PID, GF_FilterFrameInterface *frame_ifce, gf_fsess_packet_destructor destruct);
 
+/*! Allocates a new packet exposing a view of the planes of a source video frame, without copying the frame data.
+This is typically used by filters selecting part of a frame (cropping) or forwarding planes with a different layout. The view planes shall point to memory of the source packet (data or frame interface planes) and remain valid as long as the source packet is valid.
+The source packet is referenced until the view packet is destroyed, and its properties are copied to the view packet. Views of blocking frames are flagged as blocking (see \ref GF_FRAME_IFCE_BLOCKING).
+Consumers access the view planes through \ref gf_filter_pck_get_frame_interface. The producer shall set the stride properties of the PID to the view strides.
+View objects are recycled by the filter owning the PID.
+\param PID the target output PID
+\param source the source packet holding the frame memory
+\param nb_planes the number of planes in the view, at most 4
+\param planes the address of the first pixel of each plane of the view
+\param strides the stride in bytes of each plane of the view
+\return new packet or NULL if error
+*/
+GF_FilterPacket *gf_filter_pck_new_frame_view(GF_FilterPid *PID, GF_FilterPacket *source, u32 nb_planes, u8 **planes, u32 *strides);
+
 /*! Gets a frame interface associated with a packet if any.
 
 Consummers will typically first check if the packet has associated data using \ref gf_filter_pck_get_data.
@@ -617,6 +617,19 @@ GF_Err gf_rtsp_get_remote_address(GF_RTSPSession *sess, char *buffer);
 */
 GF_Err gf_rtsp_session_write_interleaved(GF_RTSPSession *sess, u32 idx, u8 *pck, u32 pck_size);
 
+/*! sets the interleaved write queue of an RTSP session. When set, \ref gf_rtsp_session_write_interleaved never waits for the connection: data not accepted by the connection is queued, and packets not fitting in the queue are dropped
+\param sess the target RTSP session
+\param max_size maximum size of queued data in bytes, 0 means packets are written synchronously (default)
+\return error if any
+*/
+GF_Err gf_rtsp_session_set_interleave_queue(GF_RTSPSession *sess, u32 max_size);
+
+/*! writes data pending in the interleaved write queue of an RTSP session, without waiting for the connection
+\param sess the target RTSP session
+\return GF_OK if the queue is empty, GF_IP_SOCK_WOULD_BLOCK if data is still pending, or error if any
+*/
+GF_Err gf_rtsp_session_flush_interleave_queue(GF_RTSPSession *sess);
+
 /*
 		RTP LIB EXPORTS
 */
@@ -781,6 +794,13 @@ void gf_rtp_reset_ssrc(GF_RTPChannel *ch);
 */
 u32 gf_rtp_read_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size);
 
+/*! enables batched reception of RTP packets on UDP. Pending datagrams are fetched from the socket in a single call, and returned one by one by \ref gf_rtp_read_rtp. Since fetched packets are no longer pending on the socket, the caller must call \ref gf_rtp_read_rtp until it returns 0 once the socket is signaled as readable
+\param ch the target RTP channel
+\param nb_packets the maximum number of packets fetched at once. 0 or 1 disables batched reception
+\return error if any
+*/
+GF_Err gf_rtp_enable_read_batch(GF_RTPChannel *ch, u32 nb_packets);
+
 /*! flushes any pending data in packet reorderer, but does not flush packet reorderer if reorderer timeout is not exceeded
 \param ch the target RTP channel
 \param buffer the buffer where to store the data
@@ -851,6 +871,26 @@ GF_Err gf_rtp_send_bye(GF_RTPChannel *ch);
 */
 GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, u8 *pck, u32 pck_size, Bool fast_send);
 
+/*! enables batched emission of RTP packets on UDP. Packets passed to \ref gf_rtp_send_packet are queued and sent in a single call once the queue is full or \ref gf_rtp_flush_send is called. Queued packets are also flushed before sending RTCP reports
+\param ch the target RTP channel
+\param nb_packets the maximum number of packets queued. 0 or 1 disables batched emission
+\return error if any
+*/
+GF_Err gf_rtp_enable_send_batch(GF_RTPChannel *ch, u32 nb_packets);
+
+/*! sends all packets queued in batched emission mode
+\param ch the target RTP channel
+\return error if any
+*/
+GF_Err gf_rtp_flush_send(GF_RTPChannel *ch);
+
+/*! sets the socket pacer used for emission of RTP packets on UDP. Packets passed to \ref gf_rtp_send_packet are queued in the pacer and sent at the pacer rate, \ref gf_rtp_send_packet returns GF_BUFFER_TOO_SMALL if the pacer queue is full. The pacer must be destroyed or flushed before the channel
+\param ch the target RTP channel
+\param pacer the socket pacer to use, or NULL to send packets directly
+\return error if any
+*/
+GF_Err gf_rtp_set_pacer(GF_RTPChannel *ch, GF_SockPacer *pacer);
+
 
 /*! callback used for writing rtp over TCP
 \param cbk1 opaque user data
@@ -328,6 +328,24 @@ struct __tag_compositor
 	u8 *framebuffer;
 	u32 framebuffer_size, framebuffer_alloc;
 
+	//output frame pool size, pool tile size and dirty rectangles signaling options
+	u32 fbpool, fbtile;
+	Bool drect;
+	//output frame pool, only used for raw 2D output when fbpool is greater than 1
+	struct _sc_frame_slot *fb_slots;
+	u32 nb_fb_slots;
+	//protects slot references and buffers, packets may be released by another thread
+	GF_Mutex *fb_mx;
+	//slot being drawn (-1 if none) and slot of the last emitted frame (-1 if none)
+	s32 fb_slot_cur, fb_slot_last;
+	//generation of each tile of the output frame, ie the number of the emitted frame in which the tile was last modified
+	u32 *fb_tile_gen;
+	u32 fb_width, fb_height, fb_tiles_w, fb_tiles_h, fb_tile_w, fb_tile_h, fb_bpp, fb_stride, fb_gen;
+	//areas modified since the last emitted frame, in output pixel coordinates
+	GF_IRect *fb_dirty;
+	u32 fb_nb_dirty, fb_dirty_alloc;
+	Bool fb_dirty_all;
+
 	//passthrough texture object - only assigned by background2D
 	struct _gf_sc_texture_handler *passthrough_txh;
 	//passthrough packet - this is only created if the associated input packet doesn't use frame interface
@@ -371,7 +389,7 @@ struct __tag_compositor
 	s32 fonts_pending;
 
 	/*options*/
-	u32 aspect_ratio, aa, textxt;
+	u32 aspect_ratio, aa, textxt, rthreads;
 	Bool fast, stress;
 	Bool is_opengl;
 	Bool autoconfig_opengl;
@@ -730,6 +748,9 @@ typedef struct
 	GF_SceneGraph *sg;
 } GF_QueuedEvent;
 
+/*signals an area of the output frame modified by the root visual, in output pixel coordinates (top-left origin). A NULL rectangle marks the whole frame*/
+void gf_sc_add_dirty_rect(GF_Compositor *compositor, GF_IRect *rc);
+
 void gf_sc_queue_dom_event(GF_Compositor *compositor, GF_Node *node, GF_DOM_Event *evt);
 void gf_sc_queue_dom_event_on_target(GF_Compositor *compositor, GF_DOM_Event *evt, GF_DOMEventTarget *target, GF_SceneGraph *sg);
 
@@ -50,6 +50,8 @@ struct _gf_crypt_context
 	GF_Err(*_decrypt) (GF_Crypt*, u8 *buffer, u32 size);
 	GF_Err(*_set_state) (GF_Crypt*, const u8 *IV, u32 IV_size);
 	GF_Err(*_get_state) (GF_Crypt*, u8 *IV, u32 *IV_size);
+	//optional, processes a crypt/skip pattern range in one call
+	GF_Err(*_crypt_pattern) (GF_Crypt*, u8 *buffer, u32 size, u32 crypt_block, u32 skip_block, Bool is_encrypt);
 };
 
 #ifdef GPAC_HAS_SSL
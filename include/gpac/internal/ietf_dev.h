@@ -88,6 +88,9 @@ void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size, Bool force_flush);
 each channel is identified by a control string given in RTSP Describe
 this control string is used with Darwin
 */
+/*max number of RTP packets per batched send or receive call*/
+#define GF_RTP_MAX_BATCH	32
+
 struct __tag_rtp_channel
 {
 	/*global transport info for the session*/
@@ -165,6 +168,17 @@ struct __tag_rtp_channel
 	GF_BitStream *bs_r, *bs_w;
 	Bool no_select;
 
+	/*batched UDP reception: datagrams fetched in one call and served one by one by gf_rtp_read_rtp*/
+	u8 *rcv_batch_buf;
+	u32 rcv_batch_max, rcv_batch_slot, rcv_batch_count, rcv_batch_pos;
+	u32 rcv_batch_sizes[GF_RTP_MAX_BATCH];
+	/*batched UDP emission: packets queued until gf_rtp_flush_send or batch is full*/
+	u8 *snd_batch_buf;
+	u32 snd_batch_max, snd_batch_count;
+	u32 snd_batch_sizes[GF_RTP_MAX_BATCH];
+	/*paced UDP emission: packets are handed to the pacer thread instead of being sent*/
+	GF_SockPacer *sk_pacer;
+
 	gf_rtp_tcp_callback send_interleave;
 	void *interleave_cbk1, *interleave_cbk2;
 };
@@ -299,6 +313,11 @@ struct _tag_rtsp_session
 	/*all RTP channels in an interleaved RTP on RTSP session*/
 	GF_List *TCPChannels;
 	Bool interleaved;
+
+	/*queue of interleaved data not yet written, only used when a queue size is set*/
+	u8 *il_queue;
+	u32 il_queue_size, il_queue_alloc, il_queue_max;
+	u32 il_nb_dropped;
 };
 
 GF_RTSPSession *gf_rtsp_session_new(char *sURL, u16 DefaultPort);
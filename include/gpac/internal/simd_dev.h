@@ -0,0 +1,49 @@
+/*
+*			GPAC - Multimedia Framework C SDK
+*
+*			Authors: GPAC contributors
+*			Copyright (c) GPAC contributors 2026
+*					All rights reserved
+*
+*  This file is part of GPAC / common tools sub-project
+*
+*  GPAC is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU Lesser General Public License as published by
+*  the Free Software Foundation; either version 2, or (at your option)
+*  any later version.
+*
+*  GPAC is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Lesser General Public License for more details.
+*
+*  You should have received a copy of the GNU Lesser General Public
+*  License along with this library; see the file COPYING.  If not, write to
+*  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*/
+
+#ifndef _GF_SIMD_DEV_H_
+#define _GF_SIMD_DEV_H_
+
+#include <gpac/setup.h>
+
+/*private - do not use
+
+Defines GPAC_HAS_SSE2 and includes the SSE2 intrinsics when they can be used. Code using SSE2 intrinsics shall include
+this header rather than checking the compiler flags itself*/
+
+//intrinsic code segfaults on 32 bit, need to check why
+#if defined(GPAC_64_BITS)
+# if defined(WIN32) && !defined(__GNUC__)
+#  include <intrin.h>
+#  define GPAC_HAS_SSE2
+# else
+#  ifdef __SSE2__
+#   include <emmintrin.h>
+#   define GPAC_HAS_SSE2
+#  endif
+# endif
+#endif
+
+#endif	/*_GF_SIMD_DEV_H_*/
@@ -145,6 +145,8 @@ typedef struct
 	u32 duration; /*MANDATORY*/
 	/*! may be 0xFFFFFFFF (-1) (\warning this needs further testing)*/
 	u32 repeat_count;
+	/*! number of additional timelines using this entry, set when an MPD update shares unchanged entries with the previous MPD - GPAC internal*/
+	u32 nb_refs;
 } GF_MPD_SegmentTimelineEntry;
 
 /*! Segment Timeline*/
@@ -737,6 +739,15 @@ typedef struct
 	char *more_info_url;
 } GF_MPD_ProgramInfo;
 
+/*! MPD patch location*/
+typedef struct
+{
+	/*! URL of the MPD patch*/
+	char *url;
+	/*! time to live of the patch location in milliseconds after the MPD publish time, 0 if not set*/
+	u64 ttl;
+} GF_MPD_PatchLocation;
+
 /*! MPD*/
 typedef struct {
 	/*! inherits from extensible*/
@@ -775,6 +786,8 @@ typedef struct {
 	GF_List *base_URLs;
 	/*! list of strings */
 	GF_List *locations;
+	/*! list of GF_MPD_PatchLocation */
+	GF_List *patch_locations;
 	/*! list of Metrics */
 	GF_List *metrics;
 	/*! list of GF_MPD_Period */
@@ -783,6 +796,11 @@ typedef struct {
 	/*! set during parsing, to set during authoring, won't be freed by GPAC*/
 	const char *xml_namespace;
 
+	/*! set during parsing when the MPD has a PatchLocation, the DOM being kept to apply patches: extensions are copied instead of moved out of the DOM*/
+	Bool keep_dom;
+	/*! set during SAX parsing, list of SegmentTimeline already parsed for the SegmentTimeline nodes of the DOM - GPAC internal*/
+	GF_List *sax_timelines;
+
 	/*! UTC timing desc if any/*/
 	GF_List *utc_timings;
 
@@ -812,6 +830,14 @@ typedef struct {
 \return error if any
 */
 GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url);
+/*! parses an MPD file using SAX. SegmentTimeline entries are parsed from the SAX events without building their DOM nodes. If the previous version of the MPD is given, the entries identical to the ones of the same timeline in the previous MPD are shared with it instead of being allocated, only the changed tail of each timeline being created
+\param file the MPD file to parse
+\param mpd MPD structure to fill
+\param base_url base URL of the MPD
+\param prev_mpd previous version of the MPD, may be NULL. The previous MPD shall not be modified while it shares entries with the new one, but can be destroyed before or after the new one
+\return error if any
+*/
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *base_url, GF_MPD *prev_mpd);
 /*! parses an MPD Period element (and subtree) from DOM
 \param root root of DOM parsing result
 \param mpd MPD structure to fill
@@ -819,6 +845,13 @@ GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url)
 \return error if any
 */
 GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url);
+/*! applies an MPD Patch document to the DOM of an MPD
+The patch operations (add, replace and remove) use a restricted XPath syntax for their selectors: absolute path of element names with optional predicates of the form [@attribute='value'] or [position], optionally ending with /@attribute.
+\param root root of the MPD DOM to patch
+\param patch root of the MPD Patch DOM. Nodes added by the patch are moved from the patch to the MPD
+\return GF_NOT_FOUND if the patch does not apply to this MPD (MPD id or publish time mismatch), GF_EOS if the patch does not change the MPD publish time, error if any. The MPD DOM may be partially modified upon error
+*/
+GF_Err gf_mpd_apply_patch(GF_XMLNode *root, GF_XMLNode *patch);
 /*! MPD constructor
 \return a new MPD*/
 GF_MPD *gf_mpd_new();
@@ -833,6 +866,10 @@ void gf_mpd_segment_url_free(void *ptr);
 \param ptr the target GF_MPD_SegmentBase
 */
 void gf_mpd_segment_base_free(void *ptr);
+/*! frees a GF_MPD_SegmentTimelineEntry structure (type-casted to void *), or releases it if it is shared with another timeline
+\param ptr the target GF_MPD_SegmentTimelineEntry
+*/
+void gf_mpd_segment_entry_free(void *ptr);
 /*! parses a new GF_MPD_SegmentURL from its DOM description
 \param container the container list where to insert the segment URL
 \param root the DOM description of the segment URL
@@ -47,6 +47,8 @@ This section documents the IP network functions of the GPAC framework.
 \ingroup net_grp
 \defgroup sockgrp_grp Socket Group
 \ingroup net_grp
+\defgroup sockpace_grp Socket Pacer
+\ingroup net_grp
 \defgroup nett_grp Network Time and helpers
 \ingroup net_grp
 \defgroup url_grp URL tools
@@ -423,6 +425,17 @@ Sends a buffer on the socket. The socket must be in a bound or connected mode
  */
 GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length);
 /*!
+\brief data emission with partial write report
+
+Sends a buffer on the socket. The socket must be in a bound or connected mode. For non-blocking sockets, part of the data may be sent before \ref GF_IP_SOCK_WOULD_BLOCK is returned
+\param sock the socket object
+\param buffer the data buffer to send
+\param length the data length to send
+\param written set to the number of bytes sent, may be NULL
+\return error if any
+ */
+GF_Err gf_sk_send_ex(GF_Socket *sock, const u8 *buffer, u32 length, u32 *written);
+/*!
 \brief data reception
 
 Fetches data on a socket. The socket must be in a bound or connected state
@@ -587,6 +600,37 @@ Fetches data on a socket without performing any select (wait), to be used with s
  */
 GF_Err gf_sk_receive_no_select(GF_Socket *sock, u8 *buffer, u32 length, u32 *read);
 
+/*!
+Sends several datagrams on the socket, using a single system call when supported (sendmmsg on Linux). For TCP sockets or on other platforms, buffers are sent one after the other.
+\param sock the socket object
+\param buffers the data buffers to send, each buffer being sent as a single datagram
+\param sizes the size of each data buffer
+\param nb_buffers the number of data buffers
+\param nb_sent set to the number of datagrams sent - may be NULL
+\return error if any
+ */
+GF_Err gf_sk_send_batch(GF_Socket *sock, const u8 **buffers, const u32 *sizes, u32 nb_buffers, u32 *nb_sent);
+
+/*!
+Fetches several pending datagrams on a socket without performing any select (wait), using a single system call when supported (recvmmsg on Linux). On other platforms, only non-blocking sockets will be drained of more than one datagram.
+\param sock the socket object
+\param buffers the reception buffers, each of them receiving one datagram
+\param buffer_size the allocated size of each reception buffer
+\param sizes set to the size of each received datagram
+\param nb_buffers the number of reception buffers
+\param nb_read set to the number of datagrams received
+\return error if any, GF_IP_NETWORK_EMPTY if nothing to read
+ */
+GF_Err gf_sk_receive_batch(GF_Socket *sock, u8 **buffers, u32 buffer_size, u32 *sizes, u32 nb_buffers, u32 *nb_read);
+
+/*!
+Enables UDP segmentation offload for \ref gf_sk_send_batch: consecutive datagrams of the same size are passed to the kernel as a single buffer and split by the network stack. If the system does not support it, the socket falls back to regular batched sends on first use.
+\param sock the socket object
+\param enable if GF_TRUE, enables segmentation offload
+\return error if any, GF_NOT_SUPPORTED if not available on this platform or socket type
+ */
+GF_Err gf_sk_enable_gso(GF_Socket *sock, Bool enable);
+
 /*!
 Checks if connection has been closed by remote peer
 \param sock the socket object
@@ -656,6 +700,78 @@ Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk, GF_SockSelectMode
 
 /*! @} */
 
+/*!
+\addtogroup sockpace_grp
+\brief Paced datagram sending
+
+The socket pacer sends datagrams from a dedicated high priority thread at given times, independently of the caller scheduling. Datagrams are either scheduled at an explicit time, or at a constant rate using a token bucket with a single datagram depth.
+
+The pacer thread sleeps until the next send time, and busy-waits for the last microseconds if requested, which is needed for sub-100 microseconds precision on most systems.
+@{
+*/
+
+/*! socket pacer object*/
+typedef struct __tag_sock_pacer GF_SockPacer;
+
+/*!
+Creates a new socket pacer and starts its thread
+\param rate the send rate in bits per second used for datagrams with no explicit send time, 0 means no pacing
+\param spin_us busy-wait this many microseconds before the send time instead of sleeping
+\return socket pacer object, NULL if error
+ */
+GF_SockPacer *gf_sk_pacer_new(u32 rate, u32 spin_us);
+/*!
+Deletes a socket pacer. All queued datagrams are sent before this function returns, sockets used by the pacer must still be valid when calling this function
+\param pacer socket pacer object
+ */
+void gf_sk_pacer_del(GF_SockPacer *pacer);
+/*!
+Sets the send rate for datagrams with no explicit send time
+\param pacer socket pacer object
+\param rate the send rate in bits per second, 0 means no pacing
+ */
+void gf_sk_pacer_set_rate(GF_SockPacer *pacer, u32 rate);
+/*!
+Queues a datagram for sending. The data is copied and the function returns immediately
+\param pacer socket pacer object
+\param sock the socket to send the datagram on
+\param data the datagram data
+\param size the datagram size
+\param send_time the time at which the datagram shall be sent, in microseconds in the \ref gf_sys_clock_high_res time base. If 0, the datagram is scheduled at the pacer rate after the previously queued one
+\return error if any, GF_BUFFER_TOO_SMALL if the pacer queue is full
+ */
+GF_Err gf_sk_pacer_send(GF_SockPacer *pacer, GF_Socket *sock, const u8 *data, u32 size, u64 send_time);
+
+/*!
+Gets the number of datagrams that can still be queued in a pacer
+\param pacer socket pacer object
+\return number of free slots in the pacer queue
+*/
+u32 gf_sk_pacer_get_free(GF_SockPacer *pacer);
+
+/*!
+Waits until all datagrams queued for a socket are sent. The pacer thread keeps running
+\param pacer socket pacer object
+\param sock socket to flush, or NULL to flush all queued datagrams
+*/
+void gf_sk_pacer_flush(GF_SockPacer *pacer, GF_Socket *sock);
+/*!
+Gets the time until all queued datagrams are sent
+\param pacer socket pacer object
+\return duration in microseconds until the last queued datagram is due, 0 if the queue is empty or late
+ */
+u64 gf_sk_pacer_get_delay(GF_SockPacer *pacer);
+/*!
+Gets the send statistics of a pacer
+\param pacer socket pacer object
+\param nb_sent set to the number of datagrams sent - may be NULL
+\param late_avg set to the average lateness of datagrams in microseconds, compared to their send time - may be NULL
+\param late_max set to the maximum lateness of datagrams in microseconds - may be NULL
+ */
+void gf_sk_pacer_get_stats(GF_SockPacer *pacer, u64 *nb_sent, u32 *late_avg, u32 *late_max);
+
+/*! @} */
+
 
 #ifdef __cplusplus
 }
@@ -241,6 +241,34 @@ u16 gf_rtp_streamer_get_next_rtp_sn(GF_RTPStreamer *streamer);
 */
 GF_Err gf_rtp_streamer_set_interleave_callbacks(GF_RTPStreamer *streamer, GF_Err (*RTP_TCPCallback)(void *cbk1, void *cbk2, Bool is_rtcp, u8 *pck, u32 pck_size), void *cbk1, void *cbk2);
 
+/*! sets callback function for built RTP packets. When set, packets are no longer sent on the RTP channel of the streamer but passed to the callback, which allows packetizing a stream once for several destinations
+\param streamer the target RTP streamer
+\param on_packet the callback function, called with the RTP header and payload of each packet built. The SSRC of the header is not set. If NULL, packets are sent on the RTP channel
+\param udta opaque data passed to callback function
+\return error if any
+*/
+GF_Err gf_rtp_streamer_set_packet_callback(GF_RTPStreamer *streamer, void (*on_packet)(void *udta, GF_RTPHeader *header, u8 *payload, u32 payload_size), void *udta);
+
+/*! enables batched emission of RTP packets on UDP, see \ref gf_rtp_enable_send_batch. The setting is kept for channels created later on (RTSP setup)
+\param streamer the target RTP streamer
+\param nb_packets the maximum number of packets queued before sending. 0 or 1 disables batched emission
+\return error if any
+*/
+GF_Err gf_rtp_streamer_enable_send_batch(GF_RTPStreamer *streamer, u32 nb_packets);
+
+/*! sets the socket pacer used for RTP emission on UDP, see \ref gf_rtp_set_pacer. The setting is kept for channels created later on (RTSP setup)
+\param streamer the target RTP streamer
+\param pacer the socket pacer to use, or NULL to send packets directly
+\return error if any
+*/
+GF_Err gf_rtp_streamer_set_pacer(GF_RTPStreamer *streamer, GF_SockPacer *pacer);
+
+/*! sends all RTP packets queued in batched emission mode
+\param streamer the target RTP streamer
+\return error if any
+*/
+GF_Err gf_rtp_streamer_flush(GF_RTPStreamer *streamer);
+
 /*! @} */
 
 #ifdef __cplusplus
@@ -309,6 +309,12 @@ char *gf_xml_dom_serialize(GF_XMLNode *node, Bool content_only);
  */
 GF_XMLNode *gf_xml_dom_get_root(GF_DOMParser *parser);
 
+/*! Detaches the root element of the document from the parser. The root element is no longer destroyed with the parser and must be destroyed using \ref gf_xml_dom_node_del
+\param parser the DOM structure
+\return The root node if exists, otherwise NULL;
+ */
+GF_XMLNode *gf_xml_dom_detach_root(GF_DOMParser *parser);
+
 /*!
 Creates an attribute with the given name and value.
 \param name the attribute name
@@ -342,6 +348,13 @@ GF_Err gf_xml_dom_rem_child(GF_XMLNode *node, GF_XMLNode *child);
  */
 void gf_xml_dom_node_del(GF_XMLNode *node);
 
+/*! Clones a node, its attributes and its children
+
+\param node the node to clone
+\return the cloned node or NULL if error
+ */
+GF_XMLNode *gf_xml_dom_node_clone(GF_XMLNode *node);
+
 
 /*! Gets the element and check that the namespace is known ('xmlns'-only supported for now)
 \param n the node to process
@@ -322,6 +322,10 @@ static void gf_sc_flush_video(GF_Compositor *compositor, Bool locked)
 }
 
 void gf_sc_render_frame(GF_Compositor *compositor);
+static Bool gf_sc_fb_pool_active(GF_Compositor *compositor);
+static Bool gf_sc_fb_pool_full(GF_Compositor *compositor);
+static u8 *gf_sc_fb_pool_acquire(GF_Compositor *compositor);
+static void gf_sc_fb_pool_reset(GF_Compositor *compositor, u32 pfmt, u32 width, u32 height, u32 stride);
 
 GF_EXPORT
 Bool gf_sc_draw_frame(GF_Compositor *compositor, Bool no_flush, s32 *ms_till_next)
@@ -333,6 +337,9 @@ Bool gf_sc_draw_frame(GF_Compositor *compositor, Bool no_flush, s32 *ms_till_nex
 	//frame still pending
 	if (compositor->frame_ifce.user_data)
 		return GF_TRUE;
+	//all frames of the output pool still pending
+	if (gf_sc_fb_pool_full(compositor))
+		return GF_TRUE;
 
 	if (compositor->flush_pending) {
 		gf_sc_flush_video(compositor, GF_FALSE);
@@ -483,6 +490,9 @@ static GF_Err rawvout_lock(struct _video_out *vout, GF_VideoSurface *vi, Bool do
 
 			vi->video_buffer = compositor->passthrough_data;
 			vi->pitch_y = compositor->passthrough_txh->stride;
+		} else if (gf_sc_fb_pool_active(compositor)) {
+			vi->video_buffer = gf_sc_fb_pool_acquire(compositor);
+			if (!vi->video_buffer) return GF_OUT_OF_MEM;
 		} else {
 			vi->video_buffer = compositor->framebuffer;
 		}
@@ -522,6 +532,9 @@ static GF_Err rawvout_evt(struct _video_out *vout, GF_Event *evt)
 	if (!compositor->framebuffer) return GF_OUT_OF_MEM;
 	memset(compositor->framebuffer, 0, sizeof(char)*compositor->framebuffer_size);
 
+	if (compositor->fbpool>1)
+		gf_sc_fb_pool_reset(compositor, pfmt, evt->setup.width, evt->setup.height, stride);
+
 #ifndef GPAC_DISABLE_3D
 	if (compositor->needs_offscreen_gl && (compositor->ogl != GF_SC_GLMODE_OFF))
 		return compositor_3d_setup_fbo(evt->setup.width, evt->setup.height, &compositor->fbo_id, &compositor->fbo_tx_id, &compositor->fbo_depth_id);
@@ -542,6 +555,362 @@ GF_VideoOutput raw_vout = {
 	.hw_caps = GF_VIDEO_HW_HAS_RGB | GF_VIDEO_HW_HAS_RGBA
 };
 
+/*output frame pool of the raw video output
+
+Each frame sent is a shared packet on a pool buffer. While downstream filters hold the last frames, the next frame
+is drawn in a free buffer brought up to date by copying the tiles modified since that buffer was last sent; tiles
+redrawn by the current frame are not copied. Single-plane formats are split in tiles of fbtile pixels, other formats
+use a single tile covering the frame*/
+typedef struct _sc_frame_slot
+{
+	u8 *buffer;
+	u32 size;
+	//generation of the last frame drawn in this buffer
+	u32 gen;
+	//number of output packets using this buffer
+	u32 nb_refs;
+	//set when the buffer no longer matches the output configuration, buffer is freed once released
+	Bool discard;
+} GF_SCFrameSlot;
+
+//above this number of dirty rectangles, the whole frame is signaled as modified
+#define GF_SC_MAX_DIRTY_RECTS	256
+
+static void gf_sc_fb_pool_reset(GF_Compositor *compositor, u32 pfmt, u32 width, u32 height, u32 stride)
+{
+	u32 i, nb_planes=1;
+
+	if (!compositor->fb_slots) {
+		compositor->fb_slots = gf_malloc(sizeof(GF_SCFrameSlot) * compositor->fbpool);
+		if (!compositor->fb_slots) return;
+		memset(compositor->fb_slots, 0, sizeof(GF_SCFrameSlot) * compositor->fbpool);
+		compositor->nb_fb_slots = compositor->fbpool;
+		compositor->fb_mx = gf_mx_new("CompositorFramePool");
+	}
+	gf_mx_p(compositor->fb_mx);
+	for (i=0; i<compositor->nb_fb_slots; i++) {
+		GF_SCFrameSlot *slot = &compositor->fb_slots[i];
+		slot->gen = 0;
+		if (slot->nb_refs) {
+			slot->discard = GF_TRUE;
+		} else if (slot->buffer) {
+			gf_free(slot->buffer);
+			slot->buffer = NULL;
+			slot->size = 0;
+		}
+	}
+	gf_mx_v(compositor->fb_mx);
+	compositor->fb_slot_cur = compositor->fb_slot_last = -1;
+
+	gf_pixel_get_size_info(pfmt, width, height, NULL, NULL, NULL, &nb_planes, NULL);
+	compositor->fb_width = width;
+	compositor->fb_height = height;
+	compositor->fb_stride = stride;
+	compositor->fb_bpp = gf_pixel_get_bytes_per_pixel(pfmt);
+	if ((nb_planes==1) && compositor->fb_bpp && compositor->fbtile) {
+		compositor->fb_tile_w = compositor->fb_tile_h = compositor->fbtile;
+	} else {
+		compositor->fb_tile_w = width;
+		compositor->fb_tile_h = height;
+	}
+	if (!compositor->fb_tile_w || !compositor->fb_tile_h) {
+		compositor->fb_tiles_w = compositor->fb_tiles_h = 0;
+	} else {
+		compositor->fb_tiles_w = (width + compositor->fb_tile_w - 1) / compositor->fb_tile_w;
+		compositor->fb_tiles_h = (height + compositor->fb_tile_h - 1) / compositor->fb_tile_h;
+	}
+	compositor->fb_tile_gen = gf_realloc(compositor->fb_tile_gen, sizeof(u32) * (compositor->fb_tiles_w * compositor->fb_tiles_h + 1));
+	if (compositor->fb_tile_gen)
+		memset(compositor->fb_tile_gen, 0, sizeof(u32) * (compositor->fb_tiles_w * compositor->fb_tiles_h + 1));
+	compositor->fb_dirty_all = GF_TRUE;
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_COMPOSE, ("[Compositor] Output frame pool of %d frames, %dx%d tiles\n", compositor->nb_fb_slots, compositor->fb_tiles_w, compositor->fb_tiles_h));
+}
+
+static Bool gf_sc_fb_pool_active(GF_Compositor *compositor)
+{
+	if (!compositor->fb_slots || !compositor->fb_tile_gen) return GF_FALSE;
+	if ((compositor->video_out != &raw_vout) || compositor->passthrough_txh) return GF_FALSE;
+#ifndef GPAC_DISABLE_3D
+	if (compositor->visual->type_3d || compositor->hybrid_opengl) return GF_FALSE;
+#endif
+	return GF_TRUE;
+}
+
+//check if the pool has no buffer available for drawing
+static Bool gf_sc_fb_pool_full(GF_Compositor *compositor)
+{
+	u32 i;
+	if (!gf_sc_fb_pool_active(compositor)) return GF_FALSE;
+	if (compositor->fb_slot_cur>=0) return GF_FALSE;
+	gf_mx_p(compositor->fb_mx);
+	for (i=0; i<compositor->nb_fb_slots; i++) {
+		if (!compositor->fb_slots[i].nb_refs) {
+			gf_mx_v(compositor->fb_mx);
+			return GF_FALSE;
+		}
+	}
+	gf_mx_v(compositor->fb_mx);
+	return GF_TRUE;
+}
+
+static Bool gf_sc_fb_tile_redrawn(GF_Compositor *compositor, u32 x, u32 y, u32 w, u32 h)
+{
+	u32 i;
+	if (compositor->fb_dirty_all) return GF_TRUE;
+	for (i=0; i<compositor->fb_nb_dirty; i++) {
+		GF_IRect *rc = &compositor->fb_dirty[i];
+		if (((s32) x >= rc->x) && ((s32) y >= rc->y) && ((s32) (x+w) <= rc->x + rc->width) && ((s32) (y+h) <= rc->y + rc->height))
+			return GF_TRUE;
+	}
+	return GF_FALSE;
+}
+
+//copy tiles modified since dst was last drawn from src, skipping tiles about to be redrawn
+static void gf_sc_fb_pool_sync(GF_Compositor *compositor, GF_SCFrameSlot *dst, GF_SCFrameSlot *src)
+{
+	u32 tx, ty, nb_copied=0;
+
+	if (compositor->fb_tiles_w * compositor->fb_tiles_h == 1) {
+		if ((compositor->fb_tile_gen[0] > dst->gen) && !compositor->fb_dirty_all)
+			memcpy(dst->buffer, src->buffer, MIN(dst->size, src->size));
+		dst->gen = src->gen;
+		return;
+	}
+	for (ty=0; ty<compositor->fb_tiles_h; ty++) {
+		u32 y = ty * compositor->fb_tile_h;
+		u32 h = MIN(compositor->fb_tile_h, compositor->fb_height - y);
+		u32 *gens = &compositor->fb_tile_gen[ty * compositor->fb_tiles_w];
+		tx = 0;
+		while (tx<compositor->fb_tiles_w) {
+			u32 start, x, w, j;
+			if ((gens[tx] <= dst->gen) || gf_sc_fb_tile_redrawn(compositor, tx * compositor->fb_tile_w, y, MIN(compositor->fb_tile_w, compositor->fb_width - tx * compositor->fb_tile_w), h)) {
+				tx++;
+				continue;
+			}
+			//merge consecutive tiles of the row in a single copy
+			start = tx;
+			while ((tx<compositor->fb_tiles_w) && (gens[tx] > dst->gen)
+				&& !gf_sc_fb_tile_redrawn(compositor, tx * compositor->fb_tile_w, y, MIN(compositor->fb_tile_w, compositor->fb_width - tx * compositor->fb_tile_w), h)
+			) {
+				tx++;
+			}
+			nb_copied += tx - start;
+			x = start * compositor->fb_tile_w;
+			w = MIN(tx * compositor->fb_tile_w, compositor->fb_width) - x;
+			for (j=y; j<y+h; j++) {
+				u32 offset = j * compositor->fb_stride + x * compositor->fb_bpp;
+				memcpy(dst->buffer + offset, src->buffer + offset, w * compositor->fb_bpp);
+			}
+		}
+	}
+	dst->gen = src->gen;
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_COMPOSE, ("[Compositor] Output frame pool synchronized %d / %d tiles\n", nb_copied, compositor->fb_tiles_w * compositor->fb_tiles_h));
+}
+
+static u8 *gf_sc_fb_pool_acquire(GF_Compositor *compositor)
+{
+	u32 i;
+	s32 idx, last;
+	GF_SCFrameSlot *slot;
+
+	if (compositor->fb_slot_cur>=0)
+		return compositor->fb_slots[compositor->fb_slot_cur].buffer;
+
+	//reuse the last sent frame if released, otherwise the most recent released frame
+	//the lock is kept until the slot is synchronized, so that the source slot buffer cannot be discarded meanwhile
+	gf_mx_p(compositor->fb_mx);
+	idx = -1;
+	last = compositor->fb_slot_last;
+	if ((last>=0) && !compositor->fb_slots[last].nb_refs) {
+		idx = last;
+	} else {
+		for (i=0; i<compositor->nb_fb_slots; i++) {
+			slot = &compositor->fb_slots[i];
+			if (slot->nb_refs) continue;
+			if ((idx<0) || (slot->gen > compositor->fb_slots[idx].gen))
+				idx = i;
+		}
+	}
+	if (idx<0) {
+		gf_mx_v(compositor->fb_mx);
+		return NULL;
+	}
+	slot = &compositor->fb_slots[idx];
+	if (!slot->buffer || (slot->size != compositor->framebuffer_size)) {
+		slot->buffer = gf_realloc(slot->buffer, compositor->framebuffer_size);
+		if (!slot->buffer) {
+			slot->size = 0;
+			gf_mx_v(compositor->fb_mx);
+			return NULL;
+		}
+		slot->size = compositor->framebuffer_size;
+		slot->gen = 0;
+		memset(slot->buffer, 0, slot->size);
+	}
+	if ((idx != last) && (last>=0))
+		gf_sc_fb_pool_sync(compositor, slot, &compositor->fb_slots[last]);
+	gf_mx_v(compositor->fb_mx);
+
+	compositor->fb_slot_cur = idx;
+	return slot->buffer;
+}
+
+static void gf_sc_fb_pool_pck_done(GF_Filter *filter, GF_FilterPid *pid, GF_FilterPacket *pck)
+{
+	u32 i, size;
+	GF_Compositor *compositor = gf_filter_get_udta(filter);
+	const u8 *data = gf_filter_pck_get_data(pck, &size);
+
+	gf_mx_p(compositor->fb_mx);
+	for (i=0; i<compositor->nb_fb_slots; i++) {
+		GF_SCFrameSlot *slot = &compositor->fb_slots[i];
+		if (slot->buffer != data) continue;
+		if (slot->nb_refs) slot->nb_refs--;
+		if (!slot->nb_refs && slot->discard) {
+			gf_free(slot->buffer);
+			slot->buffer = NULL;
+			slot->size = 0;
+			slot->discard = GF_FALSE;
+		}
+		break;
+	}
+	gf_mx_v(compositor->fb_mx);
+}
+
+//create output packet for the frame drawn in the pool and mark modified tiles
+static GF_FilterPacket *gf_sc_fb_pool_new_packet(GF_Compositor *compositor)
+{
+	u32 i, tx, ty;
+	GF_SCFrameSlot *slot;
+	GF_FilterPacket *pck;
+	s32 idx = compositor->fb_slot_cur;
+
+	//nothing drawn since last frame, send the last frame again
+	if (idx<0) idx = compositor->fb_slot_last;
+	if (idx<0) {
+		if (!gf_sc_fb_pool_acquire(compositor)) return NULL;
+		idx = compositor->fb_slot_cur;
+	}
+	slot = &compositor->fb_slots[idx];
+	pck = gf_filter_pck_new_shared(compositor->vout, slot->buffer, slot->size, gf_sc_fb_pool_pck_done);
+	if (!pck) return NULL;
+	gf_mx_p(compositor->fb_mx);
+	slot->nb_refs++;
+	gf_mx_v(compositor->fb_mx);
+	if (idx != compositor->fb_slot_cur) return pck;
+
+	compositor->fb_gen++;
+	if (compositor->fb_dirty_all) {
+		for (i=0; i<compositor->fb_tiles_w * compositor->fb_tiles_h; i++)
+			compositor->fb_tile_gen[i] = compositor->fb_gen;
+	} else {
+		for (i=0; i<compositor->fb_nb_dirty; i++) {
+			GF_IRect *rc = &compositor->fb_dirty[i];
+			u32 tx_end = MIN((rc->x + rc->width - 1) / compositor->fb_tile_w, compositor->fb_tiles_w - 1);
+			u32 ty_end = MIN((rc->y + rc->height - 1) / compositor->fb_tile_h, compositor->fb_tiles_h - 1);
+			for (ty = rc->y / compositor->fb_tile_h; ty <= ty_end; ty++) {
+				for (tx = rc->x / compositor->fb_tile_w; tx <= tx_end; tx++)
+					compositor->fb_tile_gen[ty * compositor->fb_tiles_w + tx] = compositor->fb_gen;
+			}
+		}
+	}
+	slot->gen = compositor->fb_gen;
+	compositor->fb_slot_last = idx;
+	compositor->fb_slot_cur = -1;
+	return pck;
+}
+
+static void gf_sc_fb_pool_del(GF_Compositor *compositor)
+{
+	u32 i;
+	for (i=0; i<compositor->nb_fb_slots; i++) {
+		if (compositor->fb_slots[i].buffer) gf_free(compositor->fb_slots[i].buffer);
+	}
+	if (compositor->fb_slots) gf_free(compositor->fb_slots);
+	compositor->fb_slots = NULL;
+	compositor->nb_fb_slots = 0;
+	if (compositor->fb_mx) gf_mx_del(compositor->fb_mx);
+	compositor->fb_mx = NULL;
+	if (compositor->fb_tile_gen) gf_free(compositor->fb_tile_gen);
+	compositor->fb_tile_gen = NULL;
+}
+
+void gf_sc_add_dirty_rect(GF_Compositor *compositor, GF_IRect *rc)
+{
+	GF_IRect clip;
+	if (!compositor->drect && !compositor->fb_slots) return;
+	if (compositor->fb_dirty_all) return;
+
+	if (!rc || (compositor->fb_nb_dirty >= GF_SC_MAX_DIRTY_RECTS)) {
+		compositor->fb_dirty_all = GF_TRUE;
+		compositor->fb_nb_dirty = 0;
+		return;
+	}
+	clip = *rc;
+	if (clip.x < 0) {
+		clip.width += clip.x;
+		clip.x = 0;
+	}
+	if (clip.y < 0) {
+		clip.height += clip.y;
+		clip.y = 0;
+	}
+	if (clip.x + clip.width > (s32) compositor->display_width) clip.width = (s32) compositor->display_width - clip.x;
+	if (clip.y + clip.height > (s32) compositor->display_height) clip.height = (s32) compositor->display_height - clip.y;
+	if ((clip.width<=0) || (clip.height<=0)) return;
+
+	if (compositor->fb_nb_dirty == compositor->fb_dirty_alloc) {
+		compositor->fb_dirty_alloc = compositor->fb_dirty_alloc ? 2*compositor->fb_dirty_alloc : 8;
+		compositor->fb_dirty = gf_realloc(compositor->fb_dirty, sizeof(GF_IRect) * compositor->fb_dirty_alloc);
+		if (!compositor->fb_dirty) {
+			compositor->fb_dirty_alloc = compositor->fb_nb_dirty = 0;
+			compositor->fb_dirty_all = GF_TRUE;
+			return;
+		}
+	}
+	compositor->fb_dirty[compositor->fb_nb_dirty] = clip;
+	compositor->fb_nb_dirty++;
+}
+
+//signal modified areas on the output frame and reset them
+static void gf_sc_set_dirty_rects(GF_Compositor *compositor, GF_FilterPacket *pck)
+{
+	if (compositor->drect
+#ifndef GPAC_DISABLE_3D
+		&& !compositor->visual->type_3d && !compositor->hybrid_opengl
+#endif
+	) {
+		u32 i;
+		GF_PropertyValue p;
+		p.type = GF_PROP_UINT_LIST;
+		if (compositor->fb_dirty_all) {
+			p.value.uint_list.nb_items = 4;
+		} else {
+			p.value.uint_list.nb_items = 4 * compositor->fb_nb_dirty;
+		}
+		p.value.uint_list.vals = gf_malloc(sizeof(u32) * (p.value.uint_list.nb_items + 1));
+		if (p.value.uint_list.vals) {
+			if (compositor->fb_dirty_all) {
+				p.value.uint_list.vals[0] = p.value.uint_list.vals[1] = 0;
+				p.value.uint_list.vals[2] = compositor->display_width;
+				p.value.uint_list.vals[3] = compositor->display_height;
+			} else {
+				for (i=0; i<compositor->fb_nb_dirty; i++) {
+					p.value.uint_list.vals[4*i] = compositor->fb_dirty[i].x;
+					p.value.uint_list.vals[4*i+1] = compositor->fb_dirty[i].y;
+					p.value.uint_list.vals[4*i+2] = compositor->fb_dirty[i].width;
+					p.value.uint_list.vals[4*i+3] = compositor->fb_dirty[i].height;
+				}
+			}
+			gf_filter_pck_set_property(pck, GF_PROP_PCK_DIRTY_RECTS, &p);
+			gf_free(p.value.uint_list.vals);
+		}
+	}
+	compositor->fb_nb_dirty = 0;
+	compositor->fb_dirty_all = GF_FALSE;
+}
+
 void gf_sc_setup_passthrough(GF_Compositor *compositor)
 {
 	u32 timescale;
@@ -736,6 +1105,7 @@ GF_Err gf_sc_load(GF_Compositor *compositor)
 
 	compositor->init_flags = 0;
 	compositor->os_wnd = NULL;
+	compositor->fb_slot_cur = compositor->fb_slot_last = -1;
 	sOpt = gf_opts_get_key("Temp", "OSWnd");
 	if (sOpt) sscanf(sOpt, "%p", &compositor->os_wnd);
 	sOpt = gf_opts_get_key("Temp", "InitFlags");
@@ -995,6 +1365,8 @@ void gf_sc_unload(GF_Compositor *compositor)
 	if (compositor->line_buffer) gf_free(compositor->line_buffer);
 #endif
 	if (compositor->framebuffer) gf_free(compositor->framebuffer);
+	gf_sc_fb_pool_del(compositor);
+	if (compositor->fb_dirty) gf_free(compositor->fb_dirty);
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_COMPOSE, ("[Compositor] Unloading visual compositor module\n"));
 
@@ -2902,11 +3274,15 @@ void gf_sc_render_frame(GF_Compositor *compositor)
 				compositor->passthrough_pck = NULL;
 				pck_frame_ts = gf_filter_pck_get_cts(pck);
 			} else {
+				if (gf_sc_fb_pool_active(compositor)) {
+					pck = gf_sc_fb_pool_new_packet(compositor);
+				}
 				//assign udta of frame interface event when using shared packet, as it is used to test when frame is released
-				compositor->frame_ifce.user_data = compositor;
-				if (compositor->video_out==&raw_vout) {
+				else if (compositor->video_out==&raw_vout) {
+					compositor->frame_ifce.user_data = compositor;
 					pck = gf_filter_pck_new_shared(compositor->vout, compositor->framebuffer, compositor->framebuffer_size, gf_sc_frame_ifce_done);
 				} else {
+					compositor->frame_ifce.user_data = compositor;
 					compositor->frame_ifce.get_plane = gf_sc_frame_ifce_get_plane;
 					compositor->frame_ifce.get_gl_texture = NULL;
 #ifndef GPAC_DISABLE_3D
@@ -2938,6 +3314,7 @@ void gf_sc_render_frame(GF_Compositor *compositor)
 				ts /= compositor->passthrough_timescale;
 				frame_ts = (u32) ts;
 			}
+			gf_sc_set_dirty_rects(compositor, pck);
 			gf_filter_pck_send(pck);
 			gf_sc_ar_update_video_clock(compositor->audio_renderer, frame_ts);
 
@@ -292,6 +292,10 @@ GF_Err visual_2d_init_draw(GF_VisualManager *visual, GF_TraverseState *tr_state)
 	}
 	tr_state->invalidate_all = 0;
 
+	/*whole output frame is redrawn*/
+	if (mode2d && (visual == visual->compositor->visual))
+		gf_sc_add_dirty_rect(visual->compositor, NULL);
+
 	/*reset prev nodes if any (previous traverse was indirect)*/
 	rem = count = 0;
 	prev = NULL;
@@ -576,6 +580,23 @@ static void register_dirty_rect(GF_RectArray *ra, GF_IRect *rc)
 }
 
 
+/*signal areas about to be redrawn to the compositor output, in pixel coordinates with top-left origin*/
+static void visual_2d_signal_dirty_rects(GF_VisualManager *visual)
+{
+	u32 i;
+	GF_Compositor *compositor = visual->compositor;
+	for (i=0; i<visual->to_redraw.count; i++) {
+		GF_IRect rc = visual->to_redraw.list[i].rect;
+		if (visual->center_coords) {
+			rc.x += compositor->display_width / 2;
+			rc.y = compositor->display_height / 2 - rc.y;
+		} else {
+			rc.y -= rc.height;
+		}
+		gf_sc_add_dirty_rect(compositor, &rc);
+	}
+}
+
 Bool visual_2d_terminate_draw(GF_VisualManager *visual, GF_TraverseState *tr_state)
 {
 	u32 k, i, count, num_nodes, num_changed;
@@ -713,6 +734,8 @@ Bool visual_2d_terminate_draw(GF_VisualManager *visual, GF_TraverseState *tr_sta
 
 		if (visual->compositor->debug_defer) {
 			visual->ClearSurface(visual, &visual->top_clipper, 0, 0);
+			if (visual == visual->compositor->visual)
+				gf_sc_add_dirty_rect(visual->compositor, NULL);
 		}
 	}
 
@@ -736,6 +759,9 @@ Bool visual_2d_terminate_draw(GF_VisualManager *visual, GF_TraverseState *tr_sta
 	has_changed = 1;
 	tr_state->traversing_mode = TRAVERSE_DRAW_2D;
 
+	if (visual == visual->compositor->visual)
+		visual_2d_signal_dirty_rects(visual);
+
 	//if only one opaque object has changed and not moved, skip background unless hybgl mode
 	if (!visual->compositor->hybrid_opengl && !hyb_force_redraw && !hyb_force_background && first_opaque && (visual->to_redraw.count==1) && irect_rect_equal(&first_opaque->bi->clip, &visual->to_redraw.list[0].rect)) {
 		visual->has_modif=0;
@@ -36,6 +36,8 @@ GF_Err visual_2d_init_raster(GF_VisualManager *visual)
 	if (!visual->raster_surface) {
 		visual->raster_surface = gf_evg_surface_new(visual->center_coords);
 		if (!visual->raster_surface) return GF_IO_ERR;
+		if (visual->compositor->rthreads)
+			gf_evg_surface_set_threads(visual->raster_surface, visual->compositor->rthreads);
 	}
 	return visual->GetSurfaceAccess(visual);
 }
@@ -103,3 +103,91 @@ GF_Err gf_crypt_decrypt(GF_Crypt *td, void *ciphertext, u32 len)
 	if (!len) return GF_OK;
 	return td->_decrypt(td, ciphertext, len);
 }
+
+static GF_Err gf_crypt_process_pattern(GF_Crypt *td, u8 *data, u32 size, u32 crypt_block, u32 skip_block, Bool is_encrypt)
+{
+	GF_Err e = GF_OK;
+	if (!td) return GF_BAD_PARAM;
+	if (!size) return GF_OK;
+
+	if (!crypt_block || !skip_block)
+		return is_encrypt ? td->_crypt(td, data, size) : td->_decrypt(td, data, size);
+
+	if (td->_crypt_pattern) {
+		e = td->_crypt_pattern(td, data, size, crypt_block, skip_block, is_encrypt);
+		//not handled by backend for this range
+		if (e != GF_NOT_SUPPORTED) return e;
+		e = GF_OK;
+	}
+
+	while (size) {
+		u32 len = (size >= 16*crypt_block) ? 16*crypt_block : size;
+		e = is_encrypt ? td->_crypt(td, data, len) : td->_decrypt(td, data, len);
+		if (e) return e;
+		if (size >= 16 * (crypt_block + skip_block)) {
+			data += 16 * (crypt_block + skip_block);
+			size -= 16 * (crypt_block + skip_block);
+		} else {
+			size = 0;
+		}
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_crypt_encrypt_pattern(GF_Crypt *td, void *plaintext, u32 size, u32 crypt_block, u32 skip_block)
+{
+	return gf_crypt_process_pattern(td, plaintext, size, crypt_block, skip_block, GF_TRUE);
+}
+
+GF_EXPORT
+GF_Err gf_crypt_decrypt_pattern(GF_Crypt *td, void *ciphertext, u32 size, u32 crypt_block, u32 skip_block)
+{
+	return gf_crypt_process_pattern(td, ciphertext, size, crypt_block, skip_block, GF_FALSE);
+}
+
+static GF_Err gf_crypt_process_sample(GF_Crypt *td, u8 *data, u32 size, const GF_CryptSubsample *subsamples, u32 nb_subsamples, u32 crypt_block, u32 skip_block, const u8 *const_IV, u32 const_IV_size, Bool is_encrypt)
+{
+	u32 i, pos=0;
+	u8 IV[16];
+	if (!td || !data) return GF_BAD_PARAM;
+
+	if (const_IV) {
+		if ((const_IV_size != 8) && (const_IV_size != 16)) return GF_BAD_PARAM;
+		memset(IV, 0, 16);
+		memcpy(IV, const_IV, const_IV_size);
+	}
+
+	if (!subsamples || !nb_subsamples) {
+		if (td->mode==GF_CBC) size -= size % 16;
+		if (const_IV) td->_set_state(td, IV, 16);
+		return gf_crypt_process_pattern(td, data, size, crypt_block, skip_block, is_encrypt);
+	}
+
+	for (i=0; i<nb_subsamples; i++) {
+		GF_Err e;
+		u32 crypted_bytes = subsamples[i].crypted_bytes;
+		if (pos + subsamples[i].clear_bytes + crypted_bytes > size) return GF_NON_COMPLIANT_BITSTREAM;
+		pos += subsamples[i].clear_bytes;
+
+		if (const_IV) td->_set_state(td, IV, 16);
+		if (td->mode==GF_CBC) crypted_bytes -= crypted_bytes % 16;
+
+		e = gf_crypt_process_pattern(td, data+pos, crypted_bytes, crypt_block, skip_block, is_encrypt);
+		if (e) return e;
+		pos += subsamples[i].crypted_bytes;
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_crypt_encrypt_sample(GF_Crypt *td, u8 *data, u32 size, const GF_CryptSubsample *subsamples, u32 nb_subsamples, u32 crypt_block, u32 skip_block, const u8 *const_IV, u32 const_IV_size)
+{
+	return gf_crypt_process_sample(td, data, size, subsamples, nb_subsamples, crypt_block, skip_block, const_IV, const_IV_size, GF_TRUE);
+}
+
+GF_EXPORT
+GF_Err gf_crypt_decrypt_sample(GF_Crypt *td, u8 *data, u32 size, const GF_CryptSubsample *subsamples, u32 nb_subsamples, u32 crypt_block, u32 skip_block, const u8 *const_IV, u32 const_IV_size)
+{
+	return gf_crypt_process_sample(td, data, size, subsamples, nb_subsamples, crypt_block, skip_block, const_IV, const_IV_size, GF_FALSE);
+}
@@ -26,13 +26,17 @@
 #include <gpac/internal/crypt_dev.h>
 
 #ifdef GPAC_HAS_SSL
-#include <openssl/aes.h>
-#include <openssl/modes.h>
+#include <openssl/evp.h>
 
 #include <math.h>
 
+#define AES_BLOCK_SIZE	16
+
+/*all block processing goes through EVP, which selects AES-NI / ARMv8 crypto when available and processes whole buffers in place.
+The chaining state (CBC IV, CTR counter and keystream position) is kept here so that get/set IV behave as with the legacy AES_* API*/
+
 typedef struct {
-	AES_KEY enc_key, dec_key;
+	EVP_CIPHER_CTX *enc_ctx, *dec_ctx;
 
 	u8 block[AES_BLOCK_SIZE];
 	u8 padded_input[AES_BLOCK_SIZE]; // use only when the input length is inferior to the algo block size
@@ -48,6 +52,9 @@ GF_Err gf_crypt_init_openssl_cbc(GF_Crypt* td, void *key, const void *iv)
 		GF_SAFEALLOC(ctx, Openssl_ctx_cbc);
 		if (ctx == NULL) return GF_OUT_OF_MEM;
 		td->context = ctx;
+		ctx->enc_ctx = EVP_CIPHER_CTX_new();
+		ctx->dec_ctx = EVP_CIPHER_CTX_new();
+		if (!ctx->enc_ctx || !ctx->dec_ctx) return GF_OUT_OF_MEM;
 	}
 	
 	if (iv != NULL) {
@@ -58,13 +65,20 @@ GF_Err gf_crypt_init_openssl_cbc(GF_Crypt* td, void *key, const void *iv)
 
 void gf_crypt_deinit_openssl_cbc(GF_Crypt* td)
 {
+	Openssl_ctx_cbc* ctx = (Openssl_ctx_cbc*)td->context;
+	if (!ctx) return;
+	if (ctx->enc_ctx) EVP_CIPHER_CTX_free(ctx->enc_ctx);
+	if (ctx->dec_ctx) EVP_CIPHER_CTX_free(ctx->dec_ctx);
+	ctx->enc_ctx = ctx->dec_ctx = NULL;
 }
 
 void gf_set_key_openssl_cbc(GF_Crypt* td, void *key)
 {
 	Openssl_ctx_cbc* ctx = (Openssl_ctx_cbc*)td->context;
-	AES_set_encrypt_key(key, 128, &(ctx->enc_key));
-	AES_set_decrypt_key(key, 128, &(ctx->dec_key));
+	EVP_EncryptInit_ex(ctx->enc_ctx, EVP_aes_128_cbc(), NULL, key, NULL);
+	EVP_CIPHER_CTX_set_padding(ctx->enc_ctx, 0);
+	EVP_DecryptInit_ex(ctx->dec_ctx, EVP_aes_128_cbc(), NULL, key, NULL);
+	EVP_CIPHER_CTX_set_padding(ctx->dec_ctx, 0);
 }
 
 GF_Err gf_crypt_set_IV_openssl_cbc(GF_Crypt* td, const u8 *iv, u32 iv_size)
@@ -82,38 +96,92 @@ GF_Err gf_crypt_get_IV_openssl_cbc(GF_Crypt* td, u8 *iv, u32 *iv_size)
 	return GF_OK;
 }
 
-GF_Err gf_crypt_crypt_openssl_cbc(GF_Crypt* td, u8 *plaintext, u32 len, u32 aes_crypt_type) {
+GF_Err gf_crypt_crypt_openssl_cbc(GF_Crypt* td, u8 *plaintext, u32 len, Bool is_encrypt) {
+	Openssl_ctx_cbc* ctx = (Openssl_ctx_cbc*)td->context;
+	EVP_CIPHER_CTX *evp = is_encrypt ? ctx->enc_ctx : ctx->dec_ctx;
+	u32 full_size = len - (len % AES_BLOCK_SIZE);
+	int olen;
+
+	if (full_size) {
+		u8 last_block[AES_BLOCK_SIZE];
+		//in-place decryption overwrites the last ciphertext block which is the next IV
+		if (!is_encrypt) memcpy(last_block, plaintext + full_size - AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+
+		if (!EVP_CipherInit_ex(evp, NULL, NULL, NULL, ctx->previous_ciphertext, is_encrypt ? 1 : 0))
+			return GF_IO_ERR;
+		if (!EVP_CipherUpdate(evp, plaintext, &olen, plaintext, (int) full_size))
+			return GF_IO_ERR;
+
+		if (is_encrypt) memcpy(ctx->previous_ciphertext, plaintext + full_size - AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+		else memcpy(ctx->previous_ciphertext, last_block, AES_BLOCK_SIZE);
+	}
+	//trailing partial block, processed as a zero-padded block of which only the first bytes are kept
+	if (len > full_size) {
+		u8 next_iv[AES_BLOCK_SIZE];
+		memset(ctx->padded_input, 0, AES_BLOCK_SIZE);
+		memcpy(ctx->padded_input, plaintext + full_size, len - full_size);
+		if (!is_encrypt) memcpy(next_iv, ctx->padded_input, AES_BLOCK_SIZE);
+
+		if (!EVP_CipherInit_ex(evp, NULL, NULL, NULL, ctx->previous_ciphertext, is_encrypt ? 1 : 0))
+			return GF_IO_ERR;
+		if (!EVP_CipherUpdate(evp, ctx->block, &olen, ctx->padded_input, AES_BLOCK_SIZE))
+			return GF_IO_ERR;
+		memcpy(plaintext + full_size, ctx->block, len - full_size);
+
+		memcpy(ctx->previous_ciphertext, is_encrypt ? ctx->block : next_iv, AES_BLOCK_SIZE);
+	}
+	return GF_OK;
+}
+
+//pattern encryption keeps the EVP chaining state across encrypted block groups, so the context is only initialized once per range
+GF_Err gf_crypt_pattern_openssl_cbc(GF_Crypt* td, u8 *data, u32 size, u32 crypt_block, u32 skip_block, Bool is_encrypt)
+{
 	Openssl_ctx_cbc* ctx = (Openssl_ctx_cbc*)td->context;
-	u32 iteration;
-	AES_KEY *key = aes_crypt_type ? &ctx->enc_key : &ctx->dec_key;
-	u32 numberOfIterations = len / AES_BLOCK_SIZE;
-	if (numberOfIterations * AES_BLOCK_SIZE < len) numberOfIterations++;
-
-	for (iteration = 0; iteration < numberOfIterations; ++iteration) {
-		if (len - iteration*AES_BLOCK_SIZE < AES_BLOCK_SIZE) {
-			memset(ctx->padded_input, 0, AES_BLOCK_SIZE);
-			memcpy(ctx->padded_input, plaintext, len - iteration*AES_BLOCK_SIZE);
-			AES_cbc_encrypt(plaintext + iteration*AES_BLOCK_SIZE, ctx->block, AES_BLOCK_SIZE, key, ctx->previous_ciphertext, aes_crypt_type);
-			memcpy(plaintext + iteration*AES_BLOCK_SIZE, ctx->block, len - iteration*AES_BLOCK_SIZE);
+	EVP_CIPHER_CTX *evp = is_encrypt ? ctx->enc_ctx : ctx->dec_ctx;
+	u32 crypt_size = 16*crypt_block;
+	u32 group_size = 16*(crypt_block + skip_block);
+	u8 *last_block = NULL;
+	u8 next_iv[AES_BLOCK_SIZE];
+	int olen;
+
+	//partial blocks are handled by the generic path
+	if (size % AES_BLOCK_SIZE) return GF_NOT_SUPPORTED;
+
+	if (!EVP_CipherInit_ex(evp, NULL, NULL, NULL, ctx->previous_ciphertext, is_encrypt ? 1 : 0))
+		return GF_IO_ERR;
+
+	while (size) {
+		u32 len = (size >= crypt_size) ? crypt_size : size;
+		last_block = data + len - AES_BLOCK_SIZE;
+		if (!is_encrypt) memcpy(next_iv, last_block, AES_BLOCK_SIZE);
+
+		if (!EVP_CipherUpdate(evp, data, &olen, data, (int) len))
+			return GF_IO_ERR;
+
+		if (size >= group_size) {
+			data += group_size;
+			size -= group_size;
 		} else {
-			AES_cbc_encrypt(plaintext + iteration*AES_BLOCK_SIZE, plaintext + iteration*AES_BLOCK_SIZE, AES_BLOCK_SIZE, key, ctx->previous_ciphertext, aes_crypt_type);
+			size = 0;
 		}
 	}
+	if (last_block)
+		memcpy(ctx->previous_ciphertext, is_encrypt ? last_block : next_iv, AES_BLOCK_SIZE);
 	return GF_OK;
 }
 
 GF_Err gf_crypt_encrypt_openssl_cbc(GF_Crypt* td, u8 *plaintext, u32 len)
 {
-	return gf_crypt_crypt_openssl_cbc(td, plaintext, len, AES_ENCRYPT);
+	return gf_crypt_crypt_openssl_cbc(td, plaintext, len, GF_TRUE);
 }
 
 GF_Err gf_crypt_decrypt_openssl_cbc(GF_Crypt* td, u8 *ciphertext, u32 len)
 {
-	return gf_crypt_crypt_openssl_cbc(td, ciphertext, len, AES_DECRYPT);
+	return gf_crypt_crypt_openssl_cbc(td, ciphertext, len, GF_FALSE);
 }
 
 typedef struct {
-	AES_KEY key;
+	EVP_CIPHER_CTX *evp;
 
 	u8 cyphered_iv[16];
 	u8 iv[16];
@@ -126,7 +194,7 @@ typedef struct {
 void gf_set_key_openssl_ctr(GF_Crypt* td, void *key)
 {
 	Openssl_ctx_ctr* ctx = (Openssl_ctx_ctr*)td->context;
-	AES_set_encrypt_key(key, 128, &(ctx->key));
+	EVP_EncryptInit_ex(ctx->evp, EVP_aes_128_ctr(), NULL, key, NULL);
 }
 
 GF_Err gf_crypt_set_IV_openssl_ctr(GF_Crypt* td, const u8 *iv, u32 iv_size)
@@ -158,6 +226,8 @@ GF_Err gf_crypt_init_openssl_ctr(GF_Crypt* td, void *key, const void *iv)
 		if (!ctx) return GF_OUT_OF_MEM;
 
 		td->context = ctx;
+		ctx->evp = EVP_CIPHER_CTX_new();
+		if (!ctx->evp) return GF_OUT_OF_MEM;
 	}
 	ctx->c_counter_pos = 0;
 	if (iv != NULL) {
@@ -169,17 +239,107 @@ GF_Err gf_crypt_init_openssl_ctr(GF_Crypt* td, void *key, const void *iv)
 
 void gf_crypt_deinit_openssl_ctr(GF_Crypt* td)
 {
+	Openssl_ctx_ctr* ctx = (Openssl_ctx_ctr*)td->context;
+	if (!ctx) return;
+	if (ctx->evp) EVP_CIPHER_CTX_free(ctx->evp);
+	ctx->evp = NULL;
 }
 
-GF_Err gf_crypt_crypt_openssl_ctr(GF_Crypt* td, u8 *plaintext, u32 len)
+//adds nb_blocks to the 128 bit big-endian counter
+static void ctr128_add(u8 *counter, u64 nb_blocks)
 {
-	Openssl_ctx_ctr* ctx = (Openssl_ctx_ctr*)td->context;
+	s32 i;
+	for (i=15; (i>=0) && nb_blocks; i--) {
+		u64 v = (u64) counter[i] + (nb_blocks & 0xFF);
+		counter[i] = (u8) v;
+		nb_blocks = (nb_blocks >> 8) + (v >> 8);
+	}
+}
 
-	CRYPTO_ctr128_encrypt(plaintext, plaintext, len, &ctx->key, ctx->iv, ctx->cyphered_iv, &ctx->c_counter_pos, (block128_f)AES_encrypt);
+//sets counter state after nb_bytes processed from a block boundary, computing the keystream of the current block if not fully consumed
+static GF_Err gf_crypt_ctr_advance(Openssl_ctx_ctr* ctx, u64 nb_bytes)
+{
+	int olen;
+	ctr128_add(ctx->iv, nb_bytes / AES_BLOCK_SIZE);
+	ctx->c_counter_pos = (u32) (nb_bytes % AES_BLOCK_SIZE);
+	if (!ctx->c_counter_pos) return GF_OK;
+
+	//keystream of the current counter is the encryption of a zero block
+	memset(ctx->cyphered_iv, 0, AES_BLOCK_SIZE);
+	if (!EVP_EncryptInit_ex(ctx->evp, NULL, NULL, NULL, ctx->iv))
+		return GF_IO_ERR;
+	if (!EVP_EncryptUpdate(ctx->evp, ctx->cyphered_iv, &olen, ctx->cyphered_iv, AES_BLOCK_SIZE))
+		return GF_IO_ERR;
+	ctr128_add(ctx->iv, 1);
+	return GF_OK;
+}
 
+//same state machine as CRYPTO_ctr128_encrypt: consume pending keystream, process all full blocks in a single EVP call, keep keystream of the trailing block
+GF_Err gf_crypt_crypt_openssl_ctr(GF_Crypt* td, u8 *plaintext, u32 len)
+{
+	Openssl_ctx_ctr* ctx = (Openssl_ctx_ctr*)td->context;
+	u32 nb_blocks;
+	int olen;
+
+	while (ctx->c_counter_pos && len) {
+		*plaintext ^= ctx->cyphered_iv[ctx->c_counter_pos];
+		plaintext++;
+		len--;
+		ctx->c_counter_pos = (ctx->c_counter_pos + 1) % AES_BLOCK_SIZE;
+	}
+	if (!len) return GF_OK;
+
+	if (!EVP_EncryptInit_ex(ctx->evp, NULL, NULL, NULL, ctx->iv))
+		return GF_IO_ERR;
+
+	nb_blocks = len / AES_BLOCK_SIZE;
+	if (nb_blocks) {
+		if (!EVP_EncryptUpdate(ctx->evp, plaintext, &olen, plaintext, (int) (nb_blocks * AES_BLOCK_SIZE)))
+			return GF_IO_ERR;
+		ctr128_add(ctx->iv, nb_blocks);
+		plaintext += nb_blocks * AES_BLOCK_SIZE;
+		len -= nb_blocks * AES_BLOCK_SIZE;
+	}
+	if (len) {
+		u32 i;
+		GF_Err e = gf_crypt_ctr_advance(ctx, len);
+		if (e) return e;
+		for (i=0; i<len; i++) plaintext[i] ^= ctx->cyphered_iv[i];
+	}
 	return GF_OK;
 }
 
+//the EVP CTR context keeps counter and keystream position across encrypted block groups
+GF_Err gf_crypt_pattern_openssl_ctr(GF_Crypt* td, u8 *data, u32 size, u32 crypt_block, u32 skip_block, Bool is_encrypt)
+{
+	Openssl_ctx_ctr* ctx = (Openssl_ctx_ctr*)td->context;
+	u32 crypt_size = 16*crypt_block;
+	u32 group_size = 16*(crypt_block + skip_block);
+	u64 nb_bytes = 0;
+	int olen;
+
+	//pending keystream is handled by the generic path
+	if (ctx->c_counter_pos) return GF_NOT_SUPPORTED;
+
+	if (!EVP_EncryptInit_ex(ctx->evp, NULL, NULL, NULL, ctx->iv))
+		return GF_IO_ERR;
+
+	while (size) {
+		u32 len = (size >= crypt_size) ? crypt_size : size;
+		if (!EVP_EncryptUpdate(ctx->evp, data, &olen, data, (int) len))
+			return GF_IO_ERR;
+		nb_bytes += len;
+
+		if (size >= group_size) {
+			data += group_size;
+			size -= group_size;
+		} else {
+			size = 0;
+		}
+	}
+	return gf_crypt_ctr_advance(ctx, nb_bytes);
+}
+
 GF_Err gf_crypt_encrypt_openssl_ctr(GF_Crypt* td, u8 *plaintext, u32 len)
 {
 	return gf_crypt_crypt_openssl_ctr(td, plaintext, len);
@@ -203,6 +363,7 @@ GF_Err gf_crypt_open_open_openssl(GF_Crypt* td, GF_CRYPTO_MODE mode)
 		td->_decrypt = gf_crypt_decrypt_openssl_cbc;
 		td->_get_state = gf_crypt_get_IV_openssl_cbc;
 		td->_set_state = gf_crypt_set_IV_openssl_cbc;
+		td->_crypt_pattern = gf_crypt_pattern_openssl_cbc;
 		break;
 	case GF_CTR:
 		td->_init_crypt = gf_crypt_init_openssl_ctr;
@@ -212,6 +373,7 @@ GF_Err gf_crypt_open_open_openssl(GF_Crypt* td, GF_CRYPTO_MODE mode)
 		td->_decrypt = gf_crypt_decrypt_openssl_ctr;
 		td->_get_state = gf_crypt_get_IV_openssl_ctr;
 		td->_set_state = gf_crypt_set_IV_openssl_ctr;
+		td->_crypt_pattern = gf_crypt_pattern_openssl_ctr;
 		break;
 	default:
 		return GF_BAD_PARAM;
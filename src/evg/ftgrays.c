@@ -93,6 +93,8 @@ void gray_record_cell( TRaster *raster )
 
 			if (raster->first_scanline > (u32) y)
 				raster->first_scanline = y;
+			if (raster->last_scanline <= (u32) y)
+				raster->last_scanline = y+1;
 		}
 	}
 }
@@ -607,6 +609,77 @@ void gray_sweep_line( TRaster *raster, AAScanline *sl, int y, Bool zero_non_zero
 }
 
 
+/* sort each scanline of the band and render it*/
+static void gray_sweep_band(TRaster *raster, AAScanline *scanlines, u32 first_line, u32 last_line, Bool zero_non_zero_rule)
+{
+	u32 i;
+	for (i=first_line; i<last_line; i++) {
+		AAScanline *sl = &scanlines[i];
+		if (sl->num) {
+			if (sl->num>1) gray_quick_sort(sl->cells, sl->num);
+			gray_sweep_line(raster, sl, i, zero_non_zero_rule);
+			sl->num = 0;
+		}
+	}
+}
+
+static u32 evg_raster_band_proc(void *par)
+{
+	EVG_RasterBand *band = (EVG_RasterBand *)par;
+	TRaster *raster = band->parent;
+	while (1) {
+		gf_sema_wait(band->start);
+		if (raster->bands_exit) break;
+		gray_sweep_band(&band->sweep, raster->scanlines, band->first_line, band->last_line, raster->zero_non_zero_rule);
+		gf_sema_notify(raster->bands_done, 1);
+	}
+	return 0;
+}
+
+/*splits the recorded scanlines in bands of roughly the same cost and sweeps them in parallel.
+Each scanline is swept by a single band, and span callbacks of a band only write to the rows of the band,
+so the result is identical to sequential rendering*/
+static void gray_sweep_bands(TRaster *raster, u32 weight)
+{
+	u32 i, b, acc, target;
+
+	acc = 0;
+	b = 0;
+	raster->bands[0].first_line = raster->first_scanline;
+	target = weight / raster->nb_bands;
+	for (i=raster->first_scanline; i<raster->last_scanline; i++) {
+		if (raster->scanlines[i].num)
+			acc += raster->scanlines[i].num + EVG_BAND_ROW_WEIGHT;
+		if ((acc >= target) && (b+1 < raster->nb_bands)) {
+			raster->bands[b].last_line = i+1;
+			b++;
+			raster->bands[b].first_line = i+1;
+			target = (u32) ( ((u64) weight) * (b+1) / raster->nb_bands);
+		}
+	}
+	raster->bands[b].last_line = raster->last_scanline;
+	//trailing bands left empty
+	for (i=b+1; i<raster->nb_bands; i++) {
+		raster->bands[i].first_line = raster->bands[i].last_line = raster->last_scanline;
+	}
+
+	for (i=1; i<raster->nb_bands; i++) {
+		TRaster *sweep = &raster->bands[i].sweep;
+		sweep->min_ex = raster->min_ex;
+		sweep->max_ex = raster->max_ex;
+		sweep->min_ey = raster->min_ey;
+		sweep->max_ey = raster->max_ey;
+		sweep->max_gray_spans = raster->max_gray_spans;
+		sweep->render_span = raster->render_span;
+		sweep->render_span_data = raster->render_span_data;
+		gf_sema_notify(raster->bands[i].start, 1);
+	}
+	gray_sweep_band(raster, raster->scanlines, raster->bands[0].first_line, raster->bands[0].last_line, raster->zero_non_zero_rule);
+	for (i=1; i<raster->nb_bands; i++) {
+		gf_sema_wait(raster->bands_done);
+	}
+}
+
 int evg_raster_render(GF_EVGSurface *surf)
 {
 	Bool zero_non_zero_rule;
@@ -640,6 +713,7 @@ int evg_raster_render(GF_EVGSurface *surf)
 	raster->cover = 0;
 	raster->area = 0;
 	raster->first_scanline = raster->max_ey;
+	raster->last_scanline = 0;
 
 	EVG_Outline_Decompose(outline, raster);
 	gray_record_cell( raster );
@@ -647,20 +721,105 @@ int evg_raster_render(GF_EVGSurface *surf)
 	/*store odd/even rule*/
 	zero_non_zero_rule = (outline->flags & GF_PATH_FILL_ZERO_NONZERO) ? GF_TRUE : GF_FALSE;
 
-	/* sort each scanline and render it*/
-	for (i=raster->first_scanline; i<size_y; i++) {
-		AAScanline *sl = &raster->scanlines[i];
-		if (sl->num) {
-			if (sl->num>1) gray_quick_sort(sl->cells, sl->num);
-			gray_sweep_line(raster, sl, i, zero_non_zero_rule);
-			sl->num = 0;
+	/*band-parallel sweep is only used for fills which don't share state across scanlines:
+	 - variable stencils use a single pixel run buffer on the surface and update the stencil state while filling
+	 - YUV 420/422 fills accumulate chroma alpha over two scanlines
+	 - alpha callbacks are user code*/
+	if ((raster->nb_bands>1) && surf->sten && (surf->sten->type==GF_STENCIL_SOLID)
+		&& (surf->yuv_type!=EVG_YUV)
+		&& !surf->get_alpha
+	) {
+		u32 weight = 0;
+		for (i=raster->first_scanline; i<raster->last_scanline; i++) {
+			if (raster->scanlines[i].num)
+				weight += raster->scanlines[i].num + EVG_BAND_ROW_WEIGHT;
+		}
+		if (weight >= EVG_BAND_MIN_WEIGHT) {
+			raster->zero_non_zero_rule = zero_non_zero_rule;
+			gray_sweep_bands(raster, weight);
+			return 0;
 		}
 	}
 
+	gray_sweep_band(raster, raster->scanlines, raster->first_scanline, size_y, zero_non_zero_rule);
 	return 0;
 }
 
+static void evg_raster_stop_bands(TRaster *raster)
+{
+	u32 i;
+	if (raster->bands) {
+		raster->bands_exit = GF_TRUE;
+		for (i=1; i<raster->nb_bands; i++) {
+			gf_sema_notify(raster->bands[i].start, 1);
+		}
+		for (i=1; i<raster->nb_bands; i++) {
+			EVG_RasterBand *band = &raster->bands[i];
+			gf_th_del(band->th);
+			gf_sema_del(band->start);
+			gf_free(band->sweep.gray_spans);
+		}
+		gf_free(raster->bands);
+		raster->bands = NULL;
+		raster->nb_bands = 0;
+		raster->bands_exit = GF_FALSE;
+	}
+	if (raster->bands_done) {
+		gf_sema_del(raster->bands_done);
+		raster->bands_done = NULL;
+	}
+}
 
+GF_Err evg_raster_set_threads(EVG_Raster raster, u32 nb_threads)
+{
+	u32 i, max_threads = EVG_MAX_BAND_THREADS;
+	GF_SystemRTInfo rti;
+
+	//no more workers than cores, the calling thread sweeping the first band
+	memset(&rti, 0, sizeof(GF_SystemRTInfo));
+	if (gf_sys_get_rti(0, &rti, 0) && rti.nb_cores)
+		max_threads = rti.nb_cores-1;
+	if (max_threads > EVG_MAX_BAND_THREADS) max_threads = EVG_MAX_BAND_THREADS;
+	if (nb_threads > max_threads) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CORE, ("[EVG] %u raster threads requested, using %u\n", nb_threads, max_threads));
+		nb_threads = max_threads;
+	}
+	if (raster->nb_bands == nb_threads+1) return GF_OK;
+
+	//stop current workers
+	evg_raster_stop_bands(raster);
+	if (!nb_threads) return GF_OK;
+
+	raster->bands = gf_malloc(sizeof(EVG_RasterBand) * (nb_threads+1));
+	if (!raster->bands) return GF_OUT_OF_MEM;
+	memset(raster->bands, 0, sizeof(EVG_RasterBand) * (nb_threads+1));
+	raster->bands_done = gf_sema_new(nb_threads, 0);
+	if (!raster->bands_done) {
+		gf_free(raster->bands);
+		raster->bands = NULL;
+		return GF_OUT_OF_MEM;
+	}
+	raster->bands[0].parent = raster;
+	for (i=1; i<=nb_threads; i++) {
+		EVG_RasterBand *band = &raster->bands[i];
+		band->parent = raster;
+		band->sweep.max_gray_spans = band->sweep.alloc_gray_spans = FT_MAX_GRAY_SPANS;
+		band->sweep.gray_spans = gf_malloc(sizeof(EVG_Span) * band->sweep.alloc_gray_spans);
+		band->start = gf_sema_new(1, 0);
+		band->th = gf_th_new("EVGBand");
+		if (!band->sweep.gray_spans || !band->start || !band->th || gf_th_run(band->th, evg_raster_band_proc, band)) {
+			//release this band, and stop the bands already running
+			if (band->sweep.gray_spans) gf_free(band->sweep.gray_spans);
+			if (band->start) gf_sema_del(band->start);
+			if (band->th) gf_th_del(band->th);
+			raster->nb_bands = i;
+			evg_raster_stop_bands(raster);
+			return GF_OUT_OF_MEM;
+		}
+	}
+	raster->nb_bands = nb_threads+1;
+	return GF_OK;
+}
 
 
 EVG_Raster evg_raster_new()
@@ -680,6 +839,7 @@ EVG_Raster evg_raster_new()
 void evg_raster_del(EVG_Raster raster)
 {
 	u32 i;
+	evg_raster_set_threads(raster, 0);
 	for (i=0; i<raster->max_lines; i++) {
 		gf_free(raster->scanlines[i].cells);
 		if (raster->scanlines[i].pixels)
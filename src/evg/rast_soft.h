@@ -29,6 +29,8 @@
 #define _GF_EVG_DEV_H_
 
 #include <gpac/evg.h>
+#include <gpac/thread.h>
+#include <gpac/internal/simd_dev.h>
 
 /*base stencil stack*/
 #define EVGBASESTENCIL	\
@@ -287,6 +289,27 @@ typedef struct __evg_texture
 
 void evg_fill_run(GF_EVGStencil *p, GF_EVGSurface *surf, s32 x, s32 y, u32 count);
 
+#ifdef GPAC_HAS_SSE2
+/*(u8) (mul255(a1-1, diff) + d) on 16-bit lanes, with a1 in [0, 256] and diff in [-255, 255]
+the product does not fit 16 bits, but only its bits 8 to 15 are needed for an 8-bit result*/
+static GFINLINE __m128i evg_sse2_mul255_add(__m128i a1, __m128i diff, __m128i d)
+{
+	__m128i p = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(a1, diff), 8), d);
+	return _mm_and_si128(p, _mm_set1_epi16(0xFF));
+}
+
+/*blends 16 bytes of src over dst, using a1 (alpha+1) for each byte of the low (a1_lo) and high (a1_hi) 8 bytes*/
+static GFINLINE __m128i evg_sse2_blend_u8(__m128i dst, __m128i src, __m128i a1_lo, __m128i a1_hi)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i d_lo = _mm_unpacklo_epi8(dst, zero);
+	__m128i d_hi = _mm_unpackhi_epi8(dst, zero);
+	__m128i diff_lo = _mm_sub_epi16(_mm_unpacklo_epi8(src, zero), d_lo);
+	__m128i diff_hi = _mm_sub_epi16(_mm_unpackhi_epi8(src, zero), d_hi);
+	return _mm_packus_epi16(evg_sse2_mul255_add(a1_lo, diff_lo, d_lo), evg_sse2_mul255_add(a1_hi, diff_hi, d_hi));
+}
+#endif
+
 #define evg_make_col_wide(_a, _r, _g, _b)\
 	((u64)(_a)) << 48 | ((u64)(_r))<<32 | ((u64)(_g))<<16 | ((u64)(_b))
 
@@ -492,6 +515,8 @@ typedef struct
 } AAScanline;
 
 
+typedef struct _evg_raster_band EVG_RasterBand;
+
 typedef struct  TRaster_
 {
 	AAScanline *scanlines;
@@ -510,10 +535,37 @@ typedef struct  TRaster_
 	void *render_span_data;
 
 	u32 first_scanline;
+	/*last scanline+1 of the current outline*/
+	u32 last_scanline;
 
 	GF_Matrix2D *mx;
+
+	/*band-parallel sweep: band 0 is processed by the calling thread, other bands by worker threads*/
+	EVG_RasterBand *bands;
+	u32 nb_bands;
+	GF_Semaphore *bands_done;
+	Bool bands_exit, zero_non_zero_rule;
 } TRaster;
 
+struct _evg_raster_band
+{
+	TRaster *parent;
+	GF_Thread *th;
+	GF_Semaphore *start;
+	/*first and last+1 scanlines of the band, relative to min_ey*/
+	u32 first_line, last_line;
+	/*span accumulation state of the band, only the span fields are used*/
+	TRaster sweep;
+};
+
+GF_Err evg_raster_set_threads(EVG_Raster raster, u32 nb_threads);
+/*cost of a scanline for band splitting is its number of cells plus EVG_BAND_ROW_WEIGHT for the span fill
+below EVG_BAND_MIN_WEIGHT for the whole outline, the cost of waking up the workers is higher than the sweep*/
+#define EVG_BAND_ROW_WEIGHT	8
+#define EVG_BAND_MIN_WEIGHT	4096
+//maximum number of band worker threads, also limited by the number of cores
+#define EVG_MAX_BAND_THREADS	64
+
 void gray_record_cell( TRaster *raster );
 void gray_set_cell( TRaster *raster, TCoord  ex, TCoord  ey );
 void gray_render_line(TRaster *raster, TPos  to_x, TPos  to_y);
@@ -26,18 +26,6 @@
 
 #include "rast_soft.h"
 
-
-
-#if defined(WIN32) && !defined(__GNUC__)
-# include <intrin.h>
-# define GPAC_HAS_SSE2
-#else
-# ifdef __SSE2__
-#  include <emmintrin.h>
-#  define GPAC_HAS_SSE2
-# endif
-#endif
-
 #ifdef GPAC_HAS_SSE2
 
 static Float float_clamp(Float val, Float minval, Float maxval)
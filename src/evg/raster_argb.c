@@ -160,6 +160,52 @@ GFINLINE static void overmask_argb(u32 src, u8 *dst, u32 alpha, GF_EVGSurface *s
 	}
 }
 
+#ifdef GPAC_HAS_SSE2
+static GFINLINE void evg_sse2_argb_shifts(GF_EVGSurface *surf, __m128i *shifts)
+{
+	shifts[0] = _mm_cvtsi32_si128(8*surf->idx_a);
+	shifts[1] = _mm_cvtsi32_si128(8*surf->idx_r);
+	shifts[2] = _mm_cvtsi32_si128(8*surf->idx_g);
+	shifts[3] = _mm_cvtsi32_si128(8*surf->idx_b);
+}
+
+/*source-over blend of 4 pixels, bit-exact with overmask_argb in GF_EVG_SRC_OVER mode
+srca, srcr, srcg and srcb hold one source component per 32-bit lane, shifts are the bit positions of a, r, g, b in a surface pixel*/
+static GFINLINE __m128i evg_sse2_argb_over(__m128i dst, __m128i srca, __m128i srcr, __m128i srcg, __m128i srcb, const __m128i *shifts)
+{
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i dsta, keep, fa, res, out;
+	__m128 f_sa, f_da, f_fa;
+
+	dsta = _mm_and_si128(_mm_srl_epi32(dst, shifts[0]), mask);
+	//empty destination or opaque source: copy source pixel
+	keep = _mm_or_si128(_mm_cmpeq_epi32(dsta, zero), _mm_cmpeq_epi32(srca, mask));
+	//final_a = dsta + srca - mul255(dsta, srca), product fits the low 16 bits of each lane
+	fa = _mm_sub_epi32(_mm_add_epi32(dsta, srca), _mm_srli_epi32(_mm_mullo_epi16(_mm_add_epi32(dsta, _mm_set1_epi32(1)), srca), 8));
+
+	//(srcc*srca + dstc*(dsta-srca)) / final_a: operands are exact in float, and the truncated quotient
+	//is exact since the float error is below 1/final_a
+	f_sa = _mm_cvtepi32_ps(srca);
+	f_da = _mm_cvtepi32_ps(_mm_sub_epi32(dsta, srca));
+	f_fa = _mm_cvtepi32_ps(fa);
+
+	out = _mm_sll_epi32(_mm_or_si128(_mm_and_si128(keep, srca), _mm_andnot_si128(keep, fa)), shifts[0]);
+
+#define EVG_SSE2_OVER_COMP(_src, _sh)	\
+	res = _mm_cvttps_epi32(_mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_src), f_sa), _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(dst, _sh), mask)), f_da)), f_fa));	\
+	res = _mm_and_si128(res, _mm_cmpgt_epi32(res, zero));	\
+	out = _mm_or_si128(out, _mm_sll_epi32(_mm_or_si128(_mm_and_si128(keep, _src), _mm_andnot_si128(keep, res)), _sh));
+
+	EVG_SSE2_OVER_COMP(srcr, shifts[1])
+	EVG_SSE2_OVER_COMP(srcg, shifts[2])
+	EVG_SSE2_OVER_COMP(srcb, shifts[3])
+#undef EVG_SSE2_OVER_COMP
+
+	return out;
+}
+#endif
+
 GFINLINE static void overmask_argb_const_run(u32 src, u8 *dst, s32 dst_pitch_x, u32 count, GF_EVGSurface *surf)
 {
 	u8 const_srca = GF_COL_A(src);
@@ -167,6 +213,35 @@ GFINLINE static void overmask_argb_const_run(u32 src, u8 *dst, s32 dst_pitch_x,
 	s32 srcg = GF_COL_G(src);
 	s32 srcb = GF_COL_B(src);
 
+	if (!surf->comp_mode && (dst_pitch_x==4)) {
+		//opaque source over: plain pixel copy
+		if (const_srca==0xFF) {
+			u32 pix = ((u32) 0xFF << (8*surf->idx_a)) | ((u32) srcr << (8*surf->idx_r)) | ((u32) srcg << (8*surf->idx_g)) | ((u32) srcb << (8*surf->idx_b));
+			while (count) {
+				*(u32 *)dst = pix;
+				dst += 4;
+				count--;
+			}
+			return;
+		}
+#ifdef GPAC_HAS_SSE2
+		if (count>=4) {
+			__m128i shifts[4];
+			__m128i v_a = _mm_set1_epi32(const_srca);
+			__m128i v_r = _mm_set1_epi32(srcr);
+			__m128i v_g = _mm_set1_epi32(srcg);
+			__m128i v_b = _mm_set1_epi32(srcb);
+			evg_sse2_argb_shifts(surf, shifts);
+			while (count>=4) {
+				__m128i d = _mm_loadu_si128((__m128i *) dst);
+				_mm_storeu_si128((__m128i *) dst, evg_sse2_argb_over(d, v_a, v_r, v_g, v_b, shifts));
+				dst += 16;
+				count -= 4;
+			}
+		}
+#endif
+	}
+
 	while (count) {
 		s32 srca = const_srca;
 		s32 dsta = dst[surf->idx_a];
@@ -290,6 +365,27 @@ void evg_argb_fill_var(s32 y, s32 count, EVG_Span *spans, GF_EVGSurface *surf)
 		spanalpha = spans[i].coverage;
 		evg_fill_run(surf->sten, surf, spans[i].x, y, len);
 		col = surf->stencil_pix_run;
+#ifdef GPAC_HAS_SSE2
+		if (!surf->comp_mode && (surf->pitch_x==4) && (len>=4)) {
+			__m128i shifts[4];
+			const __m128i mask = _mm_set1_epi32(0xFF);
+			__m128i v_span_a = _mm_set1_epi32(spanalpha);
+			evg_sse2_argb_shifts(surf, shifts);
+			while (len>=4) {
+				__m128i c = _mm_loadu_si128((__m128i *) col);
+				__m128i d = _mm_loadu_si128((__m128i *) p);
+				//srca = mul255(col_a, spanalpha)
+				__m128i v_a = _mm_srli_epi32(_mm_mullo_epi16(_mm_add_epi32(_mm_srli_epi32(c, 24), _mm_set1_epi32(1)), v_span_a), 8);
+				__m128i v_r = _mm_and_si128(_mm_srli_epi32(c, 16), mask);
+				__m128i v_g = _mm_and_si128(_mm_srli_epi32(c, 8), mask);
+				__m128i v_b = _mm_and_si128(c, mask);
+				_mm_storeu_si128((__m128i *) p, evg_sse2_argb_over(d, v_a, v_r, v_g, v_b, shifts));
+				col += 4;
+				p += 16;
+				len -= 4;
+			}
+		}
+#endif
 		while (len--) {
 			//we must blend in all cases since we have to merge with the dst alpha
 			overmask_argb(*col, p, spanalpha, surf);
@@ -391,6 +487,21 @@ GFINLINE static void overmask_rgbx_const_run(u32 src, u8 *dst, s32 dst_pitch_x,
 	u32 srcr = mul255(srca, ((src >> 16) & 0xff)) ;
 	u32 srcg = mul255(srca, ((src >> 8) & 0xff)) ;
 	u32 srcb = mul255(srca, ((src) & 0xff)) ;
+#ifdef GPAC_HAS_SSE2
+	if ((dst_pitch_x==4) && (count>=4)) {
+		//blend all bytes, the X byte is restored from dst
+		__m128i v_a1 = _mm_set1_epi16(srca+1);
+		__m128i v_src = _mm_set1_epi32( (srcr << (8*surf->idx_r)) | (srcg << (8*surf->idx_g)) | (srcb << (8*surf->idx_b)) );
+		__m128i v_x = _mm_set1_epi32(0xFF << (8*surf->idx_a));
+		while (count>=4) {
+			__m128i d = _mm_loadu_si128((__m128i *) dst);
+			__m128i res = evg_sse2_blend_u8(d, v_src, v_a1, v_a1);
+			_mm_storeu_si128((__m128i *) dst, _mm_or_si128(_mm_and_si128(v_x, d), _mm_andnot_si128(v_x, res)));
+			dst += 16;
+			count -= 4;
+		}
+	}
+#endif
 	while (count) {
 		u32 dstc;
 		dstc = dst[surf->idx_r];
@@ -500,7 +611,41 @@ void evg_rgbx_fill_var(s32 y, s32 count, EVG_Span *spans, GF_EVGSurface *surf)
 		evg_fill_run(surf->sten, surf, spans[i].x, y, len);
 		col = surf->stencil_pix_run;
 		x = spans[i].x * surf->pitch_x;
-		
+
+#ifdef GPAC_HAS_SSE2
+		if ((surf->pitch_x==4) && (len>=4)) {
+			const __m128i mask = _mm_set1_epi32(0xFF);
+			const __m128i zero = _mm_setzero_si128();
+			__m128i v_span_a = _mm_set1_epi32(spanalpha);
+			__m128i v_x = _mm_set1_epi32(0xFF << (8*surf->idx_a));
+			__m128i sh_r = _mm_cvtsi32_si128(8*surf->idx_r);
+			__m128i sh_g = _mm_cvtsi32_si128(8*surf->idx_g);
+			__m128i sh_b = _mm_cvtsi32_si128(8*surf->idx_b);
+			while (len>=4) {
+				__m128i c = _mm_loadu_si128((__m128i *) col);
+				__m128i d = _mm_loadu_si128((__m128i *) (dst+x));
+				__m128i c_a = _mm_srli_epi32(c, 24);
+				//a1 = mul255(col_a, spanalpha) + 1, spread on the 4 16-bit lanes of each pixel
+				__m128i a1 = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(_mm_add_epi32(c_a, _mm_set1_epi32(1)), v_span_a), 8), _mm_set1_epi32(1));
+				__m128i a1_lo = _mm_unpacklo_epi32(a1, a1);
+				__m128i a1_hi = _mm_unpackhi_epi32(a1, a1);
+				__m128i src = _mm_or_si128(_mm_or_si128(
+					_mm_sll_epi32(_mm_and_si128(_mm_srli_epi32(c, 16), mask), sh_r),
+					_mm_sll_epi32(_mm_and_si128(_mm_srli_epi32(c, 8), mask), sh_g)),
+					_mm_sll_epi32(_mm_and_si128(c, mask), sh_b));
+				//transparent source pixels and X byte are left untouched
+				__m128i keep = _mm_or_si128(_mm_cmpeq_epi32(c_a, zero), v_x);
+				__m128i res;
+				a1_lo = _mm_or_si128(a1_lo, _mm_slli_epi32(a1_lo, 16));
+				a1_hi = _mm_or_si128(a1_hi, _mm_slli_epi32(a1_hi, 16));
+				res = evg_sse2_blend_u8(d, src, a1_lo, a1_hi);
+				_mm_storeu_si128((__m128i *) (dst+x), _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, res)));
+				col += 4;
+				x += 16;
+				len -= 4;
+			}
+		}
+#endif
 		while (len--) {
 			_col = *col;
 			col_a = GF_COL_A(_col);
@@ -270,6 +270,18 @@ static void overmask_yuv420p(u8 col_a, u8 cy, char *dst, u32 alpha)
 
 static void overmask_yuv420p_const_run(u8 a, u8 val, u8 *ptr, u32 count, short x)
 {
+#ifdef GPAC_HAS_SSE2
+	if (count>=16) {
+		__m128i v_a1 = _mm_set1_epi16(a+1);
+		__m128i v_val = _mm_set1_epi8(val);
+		while (count>=16) {
+			__m128i d = _mm_loadu_si128((__m128i *) ptr);
+			_mm_storeu_si128((__m128i *) ptr, evg_sse2_blend_u8(d, v_val, v_a1, v_a1));
+			ptr += 16;
+			count -= 16;
+		}
+	}
+#endif
 	while (count) {
 		u8 dst = *(ptr);
 		*ptr = (u8) mul255(a, val - dst) + dst;
@@ -277,6 +289,59 @@ static void overmask_yuv420p_const_run(u8 a, u8 val, u8 *ptr, u32 count, short x
 		count--;
 	}
 }
+#ifdef GPAC_HAS_SSE2
+/*blends constant chroma for 8 chroma samples per iteration, using the average coverage of the 2x2 (odd_alpha set) or 2x1 luma samples
+if pV is NULL, pU points to interleaved UV samples
+returns the number of luma samples processed*/
+static u32 evg_sse2_flush_uv_const(u8 *even_alpha, u8 *odd_alpha, u32 width, u8 *pU, u8 *pV, s32 cu, s32 cv)
+{
+	u32 i;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo_mask = _mm_set1_epi16(0xFF);
+	const __m128i one = _mm_set1_epi16(1);
+	__m128i v_cu = _mm_set1_epi16(cu);
+	__m128i v_cv = _mm_set1_epi16(cv);
+	__m128i v_cuv = _mm_unpacklo_epi16(v_cu, v_cv);
+
+	for (i=0; i+16<=width; i+=16) {
+		__m128i al, a, keep, d;
+		al = _mm_loadu_si128((__m128i *) (even_alpha+i));
+		a = _mm_add_epi16(_mm_and_si128(al, lo_mask), _mm_srli_epi16(al, 8));
+		if (odd_alpha) {
+			al = _mm_loadu_si128((__m128i *) (odd_alpha+i));
+			a = _mm_add_epi16(a, _mm_add_epi16(_mm_and_si128(al, lo_mask), _mm_srli_epi16(al, 8)));
+		}
+		//a sum of 0 leaves the chroma untouched
+		keep = _mm_cmpeq_epi16(a, zero);
+		if (_mm_movemask_epi8(keep) == 0xFFFF) continue;
+		a = _mm_add_epi16(_mm_srli_epi16(a, odd_alpha ? 2 : 1), one);
+
+		if (pV) {
+			d = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i *) (pU + i/2)), zero);
+			d = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, evg_sse2_mul255_add(a, _mm_sub_epi16(v_cu, d), d)));
+			_mm_storel_epi64((__m128i *) (pU + i/2), _mm_packus_epi16(d, zero));
+
+			d = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i *) (pV + i/2)), zero);
+			d = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, evg_sse2_mul255_add(a, _mm_sub_epi16(v_cv, d), d)));
+			_mm_storel_epi64((__m128i *) (pV + i/2), _mm_packus_epi16(d, zero));
+		} else {
+			__m128i d_lo, d_hi, a_lo, a_hi, k_lo, k_hi;
+			d = _mm_loadu_si128((__m128i *) (pU + i));
+			d_lo = _mm_unpacklo_epi8(d, zero);
+			d_hi = _mm_unpackhi_epi8(d, zero);
+			a_lo = _mm_unpacklo_epi16(a, a);
+			a_hi = _mm_unpackhi_epi16(a, a);
+			k_lo = _mm_unpacklo_epi16(keep, keep);
+			k_hi = _mm_unpackhi_epi16(keep, keep);
+			d_lo = _mm_or_si128(_mm_and_si128(k_lo, d_lo), _mm_andnot_si128(k_lo, evg_sse2_mul255_add(a_lo, _mm_sub_epi16(v_cuv, d_lo), d_lo)));
+			d_hi = _mm_or_si128(_mm_and_si128(k_hi, d_hi), _mm_andnot_si128(k_hi, evg_sse2_mul255_add(a_hi, _mm_sub_epi16(v_cuv, d_hi), d_hi)));
+			_mm_storeu_si128((__m128i *) (pU + i), _mm_packus_epi16(d_lo, d_hi));
+		}
+	}
+	return i;
+}
+#endif
+
 void evg_yuv420p_flush_uv_const(GF_EVGSurface *surf, u8 *surf_uv_alpha, s32 cu, s32 cv, s32 y)
 {
 	u32 i, a;
@@ -285,8 +350,12 @@ void evg_yuv420p_flush_uv_const(GF_EVGSurface *surf, u8 *surf_uv_alpha, s32 cu,
 	pU +=  y/2 * surf->pitch_y/2;
 	pV = pU + surf->height/2 * surf->pitch_y/2;
 
+	i = 0;
+#ifdef GPAC_HAS_SSE2
+	i = evg_sse2_flush_uv_const(surf->uv_alpha, surf_uv_alpha, surf->width, (u8 *) pU, (u8 *) pV, cu, cv);
+#endif
 	//we are at an odd line, write uv
-	for (i=0; i<surf->width; i+=2) {
+	for (; i<surf->width; i+=2) {
 		u8 dst;
 
 		//even line
@@ -602,7 +671,11 @@ void evg_nv12_flush_uv_const(GF_EVGSurface *surf, u8 *surf_uv_alpha, s32 cu, s32
 	char *pU = surf->pixels + surf->height *surf->pitch_y;
 	pU +=  y/2 * surf->pitch_y;
 
-	for (i=0; i<surf->width; i+=2) {
+	i = 0;
+#ifdef GPAC_HAS_SSE2
+	i = evg_sse2_flush_uv_const(surf->uv_alpha, surf_uv_alpha, surf->width, (u8 *) pU, NULL, cu, cv);
+#endif
+	for (; i<surf->width; i+=2) {
 		u8 dst;
 
 		//even line
@@ -766,7 +839,11 @@ void evg_yuv422p_flush_uv_const(GF_EVGSurface *surf, u8 *surf_uv_alpha, s32 cu,
 	pU +=  y * surf->pitch_y/2;
 	pV = pU + surf->height * surf->pitch_y/2;
 
-	for (i=0; i<surf->width; i+=2) {
+	i = 0;
+#ifdef GPAC_HAS_SSE2
+	i = evg_sse2_flush_uv_const(surf->uv_alpha, NULL, surf->width, (u8 *) pU, (u8 *) pV, cu, cv);
+#endif
+	for (; i<surf->width; i+=2) {
 		u8 dst;
 
 		a = surf->uv_alpha[i] + surf->uv_alpha[i+1];
@@ -1334,6 +1411,23 @@ static void overmask_yuv420p_10(u16 col_a, u16 cy, u16 *dst, u32 alpha)
 
 static void overmask_yuv420p_10_const_run(u16 a, u16 val, u16 *ptr, u32 count, short x)
 {
+#ifdef GPAC_HAS_SSE2
+	if (count>=8) {
+		//(a1 * diff) >> 16 is the high word of the product, mulhi treats a1 as signed so add back diff when a1 >= 0x8000
+		u32 a1 = (u32) a + 1;
+		__m128i v_a1 = _mm_set1_epi16((s16) a1);
+		__m128i v_val = _mm_set1_epi16(val);
+		while (count>=8) {
+			__m128i d = _mm_loadu_si128((__m128i *) ptr);
+			__m128i diff = _mm_sub_epi16(v_val, d);
+			__m128i res = _mm_mulhi_epi16(v_a1, diff);
+			if (a1 & 0x8000) res = _mm_add_epi16(res, diff);
+			_mm_storeu_si128((__m128i *) ptr, _mm_add_epi16(res, d));
+			ptr += 8;
+			count -= 8;
+		}
+	}
+#endif
 	while (count) {
 		u16 dst;
 		get_u16_le(dst, ptr);
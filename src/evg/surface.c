@@ -452,6 +452,12 @@ GF_Err gf_evg_surface_set_raster_level(GF_EVGSurface *surf, GF_RasterQuality Ras
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_evg_surface_set_threads(GF_EVGSurface *surf, u32 nb_threads)
+{
+	if (!surf || !surf->raster) return GF_BAD_PARAM;
+	return evg_raster_set_threads(surf->raster, nb_threads);
+}
 
 GF_EXPORT
 GF_Err gf_evg_surface_set_clipper(GF_EVGSurface *surf , GF_IRect *rc)
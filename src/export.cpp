@@ -286,6 +286,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_bind) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_connect) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_send) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_ex) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_listen) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_accept) )
@@ -299,7 +300,18 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_wait) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_no_select) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_send_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_receive_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_enable_gso) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sk_set_usec_wait) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_pacer_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_pacer_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_pacer_set_rate) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_pacer_send) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_pacer_get_delay) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_pacer_get_free) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_pacer_flush) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_sk_pacer_get_stats) )
 
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_is_local) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_url_get_absolute_path) )
@@ -1164,6 +1176,10 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_send_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_get_payload_type) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_set_interleave_callbacks) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_set_packet_callback) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_enable_send_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_set_pacer) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_streamer_flush) )
 
 #endif
 
@@ -1274,6 +1290,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtsp_get_remote_address) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtsp_get_session_port) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtsp_session_write_interleaved) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtsp_session_set_interleave_queue) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtsp_session_flush_interleave_queue) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtsp_http_tunnel_start) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_del) )
@@ -1287,12 +1305,16 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_current_time) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reset_buffers) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_read_rtp) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_enable_read_batch) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_read_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_decode_rtp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_decode_rtcp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_rtcp_report) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_bye) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_send_packet) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_enable_send_batch) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_set_pacer) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_flush_send) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_is_unicast) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_is_interleaved) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_get_clockrate) )
@@ -2008,6 +2030,7 @@
 /* M3U8 & MPD related functions */
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_init_from_dom) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_mpd_init_from_file) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_m3u8_to_mpd) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mpd_smooth_to_mpd) )
@@ -174,6 +174,11 @@ GF_Filter *gf_filter_new(GF_FilterSession *fsess, const GF_FilterRegister *freg,
 	filter->bundle_idx_at_resolution = -1;
 	filter->cap_idx_at_resolution = -1;
 
+	if (fsess->trace_pck) {
+		GF_SAFEALLOC(filter->trace_task, GF_FSTraceHisto);
+		GF_SAFEALLOC(filter->trace_send, GF_FSTraceHisto);
+	}
+
 	if (fsess->filters_mx) gf_mx_p(fsess->filters_mx);
 	gf_list_add(fsess->filters, filter);
 	if (fsess->filters_mx) gf_mx_v(fsess->filters_mx);
@@ -405,6 +410,9 @@ void gf_filter_del(GF_Filter *filter)
 	gf_fq_del(filter->pending_pids, NULL);
 
 	reset_filter_args(filter);
+	if (filter->trace_task) gf_free(filter->trace_task);
+	if (filter->trace_send) gf_free(filter->trace_send);
+	if (filter->prof_id) gf_fs_prof_filter_done(filter->session, filter);
 	if (filter->src_args) gf_free(filter->src_args);
 
 	if (filter->pcks_shared_reservoir)
@@ -413,6 +421,8 @@ void gf_filter_del(GF_Filter *filter)
 		gf_fq_del(filter->pcks_inst_reservoir, gf_void_del);
 	if (filter->pcks_alloc_reservoir)
 		gf_fq_del(filter->pcks_alloc_reservoir, gf_filterpacket_del);
+	if (filter->frame_views_reservoir)
+		gf_fq_del(filter->frame_views_reservoir, gf_void_del);
 
 	gf_mx_del(filter->pcks_mx);
 	if (filter->tasks_mx)
@@ -2060,6 +2070,7 @@ static void gf_filter_process_task(GF_FSTask *task)
 	task->can_swap = GF_TRUE;
 
 	filter->schedule_next_time = 0;
+	filter->deadline = 0;
 
 	if (filter->disabled) {
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Filter %s is disabled, cancelling process\n", filter->name));
@@ -2406,6 +2417,18 @@ void gf_filter_ask_rt_reschedule(GF_Filter *filter, u32 us_until_next)
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_SCHEDULER, ("Filter %s real-time reschedule in %d us (at "LLU" sys clock)\n", filter->name, us_until_next, filter->schedule_next_time));
 }
 
+GF_EXPORT
+void gf_filter_set_latency_budget(GF_Filter *filter, u32 budget_us)
+{
+	if (filter) filter->latency_budget = budget_us;
+}
+
+GF_EXPORT
+void gf_filter_set_deadline(GF_Filter *filter, u64 deadline_us)
+{
+	if (filter) filter->deadline = deadline_us;
+}
+
 GF_EXPORT
 void gf_filter_set_setup_failure_callback(GF_Filter *filter, GF_Filter *source_filter, void (*on_setup_error)(GF_Filter *f, void *on_setup_error_udta, GF_Err e), void *udta)
 {
@@ -34,6 +34,8 @@ static void gf_filter_pck_reset_props(GF_FilterPacket *pck, GF_FilterPid *pid)
 	pck->pid = pid;
 	pck->src_filter = pid->filter;
 	pck->session = pid->filter->session;
+	if (pck->session->trace_pck)
+		pck->trace_create_us = gf_sys_clock_high_res();
 }
 
 GF_EXPORT
@@ -383,6 +385,88 @@ GF_FilterPacket *gf_filter_pck_new_frame_interface(GF_FilterPid *pid, GF_FilterF
 	return pck;
 }
 
+//frame view: frame interface exposing planes located in the memory of a source packet
+typedef struct
+{
+	GF_FilterFrameInterface frame_ifce;
+	//reference to the source packet, released with the view
+	GF_FilterPacket *source;
+	u8 *planes[4];
+	u32 strides[4];
+	u32 nb_planes;
+} GF_FilterFrameView;
+
+static GF_Err frame_view_get_plane(GF_FilterFrameInterface *frame, u32 plane_idx, const u8 **outPlane, u32 *outStride)
+{
+	GF_FilterFrameView *view = frame->user_data;
+	if (plane_idx >= view->nb_planes) return GF_BAD_PARAM;
+	if (outPlane) *outPlane = view->planes[plane_idx];
+	if (outStride) *outStride = view->strides[plane_idx];
+	return GF_OK;
+}
+
+static void frame_view_destruct(GF_Filter *filter, GF_FilterPid *pid, GF_FilterPacket *pck)
+{
+	GF_FilterFrameView *view = pck->frame_ifce ? pck->frame_ifce->user_data : NULL;
+	if (!view) return;
+	gf_filter_pck_unref(view->source);
+	view->source = NULL;
+	//this may be called by any thread releasing the last reference, use the filter lock-free queue
+	if (filter && filter->frame_views_reservoir)
+		gf_fq_add(filter->frame_views_reservoir, view);
+	else
+		gf_free(view);
+}
+
+static Bool gf_filter_pck_is_frame_view(GF_FilterPacket *pck)
+{
+	return (pck->frame_ifce && (pck->frame_ifce->get_plane == frame_view_get_plane)) ? GF_TRUE : GF_FALSE;
+}
+
+GF_EXPORT
+GF_FilterPacket *gf_filter_pck_new_frame_view(GF_FilterPid *pid, GF_FilterPacket *source, u32 nb_planes, u8 **planes, u32 *strides)
+{
+	u32 i;
+	GF_FilterPacket *pck;
+	GF_FilterFrameView *view;
+	if (!pid || !source || !planes || !strides || !nb_planes || (nb_planes>4)) return NULL;
+	if (PID_IS_INPUT(pid)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Attempt to allocate a frame view on an input PID in filter %s\n", pid->filter->name));
+		return NULL;
+	}
+	//only created and popped by the filter owning the PID
+	if (!pid->filter->frame_views_reservoir) {
+		pid->filter->frame_views_reservoir = gf_fq_new(pid->filter->pcks_mx);
+		if (!pid->filter->frame_views_reservoir) return NULL;
+	}
+	view = gf_fq_pop(pid->filter->frame_views_reservoir);
+	if (!view) {
+		GF_SAFEALLOC(view, GF_FilterFrameView);
+		if (!view) return NULL;
+	}
+	memset(view, 0, sizeof(GF_FilterFrameView));
+	view->frame_ifce.user_data = view;
+	view->frame_ifce.get_plane = frame_view_get_plane;
+	//sinks must not hold views on blocking frames any longer than they would hold the source
+	if (gf_filter_pck_is_blocking_ref(source))
+		view->frame_ifce.flags = GF_FRAME_IFCE_BLOCKING;
+	view->nb_planes = nb_planes;
+	for (i=0; i<nb_planes; i++) {
+		view->planes[i] = planes[i];
+		view->strides[i] = strides[i];
+	}
+
+	pck = gf_filter_pck_new_frame_interface(pid, &view->frame_ifce, frame_view_destruct);
+	if (!pck) {
+		gf_fq_add(pid->filter->frame_views_reservoir, view);
+		return NULL;
+	}
+	view->source = source;
+	gf_filter_pck_ref(&view->source);
+	gf_filter_pck_merge_properties(source, pck);
+	return pck;
+}
+
 GF_EXPORT
 GF_Err gf_filter_pck_forward(GF_FilterPacket *reference, GF_FilterPid *pid)
 {
@@ -620,6 +704,10 @@ static Bool gf_filter_aggregate_packets(GF_FilterPidInst *dst)
 
 		//destroy pcki
 		if ((i+1<count) || !final) {
+			if (pcki->queued_bytes) {
+				safe_int64_sub(&dst->filter->session->buf_queued_bytes, pcki->queued_bytes);
+				pcki->queued_bytes = 0;
+			}
 			pcki->pck = NULL;
 			pcki->pid = NULL;
 
@@ -684,6 +772,7 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 	GF_FilterPid *pid;
 	s64 duration=0;
 	u32 timescale=0;
+	u64 send_time=0;
 	GF_FilterClockType cktype;
 #ifdef GPAC_MEMORY_TRACKING
 	u32 nb_allocs=0, nb_reallocs=0, prev_nb_allocs=0, prev_nb_reallocs=0;
@@ -806,7 +895,10 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 			pid->filter->nb_pck_sent++;
 			pid->filter->nb_bytes_sent += pck->data_length;
 		} else if (pck->frame_ifce) {
-			pid->filter->nb_hw_pck_sent++;
+			if (gf_filter_pck_is_frame_view(pck))
+				pid->filter->nb_view_pck_sent++;
+			else
+				pid->filter->nb_hw_pck_sent++;
 		}
 		if (pck->info.cts!=GF_FILTER_NO_TS) {
 			pid->last_ts_sent.num = pck->info.cts;
@@ -943,6 +1035,12 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 	//by its destination before we are done adding to the other destination
 	safe_int_inc(&pck->reference_count);
 
+	if (pid->filter->session->trace_pck) {
+		send_time = gf_sys_clock_high_res();
+		if (pck->trace_create_us && !(pck->info.flags & GF_PCK_CMD_MASK))
+			gf_fs_trace_histo_add(pid->filter->trace_send, send_time - pck->trace_create_us);
+	}
+
 	assert(pck->pid);
 	count = pck->pid->num_destinations;
 	for (i=0; i<count; i++) {
@@ -980,6 +1078,11 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 			continue;
 		}
 
+		//make sure the packet queue can take this instance and all packets pending reaggregation
+		//before any accounting is done, so that an accounted packet instance is never lost
+		if (!gf_fq_reserve(dst->packets, 1 + gf_list_count(dst->pck_reassembly)))
+			return GF_OUT_OF_MEM;
+
 		inst = gf_fq_pop(pck->pid->filter->pcks_inst_reservoir);
 		if (!inst) {
 			GF_SAFEALLOC(inst, GF_FilterPacketInstance);
@@ -989,6 +1092,9 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 		inst->pid = dst;
 		inst->pid_props_change_done = 0;
 		inst->pid_info_change_done = 0;
+		inst->trace_send_us = send_time;
+		inst->trace_fetch_us = 0;
+		inst->queued_bytes = 0;
 		//if packet is an openGL interface, force scheduling on main thread for the destination
 		if (pck->frame_ifce&&pck->frame_ifce->get_gl_texture)
 			dst->filter->main_thread_forced = GF_TRUE;
@@ -1004,6 +1110,12 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 		safe_int_inc(&pck->reference_count);
 		nb_dispatch++;
 
+		//account packet size in session memory budget, removed when packet instance is dropped
+		if (pid->filter->session->buf_tune && pck->data_length) {
+			inst->queued_bytes = pck->data_length;
+			safe_int64_add(&pid->filter->session->buf_queued_bytes, inst->queued_bytes);
+		}
+
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Dispatching packet from filter %s to filter %s - %d packet in PID %s buffer ("LLU" us buffer)\n", pid->filter->name, dst->filter->name, gf_fq_count(dst->packets), pid->name, dst->buffer_duration ));
 
 		if (cktype) {
@@ -1125,7 +1237,9 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 			gf_fq_add(dst->packets, inst);
 			post_task = GF_TRUE;
 		}
-		if (post_task) {
+		if (post_task && pid->in_batch_send) {
+			dst->batch_post_pending = GF_TRUE;
+		} else if (post_task) {
 
 			//make sure we lock the tasks mutex before getting the packet count, otherwise we might end up with a wrong number of packets
 			//if one thread consumes one packet while the dispatching thread  (the caller here) is still upddating the state for that pid
@@ -1150,7 +1264,8 @@ GF_Err gf_filter_pck_send_internal(GF_FilterPacket *pck, Bool from_filter)
 	}
 #endif
 
-	gf_filter_pid_would_block(pid);
+	if (!pid->in_batch_send)
+		gf_filter_pid_would_block(pid);
 
 	//unprotect the packet now that it is safely dispatched
 	assert(pck->reference_count);
@@ -1175,6 +1290,56 @@ GF_Err gf_filter_pck_send(GF_FilterPacket *pck)
 	return gf_filter_pck_send_internal(pck, GF_TRUE);
 }
 
+static void gf_filter_pck_batch_flush(GF_FilterPid *pid)
+{
+	u32 i;
+	pid->in_batch_send = GF_FALSE;
+
+	//update buffer occupancy and post process task once per destination
+	for (i=0; i<pid->num_destinations; i++) {
+		u32 nb_pck;
+		GF_FilterPidInst *dst = gf_list_get(pid->destinations, i);
+		if (!dst->batch_post_pending) continue;
+		dst->batch_post_pending = GF_FALSE;
+
+		gf_mx_p(pid->filter->tasks_mx);
+		nb_pck = gf_fq_count(dst->packets);
+		if (pid->nb_buffer_unit < nb_pck) pid->nb_buffer_unit = nb_pck;
+		if ((s64) pid->buffer_duration < dst->buffer_duration) pid->buffer_duration = dst->buffer_duration;
+		gf_mx_v(pid->filter->tasks_mx);
+
+		gf_filter_post_process_task_internal(dst->filter, pid->direct_dispatch);
+	}
+	gf_filter_pid_would_block(pid);
+}
+
+GF_EXPORT
+GF_Err gf_filter_pck_send_batch(GF_FilterPacket **pcks, u32 nb_pcks)
+{
+	u32 i;
+	GF_Err e = GF_OK;
+	GF_FilterPid *pid = NULL;
+	if (!pcks) return GF_BAD_PARAM;
+
+	for (i=0; i<nb_pcks; i++) {
+		GF_Err res;
+		GF_FilterPacket *pck = pcks[i];
+		assert(pck->pid);
+		//new run of packets on a different pid, flush previous one
+		if (pid != pck->pid) {
+			if (pid) gf_filter_pck_batch_flush(pid);
+			pid = pck->pid;
+			//direct dispatch runs the destination from within the post, no need to batch
+			if (!pid->direct_dispatch)
+				pid->in_batch_send = GF_TRUE;
+		}
+		res = gf_filter_pck_send_internal(pck, GF_TRUE);
+		if (res && (res != GF_PENDING_PACKET) && !e) e = res;
+	}
+	if (pid) gf_filter_pck_batch_flush(pid);
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_filter_pck_ref(GF_FilterPacket **pck)
 {
@@ -25,9 +25,15 @@
 
 #include "filter_session.h"
 #include <gpac/constants.h>
+#include <gpac/bitstream.h>
+#include <gpac/version.h>
 
 void pcki_del(GF_FilterPacketInstance *pcki)
 {
+	if (pcki->queued_bytes && pcki->pid && pcki->pid->filter) {
+		safe_int64_sub(&pcki->pid->filter->session->buf_queued_bytes, pcki->queued_bytes);
+		pcki->queued_bytes = 0;
+	}
 	assert(pcki->pck->reference_count);
 	if (safe_int_dec(&pcki->pck->reference_count) == 0) {
 		gf_filter_packet_destroy(pcki->pck);
@@ -57,6 +63,8 @@ void gf_filter_pid_inst_del(GF_FilterPidInst *pidinst)
  	gf_fq_del(pidinst->packets, (gf_destruct_fun) pcki_del);
 	gf_mx_del(pidinst->pck_mx);
 	gf_list_del(pidinst->pck_reassembly);
+	if (pidinst->trace_wait) gf_free(pidinst->trace_wait);
+	if (pidinst->trace_hold) gf_free(pidinst->trace_hold);
 	if (pidinst->props) {
 		assert(pidinst->props->reference_count);
 		if (safe_int_dec(&pidinst->props->reference_count) == 0) {
@@ -86,13 +94,135 @@ static GF_FilterPidInst *gf_filter_pid_inst_new(GF_Filter *filter, GF_FilterPid
 		pidinst->pck_mx = gf_mx_new(szName);
 	}
 
-	pidinst->packets = gf_fq_new(pidinst->pck_mx);
+	//each destination has its own packet queue, fed by the source filter and consumed by the destination filter
+	//the lock-free SPSC ring is only used when all accesses happen on the session thread: no worker threads (PID instance swap,
+	//disconnect and reset then run in sequence with the producer and consumer), and no consumer pulling packets from its own threads
+	if (!pidinst->pck_mx && !filter->session->threads
+		&& !(filter->freg->flags & (GF_FS_REG_MAIN_THREAD|GF_FS_REG_ASYNC_PULL))
+	) {
+		pidinst->packets = gf_fq_new_spsc();
+	} else {
+		pidinst->packets = gf_fq_new(pidinst->pck_mx);
+	}
 
 	pidinst->pck_reassembly = gf_list_new();
 	pidinst->last_block_ended = GF_TRUE;
+
+	//allocated here rather than on first sample, stats may be read by the session (-stats) while the consumer updates them
+	if (filter->session->trace_pck) {
+		GF_SAFEALLOC(pidinst->trace_wait, GF_FSTraceHisto);
+		GF_SAFEALLOC(pidinst->trace_hold, GF_FSTraceHisto);
+	}
 	return pidinst;
 }
 
+//buffer auto-tuning: max scaling factor of PID buffer limits
+#define GF_FS_BUF_TUNE_MAX_SCALE	16
+//buffer auto-tuning: duration in us of a tuning window, limits are decreased if not increased during a window
+#define GF_FS_BUF_TUNE_WINDOW	1000000
+
+//check if buffer limits of the PID can be tuned, and store limits before tuning on first call
+static Bool gf_filter_pid_tune_check(GF_FilterPid *pid)
+{
+	if (!pid->filter->session->buf_tune) return GF_FALSE;
+	//explicit buffer requests (filter option, buffer event) are never modified
+	if (pid->user_max_buffer_time) return GF_FALSE;
+	if (!pid->tune_base_unit && !pid->tune_base_time) {
+		if (!pid->max_buffer_unit && !pid->max_buffer_time) return GF_FALSE;
+		pid->tune_base_unit = pid->max_buffer_unit;
+		pid->tune_base_time = pid->max_buffer_time;
+		pid->tune_window_start = gf_sys_clock_high_res();
+		pid->tune_nb_grow = 0;
+	}
+	return GF_TRUE;
+}
+
+//check if a tuned PID is above its limits before tuning while the session is over memory budget
+static Bool gf_filter_pid_tune_over_budget(GF_FilterPid *pid)
+{
+	GF_FilterSession *fsess = pid->filter->session;
+	if (!fsess->buf_budget || (fsess->buf_queued_bytes <= (s64) fsess->buf_budget))
+		return GF_FALSE;
+	if (pid->tune_base_unit)
+		return (pid->nb_buffer_unit >= pid->tune_base_unit) ? GF_TRUE : GF_FALSE;
+	if (pid->tune_base_time)
+		return (pid->buffer_duration >= pid->tune_base_time) ? GF_TRUE : GF_FALSE;
+	return GF_FALSE;
+}
+
+//called when the PID gets blocked: decrease the limits toward the limits before tuning if they were not increased during the last tuning window
+static void gf_filter_pid_tune_shrink(GF_FilterPid *pid, u64 now)
+{
+	if (!pid->tune_base_unit && !pid->tune_base_time) return;
+	if (now < pid->tune_window_start + GF_FS_BUF_TUNE_WINDOW) return;
+
+	if (!pid->tune_nb_grow) {
+		if (pid->tune_base_unit) {
+			if (pid->max_buffer_unit > pid->tune_base_unit) {
+				pid->max_buffer_unit -= MAX(1, pid->max_buffer_unit/4);
+				if (pid->max_buffer_unit < pid->tune_base_unit) pid->max_buffer_unit = pid->tune_base_unit;
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Filter %s PID %s buffer decreased to %d units\n", pid->filter->name, pid->name, pid->max_buffer_unit));
+			}
+		} else if (pid->max_buffer_time > pid->tune_base_time) {
+			pid->max_buffer_time -= pid->max_buffer_time/4;
+			if (pid->max_buffer_time < pid->tune_base_time) pid->max_buffer_time = pid->tune_base_time;
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Filter %s PID %s buffer decreased to "LLU" us\n", pid->filter->name, pid->name, pid->max_buffer_time));
+		}
+	}
+	pid->tune_nb_grow = 0;
+	pid->tune_window_start = now;
+}
+
+static void gf_filter_pid_check_unblock(GF_FilterPid *pid);
+
+//double the buffer limits of the PID, up to GF_FS_BUF_TUNE_MAX_SCALE times the limits before tuning
+static void gf_filter_pid_tune_grow(GF_FilterPid *pid, GF_FilterPid *starving_pid)
+{
+	if (!gf_filter_pid_tune_check(pid)) return;
+
+	if (pid->tune_base_unit) {
+		if (pid->max_buffer_unit >= GF_FS_BUF_TUNE_MAX_SCALE * pid->tune_base_unit) return;
+		pid->max_buffer_unit *= 2;
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Filter %s PID %s starving, PID %s buffer increased to %d units\n", pid->filter->name, starving_pid->name, pid->name, pid->max_buffer_unit));
+	} else {
+		if (pid->max_buffer_time >= GF_FS_BUF_TUNE_MAX_SCALE * pid->tune_base_time) return;
+		pid->max_buffer_time *= 2;
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Filter %s PID %s starving, PID %s buffer increased to "LLU" us\n", pid->filter->name, starving_pid->name, pid->name, pid->max_buffer_time));
+	}
+	pid->tune_nb_grow++;
+	if (pid->would_block)
+		gf_filter_pid_check_unblock(pid);
+}
+
+//a consumer found no packet on a PID which is not in end of stream:
+//- if the PID blocked its producer since last starvation, the consumer drained the buffer faster than the producer could refill it, increase the PID limits
+//- if other PIDs of the producer are blocked (eg demuxer feeding consumers with different rates), increase their limits so that the producer can feed the starving PID
+static void gf_filter_pid_tune_starvation(GF_FilterPid *starving_pid)
+{
+	u32 i;
+	GF_Filter *filter = starving_pid->filter;
+	GF_FilterSession *fsess = filter->session;
+
+	//do not grow if more than half of the memory budget is used
+	if (fsess->buf_budget && (2*fsess->buf_queued_bytes > (s64) fsess->buf_budget))
+		return;
+
+	//called by the consumer: limits and output PIDs of the producer are modified under the producer lock, as done when blocking/unblocking
+	gf_mx_p(filter->tasks_mx);
+	if (starving_pid->tune_last_blocks != starving_pid->nb_blocks) {
+		starving_pid->tune_last_blocks = starving_pid->nb_blocks;
+		gf_filter_pid_tune_grow(starving_pid, starving_pid);
+	}
+	if (filter->would_block) {
+		for (i=0; i<filter->num_output_pids; i++) {
+			GF_FilterPid *pid = gf_list_get(filter->output_pids, i);
+			if ((pid==starving_pid) || !pid->would_block || pid->has_seen_eos) continue;
+			gf_filter_pid_tune_grow(pid, starving_pid);
+		}
+	}
+	gf_mx_v(filter->tasks_mx);
+}
+
 static void gf_filter_pid_check_unblock(GF_FilterPid *pid)
 {
 	Bool unblock;
@@ -120,11 +250,17 @@ static void gf_filter_pid_check_unblock(GF_FilterPid *pid)
 	} else if (pid->buffer_duration * GF_FILTER_SPEED_SCALER < pid->max_buffer_time * pid->playback_speed_scaler) {
 		unblock=GF_TRUE;
 	}
+	if (unblock && gf_filter_pid_tune_over_budget(pid))
+		unblock=GF_FALSE;
 
 	gf_mx_p(pid->filter->tasks_mx);
 	if (pid->would_block && unblock) {
 		assert(pid->would_block);
 		safe_int_dec(&pid->would_block);
+		if (pid->block_start_us) {
+			pid->block_time_us += gf_sys_clock_high_res() - pid->block_start_us;
+			pid->block_start_us = 0;
+		}
 
 		assert(pid->filter->would_block);
 		safe_int_dec(&pid->filter->would_block);
@@ -207,6 +343,9 @@ static void gf_filter_pid_update_caps(GF_FilterPid *pid)
 		pid->max_buffer_time = pid->filter->session->default_pid_buffer_max_us;
 		pid->max_buffer_unit = pid->filter->session->default_pid_buffer_max_units;
 	}
+	//limits are recomputed, restart tuning
+	pid->tune_base_unit = 0;
+	pid->tune_base_time = 0;
 	pid->raw_media = GF_FALSE;
 
 	if (codecid!=GF_CODECID_RAW) {
@@ -254,6 +393,8 @@ static void gf_filter_pid_update_caps(GF_FilterPid *pid)
 			else
 				pidi->pid->max_buffer_time = pidi->pid->filter->session->decoder_pid_buffer_max_us;
 			pidi->pid->max_buffer_unit = 0;
+			pidi->pid->tune_base_unit = 0;
+			pidi->pid->tune_base_time = 0;
 
 
 			if (mtype==GF_STREAM_VISUAL) {
@@ -493,17 +634,23 @@ void gf_filter_pid_inst_swap(GF_Filter *filter, GF_FilterPidInst *dst)
 	}
 
 	if (src) {
-		GF_FilterPacketInstance *pcki;
+		GF_FilterPacketInstance *pcki, *pckis[64];
 		while (1) {
-			pcki = gf_fq_pop(src->packets);
-			if (!pcki) break;
-			assert(src->filter->pending_packets);
-			safe_int_dec(&src->filter->pending_packets);
+			u32 i, nb_pck;
+			if (!gf_fq_reserve(dst->packets, 64)) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Filter %s failed to transfer packets during PID instance swap, out of memory\n", filter->name));
+				break;
+			}
+			nb_pck = gf_fq_pop_batch(src->packets, (void **) pckis, 64);
+			if (!nb_pck) break;
+			assert(src->filter->pending_packets >= nb_pck);
+			safe_int_sub(&src->filter->pending_packets, nb_pck);
 
-			pcki->pid = dst;
-			gf_fq_add(dst->packets, pcki);
-			safe_int_inc(&dst->filter->pending_packets);
-			nb_pck_transfer++;
+			for (i=0; i<nb_pck; i++)
+				pckis[i]->pid = dst;
+			gf_fq_add_batch(dst->packets, (void **) pckis, nb_pck);
+			safe_int_add(&dst->filter->pending_packets, nb_pck);
+			nb_pck_transfer += nb_pck;
 		}
 		if (src->requires_full_data_block && gf_list_count(src->pck_reassembly)) {
 			dst->requires_full_data_block = src->requires_full_data_block;
@@ -2482,6 +2629,339 @@ static GF_FilterRegDesc *gf_filter_reg_build_graph(GF_List *links, const GF_Filt
 	return reg_desc;
 }
 
+#define GF_GRAPH_FILE_MAGIC	GF_4CC('G','F','L','G')
+#define GF_GRAPH_FILE_VERSION	1
+//max number of graph files kept in the cache directory, oldest ones are removed when a new one is stored
+#define GF_GRAPH_FILE_MAX_FILES	4
+
+static void gf_graph_hash_prop(GF_SHA1Context *sha, const GF_PropertyValue *p)
+{
+	u32 i, count;
+	gf_sha1_update(sha, (u8 *) &p->type, sizeof(p->type));
+	switch (p->type) {
+	case GF_PROP_STRING:
+	case GF_PROP_STRING_NO_COPY:
+	case GF_PROP_NAME:
+		if (p->value.string) gf_sha1_update(sha, (u8 *) p->value.string, (u32) strlen(p->value.string)+1);
+		break;
+	case GF_PROP_DATA:
+	case GF_PROP_DATA_NO_COPY:
+	case GF_PROP_CONST_DATA:
+		if (p->value.data.ptr) gf_sha1_update(sha, p->value.data.ptr, p->value.data.size);
+		break;
+	case GF_PROP_STRING_LIST:
+		count = gf_list_count(p->value.string_list);
+		for (i=0; i<count; i++) {
+			char *str = gf_list_get(p->value.string_list, i);
+			gf_sha1_update(sha, (u8 *) str, (u32) strlen(str)+1);
+		}
+		break;
+	case GF_PROP_UINT_LIST:
+		if (p->value.uint_list.vals) gf_sha1_update(sha, (u8 *) p->value.uint_list.vals, p->value.uint_list.nb_items * sizeof(u32));
+		break;
+	case GF_PROP_POINTER:
+	case GF_PROP_FORBIDEN:
+		break;
+	case GF_PROP_SINT:
+	case GF_PROP_UINT:
+	case GF_PROP_BOOL:
+	case GF_PROP_PIXFMT:
+	case GF_PROP_PCMFMT:
+		gf_sha1_update(sha, (u8 *) &p->value.uint, sizeof(u32));
+		break;
+	case GF_PROP_LSINT:
+	case GF_PROP_LUINT:
+		gf_sha1_update(sha, (u8 *) &p->value.longuint, sizeof(u64));
+		break;
+	case GF_PROP_FRACTION:
+		gf_sha1_update(sha, (u8 *) &p->value.frac, sizeof(GF_Fraction));
+		break;
+	case GF_PROP_FRACTION64:
+		gf_sha1_update(sha, (u8 *) &p->value.lfrac, sizeof(GF_Fraction64));
+		break;
+	case GF_PROP_FLOAT:
+		gf_sha1_update(sha, (u8 *) &p->value.fnumber, sizeof(Fixed));
+		break;
+	case GF_PROP_DOUBLE:
+		gf_sha1_update(sha, (u8 *) &p->value.number, sizeof(Double));
+		break;
+	case GF_PROP_VEC2I:
+		gf_sha1_update(sha, (u8 *) &p->value.vec2i, sizeof(GF_PropVec2i));
+		break;
+	case GF_PROP_VEC2:
+		gf_sha1_update(sha, (u8 *) &p->value.vec2, sizeof(GF_PropVec2));
+		break;
+	case GF_PROP_VEC3I:
+		gf_sha1_update(sha, (u8 *) &p->value.vec3i, sizeof(GF_PropVec3i));
+		break;
+	case GF_PROP_VEC3:
+		gf_sha1_update(sha, (u8 *) &p->value.vec3, sizeof(GF_PropVec3));
+		break;
+	case GF_PROP_VEC4I:
+		gf_sha1_update(sha, (u8 *) &p->value.vec4i, sizeof(GF_PropVec4i));
+		break;
+	case GF_PROP_VEC4:
+		gf_sha1_update(sha, (u8 *) &p->value.vec4, sizeof(GF_PropVec4));
+		break;
+	default:
+		break;
+	}
+}
+
+//computes the signature of the registry: any change in the set of filters, their order or their capabilities changes the signature
+static void gf_graph_file_signature(GF_FilterSession *fsess, u8 digest[GF_SHA1_DIGEST_SIZE])
+{
+	u32 i, j, count, version = GF_GRAPH_FILE_VERSION;
+	const char *gpac_version = gf_gpac_version();
+	GF_SHA1Context *sha = gf_sha1_starts();
+
+	gf_sha1_update(sha, (u8 *) &version, sizeof(u32));
+	gf_sha1_update(sha, (u8 *) gpac_version, (u32) strlen(gpac_version));
+	count = gf_list_count(fsess->registry);
+	gf_sha1_update(sha, (u8 *) &count, sizeof(u32));
+	for (i=0; i<count; i++) {
+		const GF_FilterRegister *freg = gf_list_get(fsess->registry, i);
+		gf_sha1_update(sha, (u8 *) freg->name, (u32) strlen(freg->name)+1);
+		gf_sha1_update(sha, (u8 *) &freg->flags, sizeof(u32));
+		gf_sha1_update(sha, (u8 *) &freg->priority, sizeof(freg->priority));
+		gf_sha1_update(sha, (u8 *) &freg->nb_caps, sizeof(u32));
+		for (j=0; j<freg->nb_caps; j++) {
+			const GF_FilterCapability *cap = &freg->caps[j];
+			gf_sha1_update(sha, (u8 *) &cap->code, sizeof(u32));
+			gf_sha1_update(sha, (u8 *) &cap->flags, sizeof(u32));
+			gf_sha1_update(sha, (u8 *) &cap->priority, sizeof(u8));
+			if (cap->name) gf_sha1_update(sha, (u8 *) cap->name, (u32) strlen(cap->name)+1);
+			gf_graph_hash_prop(sha, &cap->val);
+		}
+	}
+	gf_sha1_finish(sha, digest);
+}
+
+static const char *gf_graph_file_dir()
+{
+	const char *cache_dir = gf_opts_get_key("core", "cache");
+	if (!cache_dir) cache_dir = gf_get_default_cache_directory();
+	return cache_dir;
+}
+
+static char *gf_graph_file_path(u8 digest[GF_SHA1_DIGEST_SIZE])
+{
+	char szName[100];
+	char *path;
+	u32 i, len;
+	const char *cache_dir = gf_graph_file_dir();
+	if (!cache_dir) return NULL;
+
+	strcpy(szName, "gf_graph_");
+	len = (u32) strlen(szName);
+	for (i=0; i<GF_SHA1_DIGEST_SIZE; i++) {
+		sprintf(szName+len+2*i, "%02x", digest[i]);
+	}
+	strcat(szName, ".gfg");
+
+	len = (u32) strlen(cache_dir);
+	path = gf_malloc(len + (u32) strlen(szName) + 2);
+	if (!path) return NULL;
+	strcpy(path, cache_dir);
+	if (len && (cache_dir[len-1] != '/') && (cache_dir[len-1] != '\\')) {
+		path[len] = GF_PATH_SEPARATOR;
+		path[len+1] = 0;
+	}
+	strcat(path, szName);
+	return path;
+}
+
+static void gf_graph_file_reset(GF_List *links)
+{
+	while (gf_list_count(links)) {
+		GF_FilterRegDesc *rdesc = gf_list_pop_back(links);
+		if (rdesc->edges) gf_free(rdesc->edges);
+		gf_free(rdesc);
+	}
+}
+
+//loads link graph from file, returns the graph build time stored in the file, or 0 if failure
+static u64 gf_graph_file_load(GF_FilterSession *fsess, const char *path, u8 digest[GF_SHA1_DIGEST_SIZE])
+{
+	u8 *data=NULL;
+	u8 file_digest[GF_SHA1_DIGEST_SIZE];
+	u32 i, j, size, nb_regs;
+	u64 build_time;
+	GF_BitStream *bs;
+
+	if (!gf_file_exists(path) || (gf_file_load_data(path, &data, &size) != GF_OK))
+		return 0;
+
+	bs = gf_bs_new(data, size, GF_BITSTREAM_READ);
+	if ((gf_bs_read_u32(bs) != GF_GRAPH_FILE_MAGIC) || (gf_bs_read_u8(bs) != GF_GRAPH_FILE_VERSION)) {
+		build_time = 0;
+		goto exit;
+	}
+	gf_bs_read_data(bs, file_digest, GF_SHA1_DIGEST_SIZE);
+	nb_regs = gf_bs_read_u32(bs);
+	build_time = gf_bs_read_u64(bs);
+	if (memcmp(file_digest, digest, GF_SHA1_DIGEST_SIZE) || (nb_regs != gf_list_count(fsess->registry))) {
+		build_time = 0;
+		goto exit;
+	}
+	//allocate all descriptors first since edges point to any of them
+	for (i=0; i<nb_regs; i++) {
+		GF_FilterRegDesc *rdesc;
+		GF_SAFEALLOC(rdesc, GF_FilterRegDesc);
+		if (!rdesc) {
+			build_time = 0;
+			goto exit;
+		}
+		rdesc->freg = gf_list_get(fsess->registry, i);
+		gf_list_add(fsess->links, rdesc);
+	}
+	for (i=0; i<nb_regs; i++) {
+		GF_FilterRegDesc *rdesc = gf_list_get(fsess->links, i);
+		rdesc->nb_edges = gf_bs_read_u32(bs);
+		if (!rdesc->nb_edges) continue;
+		//an edge uses 14 bytes in the file
+		if (gf_bs_available(bs) < 14 * (u64) rdesc->nb_edges) {
+			build_time = 0;
+			goto exit;
+		}
+		rdesc->nb_alloc_edges = rdesc->nb_edges;
+		rdesc->edges = gf_malloc(sizeof(GF_FilterRegEdge) * rdesc->nb_alloc_edges);
+		if (!rdesc->edges) {
+			rdesc->nb_edges = rdesc->nb_alloc_edges = 0;
+			build_time = 0;
+			goto exit;
+		}
+		memset(rdesc->edges, 0, sizeof(GF_FilterRegEdge) * rdesc->nb_alloc_edges);
+		for (j=0; j<rdesc->nb_edges; j++) {
+			GF_FilterRegEdge *edge = &rdesc->edges[j];
+			u32 src_idx = gf_bs_read_u32(bs);
+			edge->src_reg = gf_list_get(fsess->links, src_idx);
+			edge->src_cap_idx = gf_bs_read_u16(bs);
+			edge->dst_cap_idx = gf_bs_read_u16(bs);
+			edge->weight = gf_bs_read_u8(bs);
+			edge->loaded_filter_only = gf_bs_read_u8(bs);
+			edge->src_stream_type = (s32) gf_bs_read_u32(bs);
+			if (!edge->src_reg || (edge->src_reg == rdesc)) {
+				build_time = 0;
+				goto exit;
+			}
+		}
+	}
+
+exit:
+	gf_bs_del(bs);
+	gf_free(data);
+	if (!build_time) {
+		//remove the entry, it is stored again after the graph is rebuilt if the rebuilt graph is consistent with the registry
+		GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Invalid or outdated filter graph file %s, removing it\n", path));
+		gf_graph_file_reset(fsess->links);
+		gf_file_delete(path);
+	}
+	return build_time;
+}
+
+typedef struct
+{
+	const char *keep;
+	u32 nb_files;
+	u64 oldest_time;
+	char oldest[GF_MAX_PATH];
+} GF_GraphFilePrune;
+
+static Bool gf_graph_file_enum(void *cbck, char *item_name, char *item_path, GF_FileEnumInfo *file_info)
+{
+	GF_GraphFilePrune *prune = (GF_GraphFilePrune *)cbck;
+	if (strncmp(item_name, "gf_graph_", 9)) return GF_FALSE;
+	prune->nb_files++;
+	if (!strcmp(item_path, prune->keep)) return GF_FALSE;
+	if (!prune->oldest[0] || (file_info->last_modified < prune->oldest_time)) {
+		prune->oldest_time = file_info->last_modified;
+		strncpy(prune->oldest, item_path, GF_MAX_PATH-1);
+		prune->oldest[GF_MAX_PATH-1] = 0;
+	}
+	return GF_FALSE;
+}
+
+//keeps at most GF_GRAPH_FILE_MAX_FILES graph files in the cache directory, removing the oldest ones
+static void gf_graph_file_prune(const char *path)
+{
+	GF_GraphFilePrune prune;
+	const char *cache_dir = gf_graph_file_dir();
+	if (!cache_dir) return;
+
+	while (1) {
+		memset(&prune, 0, sizeof(GF_GraphFilePrune));
+		prune.keep = path;
+		gf_enum_directory(cache_dir, GF_FALSE, gf_graph_file_enum, &prune, "gfg");
+		if ((prune.nb_files <= GF_GRAPH_FILE_MAX_FILES) || !prune.oldest[0]) break;
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Removing old filter graph file %s\n", prune.oldest));
+		if (gf_file_delete(prune.oldest) != GF_OK) break;
+	}
+}
+
+static void gf_graph_file_save(GF_FilterSession *fsess, const char *path, u8 digest[GF_SHA1_DIGEST_SIZE], u64 build_time)
+{
+	u8 *data=NULL;
+	u32 i, j, size, nb_regs;
+	char *tmp_path;
+	FILE *f;
+	GF_BitStream *bs;
+
+	nb_regs = gf_list_count(fsess->links);
+	//graph entries are stored by registry index, do not store a graph missing some filters
+	if (nb_regs != gf_list_count(fsess->registry)) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("Filter graph incomplete (%d entries for %d filters), not storing it\n", nb_regs, gf_list_count(fsess->registry)));
+		return;
+	}
+	for (i=0; i<nb_regs; i++) {
+		GF_FilterRegDesc *rdesc = gf_list_get(fsess->links, i);
+		if (rdesc->freg != gf_list_get(fsess->registry, i)) return;
+	}
+	bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
+	gf_bs_write_u32(bs, GF_GRAPH_FILE_MAGIC);
+	gf_bs_write_u8(bs, GF_GRAPH_FILE_VERSION);
+	gf_bs_write_data(bs, digest, GF_SHA1_DIGEST_SIZE);
+	gf_bs_write_u32(bs, nb_regs);
+	gf_bs_write_u64(bs, build_time ? build_time : 1);
+	for (i=0; i<nb_regs; i++) {
+		GF_FilterRegDesc *rdesc = gf_list_get(fsess->links, i);
+		gf_bs_write_u32(bs, rdesc->nb_edges);
+		for (j=0; j<rdesc->nb_edges; j++) {
+			GF_FilterRegEdge *edge = &rdesc->edges[j];
+			gf_bs_write_u32(bs, gf_list_find(fsess->links, edge->src_reg));
+			gf_bs_write_u16(bs, edge->src_cap_idx);
+			gf_bs_write_u16(bs, edge->dst_cap_idx);
+			gf_bs_write_u8(bs, edge->weight);
+			gf_bs_write_u8(bs, edge->loaded_filter_only);
+			gf_bs_write_u32(bs, (u32) edge->src_stream_type);
+		}
+	}
+	gf_bs_get_content(bs, &data, &size);
+	gf_bs_del(bs);
+	if (!data) return;
+
+	//write to a temp file then move it, so that concurrent sessions never read a partial graph file
+	tmp_path = gf_malloc((u32) strlen(path) + 20);
+	if (!tmp_path) {
+		gf_free(data);
+		return;
+	}
+	sprintf(tmp_path, "%s.%08x", path, gf_rand());
+	f = gf_fopen(tmp_path, "wb");
+	if (f) {
+		u32 written = (u32) gf_fwrite(data, size, f);
+		gf_fclose(f);
+		if ((written != size) || (gf_file_move(tmp_path, path) != GF_OK)) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("Failed to store filter graph file %s\n", path));
+			gf_file_delete(tmp_path);
+		} else {
+			gf_graph_file_prune(path);
+		}
+	}
+	gf_free(tmp_path);
+	gf_free(data);
+}
+
 void gf_filter_sess_build_graph(GF_FilterSession *fsess, const GF_FilterRegister *for_reg)
 {
 	u32 i, count;
@@ -2498,20 +2978,44 @@ void gf_filter_sess_build_graph(GF_FilterSession *fsess, const GF_FilterRegister
 			gf_list_add(fsess->links, freg_desc);
 		}
 	} else {
-#ifndef GPAC_DISABLE_LOG
-		u64 start_time = gf_sys_clock_high_res();
-#endif
-		count = gf_list_count(fsess->registry);
-		for (i=0; i<count; i++) {
-			const GF_FilterRegister *freg = gf_list_get(fsess->registry, i);
-			GF_FilterRegDesc *freg_desc = gf_filter_reg_build_graph(fsess->links, freg, &capstore, NULL, NULL);
-			if (!freg_desc) {
-				GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to build graph entry for filter %s\n", freg->name));
-			} else {
-				gf_list_add(fsess->links, freg_desc);
+		u64 build_time, start_time = gf_sys_clock_high_res();
+		u8 digest[GF_SHA1_DIGEST_SIZE];
+		char *graph_file = NULL;
+		u64 file_build_time = 0;
+
+		//only use graph file when enabled and building the complete graph once for the session
+		if (!gf_list_count(fsess->links) && !(fsess->flags & GF_FS_FLAG_NO_GRAPH_CACHE) && gf_opts_get_bool("core", "graph-file")) {
+			gf_graph_file_signature(fsess, digest);
+			graph_file = gf_graph_file_path(digest);
+			if (graph_file)
+				file_build_time = gf_graph_file_load(fsess, graph_file, digest);
+		}
+
+		if (!file_build_time) {
+			count = gf_list_count(fsess->registry);
+			for (i=0; i<count; i++) {
+				const GF_FilterRegister *freg = gf_list_get(fsess->registry, i);
+				GF_FilterRegDesc *freg_desc = gf_filter_reg_build_graph(fsess->links, freg, &capstore, NULL, NULL);
+				if (!freg_desc) {
+					GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to build graph entry for filter %s\n", freg->name));
+				} else {
+					gf_list_add(fsess->links, freg_desc);
+				}
 			}
+			build_time = gf_sys_clock_high_res() - start_time;
+			fsess->graph_nb_builds++;
+			GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("Build filter graph in "LLU" us\n", build_time));
+			if (graph_file)
+				gf_graph_file_save(fsess, graph_file, digest, build_time);
+		} else {
+			build_time = gf_sys_clock_high_res() - start_time;
+			fsess->graph_nb_loads++;
+			if (file_build_time > build_time)
+				fsess->graph_saved_us += file_build_time - build_time;
+			GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("Loaded filter graph from %s in "LLU" us (built in "LLU" us)\n", graph_file, build_time, file_build_time));
 		}
-		GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("Build filter graph in "LLU" us\n", gf_sys_clock_high_res() - start_time));
+		fsess->graph_build_us += build_time;
+		if (graph_file) gf_free(graph_file);
 
 		if (fsess->flags & GF_FS_FLAG_PRINT_CONNECTIONS) {
 			u32 j;
@@ -4849,6 +5353,8 @@ GF_FilterPacket *gf_filter_pid_get_packet(GF_FilterPid *pid)
 		}
 		if (!pidinst->is_end_of_stream && pidinst->pid->filter->would_block)
 			gf_filter_pid_check_unblock(pidinst->pid);
+		if (!pidinst->is_end_of_stream && pidinst->filter->session->buf_tune)
+			gf_filter_pid_tune_starvation(pidinst->pid);
 		pidinst->filter->nb_pck_io++;
 		return NULL;
 	}
@@ -4929,6 +5435,12 @@ GF_FilterPacket *gf_filter_pid_get_packet(GF_FilterPid *pid)
 		}
 	}
 	pidinst->last_pck_fetch_time = gf_sys_clock_high_res();
+	//only trace first fetch, filters may peek at the same packet several times before dropping it
+	if (pcki->trace_send_us && !pcki->trace_fetch_us) {
+		pcki->trace_fetch_us = pidinst->last_pck_fetch_time;
+		if (!(pcki->pck->info.flags & GF_PCK_CMD_MASK))
+			gf_fs_trace_queue(pidinst->filter->session, pidinst, pcki->trace_send_us, pcki->trace_fetch_us - pcki->trace_send_us);
+	}
 
 	return (GF_FilterPacket *)pcki;
 }
@@ -5084,8 +5596,9 @@ static void gf_filter_pidinst_reset_stats(GF_FilterPidInst *pidi)
 	pidi->first_frame_time = 0;
 }
 
-GF_EXPORT
-void gf_filter_pid_drop_packet(GF_FilterPid *pid)
+//if update_pid_state is not set, the packet duration is accumulated in batch_dur and the PID buffer state is not updated
+//otherwise the buffer state is updated under the tasks mutex, removing the packet duration and the accumulated batch_dur if any
+static void gf_filter_pid_drop_packet_internal(GF_FilterPid *pid, Bool update_pid_state, s64 *batch_dur)
 {
 #ifdef GPAC_MEMORY_TRACKING
 	u32 prev_nb_allocs, prev_nb_reallocs, nb_allocs, nb_reallocs;
@@ -5119,6 +5632,9 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 	pid = pid->pid;
 
 	gf_filter_pidinst_update_stats(pidinst, pck);
+	if (pcki->trace_fetch_us && !(pck->info.flags & GF_PCK_CMD_MASK)) {
+		gf_fs_trace_histo_add(pidinst->trace_hold, gf_sys_clock_high_res() - pcki->trace_fetch_us);
+	}
 	if (pck->info.cts!=GF_FILTER_NO_TS) {
 		pidinst->last_ts_drop.num = pck->info.cts;
 		pidinst->last_ts_drop.den = pck->pid_props->timescale;
@@ -5127,20 +5643,34 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 
 	//make sure we lock the tasks mutex before getting the packet count, otherwise we might end up with a wrong number of packets
 	//if one thread (the caller here) consumes one packet while the dispatching thread is still upddating the state for that pid
+	//in batch drop, this is only done for the last packet with the durations of all dropped packets, the remaining packets count cannot be 0 before
+	if (!update_pid_state) {
+		nb_pck = gf_fq_count(pidinst->packets);
+		if (pck->info.duration && (pck->info.flags & GF_PCKF_BLOCK_START)  && pck->pid_props->timescale) {
+			s64 d = ((u64)pck->info.duration) * 1000000;
+			d /= pck->pid_props->timescale;
+			*batch_dur += d;
+		}
+		goto pid_state_done;
+	}
 	gf_mx_p(pid->filter->tasks_mx);
 	nb_pck = gf_fq_count(pidinst->packets);
 
 	if (!nb_pck) {
 		safe_int64_sub(&pidinst->buffer_duration, pidinst->buffer_duration);
-	} else if (pck->info.duration && (pck->info.flags & GF_PCKF_BLOCK_START)  && pck->pid_props->timescale) {
-		s64 d = ((u64)pck->info.duration) * 1000000;
-		d /= pck->pid_props->timescale;
+	} else if ((batch_dur && *batch_dur) || (pck->info.duration && (pck->info.flags & GF_PCKF_BLOCK_START)  && pck->pid_props->timescale)) {
+		s64 d = 0;
+		if (pck->info.duration && (pck->info.flags & GF_PCKF_BLOCK_START)  && pck->pid_props->timescale) {
+			d = ((u64)pck->info.duration) * 1000000;
+			d /= pck->pid_props->timescale;
+		}
+		if (batch_dur) d += *batch_dur;
 		if (d > pidinst->buffer_duration) {
 			GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Corrupted buffer level in PID instance %s (%s -> %s), droping packet duration "LLD" us greater than buffer duration "LLU" us\n", pid->name, pid->filter->name, pidinst->filter ? pidinst->filter->name : "disconnected", d, pidinst->buffer_duration));
 			d = pidinst->buffer_duration;
 		}
 		assert(d <= pidinst->buffer_duration);
-		safe_int64_sub(&pidinst->buffer_duration, (s32) d);
+		safe_int64_sub(&pidinst->buffer_duration, d);
 	}
 
 	if ( (pid->num_destinations==1) || (pid->filter->session->blocking_mode==GF_FS_NOBLOCK_FANOUT)) {
@@ -5173,6 +5703,8 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 
 	gf_mx_v(pid->filter->tasks_mx);
 
+pid_state_done:
+
 #ifndef GPAC_DISABLE_LOG
 	if (gf_log_tool_level_on(GF_LOG_FILTER, GF_LOG_DEBUG)) {
 		u8 sap_type = (pck->info.flags & GF_PCK_SAP_MASK) >> GF_PCK_SAP_POS;
@@ -5190,6 +5722,11 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 	}
 #endif
 
+	if (pcki->queued_bytes) {
+		safe_int64_sub(&pid->filter->session->buf_queued_bytes, pcki->queued_bytes);
+		pcki->queued_bytes = 0;
+	}
+
 	//destroy pcki
 	pcki->pck = NULL;
 	pcki->pid = NULL;
@@ -5231,6 +5768,66 @@ void gf_filter_pid_drop_packet(GF_FilterPid *pid)
 	gf_rmt_end();
 }
 
+GF_EXPORT
+void gf_filter_pid_drop_packet(GF_FilterPid *pid)
+{
+	gf_filter_pid_drop_packet_internal(pid, GF_TRUE, NULL);
+}
+
+GF_EXPORT
+u32 gf_filter_pid_get_packets(GF_FilterPid *pid, GF_FilterPacket **pcks, u32 max_pcks)
+{
+	u32 i, nb_pcks;
+	GF_FilterPidInst *pidinst = (GF_FilterPidInst *)pid;
+	if (!pcks || !max_pcks) return 0;
+
+	//first packet goes through regular fetch, handling reconfigure, info update and internal packets
+	pcks[0] = gf_filter_pid_get_packet(pid);
+	if (!pcks[0]) return 0;
+
+	//following packets skip block reassembly and discard checks, only fetch them in plain mode
+	if (pidinst->requires_full_data_block || pidinst->discard_packets || pidinst->discard_inputs || pidinst->detach_pending)
+		return 1;
+
+	//only fetch following packets if they are plain data packets which don't need any of the above
+	nb_pcks = gf_fq_count(pidinst->packets);
+	if (nb_pcks > max_pcks) nb_pcks = max_pcks;
+	for (i=1; i<nb_pcks; i++) {
+		GF_FilterPacketInstance *pcki = gf_fq_get(pidinst->packets, i);
+		if (!pcki || !pcki->pck) break;
+		if (pcki->pck->info.flags & (GF_PCK_CMD_MASK|GF_PCK_CKTYPE_MASK|GF_PCKF_PROPS_CHANGED|GF_PCKF_INFO_CHANGED))
+			break;
+
+		if (pcki->trace_send_us && !pcki->trace_fetch_us) {
+			pcki->trace_fetch_us = pidinst->last_pck_fetch_time;
+			gf_fs_trace_queue(pidinst->filter->session, pidinst, pcki->trace_send_us, pcki->trace_fetch_us - pcki->trace_send_us);
+		}
+		pcks[i] = (GF_FilterPacket *)pcki;
+	}
+	return i;
+}
+
+GF_EXPORT
+void gf_filter_pid_drop_packets(GF_FilterPid *pid, u32 nb_pcks)
+{
+	u32 count;
+	s64 batch_dur = 0;
+	GF_FilterPidInst *pidinst = (GF_FilterPidInst *)pid;
+	if (PID_IS_OUTPUT(pid)) {
+		gf_filter_pid_drop_packet(pid);
+		return;
+	}
+	if (!nb_pcks) return;
+	count = gf_fq_count(pidinst->packets);
+	if (nb_pcks > count) nb_pcks = count;
+	//update pid buffer state and check unblocking only once under the tasks mutex, at the last packet
+	while (nb_pcks>1) {
+		gf_filter_pid_drop_packet_internal(pid, GF_FALSE, &batch_dur);
+		nb_pcks--;
+	}
+	gf_filter_pid_drop_packet_internal(pid, GF_TRUE, &batch_dur);
+}
+
 GF_EXPORT
 Bool gf_filter_pid_is_eos(GF_FilterPid *pid)
 {
@@ -5333,6 +5930,9 @@ Bool gf_filter_pid_would_block(GF_FilterPid *pid)
 			blockmode_broken = GF_TRUE;
 		}
 	}
+	if (!would_block && gf_filter_pid_tune_over_budget(pid))
+		would_block = GF_TRUE;
+
 	if (blockmode_broken) {
 		//don't throw a warning since some filters may dispatch a large burst of packets (eg isom muxer)
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_FILTER, ("Filter %s PID %s block mode not respected: %u units "LLU" us vs %u max units "LLU" max buffer\n", pid->pid->filter->name, pid->pid->name, pid->nb_buffer_unit, pid->buffer_duration, pid->max_buffer_unit, pid->max_buffer_time));
@@ -5345,6 +5945,11 @@ Bool gf_filter_pid_would_block(GF_FilterPid *pid)
 		safe_int_inc(&pid->filter->would_block);
 		assert(pid->filter->would_block + pid->filter->num_out_pids_not_connected <= pid->filter->num_output_pids);
 
+		pid->block_start_us = gf_sys_clock_high_res();
+		pid->nb_blocks++;
+		if (pid->filter->session->buf_tune)
+			gf_filter_pid_tune_shrink(pid, pid->block_start_us);
+
 #ifndef GPAC_DISABLE_LOG
 		if (gf_log_tool_level_on(GF_LOG_FILTER, GF_LOG_DEBUG)) {
 			if (pid->max_buffer_unit) {
@@ -6017,6 +6622,10 @@ static void filter_pid_collect_stats(GF_List *pidi_list, GF_FilterPidStatistics
 
 		if (stats->nb_buffer_units < pidi->pid->nb_buffer_unit)
 			stats->nb_buffer_units = pidi->pid->nb_buffer_unit;
+		if (stats->max_buffer_units < pidi->pid->max_buffer_unit)
+			stats->max_buffer_units = pidi->pid->max_buffer_unit;
+		stats->block_time += pidi->pid->block_time_us;
+		stats->nb_blocks += pidi->pid->nb_blocks;
 		if (stats->max_buffer_time < pidi->pid->max_buffer_time)
 			stats->max_buffer_time = pidi->pid->max_buffer_time;
 
@@ -35,10 +35,30 @@
 #endif
 #endif
 
+#define spsc_load_acquire(_ptr)	( MemoryBarrier(), *(_ptr) )
+#define spsc_store_release(_ptr, _val)	{ MemoryBarrier(); *(_ptr) = (_val); }
+#define spsc_swap_ptr(_ptr, _val)	InterlockedExchangePointer((PVOID volatile *)(_ptr), (PVOID)(_val))
+
 #else
 #define atomic_compare_and_swap(_ptr, _comparand, _replacement)	__sync_bool_compare_and_swap(_ptr, _comparand, _replacement)
+
+#ifdef __ATOMIC_ACQUIRE
+#define spsc_load_acquire(_ptr)	__atomic_load_n(_ptr, __ATOMIC_ACQUIRE)
+#define spsc_store_release(_ptr, _val)	__atomic_store_n(_ptr, _val, __ATOMIC_RELEASE)
+#define spsc_swap_ptr(_ptr, _val)	__atomic_exchange_n(_ptr, _val, __ATOMIC_ACQ_REL)
+#else
+#define spsc_load_acquire(_ptr)	( __sync_synchronize(), *(_ptr) )
+#define spsc_store_release(_ptr, _val)	{ __sync_synchronize(); *(_ptr) = (_val); }
+#define spsc_swap_ptr(_ptr, _val)	__sync_lock_test_and_set(_ptr, _val)
+#endif
+
 #endif
 
+//number of slots per SPSC ring segment
+#define GF_SPSC_SEG_SLOTS	128
+//padding used to keep producer and consumer indices on separate cache lines
+#define GF_CACHE_LINE_SIZE	64
+
 
 typedef struct __lf_item
 {
@@ -46,6 +66,73 @@ typedef struct __lf_item
 	void *data;
 } GF_LFQItem;
 
+typedef struct __spsc_seg
+{
+	struct __spsc_seg *next;
+	void *slots[GF_SPSC_SEG_SLOTS];
+} GF_SPSCSegment;
+
+/*single-producer single-consumer ring. Head and tail are free-running u32 counters used for synchronization and item count,
+each side also tracks its position in its current segment. When the producer fills a segment, it moves to a new one (taken from the spare slot if any) rather than blocking,
+since PID queues are not bounded; the consumer hands back segments it leaves through the spare slot. Segments can be linked ahead of time
+by gf_fq_reserve, so that adding an item never fails once accounted by the caller.
+
+There is no lock: add/reserve shall only be called from the producer context and pop/head/get/enum only from the consumer context,
+each context being used by a single thread at any time. The ring is therefore only used when the session has no worker threads
+and the consumer does not pull packets from other threads, see gf_filter_pid_inst_new; other queues use the regular FIFO*/
+typedef struct
+{
+	//producer side
+	volatile u32 tail;
+	u32 tail_pos;
+	GF_SPSCSegment *tail_seg;
+	//number of empty segments linked after tail_seg, and last linked segment
+	u32 nb_reserved;
+	GF_SPSCSegment *last_seg;
+	u8 _pad1[GF_CACHE_LINE_SIZE];
+
+	//consumer side
+	volatile u32 head;
+	u32 head_pos;
+	u32 cached_tail;
+	GF_SPSCSegment *head_seg;
+	u8 _pad2[GF_CACHE_LINE_SIZE];
+
+	//segment handed back by consumer
+	GF_SPSCSegment *spare;
+} GF_SPSCRing;
+
+/*priority queue entry. Entries are ordered by key then by insertion order, so that items with the same key are dequeued in FIFO order*/
+typedef struct
+{
+	u64 key;
+	u64 seq;
+	u64 deadline;
+	void *item;
+} GF_FQPrioEntry;
+
+typedef struct
+{
+	GF_FQPrioEntry *entries;
+	u32 count, alloc;
+} GF_FQPrioHeap;
+
+/*earliest deadline first queue, always protected by a mutex. Items not yet due (release time in the future) are kept in a heap ordered
+by release time and moved to the ready heap, ordered by deadline, once due. Items are dequeued from the ready heap first*/
+typedef struct
+{
+	GF_FQPrioHeap ready;
+	GF_FQPrioHeap waiting;
+	u64 seq;
+	void (*get_keys)(void *udta, void *item, u64 *release_time, u64 *deadline);
+	void *udta;
+	//set if the mutex was created by the queue
+	GF_Mutex *own_mx;
+	//items which could not be inserted in the heaps (allocation failure), dequeued first in FIFO order
+	GF_LFQItem *fifo_head, *fifo_tail;
+	u32 fifo_count;
+} GF_FQPrio;
+
 struct __gf_filter_queue
 {
 	//head element is dummy, never swaped
@@ -58,6 +145,11 @@ struct __gf_filter_queue
 	volatile u32 nb_items;
 
 	GF_Mutex *mx;
+
+	//if set, queue is in SPSC mode and none of the above is used
+	GF_SPSCRing *spsc;
+	//if set, queue is in priority mode, items are stored in the heap and only nb_items and mx are used
+	GF_FQPrio *prio;
 };
 
 
@@ -92,10 +184,333 @@ GF_FilterQueue *gf_fq_new(const GF_Mutex *mx)
 	return q;
 }
 
+GF_FilterQueue *gf_fq_new_spsc()
+{
+	GF_FilterQueue *q;
+	GF_SAFEALLOC(q, GF_FilterQueue);
+	if (!q) return NULL;
+	GF_SAFEALLOC(q->spsc, GF_SPSCRing);
+	if (!q->spsc) {
+		gf_free(q);
+		return NULL;
+	}
+	GF_SAFEALLOC(q->spsc->tail_seg, GF_SPSCSegment);
+	if (!q->spsc->tail_seg) {
+		gf_free(q->spsc);
+		gf_free(q);
+		return NULL;
+	}
+	q->spsc->head_seg = q->spsc->last_seg = q->spsc->tail_seg;
+	return q;
+}
+
+GF_FilterQueue *gf_fq_new_prio(const GF_Mutex *mx, void (*get_keys)(void *udta, void *item, u64 *release_time, u64 *deadline), void *udta)
+{
+	GF_FilterQueue *q;
+	if (!get_keys) return NULL;
+	GF_SAFEALLOC(q, GF_FilterQueue);
+	if (!q) return NULL;
+	GF_SAFEALLOC(q->prio, GF_FQPrio);
+	if (!q->prio) {
+		gf_free(q);
+		return NULL;
+	}
+	q->prio->get_keys = get_keys;
+	q->prio->udta = udta;
+	q->mx = (GF_Mutex *) mx;
+	if (!q->mx) {
+		q->prio->own_mx = q->mx = gf_mx_new("FilterQueuePrio");
+		if (!q->mx) {
+			gf_free(q->prio);
+			gf_free(q);
+			return NULL;
+		}
+	}
+	return q;
+}
+
+static GFINLINE Bool gf_prio_less(GF_FQPrioEntry *a, GF_FQPrioEntry *b)
+{
+	if (a->key < b->key) return GF_TRUE;
+	if (a->key > b->key) return GF_FALSE;
+	return (a->seq < b->seq) ? GF_TRUE : GF_FALSE;
+}
+
+static Bool gf_prio_heap_push(GF_FQPrioHeap *h, GF_FQPrioEntry *e)
+{
+	u32 idx;
+	if (h->count == h->alloc) {
+		u32 new_alloc = h->alloc ? 2*h->alloc : 32;
+		GF_FQPrioEntry *entries = gf_realloc(h->entries, sizeof(GF_FQPrioEntry)*new_alloc);
+		if (!entries) return GF_FALSE;
+		h->entries = entries;
+		h->alloc = new_alloc;
+	}
+	//sift up
+	idx = h->count;
+	while (idx) {
+		u32 parent = (idx-1)/2;
+		if (!gf_prio_less(e, &h->entries[parent])) break;
+		h->entries[idx] = h->entries[parent];
+		idx = parent;
+	}
+	h->entries[idx] = *e;
+	h->count++;
+	return GF_TRUE;
+}
+
+static void gf_prio_heap_pop(GF_FQPrioHeap *h, GF_FQPrioEntry *e)
+{
+	u32 idx;
+	GF_FQPrioEntry last;
+	*e = h->entries[0];
+	h->count--;
+	if (!h->count) return;
+	last = h->entries[h->count];
+	//sift down
+	idx = 0;
+	while (1) {
+		u32 child = 2*idx + 1;
+		if (child >= h->count) break;
+		if ((child+1 < h->count) && gf_prio_less(&h->entries[child+1], &h->entries[child]))
+			child++;
+		if (!gf_prio_less(&h->entries[child], &last)) break;
+		h->entries[idx] = h->entries[child];
+		idx = child;
+	}
+	h->entries[idx] = last;
+}
+
+//move all items due for execution to the ready heap - queue mutex shall be held
+static void gf_prio_release(GF_FQPrio *p)
+{
+	u64 now;
+	if (!p->waiting.count) return;
+	now = gf_sys_clock_high_res();
+	while (p->waiting.count && (p->waiting.entries[0].key <= now)) {
+		GF_FQPrioEntry e;
+		gf_prio_heap_pop(&p->waiting, &e);
+		e.key = e.deadline;
+		//failure to grow ready heap, keep it in waiting heap
+		if (!gf_prio_heap_push(&p->ready, &e)) {
+			gf_prio_heap_push(&p->waiting, &e);
+			break;
+		}
+	}
+}
+
+static void *gf_prio_entry(GF_FQPrio *p, u32 idx)
+{
+	if (idx < p->fifo_count) {
+		GF_LFQItem *it = p->fifo_head;
+		while (idx--) it = it->next;
+		return it->data;
+	}
+	idx -= p->fifo_count;
+	if (idx < p->ready.count) return p->ready.entries[idx].item;
+	idx -= p->ready.count;
+	if (idx < p->waiting.count) return p->waiting.entries[idx].item;
+	return NULL;
+}
+
+static void gf_prio_add(GF_FilterQueue *fq, void *item)
+{
+	GF_FQPrioEntry e;
+	u64 release=0;
+	Bool res;
+	GF_FQPrio *p = fq->prio;
+	//fetch keys outside of the lock, the callback may query the system clock
+	p->get_keys(p->udta, item, &release, &e.deadline);
+	e.item = item;
+
+	gf_mx_p(fq->mx);
+	e.seq = p->seq++;
+	if (release && (release > gf_sys_clock_high_res())) {
+		e.key = release;
+		res = gf_prio_heap_push(&p->waiting, &e);
+	} else {
+		e.key = e.deadline;
+		res = gf_prio_heap_push(&p->ready, &e);
+	}
+	//heap cannot grow, fall back to FIFO order for this item rather than losing it
+	if (!res) {
+		GF_LFQItem *it;
+		GF_SAFEALLOC(it, GF_LFQItem);
+		if (it) {
+			it->data = item;
+			if (p->fifo_tail) p->fifo_tail->next = it;
+			else p->fifo_head = it;
+			p->fifo_tail = it;
+			p->fifo_count++;
+			res = GF_TRUE;
+		} else {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_SCHEDULER, ("Failed to queue item in priority queue, out of memory\n"));
+		}
+	}
+	if (res) fq->nb_items++;
+	gf_mx_v(fq->mx);
+}
+
+static void *gf_prio_pop(GF_FilterQueue *fq)
+{
+	GF_FQPrioEntry e;
+	GF_FQPrio *p = fq->prio;
+
+	gf_mx_p(fq->mx);
+	if (!fq->nb_items) {
+		gf_mx_v(fq->mx);
+		return NULL;
+	}
+	fq->nb_items--;
+	if (p->fifo_head) {
+		GF_LFQItem *it = p->fifo_head;
+		p->fifo_head = it->next;
+		if (!p->fifo_head) p->fifo_tail = NULL;
+		p->fifo_count--;
+		gf_mx_v(fq->mx);
+		e.item = it->data;
+		gf_free(it);
+		return e.item;
+	}
+	gf_prio_release(p);
+	//no item ready, return the first one to be due
+	gf_prio_heap_pop(p->ready.count ? &p->ready : &p->waiting, &e);
+	gf_mx_v(fq->mx);
+	return e.item;
+}
+
+u64 gf_fq_head_deadline(GF_FilterQueue *fq)
+{
+	u64 deadline = 0;
+	if (!fq || !fq->prio) return 0;
+	gf_mx_p(fq->mx);
+	//items in FIFO fallback are due now
+	if (fq->prio->fifo_head) {
+		gf_mx_v(fq->mx);
+		return gf_sys_clock_high_res();
+	}
+	gf_prio_release(fq->prio);
+	if (fq->prio->ready.count)
+		deadline = fq->prio->ready.entries[0].deadline;
+	gf_mx_v(fq->mx);
+	return deadline;
+}
+
+//links empty segments after the producer segment until nb_items can be added, returns GF_FALSE if out of memory
+static Bool gf_spsc_reserve(GF_SPSCRing *r, u32 nb_items)
+{
+	while (GF_SPSC_SEG_SLOTS - r->tail_pos + r->nb_reserved * GF_SPSC_SEG_SLOTS < nb_items) {
+		GF_SPSCSegment *seg = spsc_swap_ptr(&r->spare, NULL);
+		if (!seg) {
+			seg = gf_malloc(sizeof(GF_SPSCSegment));
+			if (!seg) return GF_FALSE;
+		}
+		//not visible to the consumer until items are published in it by the release store on tail
+		seg->next = NULL;
+		r->last_seg->next = seg;
+		r->last_seg = seg;
+		r->nb_reserved++;
+	}
+	return GF_TRUE;
+}
+
+static u32 gf_spsc_add(GF_SPSCRing *r, void **items, u32 nb_items)
+{
+	u32 i, tail = r->tail;
+	for (i=0; i<nb_items; i++) {
+		//segment full, move to next one
+		if (r->tail_pos == GF_SPSC_SEG_SLOTS) {
+			if (!r->nb_reserved && !gf_spsc_reserve(r, GF_SPSC_SEG_SLOTS - r->tail_pos + 1))
+				break;
+			r->tail_seg = r->tail_seg->next;
+			r->tail_pos = 0;
+			r->nb_reserved--;
+		}
+		r->tail_seg->slots[r->tail_pos] = items[i];
+		r->tail_pos++;
+		tail++;
+	}
+	spsc_store_release(&r->tail, tail);
+	return i;
+}
+
+static u32 gf_spsc_pop(GF_SPSCRing *r, void **items, u32 max_items)
+{
+	u32 i, head = r->head;
+	for (i=0; i<max_items; i++) {
+		if (head == r->cached_tail) {
+			r->cached_tail = spsc_load_acquire(&r->tail);
+			if (head == r->cached_tail) break;
+		}
+		//leaving segment, hand it back to producer
+		if (r->head_pos == GF_SPSC_SEG_SLOTS) {
+			GF_SPSCSegment *seg = r->head_seg;
+			r->head_seg = seg->next;
+			r->head_pos = 0;
+			seg = spsc_swap_ptr(&r->spare, seg);
+			if (seg) gf_free(seg);
+		}
+		items[i] = r->head_seg->slots[r->head_pos];
+		r->head_seg->slots[r->head_pos] = NULL;
+		r->head_pos++;
+		head++;
+	}
+	spsc_store_release(&r->head, head);
+	return i;
+}
+
+//read-only lookup from the consumer context, head segment and position are owned by the consumer
+static void *gf_spsc_get(GF_SPSCRing *r, u32 idx)
+{
+	GF_SPSCSegment *seg;
+	u32 pos, tail = spsc_load_acquire(&r->tail);
+	if (tail - r->head <= idx) return NULL;
+
+	seg = r->head_seg;
+	pos = r->head_pos + idx;
+	while (pos >= GF_SPSC_SEG_SLOTS) {
+		seg = seg->next;
+		pos -= GF_SPSC_SEG_SLOTS;
+	}
+	return seg->slots[pos];
+}
+
+static void gf_spsc_del(GF_SPSCRing *r, void (*item_delete)(void *) )
+{
+	void *item;
+	while (gf_spsc_pop(r, &item, 1)) {
+		if (item_delete) item_delete(item);
+	}
+	while (r->head_seg) {
+		GF_SPSCSegment *seg = r->head_seg;
+		r->head_seg = seg->next;
+		gf_free(seg);
+	}
+	if (r->spare) gf_free(r->spare);
+	gf_free(r);
+}
 
 void gf_fq_del(GF_FilterQueue *q, void (*item_delete)(void *) )
 {
-	GF_LFQItem *it = q->head;
+	GF_LFQItem *it;
+	if (q->spsc) {
+		gf_spsc_del(q->spsc, item_delete);
+		gf_free(q);
+		return;
+	}
+	if (q->prio) {
+		void *item;
+		while ((item = gf_prio_pop(q))) {
+			if (item_delete) item_delete(item);
+		}
+		if (q->prio->ready.entries) gf_free(q->prio->ready.entries);
+		if (q->prio->waiting.entries) gf_free(q->prio->waiting.entries);
+		if (q->prio->own_mx) gf_mx_del(q->prio->own_mx);
+		gf_free(q->prio);
+		gf_free(q);
+		return;
+	}
+	it = q->head;
 	//first item is dummy if lock-free mode, doesn't hold a valid pointer
 	if (! q->mx) it->data=NULL;
 
@@ -208,7 +623,12 @@ void *gf_lfq_pop(GF_FilterQueue *q)
 
 u32 gf_fq_count(GF_FilterQueue *q)
 {
-	return q ? q->nb_items : 0;
+	if (!q) return 0;
+	if (q->spsc) {
+		u32 head = spsc_load_acquire(&q->spsc->head);
+		return spsc_load_acquire(&q->spsc->tail) - head;
+	}
+	return q->nb_items;
 }
 
 //TODO - check performances vs function pointer
@@ -217,7 +637,13 @@ void gf_fq_add(GF_FilterQueue *fq, void *item)
 	GF_LFQItem *it;
 	assert(fq);
 
-	if (! fq->mx) {
+	if (fq->spsc) {
+		if (!gf_spsc_add(fq->spsc, &item, 1)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to add item to packet queue, out of memory\n"));
+		}
+	} else if (fq->prio) {
+		gf_prio_add(fq, item);
+	} else if (! fq->mx) {
 		gf_lfq_add(fq, item);
 	} else {
 		gf_mx_p(fq->mx);
@@ -251,6 +677,12 @@ void *gf_fq_pop(GF_FilterQueue *fq)
 		return NULL;
 
 	void *data=NULL;
+	if (fq->spsc) {
+		gf_spsc_pop(fq->spsc, &data, 1);
+		return data;
+	}
+	if (fq->prio)
+		return gf_prio_pop(fq);
 	if (! fq->mx) {
 		return gf_lfq_pop(fq);
 	}
@@ -286,7 +718,14 @@ void *gf_fq_head(GF_FilterQueue *fq)
 	void *data;
 	if (!fq) return NULL;
 
-	if (fq->mx) {
+	if (fq->spsc) {
+		data = gf_spsc_get(fq->spsc, 0);
+	} else if (fq->prio) {
+		gf_mx_p(fq->mx);
+		gf_prio_release(fq->prio);
+		data = gf_prio_entry(fq->prio, 0);
+		gf_mx_v(fq->mx);
+	} else if (fq->mx) {
 		gf_mx_p(fq->mx);
 		data = fq->head ? fq->head->data : NULL;
 		gf_mx_v(fq->mx);
@@ -303,7 +742,14 @@ void *gf_fq_get(GF_FilterQueue *fq, u32 idx)
 	GF_LFQItem *it;
 	assert(fq);
 
-	if (fq->mx) {
+	if (fq->spsc) {
+		data = gf_spsc_get(fq->spsc, idx);
+	} else if (fq->prio) {
+		//heap order, only index 0 is guaranteed to be the first item to be dequeued
+		gf_mx_p(fq->mx);
+		data = gf_prio_entry(fq->prio, idx);
+		gf_mx_v(fq->mx);
+	} else if (fq->mx) {
 		gf_mx_p(fq->mx);
 		it = fq->head;
 
@@ -333,7 +779,25 @@ void gf_fq_enum(GF_FilterQueue *fq, Bool (*enum_func)(void *udta1, void *item),
 	if (!enum_func) return;
 	assert(fq);
 
-	if (fq->mx) {
+	if (fq->spsc) {
+		u32 i=0;
+		//consumer context, the callback must not pop from this queue
+		while (1) {
+			void *data = gf_spsc_get(fq->spsc, i);
+			if (!data || !enum_func(udta, data))
+				break;
+			i++;
+		}
+	} else if (fq->prio) {
+		u32 i;
+		gf_mx_p(fq->mx);
+		for (i=0; i<fq->nb_items; i++) {
+			void *item = gf_prio_entry(fq->prio, i);
+			if (!item || !enum_func(udta, item))
+				break;
+		}
+		gf_mx_v(fq->mx);
+	} else if (fq->mx) {
 		gf_mx_p(fq->mx);
 		it = fq->head;
 
@@ -352,3 +816,37 @@ void gf_fq_enum(GF_FilterQueue *fq, Bool (*enum_func)(void *udta1, void *item),
 		}
 	}
 }
+
+Bool gf_fq_reserve(GF_FilterQueue *fq, u32 nb_items)
+{
+	if (!fq || !fq->spsc) return GF_TRUE;
+	return gf_spsc_reserve(fq->spsc, nb_items);
+}
+
+void gf_fq_add_batch(GF_FilterQueue *fq, void **items, u32 nb_items)
+{
+	u32 i;
+	assert(fq);
+	if (fq->spsc) {
+		if (gf_spsc_add(fq->spsc, items, nb_items) < nb_items) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to add items to packet queue, out of memory\n"));
+		}
+		return;
+	}
+	for (i=0; i<nb_items; i++)
+		gf_fq_add(fq, items[i]);
+}
+
+u32 gf_fq_pop_batch(GF_FilterQueue *fq, void **items, u32 max_items)
+{
+	u32 i;
+	if (!fq) return 0;
+	if (fq->spsc)
+		return gf_spsc_pop(fq->spsc, items, max_items);
+
+	for (i=0; i<max_items; i++) {
+		items[i] = gf_fq_pop(fq);
+		if (!items[i]) break;
+	}
+	return i;
+}
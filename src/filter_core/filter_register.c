@@ -110,6 +110,7 @@ const GF_FilterRegister *vout_register(GF_FilterSession *session);
 #endif
 const GF_FilterRegister *vcrop_register(GF_FilterSession *session);
 const GF_FilterRegister *vflip_register(GF_FilterSession *session);
+const GF_FilterRegister *rescale_register(GF_FilterSession *session);
 const GF_FilterRegister *rawvidreframe_register(GF_FilterSession *session);
 const GF_FilterRegister *pcmreframe_register(GF_FilterSession *session);
 const GF_FilterRegister *jpgenc_register(GF_FilterSession *session);
@@ -140,6 +141,7 @@ const GF_FilterRegister *hevcmerge_register(GF_FilterSession *session);
 const GF_FilterRegister *jsfilter_register(GF_FilterSession *session);
 const GF_FilterRegister *m2tssplit_register(GF_FilterSession *session);
 const GF_FilterRegister *httpout_register(GF_FilterSession *session);
+const GF_FilterRegister *routeout_register(GF_FilterSession *session);
 
 #if !defined(GPAC_CONFIG_IOS) && !defined(GPAC_CONFIG_ANDROID) && !defined(GPAC_HAVE_DTAPI) && !defined(WIN32) 
 const GF_FilterRegister *dtout_register(GF_FilterSession *session);
@@ -233,6 +235,7 @@ void gf_fs_reg_all(GF_FilterSession *fsess, GF_FilterSession *a_sess)
 #endif
 	gf_fs_add_filter_register(fsess, vcrop_register(a_sess) );
 	gf_fs_add_filter_register(fsess, vflip_register(a_sess) );
+	gf_fs_add_filter_register(fsess, rescale_register(a_sess) );
 	gf_fs_add_filter_register(fsess, rawvidreframe_register(a_sess) );
 	gf_fs_add_filter_register(fsess, pcmreframe_register(a_sess) );
 	gf_fs_add_filter_register(fsess, jpgenc_register(a_sess) );
@@ -258,6 +261,7 @@ void gf_fs_reg_all(GF_FilterSession *fsess, GF_FilterSession *a_sess)
 	gf_fs_add_filter_register(fsess, rtpout_register(a_sess));
 	gf_fs_add_filter_register(fsess, rtspout_register(a_sess));
 	gf_fs_add_filter_register(fsess, httpout_register(a_sess));
+	gf_fs_add_filter_register(fsess, routeout_register(a_sess));
 
 	gf_fs_add_filter_register(fsess, hevcsplit_register(a_sess));
 	gf_fs_add_filter_register(fsess, hevcmerge_register(a_sess));
@@ -130,6 +130,34 @@ static Bool fs_default_event_proc(void *ptr, GF_Event *evt)
 	return 0;
 }
 
+//default latency budget of tasks in deadline scheduler mode
+#define GF_FS_DEFAULT_SCHED_SLACK	50000
+
+//deadline scheduler: a task is released at its schedule time and shall run within the latency budget of its filter, unless the filter declared an explicit deadline.
+//Since deadlines are never before the time the task is queued, a task is only delayed by tasks queued before its deadline, which prevents starvation
+static void gf_fs_task_deadline(void *udta, void *item, u64 *release_time, u64 *deadline)
+{
+	GF_FilterSession *fsess = (GF_FilterSession *)udta;
+	GF_FSTask *task = (GF_FSTask *)item;
+	u32 budget = fsess->sched_slack_us;
+	u64 release = gf_sys_clock_high_res();
+
+	*release_time = task->schedule_next_time;
+	if (release < task->schedule_next_time)
+		release = task->schedule_next_time;
+
+	if (task->filter) {
+		u64 filter_deadline = task->filter->deadline;
+		if (filter_deadline) {
+			*deadline = MAX(filter_deadline, release);
+			return;
+		}
+		if (task->filter->latency_budget)
+			budget = task->filter->latency_budget;
+	}
+	*deadline = release + budget;
+}
+
 GF_EXPORT
 GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u32 flags, const char *blacklist)
 {
@@ -174,11 +202,21 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 		fsess->tasks_mx = gf_mx_new("TasksList");
 	}
 
-	//regardless of scheduler type, we don't use lock on the main task list
-	fsess->tasks = gf_fq_new(fsess->tasks_mx);
+	fsess->sched_slack_us = GF_FS_DEFAULT_SCHED_SLACK;
+	//deadline scheduler, task lists are always mutex-protected
+	if ((flags & GF_FS_FLAG_DEADLINE_SCHED) && !fsess->direct_mode) {
+		fsess->tasks = gf_fq_new_prio(fsess->tasks_mx, gf_fs_task_deadline, fsess);
+	} else {
+		fsess->flags &= ~GF_FS_FLAG_DEADLINE_SCHED;
+		//regardless of scheduler type, we don't use lock on the main task list
+		fsess->tasks = gf_fq_new(fsess->tasks_mx);
+	}
 
 	if (nb_threads>0) {
-		fsess->main_thread_tasks = gf_fq_new(fsess->tasks_mx);
+		if (fsess->flags & GF_FS_FLAG_DEADLINE_SCHED)
+			fsess->main_thread_tasks = gf_fq_new_prio(fsess->tasks_mx, gf_fs_task_deadline, fsess);
+		else
+			fsess->main_thread_tasks = gf_fq_new(fsess->tasks_mx);
 		fsess->filters_mx = gf_mx_new("Filters");
 	} else {
 		//otherwise use the same as the global task list
@@ -302,6 +340,35 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 			fsess->blocking_mode = GF_FS_NOBLOCK;
 		}
 	}
+	fsess->trace_pck = gf_opts_get_bool("core", "pck-trace");
+	opt = gf_opts_get_key("core", "pck-trace-file");
+	if (opt) {
+		fsess->trace_file = gf_fopen(opt, "wt");
+		if (!fsess->trace_file) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to open packet trace file %s\n", opt));
+		} else {
+			fsess->trace_pck = GF_TRUE;
+			fsess->trace_mx = gf_mx_new("PacketTrace");
+			fsess->trace_tracks = gf_list_new();
+			fprintf(fsess->trace_file, "{\"traceEvents\":[\n");
+		}
+	}
+	if (fsess->trace_pck)
+		fsess->trace_start_us = gf_sys_clock_high_res();
+
+	opt = gf_opts_get_key("core", "prof-file");
+	if (opt) {
+		fsess->prof_file = gf_strdup(opt);
+		fsess->prof_ring_size = gf_opts_get_int("core", "prof-size");
+		if (!fsess->prof_ring_size) fsess->prof_ring_size = 65536;
+		fsess->prof_mx = gf_mx_new("Profiler");
+		fsess->prof_filters = gf_list_new();
+		fsess->prof_start_us = gf_sys_clock_high_res();
+#ifdef GPAC_MEMORY_TRACKING
+		gf_mem_enable_timing(GF_TRUE);
+#endif
+	}
+
 	fsess->run_status = GF_EOS;
 	fsess->nb_threads_stopped = 1+nb_threads;
 	fsess->default_pid_buffer_max_us = 1000;
@@ -448,6 +515,9 @@ GF_FilterSession *gf_fs_new_defaults(u32 inflags)
 	if (gf_opts_get_bool("core", "no-reservoir"))
 		flags |= GF_FS_FLAG_NO_RESERVOIR;
 
+	if (gf_opts_get_bool("core", "sched-deadline"))
+		flags |= GF_FS_FLAG_DEADLINE_SCHED;
+
 
 	fsess = gf_fs_new(nb_threads, sched_type, flags, blacklist);
 	if (!fsess) return NULL;
@@ -456,6 +526,15 @@ GF_FilterSession *gf_fs_new_defaults(u32 inflags)
 
 	gf_fs_set_max_sleep_time(fsess, gf_opts_get_int("core", "max-sleep") );
 
+	if (fsess->flags & GF_FS_FLAG_DEADLINE_SCHED)
+		fsess->sched_slack_us = 1000 * gf_opts_get_int("core", "sched-slack");
+
+	if (gf_opts_get_bool("core", "buf-tune")) {
+		fsess->buf_tune = GF_TRUE;
+		fsess->buf_budget = gf_opts_get_int("core", "buf-budget");
+		fsess->buf_budget *= 1024*1024;
+	}
+
 	opt = gf_opts_get_key("core", "seps");
 	if (opt)
 		gf_fs_set_separators(fsess, opt);
@@ -554,6 +633,314 @@ Bool gf_fs_enum_unmapped_options(GF_FilterSession *fsess, u32 *idx, char **argna
 }
 
 
+//max number of trace events kept in memory before writing them to the trace file
+#define GF_FS_TRACE_FLUSH	16384
+
+//histograms are allocated at filter and pid instance creation when tracing is enabled
+void gf_fs_trace_histo_add(GF_FSTraceHisto *h, u64 duration_us)
+{
+	u32 idx;
+	if (!h) return;
+	if (duration_us < 8) {
+		idx = (u32) duration_us;
+	} else {
+		u32 msb = 3;
+		while ((msb<63) && (duration_us >> (msb+1))) msb++;
+		idx = 8 + (msb-3)*4 + (u32) ((duration_us >> (msb-2)) & 3);
+		if (idx >= GF_FS_TRACE_HISTO_SIZE) idx = GF_FS_TRACE_HISTO_SIZE-1;
+	}
+	h->buckets[idx]++;
+	h->nb_samples++;
+	h->total_us += duration_us;
+	if (duration_us > h->max_us) h->max_us = duration_us;
+}
+
+static u64 gf_fs_trace_histo_percentile(GF_FSTraceHisto *h, u32 percent)
+{
+	u32 i;
+	u64 nb=0, target;
+	if (!h->nb_samples) return 0;
+	target = (h->nb_samples * percent + 99) / 100;
+	for (i=0; i<GF_FS_TRACE_HISTO_SIZE; i++) {
+		u64 bucket_max;
+		nb += h->buckets[i];
+		if (nb < target) continue;
+		//return upper bound of the bucket
+		if (i<8) {
+			bucket_max = i;
+		} else {
+			u32 msb = 3 + (i-8)/4;
+			bucket_max = (((u64) 5 + (i-8)%4) << (msb-2)) - 1;
+		}
+		return (bucket_max < h->max_us) ? bucket_max : h->max_us;
+	}
+	return h->max_us;
+}
+
+static void gf_fs_trace_write_str(FILE *f, const char *str)
+{
+	fputc('"', f);
+	while (str && *str) {
+		if ((*str=='"') || (*str=='\\')) fputc('\\', f);
+		if ((u8) *str >= 0x20) fputc(*str, f);
+		str++;
+	}
+	fputc('"', f);
+}
+
+//Chrome trace writer shared by packet tracing and the profiler: starts an event object, the caller writes the remaining fields and closes it
+static void gf_fs_trace_write_event(FILE *f, Bool *has_events, const char *name, const char *cat, const char *ph, u32 tid)
+{
+	if (*has_events) fputs(",\n", f);
+	*has_events = GF_TRUE;
+	fputs("{\"name\":", f);
+	gf_fs_trace_write_str(f, name);
+	if (cat) fprintf(f, ",\"cat\":\"%s\"", cat);
+	fprintf(f, ",\"ph\":\"%s\",\"pid\":1,\"tid\":%u", ph, tid);
+}
+
+//names the session threads, main thread is 0, and closes the trace
+static void gf_fs_trace_write_end(GF_FilterSession *fsess, FILE *f, Bool *has_events)
+{
+	u32 i, count = fsess->threads ? gf_list_count(fsess->threads) : 0;
+
+	gf_fs_trace_write_event(f, has_events, "process_name", NULL, "M", 0);
+	fputs(",\"args\":{\"name\":\"gpac\"}}", f);
+	for (i=0; i<=count; i++) {
+		gf_fs_trace_write_event(f, has_events, "thread_name", NULL, "M", i);
+		if (!i)
+			fputs(",\"args\":{\"name\":\"Main thread\"}}", f);
+		else
+			fprintf(f, ",\"args\":{\"name\":\"Thread %u\"}}", i);
+	}
+	fputs("\n],\n\"displayTimeUnit\":\"ms\"}\n", f);
+}
+
+static void gf_fs_trace_flush(GF_FilterSession *fsess)
+{
+	u32 i;
+	FILE *f = fsess->trace_file;
+	for (i=0; i<fsess->nb_trace_events; i++) {
+		GF_FSTraceEvent *evt = &fsess->trace_events[i];
+		const char *name = gf_list_get(fsess->trace_tracks, evt->track);
+
+		if (evt->task_name) {
+			gf_fs_trace_write_event(f, &fsess->trace_has_events, name, "task", "X", evt->id);
+			fprintf(f, ",\"ts\":"LLU",\"dur\":"LLU",\"args\":{\"task\":\"%s\"}}", evt->start_us, evt->dur_us, evt->task_name);
+		} else {
+			gf_fs_trace_write_event(f, &fsess->trace_has_events, name, "queue", "b", 0);
+			fprintf(f, ",\"id\":%u,\"ts\":"LLU"}", evt->id, evt->start_us);
+			gf_fs_trace_write_event(f, &fsess->trace_has_events, name, "queue", "e", 0);
+			fprintf(f, ",\"id\":%u,\"ts\":"LLU"}", evt->id, evt->start_us + evt->dur_us);
+		}
+	}
+	fsess->nb_trace_events = 0;
+}
+
+static void gf_fs_trace_push(GF_FilterSession *fsess, u32 *track, GF_Filter *filter, GF_FilterPidInst *pidinst, u32 id, const char *task_name, u64 start_us, u64 dur_us)
+{
+	GF_FSTraceEvent *evt;
+	gf_mx_p(fsess->trace_mx);
+	//track names are copied since filters and pids may be destroyed before the trace is written
+	if (! *track) {
+		char *name = NULL;
+		if (filter) {
+			gf_dynstrcat(&name, filter->name, NULL);
+		} else {
+			gf_dynstrcat(&name, pidinst->pid->filter->name, NULL);
+			gf_dynstrcat(&name, pidinst->pid->name, ".");
+			gf_dynstrcat(&name, pidinst->filter ? pidinst->filter->name : "none", " -> ");
+		}
+		gf_list_add(fsess->trace_tracks, name);
+		*track = gf_list_count(fsess->trace_tracks);
+	}
+	if (fsess->nb_trace_events == fsess->nb_alloc_trace_events) {
+		if (fsess->nb_alloc_trace_events >= GF_FS_TRACE_FLUSH) {
+			gf_fs_trace_flush(fsess);
+		} else {
+			GF_FSTraceEvent *events = gf_realloc(fsess->trace_events, sizeof(GF_FSTraceEvent) * (fsess->nb_alloc_trace_events + 1024));
+			//keep the pending events, write them out to make room for the new one
+			if (!events) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Failed to grow trace event buffer, flushing\n"));
+				if (fsess->nb_trace_events) {
+					gf_fs_trace_flush(fsess);
+				} else {
+					gf_mx_v(fsess->trace_mx);
+					return;
+				}
+			} else {
+				fsess->trace_events = events;
+				fsess->nb_alloc_trace_events += 1024;
+			}
+		}
+	}
+	evt = &fsess->trace_events[fsess->nb_trace_events];
+	evt->start_us = start_us - fsess->trace_start_us;
+	evt->dur_us = dur_us;
+	evt->id = id;
+	evt->track = *track - 1;
+	evt->task_name = task_name;
+	fsess->nb_trace_events++;
+	gf_mx_v(fsess->trace_mx);
+}
+
+void gf_fs_trace_task(GF_FilterSession *fsess, GF_Filter *filter, u32 thread_idx, const char *task_name, u64 start_us, u64 dur_us)
+{
+	gf_fs_trace_histo_add(filter->trace_task, dur_us);
+	if (fsess->trace_file)
+		gf_fs_trace_push(fsess, &filter->trace_track, filter, NULL, thread_idx, task_name ? task_name : "task", start_us, dur_us);
+}
+
+void gf_fs_trace_queue(GF_FilterSession *fsess, GF_FilterPidInst *pidinst, u64 start_us, u64 dur_us)
+{
+	gf_fs_trace_histo_add(pidinst->trace_wait, dur_us);
+	if (fsess->trace_file)
+		gf_fs_trace_push(fsess, &pidinst->trace_track, NULL, pidinst, safe_int_inc(&fsess->trace_evt_id), NULL, start_us, dur_us);
+}
+
+static void gf_fs_trace_close(GF_FilterSession *fsess)
+{
+	gf_fs_trace_flush(fsess);
+	gf_fs_trace_write_end(fsess, fsess->trace_file, &fsess->trace_has_events);
+	gf_fclose(fsess->trace_file);
+	fsess->trace_file = NULL;
+
+	while (gf_list_count(fsess->trace_tracks)) {
+		char *name = gf_list_pop_back(fsess->trace_tracks);
+		gf_free(name);
+	}
+	gf_list_del(fsess->trace_tracks);
+	fsess->trace_tracks = NULL;
+	if (fsess->trace_events) gf_free(fsess->trace_events);
+	fsess->trace_events = NULL;
+	gf_mx_del(fsess->trace_mx);
+	fsess->trace_mx = NULL;
+}
+
+static void gf_fs_prof_push(GF_FilterSession *fsess, GF_SessionThread *sess_thread, GF_Filter *filter, const char *task_name, u64 start_us, u64 dur_us, u64 alloc_us)
+{
+	GF_FSProfEvent *evt;
+	//allocated by the thread itself, the ring is never accessed by other threads before the session is destroyed
+	if (!sess_thread->prof_ring) {
+		sess_thread->prof_ring = gf_malloc(sizeof(GF_FSProfEvent) * fsess->prof_ring_size);
+		if (!sess_thread->prof_ring) return;
+	}
+	if (filter && !filter->prof_id) {
+		GF_FSProfFilter *pf;
+		GF_SAFEALLOC(pf, GF_FSProfFilter);
+		if (pf) {
+			gf_mx_p(fsess->prof_mx);
+			gf_list_add(fsess->prof_filters, pf);
+			filter->prof_id = gf_list_count(fsess->prof_filters);
+			gf_mx_v(fsess->prof_mx);
+		}
+	}
+	evt = &sess_thread->prof_ring[sess_thread->prof_nb_events % fsess->prof_ring_size];
+	evt->start_us = start_us - fsess->prof_start_us;
+	evt->dur_us = (u32) dur_us;
+	evt->alloc_us = (u32) alloc_us;
+	evt->filter_id = filter ? filter->prof_id : 0;
+	evt->task_name = task_name;
+	sess_thread->prof_nb_events++;
+}
+
+void gf_fs_prof_filter_done(GF_FilterSession *fsess, GF_Filter *filter)
+{
+	GF_FSProfFilter *pf;
+	gf_mx_p(fsess->prof_mx);
+	pf = gf_list_get(fsess->prof_filters, filter->prof_id - 1);
+	if (pf) {
+		//filter names may change after the first task, keep the final one
+		if (pf->name) gf_free(pf->name);
+		pf->name = gf_strdup(filter->name ? filter->name : filter->freg->name);
+		pf->nb_tasks = filter->nb_tasks_done;
+		pf->process_us = filter->time_process;
+		pf->alloc_us = filter->prof_alloc_us;
+	}
+	gf_mx_v(fsess->prof_mx);
+	filter->prof_id = 0;
+}
+
+static void gf_fs_prof_close(GF_FilterSession *fsess)
+{
+	u32 i, j, count;
+	u64 total_us = 0;
+	FILE *f;
+
+#ifdef GPAC_MEMORY_TRACKING
+	gf_mem_enable_timing(GF_FALSE);
+#endif
+
+	count = gf_list_count(fsess->prof_filters);
+	f = gf_fopen(fsess->prof_file, "wt");
+	if (!f) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to open profiler file %s\n", fsess->prof_file));
+	} else {
+		Bool has_events = GF_FALSE;
+		u32 nb_threads = fsess->threads ? gf_list_count(fsess->threads) : 0;
+		fprintf(f, "{\"traceEvents\":[\n");
+		//main thread is 0
+		for (i=0; i<=nb_threads; i++) {
+			u64 nb_events, first;
+			GF_SessionThread *sess_th = i ? gf_list_get(fsess->threads, i-1) : &fsess->main_th;
+
+			if (!sess_th->prof_ring) continue;
+			nb_events = sess_th->prof_nb_events;
+			if (nb_events > fsess->prof_ring_size) nb_events = fsess->prof_ring_size;
+			first = sess_th->prof_nb_events - nb_events;
+			if (first) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("Profiler ring of thread %d wrapped, "LLU" oldest events dropped - increase prof-size to keep them\n", i, first));
+			}
+			for (j=0; j<nb_events; j++) {
+				GF_FSProfFilter *pf;
+				GF_FSProfEvent *evt = &sess_th->prof_ring[(first + j) % fsess->prof_ring_size];
+				if (!evt->task_name) {
+					gf_fs_trace_write_event(f, &has_events, "wait", "wait", "X", i);
+					fprintf(f, ",\"ts\":"LLU",\"dur\":%u}", evt->start_us, evt->dur_us);
+					continue;
+				}
+				pf = evt->filter_id ? gf_list_get(fsess->prof_filters, evt->filter_id-1) : NULL;
+				gf_fs_trace_write_event(f, &has_events, pf ? (pf->name ? pf->name : "unknown") : "session", evt->filter_id ? "filter" : "session", "X", i);
+				fprintf(f, ",\"ts\":"LLU",\"dur\":%u,\"args\":{\"task\":\"%s\"", evt->start_us, evt->dur_us, evt->task_name);
+#ifdef GPAC_MEMORY_TRACKING
+				fprintf(f, ",\"alloc_us\":%u}}", evt->alloc_us);
+#else
+				fputs("}}", f);
+#endif
+			}
+		}
+		gf_fs_trace_write_end(fsess, f, &has_events);
+		gf_fclose(f);
+	}
+
+	//per-filter CPU attribution
+	for (i=0; i<count; i++) {
+		GF_FSProfFilter *pf = gf_list_get(fsess->prof_filters, i);
+		total_us += pf->process_us;
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("Profiler: "LLU" us spent in %d filters, timeline written to %s\n", total_us, count, fsess->prof_file));
+	for (i=0; i<count; i++) {
+		GF_FSProfFilter *pf = gf_list_get(fsess->prof_filters, i);
+		GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("\t%s: "LLU" tasks, "LLU" us (%.02f %%)", pf->name ? pf->name : "unknown", pf->nb_tasks, pf->process_us, total_us ? (100.0 * pf->process_us) / total_us : 0.0));
+#ifdef GPAC_MEMORY_TRACKING
+		GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, (", "LLU" us in allocator", pf->alloc_us));
+#endif
+		GF_LOG(GF_LOG_INFO, GF_LOG_FILTER, ("\n"));
+	}
+
+	while (gf_list_count(fsess->prof_filters)) {
+		GF_FSProfFilter *pf = gf_list_pop_back(fsess->prof_filters);
+		if (pf->name) gf_free(pf->name);
+		gf_free(pf);
+	}
+	gf_list_del(fsess->prof_filters);
+	fsess->prof_filters = NULL;
+	gf_mx_del(fsess->prof_mx);
+	fsess->prof_mx = NULL;
+	gf_free(fsess->prof_file);
+	fsess->prof_file = NULL;
+}
+
 GF_EXPORT
 void gf_fs_del(GF_FilterSession *fsess)
 {
@@ -639,6 +1026,12 @@ void gf_fs_del(GF_FilterSession *fsess)
 		gf_list_del(fsess->registry);
 	}
 
+	if (fsess->trace_file)
+		gf_fs_trace_close(fsess);
+
+	if (fsess->prof_file)
+		gf_fs_prof_close(fsess);
+
 	if (fsess->tasks)
 		gf_fq_del(fsess->tasks, gf_void_del);
 
@@ -652,10 +1045,13 @@ void gf_fs_del(GF_FilterSession *fsess)
 		while (gf_list_count(fsess->threads)) {
 			GF_SessionThread *sess_th = gf_list_pop_back(fsess->threads);
 			gf_th_del(sess_th->th);
+			if (sess_th->prof_ring) gf_free(sess_th->prof_ring);
 			gf_free(sess_th);
 		}
 		gf_list_del(fsess->threads);
 	}
+	if (fsess->main_th.prof_ring)
+		gf_free(fsess->main_th.prof_ring);
 
 	if (fsess->prop_maps_reservoir)
 		gf_fq_del(fsess->prop_maps_reservoir, gf_propmap_del);
@@ -778,9 +1174,12 @@ void gf_fs_post_task_ex(GF_FilterSession *fsess, gf_fs_task_callback task_fun, G
 		task_fun(&atask);
 		filter = atask.filter;
 		if (filter) {
-			filter->time_process += gf_sys_clock_high_res() - task_time;
+			u64 now = gf_sys_clock_high_res();
+			filter->time_process += now - task_time;
 			filter->scheduled_for_next_task = GF_FALSE;
 			filter->nb_tasks_done++;
+			if (fsess->trace_pck)
+				gf_fs_trace_task(fsess, filter, 0, log_name, task_time, now - task_time);
 		}
 		if (!atask.requeue_request)
 			return;
@@ -1066,6 +1465,27 @@ GF_Filter *gf_fs_load_filter(GF_FilterSession *fsess, const char *name, GF_Err *
 //this defines the sleep time for this case
 #define MONOTH_MIN_SLEEP	5
 
+//check if a released task in the session lists has an earlier deadline than the next run of the filter
+static Bool gf_fs_deadline_preempt(GF_FilterSession *fsess, GF_Filter *filter, u32 thid)
+{
+	u64 next_deadline, deadline;
+	if (filter->deadline) {
+		next_deadline = filter->deadline;
+	} else {
+		u32 budget = filter->latency_budget ? filter->latency_budget : fsess->sched_slack_us;
+		//only yield to tasks due well before our next deadline, so that filters with the same budget are not switched after each task
+		next_deadline = MAX(filter->schedule_next_time, gf_sys_clock_high_res());
+		next_deadline += budget/2;
+	}
+	deadline = gf_fq_head_deadline(fsess->tasks);
+	if (deadline && (deadline < next_deadline)) return GF_TRUE;
+	if (!thid && (fsess->main_thread_tasks != fsess->tasks)) {
+		deadline = gf_fq_head_deadline(fsess->main_thread_tasks);
+		if (deadline && (deadline < next_deadline)) return GF_TRUE;
+	}
+	return GF_FALSE;
+}
+
 static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 {
 	GF_FilterSession *fsess = sess_thread->fsess;
@@ -1101,7 +1521,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 	while (1) {
 		Bool notified;
 		Bool requeue = GF_FALSE;
-		u64 active_start, task_time;
+		u64 active_start, task_time, alloc_time=0;
 		GF_FSTask *task=NULL;
 #ifdef CHECK_TASK_LIST_INTEGRITY
 		GF_Filter *prev_current_filter = NULL;
@@ -1120,12 +1540,18 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 		safe_int_dec(&fsess->active_threads);
 
 		if (!skip_next_sema_wait && (current_filter==NULL)) {
+			u64 wait_start = fsess->prof_file ? gf_sys_clock_high_res() : 0;
 			gf_rmt_begin(sema_wait, GF_RMT_AGGREGATE);
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_SCHEDULER, ("Thread %u Waiting scheduler %s semaphore\n", sys_thid, use_main_sema ? "main" : "secondary"));
 			//wait for something to be done
 			gf_fs_sema_io(fsess, GF_FALSE, use_main_sema);
 			consecutive_filter_tasks = 0;
 			gf_rmt_end();
+			if (wait_start) {
+				u64 wait_time = gf_sys_clock_high_res() - wait_start;
+				sess_thread->prof_wait_us += wait_time;
+				gf_fs_prof_push(fsess, sess_thread, NULL, NULL, wait_start, wait_time, 0);
+			}
 		}
 		safe_int_inc(&fsess->active_threads);
 		skip_next_sema_wait = GF_FALSE;
@@ -1460,6 +1886,9 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 		safe_int_inc(& fsess->tasks_in_process );
 		assert( task->run_task );
+#ifdef GPAC_MEMORY_TRACKING
+		alloc_time = fsess->prof_file ? gf_mem_get_thread_time() : 0;
+#endif
 		task_time = gf_sys_clock_high_res();
 
 		task->can_swap = GF_FALSE;
@@ -1470,6 +1899,15 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 		task_time = gf_sys_clock_high_res() - task_time;
 		safe_int_dec(& fsess->tasks_in_process );
 
+		if (fsess->prof_file) {
+#ifdef GPAC_MEMORY_TRACKING
+			alloc_time = gf_mem_get_thread_time() - alloc_time;
+			if (task->filter) task->filter->prof_alloc_us += alloc_time;
+#endif
+			//task->filter is NULL if the task destroyed the filter
+			gf_fs_prof_push(fsess, sess_thread, task->filter, task->log_name ? task->log_name : "task", gf_sys_clock_high_res() - task_time, task_time, alloc_time);
+		}
+
 		//may now be NULL if task was a filter destruction task
 		current_filter = task->filter;
 
@@ -1481,6 +1919,8 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 		if (current_filter) {
 			current_filter->nb_tasks_done++;
 			current_filter->time_process += task_time;
+			if (fsess->trace_pck)
+				gf_fs_trace_task(fsess, current_filter, thid, task->log_name, gf_sys_clock_high_res() - task_time, task_time);
 			consecutive_filter_tasks++;
 
 			gf_mx_p(current_filter->tasks_mx);
@@ -1495,6 +1935,8 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 				//or requeue request and we have been running on that filter for more than 10 times, abort
 				|| (requeue && (consecutive_filter_tasks>10))
+				//or requeue request in deadline mode and a released task must run before the next execution of this filter
+				|| (requeue && (fsess->flags & GF_FS_FLAG_DEADLINE_SCHED) && gf_fs_deadline_preempt(fsess, current_filter, thid))
 			) {
 
 				if (requeue) {
@@ -1837,6 +2279,11 @@ static GFINLINE void print_filter_name(GF_Filter *f, Bool skip_id, Bool skip_arg
 	GF_LOG(GF_LOG_INFO, GF_LOG_APP, (")"));
 }
 
+static void gf_fs_print_trace_histo(const char *name, GF_FSTraceHisto *h)
+{
+	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\t\t%s: "LLU" samples avg "LLU" us p50 "LLU" us p99 "LLU" us max "LLU" us\n", name, h->nb_samples, h->nb_samples ? h->total_us / h->nb_samples : 0, gf_fs_trace_histo_percentile(h, 50), gf_fs_trace_histo_percentile(h, 99), h->max_us));
+}
+
 GF_EXPORT
 void gf_fs_print_stats(GF_FilterSession *fsess)
 {
@@ -1879,6 +2326,11 @@ void gf_fs_print_stats(GF_FilterSession *fsess)
 					GF_LOG(GF_LOG_INFO, GF_LOG_APP, (" (%g pck/sec)", (Double) f->nb_hw_pck_sent*1000000/f->time_process));
 				}
 
+			} else if (f->nb_view_pck_sent) {
+				GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\t\t"LLU" frame views sent", f->nb_view_pck_sent));
+				if (f->time_process) {
+					GF_LOG(GF_LOG_INFO, GF_LOG_APP, (" (%g pck/sec)", (Double) f->nb_view_pck_sent*1000000/f->time_process));
+				}
 			} else if (f->nb_pck_sent) {
 				GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\t\t"LLU" packets sent "LLU" bytes sent", f->nb_pck_sent, f->nb_bytes_sent));
 				if (f->time_process) {
@@ -1888,15 +2340,20 @@ void gf_fs_print_stats(GF_FilterSession *fsess)
 			GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\n"));
 		}
 
+		if (f->trace_task && f->trace_task->nb_samples) gf_fs_print_trace_histo("task time", f->trace_task);
+		if (f->trace_send && f->trace_send->nb_samples) gf_fs_print_trace_histo("packet creation to dispatch", f->trace_send);
+
 		for (k=0; k<ipids; k++) {
 			GF_FilterPidInst *pid = gf_list_get(f->input_pids, k);
 			if (!pid->pid) continue;
 			GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\t\t* input PID %s: %d packets received\n", pid->pid->name, pid->pid->nb_pck_sent));
+			if (pid->trace_wait && pid->trace_wait->nb_samples) gf_fs_print_trace_histo("\tqueue wait", pid->trace_wait);
+			if (pid->trace_hold && pid->trace_hold->nb_samples) gf_fs_print_trace_histo("\tpacket hold", pid->trace_hold);
 		}
 #ifndef GPAC_DISABLE_LOG
 		for (k=0; k<opids; k++) {
 			GF_FilterPid *pid = gf_list_get(f->output_pids, k);
-			GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\t\t* output PID %s: %d packets sent\n", pid->name, pid->nb_pck_sent));
+			GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\t\t* output PID %s: %d packets sent - max buffer %u units / "LLU" us - blocked "LLU" us (%u times)\n", pid->name, pid->nb_pck_sent, pid->max_buffer_unit, pid->max_buffer_time, pid->block_time_us, pid->nb_blocks));
 		}
 		if (f->nb_errors) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\t\t%d errors while processing\n", f->nb_errors));
@@ -1925,6 +2382,9 @@ void gf_fs_print_stats(GF_FilterSession *fsess)
 		nb_tasks+=s->nb_tasks;
 	}
 	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\nTotal: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", run_time, active_time, nb_tasks));
+	if (fsess->graph_nb_builds || fsess->graph_nb_loads) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("Filter graph: %u builds %u loads from graph file - "LLU" us total ("LLU" us saved)\n", fsess->graph_nb_builds, fsess->graph_nb_loads, fsess->graph_build_us, fsess->graph_saved_us));
+	}
 }
 
 static void gf_fs_print_filter_outputs(GF_Filter *f, GF_List *filters_done, u32 indent, GF_FilterPid *pid, GF_Filter *alias_for)
@@ -2931,7 +3391,7 @@ GF_Err gf_filter_get_stats(GF_Filter *f, GF_FilterStats *stats)
 	stats->nb_pck_processed = f->nb_pck_processed;
 	stats->nb_bytes_processed = f->nb_bytes_processed;
 	stats->time_process = f->time_process;
-	stats->nb_hw_pck_sent = f->nb_hw_pck_sent;
+	stats->nb_hw_pck_sent = f->nb_hw_pck_sent + f->nb_view_pck_sent;
 	stats->nb_pck_sent = f->nb_pck_sent;
 	stats->nb_bytes_sent = f->nb_bytes_sent;
 	stats->nb_tasks_done = f->nb_tasks_done;
@@ -112,6 +112,15 @@ typedef struct __gf_filter_queue GF_FilterQueue;
 //constructs a new fifo queue. If mx is set all pop/add/head operations are protected by the mutex
 //otherwise, a lock-free version of the fifo is used
 GF_FilterQueue *gf_fq_new(const GF_Mutex *mx);
+//constructs a new single-producer single-consumer fifo queue, made of chained ring segments with producer and consumer indices on separate cache lines
+//the queue has no lock: add/reserve shall only be called from the producer context, pop/head/get/enum only from the consumer context
+GF_FilterQueue *gf_fq_new_spsc();
+//constructs a new earliest deadline first queue. get_keys is called each time an item is added and returns the item release time (system clock, 0 if none) and deadline.
+//Items already released are dequeued by increasing deadline then in insertion order, if no item is released the first item to be due is dequeued.
+//All operations are protected by the mutex; if mx is NULL, the queue creates its own mutex
+GF_FilterQueue *gf_fq_new_prio(const GF_Mutex *mx, void (*get_keys)(void *udta, void *item, u64 *release_time, u64 *deadline), void *udta);
+//returns the deadline of the first released item in an EDF queue, 0 if none
+u64 gf_fq_head_deadline(GF_FilterQueue *fq);
 void gf_fq_del(GF_FilterQueue *fq, void (*item_delete)(void *) );
 void gf_fq_add(GF_FilterQueue *fq, void *item);
 void *gf_fq_pop(GF_FilterQueue *fq);
@@ -119,6 +128,13 @@ void *gf_fq_head(GF_FilterQueue *fq);
 u32 gf_fq_count(GF_FilterQueue *fq);
 void *gf_fq_get(GF_FilterQueue *fq, u32 idx);
 void gf_fq_enum(GF_FilterQueue *fq, Bool (*enum_func)(void *udta1, void *item), void *udta);
+//makes sure nb_items can be added to the queue without allocation failure - only does something in SPSC mode, other modes allocate on add
+//returns GF_FALSE if out of memory
+Bool gf_fq_reserve(GF_FilterQueue *fq, u32 nb_items);
+//adds nb_items items to the queue - in SPSC mode, items are published at once
+void gf_fq_add_batch(GF_FilterQueue *fq, void **items, u32 nb_items);
+//pops at most max_items items from the queue and returns the number of items popped
+u32 gf_fq_pop_batch(GF_FilterQueue *fq, void **items, u32 max_items);
 
 
 typedef void (*gf_destruct_fun)(void *cbck);
@@ -134,10 +150,54 @@ typedef struct __gf_filter_pck_inst
 	GF_FilterPidInst *pid;
 	u8 pid_props_change_done;
 	u8 pid_info_change_done;
+	//packet tracing: dispatch time and first fetch time by the consumer, in us
+	u64 trace_send_us, trace_fetch_us;
+	//buffer auto-tuning: packet size accounted in the session queued bytes, 0 if not accounted
+	u32 queued_bytes;
 
 	//DO NOT EXTEND UNLESS UPDATING CODE IN gf_filter_pck_send()
 } GF_FilterPacketInstance;
 
+//packet tracing: log-linear histogram of durations in us, 4 sub-buckets per power of 2 (values below 8 us are exact)
+#define GF_FS_TRACE_HISTO_SIZE	128
+typedef struct
+{
+	u64 nb_samples, total_us, max_us;
+	u32 buckets[GF_FS_TRACE_HISTO_SIZE];
+} GF_FSTraceHisto;
+
+//packet tracing: timeline event, exported in Chrome trace format
+typedef struct
+{
+	u64 start_us, dur_us;
+	//thread index for tasks, async event ID for queue events
+	u32 id;
+	//index of track name (filter name or pid connection name) in session trace tracks
+	u32 track;
+	//task name for task events, NULL for queue events
+	const char *task_name;
+} GF_FSTraceEvent;
+
+//profiler: time slice recorded in the ring of the thread executing it
+typedef struct
+{
+	u64 start_us;
+	u32 dur_us;
+	//time spent in the memory allocator during the slice, only measured with memory tracking
+	u32 alloc_us;
+	//profiler ID of the filter (index + 1 in session profiled filters), 0 for semaphore waits and session tasks
+	u32 filter_id;
+	//task name, NULL for semaphore waits
+	const char *task_name;
+} GF_FSProfEvent;
+
+//profiler: filter totals, copied when the filter is destroyed since the ring may have wrapped
+typedef struct
+{
+	char *name;
+	u64 nb_tasks, process_us, alloc_us;
+} GF_FSProfFilter;
+
 
 //packet flags
 enum
@@ -234,6 +294,9 @@ struct __gf_filter_pck
 	GF_PropertyMap *props;
 	//pid properties applying to this packet
 	GF_PropertyMap *pid_props;
+
+	//packet tracing: creation time in us
+	u64 trace_create_us;
 };
 
 /*!
@@ -285,6 +348,12 @@ typedef struct __gf_fs_thread
 	char rmt_name[20];
 #endif
 
+	//profiler ring, only written by this thread and read once all threads are done
+	GF_FSProfEvent *prof_ring;
+	//total number of events recorded, the ring keeps the last prof_ring_size ones
+	u64 prof_nb_events;
+	u64 prof_wait_us;
+
 } GF_SessionThread;
 
 typedef struct
@@ -388,6 +457,11 @@ struct __gf_filter_session
 	u32 default_pid_buffer_max_us, decoder_pid_buffer_max_us;
 	u32 default_pid_buffer_max_units;
 
+	//PID buffer auto-tuning: memory budget in bytes (0 for none) and bytes currently queued in PID instances - concurrent inc/dec
+	Bool buf_tune;
+	u64 buf_budget;
+	volatile s64 buf_queued_bytes;
+
 #ifdef GPAC_MEMORY_TRACKING
 	Bool check_allocs;
 	u32 nb_alloc_pck, nb_realloc_pck;
@@ -403,10 +477,15 @@ struct __gf_filter_session
 	u32 max_resolve_chain_len;
 	//max sleep time
 	u32 max_sleep;
+	//deadline scheduler: latency budget in us of tasks for filters without declared latency budget
+	u32 sched_slack_us;
 
 	//protect access to link bank
 	GF_Mutex *links_mx;
 	GF_List *links;
+	//link graph build stats: cumulated build/load time, time saved by loading from the graph file
+	u64 graph_build_us, graph_saved_us;
+	u32 graph_nb_builds, graph_nb_loads;
 
 
 	GF_List *parsed_args;
@@ -415,6 +494,24 @@ struct __gf_filter_session
 	const char *blacklist;
 	Bool init_done;
 
+	//packet tracing, only enabled through pck-trace and pck-trace-file options
+	Bool trace_pck;
+	u64 trace_start_us;
+	FILE *trace_file;
+	GF_Mutex *trace_mx;
+	GF_List *trace_tracks;
+	GF_FSTraceEvent *trace_events;
+	u32 nb_trace_events, nb_alloc_trace_events;
+	volatile u32 trace_evt_id;
+	Bool trace_has_events;
+
+	//profiler, only enabled through prof-file option
+	char *prof_file;
+	u32 prof_ring_size;
+	u64 prof_start_us;
+	GF_Mutex *prof_mx;
+	GF_List *prof_filters;
+
 	GF_List *auto_inc_nums;
 #ifndef GPAC_DISABLE_3D
 	GF_List *gl_providers;
@@ -530,6 +627,8 @@ struct __gf_filter
 	GF_FilterQueue *pcks_shared_reservoir;
 	//reservoir for packets instances - the ones stored in the pid destination(s) with shared memory
 	GF_FilterQueue *pcks_inst_reservoir;
+	//reservoir for frame view objects, see gf_filter_pck_new_frame_view
+	GF_FilterQueue *frame_views_reservoir;
 
 	GF_Mutex *pcks_mx;
 
@@ -580,6 +679,8 @@ struct __gf_filter
 	u64 nb_pck_sent;
 	//number of hardware frames packets sent by this filter
 	u64 nb_hw_pck_sent;
+	//number of frame views sent by this filter
+	u64 nb_view_pck_sent;
 	//number of processing errors in the lifetime of the filter
 	u32 nb_errors;
 
@@ -588,6 +689,15 @@ struct __gf_filter
 	//number of microseconds this filter was active
 	u64 time_process;
 
+	//packet tracing: task execution time and packet creation to dispatch time histograms
+	GF_FSTraceHisto *trace_task, *trace_send;
+	//packet tracing: track index + 1 of this filter, 0 if not assigned
+	u32 trace_track;
+	//profiler: index + 1 of this filter in session profiled filters, 0 if not assigned
+	u32 prof_id;
+	//profiler: time spent in the memory allocator by the filter tasks
+	u64 prof_alloc_us;
+
 #ifdef GPAC_MEMORY_TRACKING
 	//various stats in mem tracking mode, mostly used to detect heavy alloc/free usage by the filter
 	u64 stats_mem_allocated;
@@ -630,6 +740,10 @@ struct __gf_filter
 
 	//time in system clock at which the process should be called, used for real-time regulation of some filters
 	u64 schedule_next_time;
+	//deadline scheduler: deadline in system clock for the next task of the filter, reset before each task execution
+	u64 deadline;
+	//deadline scheduler: max latency in us between the time a task is due and its execution, 0 means session default
+	u32 latency_budget;
 
 	//clock (PCR) dispatch info
 	u64 next_clock_dispatch;
@@ -805,6 +919,12 @@ struct __gf_filter_pid_inst
 
 	GF_Fraction64 last_ts_drop;
 
+	//packet tracing: queue wait (dispatch to first fetch) and hold (first fetch to drop) time histograms
+	GF_FSTraceHisto *trace_wait, *trace_hold;
+	//packet tracing: track index + 1 of this connection, 0 if not assigned
+	u32 trace_track;
+	//set when packets were queued during a batch send and the process task is not yet posted
+	Bool batch_post_pending;
 };
 
 struct __gf_filter_pid
@@ -846,6 +966,14 @@ struct __gf_filter_pid
 	u32 user_max_buffer_time, user_max_playout_time, user_min_playout_time;
 	//max buffered duration of packets in each of the destination pids - concurrent inc/dec
 	u64 buffer_duration;
+	//buffer auto-tuning: limits before tuning (0 if not tuned yet), start of current tuning window, number of limit increases in window and number of blocks at last starvation
+	u32 tune_base_unit;
+	u64 tune_base_time;
+	u64 tune_window_start;
+	u32 tune_nb_grow, tune_last_blocks;
+	//blocking stats: time at which the PID blocked (0 if not blocked), total time in us the PID was blocked and number of blocking periods
+	u64 block_start_us, block_time_us;
+	u32 nb_blocks;
 	//true if the pid carries raw media
 	Bool raw_media;
 	//for stats only
@@ -880,6 +1008,9 @@ struct __gf_filter_pid
 	//only used in filter_check_caps
 	GF_PropertyMap *local_props;
 	volatile u32 num_pidinst_del_pending;
+
+	//set while a batch of packets is being dispatched, buffer state update and task posting are done once at the end of the batch
+	Bool in_batch_send;
 };
 
 
@@ -940,6 +1071,10 @@ void gf_filter_remove_internal(GF_Filter *filter, GF_Filter *until_filter, Bool
 GF_FilterPacket *gf_filter_pck_new_shared_internal(GF_FilterPid *pid, const u8 *data, u32 data_size, gf_fsess_packet_destructor destruct, Bool intern_pck);
 
 void gf_filter_sess_build_graph(GF_FilterSession *fsess, const GF_FilterRegister *freg);
+void gf_fs_trace_histo_add(GF_FSTraceHisto *histo, u64 duration_us);
+void gf_fs_trace_task(GF_FilterSession *fsess, GF_Filter *filter, u32 thread_idx, const char *task_name, u64 start_us, u64 dur_us);
+void gf_fs_trace_queue(GF_FilterSession *fsess, GF_FilterPidInst *pidinst, u64 start_us, u64 dur_us);
+void gf_fs_prof_filter_done(GF_FilterSession *fsess, GF_Filter *filter);
 void gf_filter_sess_reset_graph(GF_FilterSession *fsess, const GF_FilterRegister *freg);
 
 Bool gf_fs_ui_event(GF_FilterSession *session, GF_Event *uievt);
@@ -996,6 +1131,8 @@ typedef struct __freg_desc
 
 #ifdef GPAC_MEMORY_TRACKING
 size_t gf_mem_get_stats(unsigned int *nb_allocs, unsigned int *nb_callocs, unsigned int *nb_reallocs, unsigned int *nb_free);
+void gf_mem_enable_timing(unsigned int enable);
+u64 gf_mem_get_thread_time();
 #endif
 
 void gf_filter_post_process_task_internal(GF_Filter *filter, Bool use_direct_dispatch);
@@ -1121,10 +1121,10 @@ GF_Err gf_fs_load_js_api(JSContext *c, GF_FilterSession *fs)
 	
 
 	//initialize filter class and create a single filter object in global scope
-	JS_NewClassID(&fs_class_id);
+	gf_js_new_class_id(&fs_class_id);
 	JS_NewClass(rt, fs_class_id, &fs_class);
 
-	JS_NewClassID(&fs_f_class_id);
+	gf_js_new_class_id(&fs_f_class_id);
 	JS_NewClass(rt, fs_f_class_id, &fs_f_class);
 
 
@@ -729,6 +729,7 @@ static GF_FilterArgs CompositorArgs[] =
 	{ OFFS(yuvhw), "enable YUV hardware for 2D blits", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_UPDATE|GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(blitp), "partial hardware blits (if not set, will force more redraw)", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_UPDATE|GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(softblt), "enable software blit/stretch in 2D. If disabled, vector graphics rasterizer will always be used", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(rthreads), "number of worker threads for the 2D software rasterizer, each sweeping and filling a horizontal band of large solid color paths", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 
 	{ OFFS(stress), "enable stress mode of compositor (rebuild all vector graphics and texture states at each frame)", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_UPDATE|GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(fast), "enable speed optimization - whether the setting is applied or not depends on the graphics module / graphic card", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_UPDATE},
@@ -751,6 +752,9 @@ static GF_FilterArgs CompositorArgs[] =
 	{ OFFS(timescale), "timescale used for output packets when no input video pid. A value of 0 means fps numerator", GF_PROP_UINT, "0", NULL, GF_FS_ARG_UPDATE},
 	{ OFFS(autofps), "use video input fps for output. If no video or not set, uses [-fps](). Ignored in player mode", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(vfr), "only emit frames when changes are detected. Always true in player mode and when filter is dynamically loaded", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(drect), "signal the areas modified since the previous output frame in the `DirtyRects` packet property (2D software rendering only)", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(fbpool), "number of output frames in the frame pool of raw 2D output. When greater than 1, the next frame can be drawn while previous frames are still held downstream, copying only the tiles modified since the reused frame", GF_PROP_UINT, "1", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(fbtile), "tile size in pixels used to track modified areas of the output frame pool", GF_PROP_UINT, "64", NULL, GF_FS_ARG_HINT_EXPERT},
 
 	{ OFFS(dur), "duration of generation. Mostly used when no video input is present. Negative values mean number of frames, positive values duration in second, 0 stops as soon as all streams are done", GF_PROP_DOUBLE, "0", NULL, GF_FS_ARG_UPDATE},
 	{ OFFS(fsize), "force the scene to resize to the biggest bitmap available if no size info is given in the BIFS configuration", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_UPDATE|GF_FS_ARG_HINT_EXPERT},
@@ -959,7 +963,7 @@ const GF_FilterRegister CompositorFilterRegister = {
 	"\n"
 	)
 	.private_size = sizeof(GF_Compositor),
-	.flags = GF_FS_REG_MAIN_THREAD,
+	.flags = GF_FS_REG_MAIN_THREAD|GF_FS_REG_ASYNC_PULL,
 	.max_extra_pids = (u32) -1,
 	SETCAPS(CompositorCaps),
 	.args = CompositorArgs,
@@ -84,6 +84,10 @@ typedef struct
 	GF_BitStream *bs_r;
 
 	GF_DownloadManager *dm;
+
+	//subsample map of current packet
+	GF_CryptSubsample *subs;
+	u32 nb_alloc_subs;
 } GF_CENCDecCtx;
 
 
@@ -755,6 +759,7 @@ static GF_Err cenc_dec_process_cenc(GF_CENCDecCtx *ctx, GF_CENCDecStream *cstr,
 	u32 saiz=0;
 	u32 IV_size;
 	Bool crypt_reinit = GF_FALSE;
+	u32 crypt_byte_block=0, skip_byte_block=0;
 	GF_FilterPacket *out_pck;
 	const GF_PropertyValue *prop, *const_IV=NULL, *cbc_pattern=NULL;
 
@@ -886,9 +891,15 @@ static GF_Err cenc_dec_process_cenc(GF_CENCDecCtx *ctx, GF_CENCDecStream *cstr,
 		}
 	}
 
-	//sub-sample encryption
+	if (cbc_pattern && cbc_pattern->value.frac.den && cbc_pattern->value.frac.num) {
+		skip_byte_block = cbc_pattern->value.frac.num;
+		crypt_byte_block = cbc_pattern->value.frac.den;
+	}
+
+	//sub-sample encryption: gather the subsample map and decrypt the sample in one call
 	if (subsample_count) {
 		u32 cur_pos = 0;
+		u32 nb_subs = 0;
 
 		while (cur_pos < data_size) {
 			u32 bytes_clear_data, bytes_encrypted_data;
@@ -906,48 +917,28 @@ static GF_Err cenc_dec_process_cenc(GF_CENCDecCtx *ctx, GF_CENCDecStream *cstr,
 			bytes_encrypted_data = gf_bs_read_u32(ctx->bs_r);
 			subsample_count--;
 
-			if (const_IV) {
-				memmove(IV, const_IV->value.data.ptr, const_IV->value.data.size);
-				if (const_IV->value.data.size == 8)
-					memset(IV+8, 0, sizeof(char)*8);
-				gf_crypt_set_IV(cstr->crypt, IV, 16);
-			}
 			if (cur_pos + bytes_clear_data + bytes_encrypted_data > data_size) {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Corrupted CENC sai, subsample info describe more bytes (%d) than in packet (%d)\n", cur_pos + bytes_clear_data + bytes_encrypted_data , data_size ));
 				e = GF_NON_COMPLIANT_BITSTREAM;
 				goto exit;
 			}
-			/*skip clear data*/
-			cur_pos += bytes_clear_data;
-
-			//pattern decryption
-			if (cbc_pattern && cbc_pattern->value.frac.den && cbc_pattern->value.frac.num) {
-				u32 pos = cur_pos;
-				u32 res = bytes_encrypted_data;
-				u32 skip_byte_block = cbc_pattern->value.frac.num;
-				u32 crypt_byte_block = cbc_pattern->value.frac.den;
-
-				if (cstr->is_cbc) {
-					u32 clear_trailing = res % 16;
-					res -= clear_trailing;
+			if (nb_subs == ctx->nb_alloc_subs) {
+				ctx->nb_alloc_subs = ctx->nb_alloc_subs ? 2*ctx->nb_alloc_subs : 32;
+				ctx->subs = gf_realloc(ctx->subs, sizeof(GF_CryptSubsample) * ctx->nb_alloc_subs);
+				if (!ctx->subs) {
+					ctx->nb_alloc_subs = 0;
+					e = GF_OUT_OF_MEM;
+					goto exit;
 				}
-
-				while (res) {
-					gf_crypt_decrypt(cstr->crypt, out_data + pos, res >= (u32) (16* crypt_byte_block) ? 16* crypt_byte_block : res);
-					if (res >= (u32) (16 * (crypt_byte_block + skip_byte_block))) {
-						pos += 16 * (crypt_byte_block + skip_byte_block);
-						res -= 16 * (crypt_byte_block + skip_byte_block);
-					} else {
-						res = 0;
-					}
-				}
-			}
-			//full subsample decryption
-			else {
-				gf_crypt_decrypt(cstr->crypt, out_data+cur_pos, bytes_encrypted_data);
 			}
-			cur_pos += bytes_encrypted_data;
+			ctx->subs[nb_subs].clear_bytes = bytes_clear_data;
+			ctx->subs[nb_subs].crypted_bytes = bytes_encrypted_data;
+			nb_subs++;
+			cur_pos += bytes_clear_data + bytes_encrypted_data;
 		}
+		e = gf_crypt_decrypt_sample(cstr->crypt, out_data, data_size, ctx->subs, nb_subs, crypt_byte_block, skip_byte_block,
+			const_IV ? const_IV->value.data.ptr : NULL, const_IV ? const_IV->value.data.size : 0);
+		if (e) goto exit;
 	}
 	//full sample encryption
 	else {
@@ -1272,6 +1263,7 @@ static void cenc_dec_finalize(GF_Filter *filter)
 
 	if (ctx->bs_r) gf_bs_del(ctx->bs_r);
 	if (ctx->cinfo) gf_crypt_info_del(ctx->cinfo);
+	if (ctx->subs) gf_free(ctx->subs);
 }
 
 
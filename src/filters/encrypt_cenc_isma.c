@@ -30,6 +30,7 @@
 #include <gpac/base_coding.h>
 #include <gpac/download.h>
 #include <gpac/xml.h>
+#include <gpac/thread.h>
 #include <gpac/internal/isomedia_dev.h>
 
 #include <gpac/internal/media_dev.h>
@@ -106,18 +107,60 @@ typedef struct
 	Bool slice_header_clear;
 } GF_CENCStream;
 
+//byte range of a sample to encrypt, recorded when sample encryption is split across worker threads
 typedef struct
+{
+	u8 *data;
+	u32 size;
+	//CTR mode: offset of the range in the keystream of the sample
+	u64 ks_offset;
+	//CBC mode with constant IV: chaining restarts from the constant IV at this range
+	Bool new_chain;
+} CENCCryptRange;
+
+typedef struct _cenc_enc_ctx GF_CENCEncCtx;
+
+typedef struct
+{
+	GF_CENCEncCtx *ctx;
+	GF_Thread *th;
+	GF_Semaphore *start;
+	//one crypto context per mode, keyed on the last key used
+	GF_Crypt *crypt_ctr, *crypt_cbc;
+	bin128 key_ctr, key_cbc;
+
+	//current job
+	GF_CENCStream *cstr;
+	u32 first_range, last_range;
+	GF_Err e;
+} CENCWorker;
+
+struct _cenc_enc_ctx
 {
 	//options
 	const char *cfile;
 	Bool allc;
+	u32 threads;
 	
 	//internal
 	GF_CryptInfo *cinfo;
 
 	GF_List *streams;
 	GF_BitStream *bs_w, *bs_r;
-} GF_CENCEncCtx;
+
+	//multithreaded encryption
+	CENCWorker *workers;
+	GF_Semaphore *workers_done;
+	Bool workers_exit;
+	//set while ranges of the current packet are recorded rather than encrypted
+	Bool mt_pending;
+	CENCCryptRange *ranges;
+	u32 nb_ranges, nb_alloc_ranges;
+	u64 ks_offset;
+	char mt_base_IV[17];
+
+	u64 bytes_crypted, crypt_time_us;
+};
 
 
 static GF_Err isma_enc_configure(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, Bool is_isma, const char *scheme_uri, const char *kms_uri)
@@ -1223,6 +1266,207 @@ static u32 cenc_get_clear_bytes(GF_CENCStream *cstr, GF_BitStream *plaintext_bs,
 }
 #endif
 
+/*samples smaller than this are always encrypted on the filter thread*/
+#define CENC_MT_MIN_SIZE	65536
+/*max size of a recorded range in CTR mode, larger ranges are split at block boundaries for load balancing*/
+#define CENC_MT_RANGE_SIZE	16384
+
+static void cenc_add_counter(char *x, u64 nb_blocks)
+{
+	s32 i;
+	for (i=15; (i>=0) && nb_blocks; i--) {
+		u64 v = (u64) (u8) x[i] + (nb_blocks & 0xFF);
+		x[i] = (char) v;
+		nb_blocks = (nb_blocks >> 8) + (v >> 8);
+	}
+}
+
+static GF_Err cenc_mt_add_range(GF_CENCEncCtx *ctx, u8 *data, u32 size, Bool new_chain)
+{
+	if (ctx->nb_ranges == ctx->nb_alloc_ranges) {
+		ctx->nb_alloc_ranges = ctx->nb_alloc_ranges ? 2*ctx->nb_alloc_ranges : 64;
+		ctx->ranges = gf_realloc(ctx->ranges, sizeof(CENCCryptRange) * ctx->nb_alloc_ranges);
+		if (!ctx->ranges) {
+			ctx->nb_alloc_ranges = ctx->nb_ranges = 0;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	ctx->ranges[ctx->nb_ranges].data = data;
+	ctx->ranges[ctx->nb_ranges].size = size;
+	ctx->ranges[ctx->nb_ranges].ks_offset = ctx->ks_offset;
+	ctx->ranges[ctx->nb_ranges].new_chain = new_chain;
+	ctx->nb_ranges++;
+	ctx->ks_offset += size;
+	return GF_OK;
+}
+
+//encrypts a range of the sample, or records it for later parallel processing. new_chain is set for CBC constant IV reset
+static GF_Err cenc_encrypt_range(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, u8 *data, u32 size, Bool new_chain)
+{
+	if (!ctx->mt_pending) {
+		if (new_chain)
+			gf_crypt_set_IV(cstr->crypt, cstr->IV, 16);
+		return gf_crypt_encrypt(cstr->crypt, data, size);
+	}
+	if (cstr->ctr_mode) {
+		while (size > CENC_MT_RANGE_SIZE) {
+			GF_Err e = cenc_mt_add_range(ctx, data, CENC_MT_RANGE_SIZE, GF_FALSE);
+			if (e) return e;
+			data += CENC_MT_RANGE_SIZE;
+			size -= CENC_MT_RANGE_SIZE;
+		}
+	}
+	return cenc_mt_add_range(ctx, data, size, new_chain);
+}
+
+//encrypts ranges [first_range, last_range[ using the given crypto context
+static GF_Err cenc_mt_process_ranges(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Crypt *crypt, u32 first_range, u32 last_range)
+{
+	u32 i;
+	GF_Err e;
+	if (first_range>=last_range) return GF_OK;
+
+	if (cstr->ctr_mode) {
+		char IV[17];
+		u64 ks_offset = ctx->ranges[first_range].ks_offset;
+		memcpy(IV, ctx->mt_base_IV, 17);
+		cenc_add_counter(IV+1, ks_offset / 16);
+		e = gf_crypt_set_IV(crypt, IV, 17);
+		if (e) return e;
+		//range starts in the middle of a block, consume the beginning of the keystream
+		if (ks_offset % 16) {
+			u8 skip[16];
+			memset(skip, 0, 16);
+			e = gf_crypt_encrypt(crypt, skip, (u32) (ks_offset % 16));
+			if (e) return e;
+		}
+	}
+	for (i=first_range; i<last_range; i++) {
+		CENCCryptRange *r = &ctx->ranges[i];
+		if (r->new_chain)
+			gf_crypt_set_IV(crypt, cstr->IV, 16);
+		e = gf_crypt_encrypt(crypt, r->data, r->size);
+		if (e) return e;
+	}
+	return GF_OK;
+}
+
+static GF_Crypt *cenc_worker_get_crypt(CENCWorker *w, GF_CENCStream *cstr)
+{
+	GF_Crypt **crypt;
+	u8 *key;
+
+	crypt = cstr->ctr_mode ? &w->crypt_ctr : &w->crypt_cbc;
+	key = cstr->ctr_mode ? w->key_ctr : w->key_cbc;
+	if (! *crypt) {
+		*crypt = gf_crypt_open(GF_AES_128, cstr->ctr_mode ? GF_CTR : GF_CBC);
+		if (! *crypt) return NULL;
+		if (gf_crypt_init(*crypt, cstr->key, cstr->IV) != GF_OK) {
+			gf_crypt_close(*crypt);
+			*crypt = NULL;
+			return NULL;
+		}
+	} else if (!memcmp(key, cstr->key, 16)) {
+		return *crypt;
+	} else {
+		gf_crypt_set_key(*crypt, cstr->key);
+	}
+	memcpy(key, cstr->key, 16);
+	return *crypt;
+}
+
+static u32 cenc_worker_proc(void *par)
+{
+	GF_Crypt *crypt;
+	CENCWorker *w = (CENCWorker *)par;
+	while (1) {
+		gf_sema_wait(w->start);
+		if (w->ctx->workers_exit) break;
+
+		if (w->first_range < w->last_range) {
+			crypt = cenc_worker_get_crypt(w, w->cstr);
+			if (!crypt) w->e = GF_IO_ERR;
+			else w->e = cenc_mt_process_ranges(w->ctx, w->cstr, crypt, w->first_range, w->last_range);
+		}
+		gf_sema_notify(w->ctx->workers_done, 1);
+	}
+	return 0;
+}
+
+//distributes recorded ranges over the workers and the filter thread, then sets the stream crypto state as if the sample had been encrypted serially
+static GF_Err cenc_mt_flush(GF_CENCEncCtx *ctx, GF_CENCStream *cstr)
+{
+	u32 i, nb_jobs, cur_range, target, done;
+	u64 total_size = 0;
+	GF_Err e;
+
+	ctx->mt_pending = GF_FALSE;
+	for (i=0; i<ctx->nb_ranges; i++)
+		total_size += ctx->ranges[i].size;
+
+	nb_jobs = ctx->threads + 1;
+	target = (u32) (total_size / nb_jobs);
+	cur_range = 0;
+	for (i=0; i<ctx->threads; i++) {
+		CENCWorker *w = &ctx->workers[i];
+		done = 0;
+		w->cstr = cstr;
+		w->e = GF_OK;
+		w->first_range = cur_range;
+		while ((cur_range < ctx->nb_ranges) && (done < target)) {
+			done += ctx->ranges[cur_range].size;
+			cur_range++;
+			//CBC chains cannot be split
+			while (!cstr->ctr_mode && (cur_range < ctx->nb_ranges) && !ctx->ranges[cur_range].new_chain) {
+				done += ctx->ranges[cur_range].size;
+				cur_range++;
+			}
+		}
+		w->last_range = cur_range;
+		gf_sema_notify(w->start, 1);
+	}
+	//last job on the filter thread
+	e = cenc_mt_process_ranges(ctx, cstr, cstr->crypt, cur_range, ctx->nb_ranges);
+
+	for (i=0; i<ctx->threads; i++) {
+		gf_sema_wait(ctx->workers_done);
+	}
+	for (i=0; i<ctx->threads; i++) {
+		if (ctx->workers[i].e) e = ctx->workers[i].e;
+	}
+	if (e) return e;
+
+	//CTR state after the last byte of the sample keystream
+	if (cstr->ctr_mode) {
+		char IV[17];
+		memcpy(IV, ctx->mt_base_IV, 17);
+		cenc_add_counter(IV+1, (ctx->ks_offset + 15) / 16);
+		IV[0] = (char) (ctx->ks_offset % 16);
+		gf_crypt_set_IV(cstr->crypt, IV, 17);
+	}
+	return GF_OK;
+}
+
+static void cenc_mt_setup_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, u32 pck_size)
+{
+	ctx->mt_pending = GF_FALSE;
+	ctx->nb_ranges = 0;
+	ctx->ks_offset = 0;
+	if (!ctx->threads || !ctx->workers || (pck_size < CENC_MT_MIN_SIZE)) return;
+
+	if (cstr->ctr_mode) {
+		u32 size = 17;
+		gf_crypt_get_IV(cstr->crypt, ctx->mt_base_IV, &size);
+		//only start from block boundaries
+		if ((size != 17) || ctx->mt_base_IV[0]) return;
+	}
+	//CBC with per-sample IV chains all subsamples
+	else if (cstr->tci->IV_size) {
+		return;
+	}
+	ctx->mt_pending = GF_TRUE;
+}
+
 static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPacket *pck)
 {
 	GF_BitStream *sai_bs;
@@ -1234,6 +1478,8 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	u8 *output;
 	u32 sai_size = cstr->tci->IV_size;
 	u32 nb_subsamples=0;
+	u64 clock_start = gf_sys_clock_high_res();
+	GF_Err e;
 
 	//in cbcs scheme, if Per_Sample_IV_size is not 0 (no constant IV), fetch current IV
 	if (!cstr->ctr_mode && cstr->tci->IV_size) {
@@ -1255,6 +1501,8 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	gf_filter_pck_merge_properties(pck, dst_pck);
 	gf_filter_pck_set_crypt_flags(dst_pck, GF_FILTER_PCK_CRYPT);
 
+	cenc_mt_setup_packet(ctx, cstr, pck_size);
+
 	if (!ctx->bs_r) ctx->bs_r = gf_bs_new(data, pck_size, GF_BITSTREAM_READ);
 	else gf_bs_reassign_buffer(ctx->bs_r, data, pck_size);
 
@@ -1263,7 +1511,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	gf_bs_write_data(sai_bs, cstr->IV, cstr->tci->IV_size);
 
 	while (gf_bs_available(ctx->bs_r)) {
-		GF_Err e=GF_OK;
+		e=GF_OK;
 
 		if (cstr->use_subsamples) {
 #ifndef GPAC_DISABLE_AV_PARSERS
@@ -1475,8 +1723,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 					gf_bs_skip_bytes(ctx->bs_r, nalu_size - clear_bytes);
 
 					//cbcs scheme with constant IV, reinit at each sub sample,
-					if (!cstr->ctr_mode && !cstr->tci->IV_size)
-						gf_crypt_set_IV(cstr->crypt, cstr->IV, 16);
+					Bool new_chain = (!cstr->ctr_mode && !cstr->tci->IV_size) ? GF_TRUE : GF_FALSE;
 
 					//pattern encryption
 					if (cstr->tci->crypt_byte_block && cstr->tci->skip_byte_block) {
@@ -1484,8 +1731,16 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 						pos = cur_pos;
 						assert((res % 16) == 0);
 
+						//serial mode, process the whole protected range in one call
+						if (!ctx->mt_pending) {
+							if (new_chain)
+								gf_crypt_set_IV(cstr->crypt, cstr->IV, 16);
+							e = gf_crypt_encrypt_pattern(cstr->crypt, output+pos, res, cstr->tci->crypt_byte_block, cstr->tci->skip_byte_block);
+							res = 0;
+						}
 						while (res) {
-							e = gf_crypt_encrypt(cstr->crypt, output+pos, res >= (u32) (16*cstr->tci->crypt_byte_block) ? 16*cstr->tci->crypt_byte_block : res);
+							e = cenc_encrypt_range(ctx, cstr, output+pos, res >= (u32) (16*cstr->tci->crypt_byte_block) ? 16*cstr->tci->crypt_byte_block : res, new_chain);
+							new_chain = GF_FALSE;
 							if (res >= (u32) (16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block))) {
 								pos += 16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block);
 								res -= 16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block);
@@ -1496,7 +1751,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 					}
 					//full subsample encryption
 					else {
-						e = gf_crypt_encrypt(cstr->crypt, output+cur_pos, nalu_size - clear_bytes);
+						e = cenc_encrypt_range(ctx, cstr, output+cur_pos, nalu_size - clear_bytes, new_chain);
 					}
 				}
 
@@ -1559,18 +1814,17 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 			}
 		} else if (cstr->ctr_mode) {
 			gf_bs_skip_bytes(ctx->bs_r, pck_size);
-			e = gf_crypt_encrypt(cstr->crypt, output, pck_size);
+			e = cenc_encrypt_range(ctx, cstr, output, pck_size, GF_FALSE);
 		} else {
 			u32 clear_trailing;
 
 			clear_trailing = pck_size % 16;
 
 			//cbcs scheme with constant IV, reinit at each sample,
-			if (!cstr->tci->IV_size)
-				gf_crypt_set_IV(cstr->crypt, cstr->IV, 16);
-
 			if (pck_size >= 16) {
-				gf_crypt_encrypt(cstr->crypt, output, pck_size - clear_trailing);
+				e = cenc_encrypt_range(ctx, cstr, output, pck_size - clear_trailing, cstr->tci->IV_size ? GF_FALSE : GF_TRUE);
+			} else if (!cstr->tci->IV_size) {
+				gf_crypt_set_IV(cstr->crypt, cstr->IV, 16);
 			}
 			gf_bs_skip_bytes(ctx->bs_r, pck_size);
 		}
@@ -1580,6 +1834,16 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 			return e;
 		}
 	}
+
+	if (ctx->mt_pending) {
+		e = cenc_mt_flush(ctx, cstr);
+		if (e) {
+			gf_filter_pck_discard(dst_pck);
+			return e;
+		}
+	}
+	ctx->bytes_crypted += pck_size;
+	ctx->crypt_time_us += gf_sys_clock_high_res() - clock_start;
 	
 	if (prev_entry_bytes_clear || prev_entry_bytes_crypt) {
 		if (!nb_subsamples) gf_bs_write_u16(sai_bs, 0);
@@ -1814,12 +2078,48 @@ static GF_Err cenc_enc_initialize(GF_Filter *filter)
 	}
 
 	ctx->streams = gf_list_new();
+
+	if (ctx->threads) {
+		u32 i;
+		ctx->workers = gf_malloc(sizeof(CENCWorker) * ctx->threads);
+		if (!ctx->workers) return GF_OUT_OF_MEM;
+		memset(ctx->workers, 0, sizeof(CENCWorker) * ctx->threads);
+		ctx->workers_done = gf_sema_new(ctx->threads, 0);
+		for (i=0; i<ctx->threads; i++) {
+			CENCWorker *w = &ctx->workers[i];
+			w->ctx = ctx;
+			w->start = gf_sema_new(1, 0);
+			w->th = gf_th_new("CENCWorker");
+			gf_th_run(w->th, cenc_worker_proc, w);
+		}
+	}
 	return GF_OK;
 }
 
 static void cenc_enc_finalize(GF_Filter *filter)
 {
 	GF_CENCEncCtx *ctx = (GF_CENCEncCtx *)gf_filter_get_udta(filter);
+
+	if (ctx->bytes_crypted && ctx->crypt_time_us) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_AUTHOR, ("[CENCCrypt] Encrypted "LLU" bytes in "LLU" ms - %.02f MB/s\n", ctx->bytes_crypted, ctx->crypt_time_us/1000, ((Double) ctx->bytes_crypted) / ctx->crypt_time_us ));
+	}
+	if (ctx->workers) {
+		u32 i;
+		ctx->workers_exit = GF_TRUE;
+		for (i=0; i<ctx->threads; i++) {
+			gf_sema_notify(ctx->workers[i].start, 1);
+		}
+		for (i=0; i<ctx->threads; i++) {
+			CENCWorker *w = &ctx->workers[i];
+			gf_th_del(w->th);
+			gf_sema_del(w->start);
+			if (w->crypt_ctr) gf_crypt_close(w->crypt_ctr);
+			if (w->crypt_cbc) gf_crypt_close(w->crypt_cbc);
+		}
+		gf_free(ctx->workers);
+		gf_sema_del(ctx->workers_done);
+	}
+	if (ctx->ranges) gf_free(ctx->ranges);
 	if (ctx->cinfo) gf_crypt_info_del(ctx->cinfo);
 	while (gf_list_count(ctx->streams)) {
 		GF_CENCStream *s = gf_list_pop_back(ctx->streams);
@@ -1852,7 +2152,8 @@ static const GF_FilterCapability CENCEncCaps[] =
 static const GF_FilterArgs GF_CENCEncArgs[] =
 {
 	{ OFFS(cfile), "crypt file location - see filter help", GF_PROP_STRING, NULL, NULL, 0},
-	{ OFFS(allc), "throw error if no DRM config file is found for a PID - see filter help", GF_PROP_STRING, NULL, NULL, 0},
+	{ OFFS(allc), "throw error if no DRM config file is found for a PID - see filter help", GF_PROP_BOOL, "false", NULL, 0},
+	{ OFFS(threads), "number of worker threads used to encrypt large samples in CENC/CENS/constant IV CBCS modes, 0 disables multithreaded encryption - output is identical in both modes", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{0}
 };
 
@@ -1864,6 +2165,9 @@ GF_FilterRegister CENCEncRegister = {
 	"The DRM config file can be set per PID using the property `CryptInfo`, or set at the filter level using [-cfile]().\n"
 	"When the DRM config file is set per PID, the first `CrypTrack` in the DRM config file with the same ID is used, otherwise the first `CrypTrack` is used.\n"
 	"If no DRM config file is defined for a given PID, this PID will not be encrypted, or an error will be thrown if [-allc]() is specified.\n"
+	"\n"
+	"Samples larger than 64 kBytes can be encrypted by several threads using [-threads](). This only applies to CTR-based schemes and to CBC-based schemes with constant IV, "
+	"since CBC chaining across subsamples is sequential otherwise. Counter values are derived from the keystream offset of each range, so the output is bit-identical to single-threaded encryption.\n"
 	)
 	.private_size = sizeof(GF_CENCEncCtx),
 	.max_extra_pids=-1,
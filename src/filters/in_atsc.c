@@ -46,7 +46,7 @@ typedef struct
 {
 	//options
 	char *src, *ifce, *odir;
-	Bool gcache, kc, sr, reorder;
+	Bool gcache, kc, sr, reorder, rthread;
 	u32 buffer, timeout, stats, max_segs, tsidbg, rtimeout;
 	s32 tunein, stsi;
 	
@@ -81,6 +81,7 @@ static void atscin_finalize(GF_Filter *filter)
 	ATSCInCtx *ctx = gf_filter_get_udta(filter);
 	if (ctx->clock_init_seg) gf_free(ctx->clock_init_seg);
 	if (ctx->atsc_dmx) gf_atsc3_dmx_del(ctx->atsc_dmx);
+	ctx->atsc_dmx = NULL;
 
 	if (ctx->tsi_outs) {
 		while (gf_list_count(ctx->tsi_outs)) {
@@ -99,10 +100,20 @@ static void atscin_finalize(GF_Filter *filter)
 	}
 }
 
+static void atscin_pck_destructor(GF_Filter *filter, GF_FilterPid *pid, GF_FilterPacket *pck)
+{
+	u32 size;
+	ATSCInCtx *ctx = gf_filter_get_udta(filter);
+	u8 *data = (u8 *) gf_filter_pck_get_data(pck, &size);
+	if (!data) return;
+	if (ctx->atsc_dmx) gf_atsc3_dmx_release_object_data(ctx->atsc_dmx, data);
+	else gf_free(data);
+}
+
 static void atscin_send_file(ATSCInCtx *ctx, u32 service_id, GF_ATSCEventFileInfo *finfo, u32 evt_type)
 {
 	if (!ctx->kc || !finfo->corrupted) {
-		u8 *output;
+		u8 *output, *data;
 		char *ext;
 		GF_FilterPid *pid, **p_pid;
 		GF_FilterPacket *pck;
@@ -146,8 +157,19 @@ static void atscin_send_file(ATSCInCtx *ctx, u32 service_id, GF_ATSCEventFileInf
 		ext = gf_file_ext_start(finfo->filename);
 		gf_filter_pid_set_property(pid, GF_PROP_PID_FILE_EXT, &PROP_STRING(ext ? (ext+1) : "*" ));
 
-		pck = gf_filter_pck_new_alloc(pid, finfo->size, &output);
-		memcpy(output, finfo->data, finfo->size);
+		//forward object data without copy if possible
+		data = gf_atsc3_dmx_hold_object_data(ctx->atsc_dmx, finfo);
+		if (data) {
+			pck = gf_filter_pck_new_shared(pid, data, finfo->size, atscin_pck_destructor);
+			if (!pck) {
+				gf_atsc3_dmx_release_object_data(ctx->atsc_dmx, data);
+				return;
+			}
+		} else {
+			pck = gf_filter_pck_new_alloc(pid, finfo->size, &output);
+			if (!pck) return;
+			memcpy(output, finfo->data, finfo->size);
+		}
 		if (finfo->corrupted) gf_filter_pck_set_corrupted(pck, GF_TRUE);
 		gf_filter_pck_send(pck);
 
@@ -396,6 +418,8 @@ static GF_Err atscin_initialize(GF_Filter *filter)
 	}
 
 	gf_atsc3_set_reorder(ctx->atsc_dmx, ctx->reorder, ctx->rtimeout);
+	if (ctx->rthread)
+		gf_atsc3_set_threaded(ctx->atsc_dmx, GF_TRUE);
 
 	if (ctx->tsidbg) {
 		gf_atsc3_dmx_debug_tsi(ctx->atsc_dmx, ctx->tsidbg);
@@ -436,6 +460,7 @@ static const GF_FilterArgs ATSCInArgs[] =
 	{ OFFS(odir), "output directory for stand-alone mode - see filter help", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(reorder), "ignore order flag in ROUTE/LCT packets, avoiding considering object done when TOI changes", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(rtimeout), "default timeout in ms to wait when gathering out-of-order packets", GF_PROP_UINT, "5000", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(rthread), "read each ROUTE session socket from a dedicated thread - see filter help", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -468,12 +493,17 @@ GF_FilterRegister ATSCInRegister = {
 	"If needed, one pid per TSI can be used rather than a single pid. This avoids mixing files of different mime types on the same pid (e.g. mpd and isobmff).\n"
 	"EX gpac -i atsc://cache=false -o $ServiceID$/$File$:dynext\n"
 	"This will grab the files and forward them as output PIDs, consumed by the [fout](fout) filter.\n"
+	"Files are forwarded without copy whenever possible, the object buffers being recycled once the packets are released.\n"
 	"\n"
 	"# Standalone mode\n"
 	"In standalone mode, the filter does not produce any output pid and writes received files to the [-odir]() directory.\n"
 	"EX gpac -i atsc://odir=output\n"
 	"This will grab the files and write them to `output` directory.\n"
 	"\n"
+	"# Threaded reception\n"
+	"When [-rthread]() is set, each ROUTE session socket is drained by a dedicated thread fetching several datagrams per system call, the filter only demultiplexes the received datagrams. "
+	"This prevents losses when the filter is not scheduled for a while, at the cost of one thread per socket.\n"
+	"\n"
 	"# Interface setup\n"
 	"On some systems (OSX), when using VM packet replay, you may need to force multicast routing on your local interface.\n"
 	"You will have to do this for the base ATSC3 multicast (224.0.23.60):\n"
@@ -38,6 +38,8 @@
 
 
 #define RTSP_BUFFER_SIZE		5000
+/*max number of RTP packets fetched from a socket in one call*/
+#define RTPIN_READ_BATCH		16
 
 typedef struct _rtsp_session GF_RTPInRTSP;
 typedef struct __rtpin_stream GF_RTPInStream;
@@ -55,8 +55,11 @@ GF_Err rtpin_stream_init(GF_RTPInStream *stream, Bool ResetOnly)
 		e = gf_rtp_initialize(stream->rtp_ch, stream->rtpin->block_size, GF_FALSE, 0, stream->rtpin->reorder_len, stream->rtpin->reorder_delay, (char *)ip_ifce);
 		if (e) return e;
 
-		if (stream->rtp_ch->rtp)
+		if (stream->rtp_ch->rtp) {
 			gf_sk_group_register(stream->rtpin->sockgroup, stream->rtp_ch->rtp);
+			//fetch pending datagrams in one call, see rtpin_stream_read
+			gf_rtp_enable_read_batch(stream->rtp_ch, RTPIN_READ_BATCH);
+		}
 		if (stream->rtp_ch->rtcp)
 			gf_sk_group_register(stream->rtpin->sockgroup, stream->rtp_ch->rtcp);
 
@@ -732,11 +735,15 @@ u32 rtpin_stream_read(GF_RTPInStream *stream)
 	}
 
 	if (gf_sk_group_sock_is_set(stream->rtpin->sockgroup, stream->rtp_ch->rtp, GF_SK_SELECT_READ)) {
-		size = gf_rtp_read_rtp(stream->rtp_ch, stream->buffer, stream->rtpin->block_size);
-		if (size) {
+		//in batched mode, all fetched packets must be consumed
+		u32 nb_pck = 0;
+		while (nb_pck < RTPIN_READ_BATCH) {
+			size = gf_rtp_read_rtp(stream->rtp_ch, stream->buffer, stream->rtpin->block_size);
+			if (!size) break;
 			tot_size += size;
 			stream->rtpin->udp_timeout = 0;
 			rtpin_stream_on_rtp_pck(stream, stream->buffer, size);
+			nb_pck++;
 		}
 	}
 	if (!tot_size) return 0;
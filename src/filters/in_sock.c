@@ -32,6 +32,9 @@
 #include <gpac/internal/ietf_dev.h>
 #endif
 
+//max number of datagrams read and dispatched per process call
+#define SOCKIN_MAX_BATCH	64
+
 typedef struct
 {
 	GF_FilterPid *pid;
@@ -72,6 +75,9 @@ typedef struct
 	Bool is_udp;
 
 	char *buffer;
+	//datagram slots in buffer, only the first one is used for TCP
+	u8 *dgram_bufs[SOCKIN_MAX_BATCH];
+	u32 dgram_sizes[SOCKIN_MAX_BATCH];
 
 	GF_SockGroup *active_sockets;
 	u64 last_rcv_time;
@@ -83,7 +89,7 @@ static GF_Err sockin_initialize(GF_Filter *filter)
 {
 	char *str, *url;
 	u16 port;
-	u32 sock_type = 0;
+	u32 i, nb_slots, sock_type = 0;
 	GF_Err e = GF_OK;
 	GF_SockInCtx *ctx = (GF_SockInCtx *) gf_filter_get_udta(filter);
 
@@ -171,8 +177,11 @@ static GF_Err sockin_initialize(GF_Filter *filter)
 
 	if (ctx->block_size<2000)
 		ctx->block_size = 2000;
-	ctx->buffer = gf_malloc(ctx->block_size + 1);
+	nb_slots = ctx->is_udp ? SOCKIN_MAX_BATCH : 1;
+	ctx->buffer = gf_malloc((ctx->block_size + 1) * nb_slots);
 	if (!ctx->buffer) return GF_OUT_OF_MEM;
+	for (i=0; i<nb_slots; i++)
+		ctx->dgram_bufs[i] = ctx->buffer + i * (ctx->block_size + 1);
 	//ext/mime given and not mpeg2, disable probe
 	if (ctx->ext && !strstr("ts|m2t|mts|dmb|trp", ctx->ext)) ctx->tsprobe = GF_FALSE;
 	if (ctx->mime && !strstr(ctx->mime, "mpeg-2") && !strstr(ctx->mime, "mp2t")) ctx->tsprobe = GF_FALSE;
@@ -249,10 +258,10 @@ static Bool sockin_process_event(GF_Filter *filter, const GF_FilterEvent *evt)
 
 static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockInClient *sock_c)
 {
-	u32 nb_read;
+	u32 i, nb_read, nb_dgrams=0, nb_pcks=0;
 	u64 bitrate;
 	GF_Err e;
-	GF_FilterPacket *dst_pck;
+	GF_FilterPacket *dst_pck, *pcks[SOCKIN_MAX_BATCH];
 	u8 *out_data, *in_data;
 
 	if (!sock_c->socket)
@@ -266,7 +275,14 @@ static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockIn
 
 	if (!sock_c->start_time) sock_c->start_time = gf_sys_clock_high_res();
 
-	e = gf_sk_receive_no_select(sock_c->socket, ctx->buffer, ctx->block_size, &nb_read);
+	//for datagram sockets, fetch all pending datagrams in one call and dispatch them as a single batch
+	if (ctx->is_udp) {
+		e = gf_sk_receive_batch(sock_c->socket, ctx->dgram_bufs, ctx->block_size, ctx->dgram_sizes, SOCKIN_MAX_BATCH, &nb_dgrams);
+	} else {
+		e = gf_sk_receive_no_select(sock_c->socket, ctx->buffer, ctx->block_size, &nb_read);
+		ctx->dgram_sizes[0] = nb_read;
+		nb_dgrams = nb_read ? 1 : 0;
+	}
 	switch (e) {
 	case GF_IP_NETWORK_EMPTY:
 		return GF_OK;
@@ -281,9 +297,11 @@ static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockIn
 	default:
 		return e;
 	}
-	if (!nb_read) return GF_OK;
-	sock_c->nb_bytes += nb_read;
+	if (!nb_dgrams) return GF_OK;
+	nb_read = ctx->dgram_sizes[0];
 	sock_c->done = GF_FALSE;
+	//restart inactivity timeout
+	ctx->last_rcv_time = 0;
 
 	//we allocated one more byte for that
 	ctx->buffer[nb_read] = 0;
@@ -325,34 +343,42 @@ static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockIn
 
 	}
 
-	in_data = ctx->buffer;
+	for (i=0; i<nb_dgrams; i++) {
+		in_data = ctx->dgram_bufs[i];
+		nb_read = ctx->dgram_sizes[i];
+		if (!nb_read) continue;
+		sock_c->nb_bytes += nb_read;
 
 #ifndef GPAC_DISABLE_STREAMING
-	if (sock_c->rtp_reorder) {
-		char *pck;
-		u16 seq_num = ((ctx->buffer[2] << 8) & 0xFF00) | (ctx->buffer[3] & 0xFF);
-		gf_rtp_reorderer_add(sock_c->rtp_reorder, (void *) ctx->buffer, nb_read, seq_num);
-
-		pck = (char *) gf_rtp_reorderer_get(sock_c->rtp_reorder, &nb_read, GF_FALSE);
-		if (pck) {
-			dst_pck = gf_filter_pck_new_shared(sock_c->pid, pck+12, nb_read-12, sockin_rtp_destructor);
-			gf_filter_pck_set_framing(dst_pck, GF_TRUE, GF_TRUE);
-			gf_filter_pck_send(dst_pck);
+		if (sock_c->rtp_reorder) {
+			char *pck;
+			u16 seq_num = ((in_data[2] << 8) & 0xFF00) | (in_data[3] & 0xFF);
+			gf_rtp_reorderer_add(sock_c->rtp_reorder, (void *) in_data, nb_read, seq_num);
+
+			pck = (char *) gf_rtp_reorderer_get(sock_c->rtp_reorder, &nb_read, GF_FALSE);
+			if (pck) {
+				dst_pck = gf_filter_pck_new_shared(sock_c->pid, pck+12, nb_read-12, sockin_rtp_destructor);
+				gf_filter_pck_set_framing(dst_pck, GF_TRUE, GF_TRUE);
+				pcks[nb_pcks++] = dst_pck;
+			}
+			continue;
 		}
-		return GF_OK;
-	}
 #else
-	if (sock_c->is_rtp) {
-		in_data = ctx->buffer + 12;
-		nb_read -= 12;
-	}
+		if (sock_c->is_rtp) {
+			in_data += 12;
+			nb_read -= 12;
+		}
 #endif
 
-	dst_pck = gf_filter_pck_new_alloc(sock_c->pid, nb_read, &out_data);
-	memcpy(out_data, in_data, nb_read);
+		dst_pck = gf_filter_pck_new_alloc(sock_c->pid, nb_read, &out_data);
+		if (!dst_pck) break;
+		memcpy(out_data, in_data, nb_read);
 
-	gf_filter_pck_set_framing(dst_pck, (sock_c->nb_bytes == nb_read)  ? GF_TRUE : GF_FALSE, GF_FALSE);
-	gf_filter_pck_send(dst_pck);
+		gf_filter_pck_set_framing(dst_pck, (sock_c->nb_bytes == nb_read)  ? GF_TRUE : GF_FALSE, GF_FALSE);
+		pcks[nb_pcks++] = dst_pck;
+	}
+	if (nb_pcks)
+		gf_filter_pck_send_batch(pcks, nb_pcks);
 
 	//send bitrate
 	bitrate = ( gf_sys_clock_high_res() - sock_c->start_time );
@@ -120,6 +120,7 @@ typedef struct
 {
 	//options
 	const char *js;
+	Bool isolate;
 
 	GF_Filter *filter;
 
@@ -200,6 +201,10 @@ typedef struct _js_pck_ctx
 	JSValue cbck_val;
 	//array buffer
 	JSValue data_ab;
+	//array buffer returned by the last append_data
+	JSValue append_ab;
+	//array of array buffers, one per plane of raw video frame
+	JSValue planes_ab;
 	u32 flags;
 } GF_JSPckCtx;
 
@@ -290,6 +295,23 @@ static void jsf_pck_detach_ab(JSContext *ctx, GF_JSPckCtx *pckctx)
 		JS_FreeValue(ctx, pckctx->data_ab);
 		pckctx->data_ab = JS_UNDEFINED;
 	}
+	if (!JS_IsUndefined(pckctx->append_ab)) {
+		JS_DetachArrayBuffer(ctx, pckctx->append_ab);
+		JS_FreeValue(ctx, pckctx->append_ab);
+		pckctx->append_ab = JS_UNDEFINED;
+	}
+	//array buffers of planes point to packet data or frame interface memory, detach them so that scripts keeping them cannot access released memory
+	if (!JS_IsUndefined(pckctx->planes_ab)) {
+		u32 i;
+		for (i=0; i<4; i++) {
+			JSValue ab = JS_GetPropertyUint32(ctx, pckctx->planes_ab, i);
+			if (JS_IsObject(ab))
+				JS_DetachArrayBuffer(ctx, ab);
+			JS_FreeValue(ctx, ab);
+		}
+		JS_FreeValue(ctx, pckctx->planes_ab);
+		pckctx->planes_ab = JS_UNDEFINED;
+	}
 }
 
 static void jsf_pck_finalizer(JSRuntime *rt, JSValue val)
@@ -306,6 +328,14 @@ static void jsf_pck_finalizer(JSRuntime *rt, JSValue val)
 		JS_FreeValueRT(rt, pckctx->data_ab);
 		pckctx->data_ab = JS_UNDEFINED;
 	}
+	if (!JS_IsUndefined(pckctx->append_ab)) {
+		JS_FreeValueRT(rt, pckctx->append_ab);
+		pckctx->append_ab = JS_UNDEFINED;
+	}
+	if (!JS_IsUndefined(pckctx->planes_ab)) {
+		JS_FreeValueRT(rt, pckctx->planes_ab);
+		pckctx->planes_ab = JS_UNDEFINED;
+	}
 
     if (JS_IsUndefined(pckctx->ref_val) && pckctx->jspid && pckctx->jspid->jsf) {
 		gf_list_add(pckctx->jspid->jsf->pck_res, pckctx);
@@ -328,6 +358,12 @@ static void jsf_filter_pck_mark(JSRuntime *rt, JSValueConst val, JS_MarkFunc *ma
     if (!JS_IsUndefined(pckctx->data_ab)) {
 		JS_MarkValue(rt, pckctx->data_ab, mark_func);
 	}
+    if (!JS_IsUndefined(pckctx->append_ab)) {
+		JS_MarkValue(rt, pckctx->append_ab, mark_func);
+	}
+    if (!JS_IsUndefined(pckctx->planes_ab)) {
+		JS_MarkValue(rt, pckctx->planes_ab, mark_func);
+	}
 }
 
 static JSClassDef jsf_pck_class = {
@@ -2030,6 +2066,8 @@ static JSValue jsf_pid_get_packet(JSContext *ctx, JSValueConst this_val, int arg
 	pckctx->jsobj = JS_DupValue(ctx, res);
 	pckctx->ref_val = JS_UNDEFINED;
 	pckctx->data_ab = JS_UNDEFINED;
+	pckctx->append_ab = JS_UNDEFINED;
+	pckctx->planes_ab = JS_UNDEFINED;
 	pctx->pck_head = pckctx;
 
 	JS_SetOpaque(res, pckctx);
@@ -2049,6 +2087,7 @@ static JSValue jsf_pid_drop_packet(JSContext *ctx, JSValueConst this_val, int ar
 	}
 
 	pckctx = pctx->pck_head;
+	jsf_pck_detach_ab(ctx, pckctx);
 	pckctx->pck = NULL;
 	pctx->pck_head = NULL;
 	JS_FreeValue(ctx, pckctx->jsobj);
@@ -2273,6 +2312,8 @@ static JSValue jsf_pid_new_packet(JSContext *ctx, JSValueConst this_val, int arg
 	pckc->cbck_val = JS_UNDEFINED;
 	pckc->ref_val = JS_UNDEFINED;
 	pckc->data_ab = JS_UNDEFINED;
+	pckc->append_ab = JS_UNDEFINED;
+	pckc->planes_ab = JS_UNDEFINED;
 
 	if (argc>1)
 		use_shared = JS_ToBool(ctx, argv[1]);
@@ -3444,7 +3485,7 @@ static JSValue jsf_pck_get_prop(JSContext *ctx, JSValueConst this_val, int magic
 		if (JS_IsUndefined(pckctx->data_ab)) {
 			const u8 *data = gf_filter_pck_get_data(pck, &ival);
 			if (!data) return JS_NULL;
-			pckctx->data_ab = JS_NewArrayBuffer(ctx, (u8 *) data, ival, NULL, NULL, GF_TRUE);
+			pckctx->data_ab = JS_NewArrayBuffer(ctx, (u8 *) data, ival, NULL, NULL, GF_FALSE);
 		}
 		return JS_DupValue(ctx, pckctx->data_ab);
 	case JSF_PCK_FRAME_IFCE:
@@ -3546,6 +3587,8 @@ static JSValue jsf_pck_ref(JSContext *ctx, JSValueConst this_val, int argc, JSVa
 	ref_pckctx->flags = GF_JS_PCK_IS_REF;
 	ref_pckctx->jsobj = JS_NewObjectClass(ctx, jsf_pck_class_id);
 	ref_pckctx->data_ab = JS_UNDEFINED;
+	ref_pckctx->append_ab = JS_UNDEFINED;
+	ref_pckctx->planes_ab = JS_UNDEFINED;
 	ref_pckctx->ref_val = JS_UNDEFINED;
 	JS_SetOpaque(ref_pckctx->jsobj, ref_pckctx);
 	return JS_DupValue(ctx, ref_pckctx->jsobj);
@@ -3558,6 +3601,7 @@ static JSValue jsf_pck_unref(JSContext *ctx, JSValueConst this_val, int argc, JS
  	if (!(pckctx->flags & GF_JS_PCK_IS_REF))
 		return js_throw_err_msg(ctx, GF_BAD_PARAM, "Attempt to unref a non-reference packet");
 
+	jsf_pck_detach_ab(ctx, pckctx);
 	gf_filter_pck_unref(pckctx->pck);
 	pckctx->pck = NULL;
 	JS_FreeValue(ctx, pckctx->jsobj);
@@ -3573,10 +3617,8 @@ static JSValue jsf_pck_send(JSContext *ctx, JSValueConst this_val, int argc, JSV
 	GF_JSPckCtx *pckctx = JS_GetOpaque(this_val, jsf_pck_class_id);
     if (!pckctx || !pckctx->pck) return JS_EXCEPTION;
     pck = pckctx->pck;
-    if (!JS_IsUndefined(pckctx->data_ab)) {
-    	JS_FreeValue(ctx, pckctx->data_ab);
-    	pckctx->data_ab = JS_UNDEFINED;
-	}
+	//packet memory may be released by consumer at any time once sent
+	jsf_pck_detach_ab(ctx, pckctx);
 	gf_filter_pck_send(pck);
 	JS_SetOpaque(this_val, NULL);
 	if (!(pckctx->flags & GF_JS_PCK_IS_SHARED)) {
@@ -3592,6 +3634,7 @@ static JSValue jsf_pck_discard(JSContext *ctx, JSValueConst this_val, int argc,
     if (!pckctx || !pckctx->pck) return JS_EXCEPTION;
     pck = pckctx->pck;
     pckctx->pck = NULL;
+	jsf_pck_detach_ab(ctx, pckctx);
 	gf_filter_pck_discard(pck);
 	return JS_UNDEFINED;
 }
@@ -3669,8 +3712,10 @@ static JSValue jsf_pck_append_data(JSContext *ctx, JSValueConst this_val, int ar
 			JS_FreeCString(ctx, str);
 		}
 
+		//packet data may have been reallocated
 		jsf_pck_detach_ab(ctx, pckctx);
-		return JS_NewArrayBuffer(ctx, (u8 *) new_start, len, NULL, NULL, GF_TRUE);
+		pckctx->append_ab = JS_NewArrayBuffer(ctx, (u8 *) new_start, len, NULL, NULL, GF_FALSE);
+		return JS_DupValue(ctx, pckctx->append_ab);
 	}
 
 	if (!JS_IsObject(argv[0])) return JS_EXCEPTION;
@@ -3686,9 +3731,10 @@ static JSValue jsf_pck_append_data(JSContext *ctx, JSValueConst this_val, int ar
 	}
 	memcpy(new_start, data, ab_size);
 
+	//packet data may have been reallocated
 	jsf_pck_detach_ab(ctx, pckctx);
-
-	return JS_NewArrayBuffer(ctx, (u8 *) new_start, ab_size, NULL, NULL, GF_TRUE);
+	pckctx->append_ab = JS_NewArrayBuffer(ctx, (u8 *) new_start, ab_size, NULL, NULL, GF_FALSE);
+	return JS_DupValue(ctx, pckctx->append_ab);
 }
 
 static JSValue jsf_pck_truncate(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv)
@@ -3722,6 +3768,62 @@ static JSValue jsf_pck_copy_props(JSContext *ctx, JSValueConst this_val, int arg
     return JS_UNDEFINED;
 }
 
+static JSValue jsf_pck_get_planes(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv)
+{
+	GF_Err e;
+	u32 i, width, height, pf, stride, stride_uv, size, nb_planes, uv_height;
+	u32 plane_size[4];
+	const u8 *planes[4];
+	JSValue res;
+	GF_JSPckCtx *pckctx = JS_GetOpaque(this_val, jsf_pck_class_id);
+    if (!pckctx || !pckctx->pck) return JS_EXCEPTION;
+
+	memset(planes, 0, sizeof(planes));
+	e = jsf_get_filter_packet_planes(ctx, this_val, &width, &height, &pf, &stride, &stride_uv, &planes[0], &planes[1], &planes[2], &planes[3]);
+	if (e) return js_throw_err(ctx, e);
+	if (!planes[0]) return JS_NULL;
+
+	if (!gf_pixel_get_size_info(pf, width, height, &size, &stride, &stride_uv, &nb_planes, &uv_height))
+		return js_throw_err(ctx, GF_NOT_SUPPORTED);
+
+	plane_size[0] = stride * height;
+	plane_size[1] = plane_size[2] = stride_uv * uv_height;
+	plane_size[3] = stride * height;
+
+	//packet data: planes are contiguous in the payload
+	if (!gf_filter_pck_get_frame_interface(pckctx->pck)) {
+		u32 pck_size;
+		gf_filter_pck_get_data(pckctx->pck, &pck_size);
+		if (pck_size < size)
+			return js_throw_err_msg(ctx, GF_BAD_PARAM, "Packet size %d less than frame size %d", pck_size, size);
+		for (i=1; i<nb_planes; i++)
+			planes[i] = planes[i-1] + plane_size[i-1];
+		if (nb_planes==1) plane_size[0] = size;
+	}
+
+	if (JS_IsUndefined(pckctx->planes_ab)) {
+		pckctx->planes_ab = JS_NewArray(ctx);
+		for (i=0; i<nb_planes; i++) {
+			JSValue ab;
+			if (!planes[i]) break;
+			//input packets may be shared with other filters, only expose a copy of their planes
+			if (pckctx->flags & GF_JS_PCK_IS_OUTPUT)
+				ab = JS_NewArrayBuffer(ctx, (u8 *) planes[i], plane_size[i], NULL, NULL, GF_FALSE);
+			else
+				ab = JS_NewArrayBufferCopy(ctx, planes[i], plane_size[i]);
+			JS_SetPropertyUint32(ctx, pckctx->planes_ab, i, ab);
+		}
+	}
+	res = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, res, "width", JS_NewInt32(ctx, width));
+	JS_SetPropertyStr(ctx, res, "height", JS_NewInt32(ctx, height));
+	JS_SetPropertyStr(ctx, res, "pfmt", JS_NewString(ctx, gf_pixel_fmt_name(pf)));
+	JS_SetPropertyStr(ctx, res, "stride", JS_NewInt32(ctx, stride));
+	JS_SetPropertyStr(ctx, res, "stride_uv", JS_NewInt32(ctx, stride_uv));
+	JS_SetPropertyStr(ctx, res, "planes", JS_DupValue(ctx, pckctx->planes_ab));
+	return res;
+}
+
 static const JSCFunctionListEntry jsf_pck_funcs[] =
 {
     JS_CGETSET_MAGIC_DEF("start", jsf_pck_get_prop, jsf_pck_set_prop, JSF_PCK_START),
@@ -3747,7 +3849,7 @@ static const JSCFunctionListEntry jsf_pck_funcs[] =
     JS_CGETSET_MAGIC_DEF("redundant", jsf_pck_get_prop, jsf_pck_set_prop, JSF_PCK_HAS_REDUNDANT),
     JS_CGETSET_MAGIC_DEF("size", jsf_pck_get_prop, NULL, JSF_PCK_SIZE),
     JS_CGETSET_MAGIC_DEF("data", jsf_pck_get_prop, NULL, JSF_PCK_DATA),
-    JS_CGETSET_MAGIC_DEF("frame_ifce", jsf_pck_get_prop, NULL, JSF_PCK_DATA),
+    JS_CGETSET_MAGIC_DEF("frame_ifce", jsf_pck_get_prop, NULL, JSF_PCK_FRAME_IFCE),
 
     JS_CFUNC_DEF("set_readonly", 0, jsf_pck_set_readonly),
     JS_CFUNC_DEF("enum_properties", 0, jsf_pck_enum_properties),
@@ -3760,6 +3862,7 @@ static const JSCFunctionListEntry jsf_pck_funcs[] =
     JS_CFUNC_DEF("append", 0, jsf_pck_append_data),
     JS_CFUNC_DEF("truncate", 0, jsf_pck_truncate),
     JS_CFUNC_DEF("copy_props", 0, jsf_pck_copy_props),
+    JS_CFUNC_DEF("get_planes", 0, jsf_pck_get_planes),
 };
 
 
@@ -4006,7 +4109,7 @@ void js_load_constants(JSContext *ctx, JSValue global_obj)
 
 
 	//initialize filter event class
-	JS_NewClassID(&jsf_event_class_id);
+	gf_js_new_class_id(&jsf_event_class_id);
 	JS_NewClass(JS_GetRuntime(ctx), jsf_event_class_id, &jsf_event_class);
 	JSValue evt_proto = JS_NewObjectClass(ctx, jsf_event_class_id);
     JS_SetPropertyFunctionList(ctx, evt_proto, jsf_event_funcs, countof(jsf_event_funcs));
@@ -4043,9 +4146,20 @@ static GF_Err jsfilter_initialize(GF_Filter *filter)
 	}
 	jsf->filter_obj = JS_UNDEFINED;
 
-	jsf->ctx = gf_js_create_context();
+	//load script
+	GF_Err e = gf_file_load_data(jsf->js, &buf, &buf_len);
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_SCRIPT, ("[JSF] Error loading script file %s: %s\n", jsf->js, gf_error_to_string(e) ));
+		return e;
+	}
+
+	if (jsf->isolate)
+		jsf->ctx = gf_js_create_isolated_context();
+	else
+		jsf->ctx = gf_js_create_context();
 	if (!jsf->ctx) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_SCRIPT, ("[JSF] Failed to load QuickJS context\n"));
+		gf_free(buf);
 		return GF_IO_ERR;
 	}
 	JS_SetContextOpaque(jsf->ctx, jsf);
@@ -4057,7 +4171,7 @@ static GF_Err jsfilter_initialize(GF_Filter *filter)
 
 
 	//initialize filter class and create a single filter object in global scope
-	JS_NewClassID(&jsf_filter_class_id);
+	gf_js_new_class_id(&jsf_filter_class_id);
 	JS_NewClass(rt, jsf_filter_class_id, &jsf_filter_class);
 
 	jsf->filter_obj = JS_NewObjectClass(jsf->ctx, jsf_filter_class_id);
@@ -4066,14 +4180,14 @@ static GF_Err jsfilter_initialize(GF_Filter *filter)
     JS_SetPropertyStr(jsf->ctx, global_obj, "filter", jsf->filter_obj);
 
 	//initialize filter instance class
-	JS_NewClassID(&jsf_filter_inst_class_id);
+	gf_js_new_class_id(&jsf_filter_inst_class_id);
 	JS_NewClass(rt, jsf_filter_inst_class_id, &jsf_filter_inst_class);
 	JSValue finst_proto = JS_NewObjectClass(jsf->ctx, jsf_filter_inst_class_id);
     JS_SetPropertyFunctionList(jsf->ctx, finst_proto, jsf_filter_inst_funcs, countof(jsf_filter_inst_funcs));
     JS_SetClassProto(jsf->ctx, jsf_filter_inst_class_id, finst_proto);
 
 	//initialize filter pid class
-	JS_NewClassID(&jsf_pid_class_id);
+	gf_js_new_class_id(&jsf_pid_class_id);
 	JS_NewClass(rt, jsf_pid_class_id, &jsf_pid_class);
 	JSValue pid_proto = JS_NewObjectClass(jsf->ctx, jsf_pid_class_id);
     JS_SetPropertyFunctionList(jsf->ctx, pid_proto, jsf_pid_funcs, countof(jsf_pid_funcs));
@@ -4081,7 +4195,7 @@ static GF_Err jsfilter_initialize(GF_Filter *filter)
 
 
 	//initialize filter event class
-	JS_NewClassID(&jsf_pck_class_id);
+	gf_js_new_class_id(&jsf_pck_class_id);
 	JS_NewClass(rt, jsf_pck_class_id, &jsf_pck_class);
 	JSValue pck_proto = JS_NewObjectClass(jsf->ctx, jsf_pck_class_id);
     JS_SetPropertyFunctionList(jsf->ctx, pck_proto, jsf_pck_funcs, countof(jsf_pck_funcs));
@@ -4090,21 +4204,15 @@ static GF_Err jsfilter_initialize(GF_Filter *filter)
 	JS_SetPropertyStr(jsf->ctx, global_obj, "_gpac_log_name", JS_NewString(jsf->ctx, gf_file_basename(jsf->js) ) );
     JS_FreeValue(jsf->ctx, global_obj);
 
-
-	//load script
-	GF_Err e = gf_file_load_data(jsf->js, &buf, &buf_len);
-	if (e) {
-		GF_LOG(GF_LOG_ERROR, GF_LOG_SCRIPT, ("[JSF] Error loading script file %s: %s\n", jsf->js, gf_error_to_string(e) ));
-		return e;
-	}
-
-	if (strstr(buf, "session.")) {
+	//session API objects live in the shared runtime, not available in a dedicated one
+	if (!jsf->isolate && strstr(buf, "session.")) {
 		GF_Err gf_fs_load_js_api(JSContext *c, GF_FilterSession *fs);
 //		GF_FilterSession *fs = sjs->compositor->filter->session;
 
 		e = gf_fs_load_js_api(jsf->ctx, filter->session);
 		if (e) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_SCRIPT, ("[JSF] Error loading session API: %s\n", gf_error_to_string(e) ));
+			gf_free(buf);
 			return e;
 		}
 		jsf->unload_session_api = GF_TRUE;
@@ -4349,6 +4457,7 @@ static const char * jsfilter_probe_data(const u8 *data, u32 size, GF_FilterProbe
 static GF_FilterArgs JSFilterArgs[] =
 {
 	{ OFFS(js), "location of script source", GF_PROP_NAME, NULL, NULL, 0},
+	{ OFFS(isolate), "use a dedicated JavaScript runtime for this filter, allowing parallel execution with other JavaScript filters. The session API is not available in this mode", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ "*", -1, "any possible options defined for the script. See `gpac -hx jsf:js=$YOURSCRIPT`", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_META},
 	{0}
 };
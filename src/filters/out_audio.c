@@ -563,6 +563,8 @@ GF_FilterRegister AudioOutRegister = {
 	GF_FS_SET_DESCRIPTION("Audio output")
 	GF_FS_SET_HELP("This filter outputs a single uncompressed audio PID to a soundcard.")
 	.private_size = sizeof(GF_AudioOutCtx),
+	//packets are pulled from the audio thread or callback
+	.flags = GF_FS_REG_ASYNC_PULL,
 	.args = AudioOutArgs,
 	SETCAPS(AudioOutCaps),
 	.initialize = aout_initialize,
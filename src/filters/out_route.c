@@ -0,0 +1,1318 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / ROUTE output filter
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/filters.h>
+#include <gpac/constants.h>
+#include <gpac/network.h>
+
+#ifndef GPAC_DISABLE_ATSC
+
+#define ROUTEOUT_LLS_ADDR	"224.0.23.60"
+#define ROUTEOUT_LLS_PORT	4937
+//TOI of init segments, media segments use their segment number as TOI
+#define ROUTEOUT_INIT_TOI	0xFFFFFFFF
+//codepoint of media objects, ATSC 3.0 media segment file mode
+#define ROUTEOUT_MEDIA_CP	8
+//max size of LCT header with TOL48 extension, plus start offset or FEC payload ID
+#define ROUTEOUT_MAX_HDR	28
+//max number of datagrams sent in one call
+#define ROUTEOUT_MAX_BATCH	64
+//max number of datagrams sent per service per process call
+#define ROUTEOUT_MAX_DGRAMS	1024
+//max duration in us of datagrams queued in the pacer
+#define ROUTEOUT_PACER_MAX_DELAY	50000
+//max size of objects waiting to be sent before we stop fetching input packets
+#define ROUTEOUT_MAX_QUEUE	(64*1024*1024)
+//max sleep time in us when waiting for input, a pending reschedule delays processing of new input packets
+#define ROUTEOUT_IDLE_WAKE	50000
+
+enum
+{
+	ROUTEOUT_FEC_NONE=0,
+	ROUTEOUT_FEC_RS,
+};
+
+typedef struct __routeout_service ROUTEService;
+
+typedef struct
+{
+	GF_FilterPid *pid;
+	ROUTEService *serv;
+	Bool is_manifest, is_ignored, eos;
+	//path of the pid destination relative to the server root, as given by the filter alias
+	char *path;
+	u32 tsi;
+
+	//file being assembled
+	u8 *buf;
+	u32 buf_size, buf_alloc;
+	Bool in_file;
+	Bool has_fnum;
+	u32 fnum;
+	char *fname;
+
+	//init segment, kept for the carousel
+	char *init_name;
+	u8 *init_data;
+	u32 init_size;
+	//file template with $TOI$, set with the first media segment
+	char *template;
+	Bool name_warned;
+} ROUTEPid;
+
+typedef struct
+{
+	u32 tsi, toi;
+	u8 cp;
+	u8 *data;
+	u32 size;
+	//source block number and encoding symbol ID of next datagram
+	u32 sbn, esi;
+} ROUTEObject;
+
+struct __routeout_service
+{
+	u32 service_id;
+	u16 port;
+	//manifest directory relative to server root, including trailing '/'
+	char *root;
+	ROUTEPid *manifest;
+	char *mpd_name;
+	u8 *mpd;
+	u32 mpd_size, mpd_version;
+	char *stsid;
+	u32 stsid_version;
+	//segment pids
+	GF_List *pids;
+
+	GF_Socket *sock, *rsock;
+	GF_SockPacer *pacer;
+	GF_List *objects;
+	//repair symbols of the current source block
+	u8 *repair;
+
+	u64 nb_bytes, nb_dgrams, nb_repair;
+	u32 nb_objects;
+};
+
+typedef struct
+{
+	//options
+	char *dst, *ext, *mime, *ifce;
+	u32 sid, mtu, rate, spin, carousel, sdelay, fec, fecn, fecr, sockbuf;
+
+	//internal
+	GF_Filter *filter;
+	GF_FilterCapability in_caps[2];
+	char szExt[10];
+
+	char *ip;
+	u16 port;
+	GF_List *pids;
+	GF_List *services;
+	GF_Socket *lls_sock;
+	u8 *lls;
+	u32 lls_size;
+
+	Bool started;
+	GF_Err setup_error;
+	u64 start_time, last_carousel;
+	u32 symbol_size;
+	u64 queued_bytes;
+
+	u8 *batch;
+	u32 sizes[ROUTEOUT_MAX_BATCH];
+	u32 sbns[ROUTEOUT_MAX_BATCH], esis[ROUTEOUT_MAX_BATCH];
+
+	//GF(256) tables, and repair coefficients for each source block length
+	u8 *gf_mul;
+	u8 gf_exp[512], gf_log[256];
+	u8 *fec_coefs[256];
+} GF_ROUTEOutCtx;
+
+
+static const char *routeout_get_path(const char *url)
+{
+	const char *sep = strstr(url, "://");
+	if (!sep) return url;
+	sep = strchr(sep+3, '/');
+	return sep ? sep+1 : "";
+}
+
+static GF_Err routeout_initialize(GF_Filter *filter)
+{
+	char *url, *sep;
+	const char *ext;
+	GF_ROUTEOutCtx *ctx = (GF_ROUTEOutCtx *) gf_filter_get_udta(filter);
+
+	if (!ctx || !ctx->dst) return GF_OK;
+	if (strnicmp(ctx->dst, "route://", 8)) return GF_NOT_SUPPORTED;
+
+	//static cap, streamtype = file
+	if (ctx->ext) ext = ctx->ext;
+	else {
+		ext = gf_file_ext_start(routeout_get_path(ctx->dst));
+		ext = ext ? ext+1 : "*";
+	}
+	ctx->in_caps[0].code = GF_PROP_PID_STREAM_TYPE;
+	ctx->in_caps[0].val = PROP_UINT(GF_STREAM_FILE);
+	ctx->in_caps[0].flags = GF_CAPS_INPUT_STATIC;
+	if (ctx->mime) {
+		ctx->in_caps[1].code = GF_PROP_PID_MIME;
+		ctx->in_caps[1].val = PROP_NAME( ctx->mime );
+		ctx->in_caps[1].flags = GF_CAPS_INPUT;
+	} else {
+		strncpy(ctx->szExt, ext, 9);
+		ctx->szExt[9] = 0;
+		strlwr(ctx->szExt);
+		ctx->in_caps[1].code = GF_PROP_PID_FILE_EXT;
+		ctx->in_caps[1].val = PROP_NAME( ctx->szExt );
+		ctx->in_caps[1].flags = GF_CAPS_INPUT;
+	}
+	gf_filter_override_caps(filter, ctx->in_caps, 2);
+
+	/*this is an alias for our main filter, nothing to initialize*/
+	if (gf_filter_is_alias(filter)) return GF_OK;
+
+	ctx->filter = filter;
+	url = gf_strdup(ctx->dst+8);
+	if (!url) return GF_OUT_OF_MEM;
+	sep = strchr(url, '/');
+	if (sep) sep[0] = 0;
+	ctx->port = 1234;
+	sep = strrchr(url, ':');
+	if (sep) {
+		ctx->port = atoi(sep+1);
+		sep[0] = 0;
+	}
+	ctx->ip = url;
+	if (!gf_sk_is_multicast_address(ctx->ip)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ROUTEOut] Destination %s is not a multicast address, ROUTE receivers will likely not get the content\n", ctx->ip));
+	}
+
+	if (ctx->mtu <= ROUTEOUT_MAX_HDR + 100) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ROUTEOut] MTU %d too small, using 1472\n", ctx->mtu));
+		ctx->mtu = 1472;
+	}
+	ctx->symbol_size = ctx->mtu - ROUTEOUT_MAX_HDR;
+	ctx->batch = gf_malloc(ctx->mtu * ROUTEOUT_MAX_BATCH);
+	ctx->pids = gf_list_new();
+	ctx->services = gf_list_new();
+	if (!ctx->batch || !ctx->pids || !ctx->services) return GF_OUT_OF_MEM;
+
+	if (!ctx->fecn) ctx->fecn = 1;
+	if (ctx->fec==ROUTEOUT_FEC_NONE) {
+		ctx->fecr = 0;
+	} else {
+		u32 i, j, x;
+		if (!ctx->fecr) ctx->fecr = 1;
+		if (ctx->fecn + ctx->fecr > 255) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ROUTEOut] Reed-Solomon block of %d source and %d repair symbols exceeds the 255 symbols limit\n", ctx->fecn, ctx->fecr));
+			return GF_BAD_PARAM;
+		}
+		ctx->gf_mul = gf_malloc(256*256);
+		if (!ctx->gf_mul) return GF_OUT_OF_MEM;
+
+		//GF(2^8) with primitive polynomial x^8+x^4+x^3+x^2+1, as specified in RFC 5510 for m=8
+		x = 1;
+		for (i=0; i<255; i++) {
+			ctx->gf_exp[i] = ctx->gf_exp[i+255] = (u8) x;
+			ctx->gf_log[x] = i;
+			x <<= 1;
+			if (x & 0x100) x ^= 0x11D;
+		}
+		ctx->gf_exp[510] = ctx->gf_exp[0];
+		ctx->gf_exp[511] = ctx->gf_exp[1];
+		ctx->gf_log[0] = 0;
+		for (i=0; i<256; i++) {
+			for (j=0; j<256; j++) {
+				ctx->gf_mul[i*256 + j] = (i && j) ? ctx->gf_exp[ctx->gf_log[i] + ctx->gf_log[j]] : 0;
+			}
+		}
+	}
+	return GF_OK;
+}
+
+static void routeout_del_object(GF_ROUTEOutCtx *ctx, ROUTEObject *obj)
+{
+	ctx->queued_bytes -= obj->size;
+	gf_free(obj->data);
+	gf_free(obj);
+}
+
+static void routeout_del_pid(ROUTEPid *rpid)
+{
+	if (rpid->path) gf_free(rpid->path);
+	if (rpid->buf) gf_free(rpid->buf);
+	if (rpid->fname) gf_free(rpid->fname);
+	if (rpid->init_name) gf_free(rpid->init_name);
+	if (rpid->init_data) gf_free(rpid->init_data);
+	if (rpid->template) gf_free(rpid->template);
+	gf_free(rpid);
+}
+
+static void routeout_del_service(GF_ROUTEOutCtx *ctx, ROUTEService *serv)
+{
+	if (serv->nb_dgrams) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_ATSC, ("[ROUTEOut] Service %d sent %d objects "LLU" bytes in "LLU" datagrams ("LLU" repair)\n", serv->service_id, serv->nb_objects, serv->nb_bytes, serv->nb_dgrams, serv->nb_repair));
+	}
+	//flushes pending datagrams, must be done before destroying the sockets
+	if (serv->pacer) gf_sk_pacer_del(serv->pacer);
+	if (serv->sock) gf_sk_del(serv->sock);
+	if (serv->rsock) gf_sk_del(serv->rsock);
+	while (gf_list_count(serv->objects)) {
+		routeout_del_object(ctx, gf_list_pop_back(serv->objects));
+	}
+	gf_list_del(serv->objects);
+	gf_list_del(serv->pids);
+	if (serv->root) gf_free(serv->root);
+	if (serv->mpd_name) gf_free(serv->mpd_name);
+	if (serv->mpd) gf_free(serv->mpd);
+	if (serv->stsid) gf_free(serv->stsid);
+	if (serv->repair) gf_free(serv->repair);
+	gf_free(serv);
+}
+
+static void routeout_finalize(GF_Filter *filter)
+{
+	u32 i;
+	GF_ROUTEOutCtx *ctx = (GF_ROUTEOutCtx *) gf_filter_get_udta(filter);
+
+	if (ctx->services) {
+		while (gf_list_count(ctx->services)) {
+			routeout_del_service(ctx, gf_list_pop_back(ctx->services));
+		}
+		gf_list_del(ctx->services);
+	}
+	if (ctx->pids) {
+		while (gf_list_count(ctx->pids)) {
+			routeout_del_pid(gf_list_pop_back(ctx->pids));
+		}
+		gf_list_del(ctx->pids);
+	}
+	if (ctx->lls_sock) gf_sk_del(ctx->lls_sock);
+	if (ctx->lls) gf_free(ctx->lls);
+	if (ctx->ip) gf_free(ctx->ip);
+	if (ctx->batch) gf_free(ctx->batch);
+	if (ctx->gf_mul) gf_free(ctx->gf_mul);
+	for (i=0; i<256; i++) {
+		if (ctx->fec_coefs[i]) gf_free(ctx->fec_coefs[i]);
+	}
+}
+
+static GF_Err routeout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_remove)
+{
+	const GF_PropertyValue *p;
+	GF_FilterEvent evt;
+	GF_ROUTEOutCtx *ctx_orig;
+	ROUTEPid *rpid;
+	const char *path;
+	GF_ROUTEOutCtx *ctx = (GF_ROUTEOutCtx *) gf_filter_get_udta(filter);
+
+	rpid = gf_filter_pid_get_udta(pid);
+	if (is_remove) {
+		if (rpid) {
+			if (rpid->serv) {
+				if (rpid->serv->manifest==rpid) rpid->serv->manifest = NULL;
+				gf_list_del_item(rpid->serv->pids, rpid);
+			}
+			gf_list_del_item(ctx->pids, rpid);
+			routeout_del_pid(rpid);
+			gf_filter_pid_set_udta(pid, NULL);
+		}
+		return GF_OK;
+	}
+	if (rpid) return GF_OK;
+
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_DISABLE_PROGRESSIVE);
+	if (p && p->value.uint) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ROUTEOut] Block patching is not supported by ROUTE output\n"));
+		return GF_FILTER_NOT_SUPPORTED;
+	}
+
+	GF_SAFEALLOC(rpid, ROUTEPid);
+	if (!rpid) return GF_OUT_OF_MEM;
+	rpid->pid = pid;
+
+	/*if PID was connected to an alias, get the alias context to get the destination
+	Otherwise PID was directly connected to the main filter, use main filter destination*/
+	ctx_orig = (GF_ROUTEOutCtx *) gf_filter_pid_get_alias_udta(pid);
+	if (!ctx_orig) ctx_orig = ctx;
+	path = ctx_orig->dst ? routeout_get_path(ctx_orig->dst) : "";
+	rpid->path = gf_strdup(path);
+
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_FILE_EXT);
+	if (p && p->value.string && !stricmp(p->value.string, "mpd")) rpid->is_manifest = GF_TRUE;
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_MIME);
+	if (p && p->value.string && !stricmp(p->value.string, "application/dash+xml")) rpid->is_manifest = GF_TRUE;
+
+	if (!rpid->is_manifest) {
+		p = gf_filter_pid_get_property(pid, GF_PROP_PID_FILE_EXT);
+		if (p && p->value.string && !stricmp(p->value.string, "m3u8")) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ROUTEOut] HLS playlists are not carried over ROUTE, ignoring %s\n", rpid->path));
+			rpid->is_ignored = GF_TRUE;
+		}
+	}
+
+	if (rpid->is_manifest) {
+		ROUTEService *serv;
+		char *sep;
+		u32 idx = gf_list_count(ctx->services);
+		GF_SAFEALLOC(serv, ROUTEService);
+		if (!serv) {
+			routeout_del_pid(rpid);
+			return GF_OUT_OF_MEM;
+		}
+		serv->service_id = ctx->sid + idx;
+		//source flows on even ports, repair flows on the next port
+		serv->port = ctx->port + 2*idx;
+		serv->manifest = rpid;
+		serv->pids = gf_list_new();
+		serv->objects = gf_list_new();
+		serv->root = gf_strdup(rpid->path);
+		sep = strrchr(serv->root, '/');
+		if (sep) sep[1] = 0;
+		else serv->root[0] = 0;
+		serv->mpd_name = gf_strdup(rpid->path + strlen(serv->root));
+		gf_list_add(ctx->services, serv);
+		rpid->serv = serv;
+
+		if (ctx->started) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ROUTEOut] New manifest %s after session start, service %d will not be announced\n", rpid->path, serv->service_id));
+		}
+	}
+
+	gf_list_add(ctx->pids, rpid);
+	gf_filter_pid_set_udta(pid, rpid);
+
+	gf_filter_pid_init_play_event(pid, &evt, 0, 1.0, "ROUTEOut");
+	gf_filter_pid_send_event(pid, &evt);
+	return GF_OK;
+}
+
+//attach a segment pid to the service with the longest manifest directory matching its destination
+static Bool routeout_map_pid(GF_ROUTEOutCtx *ctx, ROUTEPid *rpid)
+{
+	u32 i, len=0;
+	ROUTEService *serv, *found=NULL;
+	if (rpid->serv) return GF_TRUE;
+	i=0;
+	while ((serv = gf_list_enum(ctx->services, &i))) {
+		u32 rlen = (u32) strlen(serv->root);
+		if (strncmp(rpid->path, serv->root, rlen)) continue;
+		if (!found || (rlen>len)) {
+			found = serv;
+			len = rlen;
+		}
+	}
+	if (!found) return GF_FALSE;
+	rpid->serv = found;
+	gf_list_add(found->pids, rpid);
+	rpid->tsi = gf_list_count(found->pids);
+	if (ctx->started) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ROUTEOut] New stream %s in service %d after session start, receivers not supporting S-TSID updates will not get it\n", rpid->path, found->service_id));
+	}
+	return GF_TRUE;
+}
+
+//get name of file relative to the service manifest
+static const char *routeout_get_file_name(ROUTEPid *rpid, const char *url)
+{
+	const char *path = routeout_get_path(url);
+	u32 len = (u32) strlen(rpid->serv->root);
+	if (!strncmp(path, rpid->serv->root, len)) path += len;
+	return path;
+}
+
+static void routeout_queue_object(GF_ROUTEOutCtx *ctx, ROUTEService *serv, u32 tsi, u32 toi, u8 cp, u8 *data, u32 size, Bool copy, s32 pos)
+{
+	ROUTEObject *obj;
+	if (!size) {
+		if (!copy) gf_free(data);
+		return;
+	}
+	GF_SAFEALLOC(obj, ROUTEObject);
+	if (!obj) {
+		if (!copy) gf_free(data);
+		return;
+	}
+	obj->tsi = tsi;
+	obj->toi = toi;
+	obj->cp = cp;
+	obj->size = size;
+	if (copy) {
+		obj->data = gf_malloc(size);
+		if (!obj->data) {
+			gf_free(obj);
+			return;
+		}
+		memcpy(obj->data, data, size);
+	} else {
+		obj->data = data;
+	}
+	ctx->queued_bytes += size;
+	//never insert before an object being sent
+	if (pos>=0) {
+		ROUTEObject *first = gf_list_get(serv->objects, 0);
+		if (first && (first->sbn || first->esi)) pos++;
+		gf_list_insert(serv->objects, obj, pos);
+	} else {
+		gf_list_add(serv->objects, obj);
+	}
+}
+
+static void routeout_queue_signaling(GF_ROUTEOutCtx *ctx, ROUTEService *serv, Bool with_init)
+{
+	u32 i, pos, version;
+	ROUTEPid *rpid;
+	char *bundle = NULL;
+	char szHdr[1024];
+	const char *boundary = "ROUTEOutBoundary";
+
+	if (!serv->mpd || !serv->stsid) return;
+	//the TOI carries a single version for both objects, the receiver checks the envelope versions
+	version = serv->mpd_version;
+
+	sprintf(szHdr, "Content-Type: multipart/related; type=\"application/mbms-envelope+xml\"; boundary=\"%s\"\r\n\r\n", boundary);
+	gf_dynstrcat(&bundle, szHdr, NULL);
+
+	sprintf(szHdr, "--%s\r\nContent-Type: application/mbms-envelope+xml\r\nContent-Location: envelope.xml\r\n\r\n", boundary);
+	gf_dynstrcat(&bundle, szHdr, NULL);
+	sprintf(szHdr, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<metadataEnvelope xmlns=\"urn:3gpp:metadata:2005:MBMS:envelope\">\n"
+		" <item metadataURI=\"stsid.xml\" version=\"%d\" contentType=\"application/s-tsid\"/>\n"
+		" <item metadataURI=\"%s\" version=\"%d\" contentType=\"application/dash+xml\"/>\n"
+		"</metadataEnvelope>\r\n", serv->stsid_version, serv->mpd_name, serv->mpd_version);
+	gf_dynstrcat(&bundle, szHdr, NULL);
+
+	sprintf(szHdr, "--%s\r\nContent-Type: application/dash+xml\r\nContent-Location: %s\r\n\r\n", boundary, serv->mpd_name);
+	gf_dynstrcat(&bundle, szHdr, NULL);
+	gf_dynstrcat(&bundle, serv->mpd, NULL);
+
+	sprintf(szHdr, "\r\n--%s\r\nContent-Type: application/s-tsid\r\nContent-Location: stsid.xml\r\n\r\n", boundary);
+	gf_dynstrcat(&bundle, szHdr, NULL);
+	gf_dynstrcat(&bundle, serv->stsid, NULL);
+	sprintf(szHdr, "\r\n--%s--\r\n", boundary);
+	gf_dynstrcat(&bundle, szHdr, NULL);
+
+	//TSI 0, TOI with S-TSID and MPD flags and version
+	routeout_queue_object(ctx, serv, 0, (1<<17) | (1<<18) | version, 0, bundle, (u32) strlen(bundle), GF_FALSE, 0);
+	if (!with_init) return;
+
+	pos = 1;
+	i=0;
+	while ((rpid = gf_list_enum(serv->pids, &i))) {
+		if (!rpid->init_data || !rpid->template) continue;
+		routeout_queue_object(ctx, serv, rpid->tsi, ROUTEOUT_INIT_TOI, ROUTEOUT_MEDIA_CP, rpid->init_data, rpid->init_size, GF_TRUE, pos);
+		pos++;
+	}
+}
+
+//derive the ROUTE file template from a segment name by replacing its segment number with $TOI$
+static GF_Err routeout_set_template(ROUTEPid *rpid, const char *name, u32 fnum)
+{
+	char szNum[20];
+	const char *sep, *found = NULL;
+	u32 len;
+
+	sprintf(szNum, "%u", fnum);
+	len = (u32) strlen(szNum);
+	sep = strstr(name, szNum);
+	while (sep) {
+		if (((sep==name) || !isdigit(sep[-1])) && !isdigit(sep[len]))
+			found = sep;
+		sep = strstr(sep+1, szNum);
+	}
+	if (!found) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ROUTEOut] Cannot derive file template from segment %s: segment number %d not found or zero-padded, use $Number$ without padding in segment template\n", name, fnum));
+		return GF_NOT_SUPPORTED;
+	}
+	len = (u32) (found - name);
+	rpid->template = gf_malloc(strlen(name) + 6);
+	if (!rpid->template) return GF_OUT_OF_MEM;
+	memcpy(rpid->template, name, len);
+	strcpy(rpid->template + len, "$TOI$");
+	strcat(rpid->template, found + strlen(szNum));
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_ATSC, ("[ROUTEOut] Service %d TSI %d file template %s\n", rpid->serv->service_id, rpid->tsi, rpid->template));
+	return GF_OK;
+}
+
+//get segment number from a segment name, for muxers only signaling the file name in dash mode
+//this uses the file template if known, or the last decimal number of the name otherwise
+static Bool routeout_get_seg_number(ROUTEPid *rpid, const char *name, u32 *fnum)
+{
+	const char *start, *end;
+	if (rpid->template) {
+		const char *sep = strstr(rpid->template, "$TOI$");
+		u32 len = (u32) (sep - rpid->template);
+		if (strncmp(name, rpid->template, len)) return GF_FALSE;
+		start = end = name + len;
+		while (isdigit(*end)) end++;
+		if ((end==start) || strcmp(end, sep+5)) return GF_FALSE;
+	} else {
+		const char *ext = gf_file_ext_start(name);
+		end = ext ? ext : name + strlen(name);
+		while ((end>name) && !isdigit(end[-1])) end--;
+		if (end==name) return GF_FALSE;
+		start = end;
+		while ((start>name) && isdigit(start[-1])) start--;
+	}
+	*fnum = (u32) strtoul(start, NULL, 10);
+	return GF_TRUE;
+}
+
+static void routeout_on_file(GF_ROUTEOutCtx *ctx, ROUTEPid *rpid)
+{
+	ROUTEService *serv = rpid->serv;
+	u8 *data = rpid->buf;
+	u32 size = rpid->buf_size;
+
+	rpid->in_file = GF_FALSE;
+	rpid->buf_size = 0;
+	if (rpid->is_ignored) return;
+
+	if (rpid->is_manifest) {
+		if (serv->mpd) gf_free(serv->mpd);
+		serv->mpd = gf_malloc(size+1);
+		if (!serv->mpd) return;
+		memcpy(serv->mpd, data, size);
+		serv->mpd[size] = 0;
+		serv->mpd_size = size;
+		serv->mpd_version = (serv->mpd_version % 255) + 1;
+		if (rpid->fname) {
+			const char *name = routeout_get_file_name(rpid, rpid->fname);
+			if (strcmp(name, serv->mpd_name)) {
+				gf_free(serv->mpd_name);
+				serv->mpd_name = gf_strdup(name);
+			}
+		}
+		if (ctx->started) routeout_queue_signaling(ctx, serv, GF_FALSE);
+		return;
+	}
+
+	//no segment number, file following the init segment is a media segment if its number can be found in its name
+	if (!rpid->has_fnum && rpid->init_name && rpid->fname) {
+		const char *name = routeout_get_file_name(rpid, rpid->fname);
+		if (strcmp(name, rpid->init_name) && routeout_get_seg_number(rpid, name, &rpid->fnum))
+			rpid->has_fnum = GF_TRUE;
+	}
+	//init segment
+	if (!rpid->has_fnum) {
+		const char *name = routeout_get_file_name(rpid, rpid->fname ? rpid->fname : rpid->path);
+		if (rpid->init_name && strcmp(rpid->init_name, name)) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ROUTEOut] Init segment name changed from %s to %s, not supported by S-TSID signaling\n", rpid->init_name, name));
+		}
+		if (!rpid->init_name) rpid->init_name = gf_strdup(name);
+		rpid->init_data = gf_realloc(rpid->init_data, size);
+		if (!rpid->init_data) return;
+		memcpy(rpid->init_data, data, size);
+		rpid->init_size = size;
+		routeout_queue_object(ctx, serv, rpid->tsi, ROUTEOUT_INIT_TOI, ROUTEOUT_MEDIA_CP, data, size, GF_TRUE, -1);
+		return;
+	}
+
+	if (!rpid->template) {
+		const char *name = routeout_get_file_name(rpid, rpid->fname ? rpid->fname : rpid->path);
+		if (routeout_set_template(rpid, name, rpid->fnum) != GF_OK) {
+			rpid->is_ignored = GF_TRUE;
+			//drop the init segment, it will not be signaled
+			while (1) {
+				u32 i, count = gf_list_count(serv->objects);
+				for (i=0; i<count; i++) {
+					ROUTEObject *obj = gf_list_get(serv->objects, i);
+					if (obj->tsi != rpid->tsi) continue;
+					gf_list_rem(serv->objects, i);
+					routeout_del_object(ctx, obj);
+					break;
+				}
+				if (i==count) break;
+			}
+			return;
+		}
+	} else if (!rpid->name_warned && rpid->fname) {
+		char szName[GF_MAX_PATH], *sep;
+		const char *name = routeout_get_file_name(rpid, rpid->fname);
+		strncpy(szName, rpid->template, GF_MAX_PATH-20);
+		szName[GF_MAX_PATH-20] = 0;
+		sep = strstr(szName, "$TOI$");
+		if (sep) {
+			sprintf(sep, "%u%s", rpid->fnum, strstr(rpid->template, "$TOI$") + 5);
+			if (strcmp(szName, name)) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ROUTEOut] Segment %s does not match file template %s, receivers will use %s\n", name, rpid->template, szName));
+				rpid->name_warned = GF_TRUE;
+			}
+		}
+	}
+	//segment data is handed to the object, avoiding a copy
+	routeout_queue_object(ctx, serv, rpid->tsi, rpid->fnum, ROUTEOUT_MEDIA_CP, data, size, GF_FALSE, -1);
+	rpid->buf = NULL;
+	rpid->buf_alloc = 0;
+}
+
+static void routeout_process_packet(GF_ROUTEOutCtx *ctx, ROUTEPid *rpid, GF_FilterPacket *pck)
+{
+	Bool start, end;
+	const u8 *data;
+	u32 size;
+
+	gf_filter_pck_get_framing(pck, &start, &end);
+	if (start) {
+		const GF_PropertyValue *p;
+		if (rpid->in_file) routeout_on_file(ctx, rpid);
+		rpid->in_file = GF_TRUE;
+		rpid->buf_size = 0;
+
+		p = gf_filter_pck_get_property(pck, GF_PROP_PCK_FILENUM);
+		rpid->has_fnum = p ? GF_TRUE : GF_FALSE;
+		rpid->fnum = p ? p->value.uint : 0;
+		if (rpid->fname) gf_free(rpid->fname);
+		rpid->fname = NULL;
+		p = gf_filter_pck_get_property(pck, GF_PROP_PCK_FILENAME);
+		if (p && p->value.string) rpid->fname = gf_strdup(p->value.string);
+	}
+	if (!rpid->in_file) return;
+
+	data = gf_filter_pck_get_data(pck, &size);
+	if (data && size && !rpid->is_ignored) {
+		if (rpid->buf_size + size > rpid->buf_alloc) {
+			rpid->buf_alloc = MAX(rpid->buf_alloc*2, rpid->buf_size + size);
+			rpid->buf = gf_realloc(rpid->buf, rpid->buf_alloc);
+			if (!rpid->buf) {
+				rpid->buf_alloc = rpid->buf_size = 0;
+				return;
+			}
+		}
+		memcpy(rpid->buf + rpid->buf_size, data, size);
+		rpid->buf_size += size;
+	}
+	if (end) routeout_on_file(ctx, rpid);
+}
+
+static GF_Err routeout_send_slt(GF_ROUTEOutCtx *ctx)
+{
+	GF_Err e;
+	if (!ctx->lls) {
+		u32 i, size;
+		char szService[1024];
+		ROUTEService *serv;
+		char *slt = NULL;
+		u8 *comp;
+
+		gf_dynstrcat(&slt, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<SLT xmlns=\"tag:atsc.org,2016:XMLSchemas/ATSC3/Delivery/SLT/1.0/\" bsid=\"1\">\n", NULL);
+		i=0;
+		while ((serv = gf_list_enum(ctx->services, &i))) {
+			sprintf(szService, " <Service serviceId=\"%d\" sltSvcSeqNum=\"0\" protected=\"false\" majorChannelNo=\"%d\" minorChannelNo=\"1\" serviceCategory=\"1\" shortServiceName=\"GPAC%d\">\n"
+				"  <BroadcastSvcSignaling slsProtocol=\"1\" slsDestinationIpAddress=\"%s\" slsDestinationUdpPort=\"%d\" slsSourceIpAddress=\"%s\"/>\n"
+				" </Service>\n", serv->service_id, serv->service_id, serv->service_id, ctx->ip, serv->port, ctx->ifce ? ctx->ifce : "0.0.0.0");
+			gf_dynstrcat(&slt, szService, NULL);
+		}
+		gf_dynstrcat(&slt, "</SLT>\n", NULL);
+
+		size = (u32) strlen(slt);
+		comp = (u8 *) slt;
+		e = gf_gz_compress_payload(&comp, size, &size);
+		if (e) {
+			gf_free(comp);
+			return e;
+		}
+		ctx->lls = gf_malloc(size+4);
+		if (!ctx->lls) {
+			gf_free(comp);
+			return GF_OUT_OF_MEM;
+		}
+		//LLS table ID 1 (SLT), group ID 0, group count 1, version 0
+		ctx->lls[0] = 1;
+		ctx->lls[1] = 0;
+		ctx->lls[2] = 0;
+		ctx->lls[3] = 0;
+		memcpy(ctx->lls+4, comp, size);
+		ctx->lls_size = size+4;
+		gf_free(comp);
+	}
+	e = gf_sk_send(ctx->lls_sock, ctx->lls, ctx->lls_size);
+	if (e) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ROUTEOut] Failed to send SLT: %s\n", gf_error_to_string(e) ));
+	}
+	return GF_OK;
+}
+
+static GF_Socket *routeout_create_socket(GF_ROUTEOutCtx *ctx, const char *ip, u16 port)
+{
+	GF_Err e;
+	GF_Socket *sock = gf_sk_new(GF_SOCK_TYPE_UDP);
+	if (!sock) return NULL;
+	if (gf_sk_is_multicast_address(ip)) {
+		//don't bind the multicast port, we would receive our own traffic on loopback
+		e = gf_sk_setup_multicast(sock, ip, port, 0, GF_TRUE, ctx->ifce);
+	} else {
+		e = gf_sk_bind(sock, ctx->ifce, port, ip, port, GF_SOCK_REUSE_PORT | GF_SOCK_FAKE_BIND);
+	}
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ROUTEOut] Failed to setup socket for %s:%d: %s\n", ip, port, gf_error_to_string(e) ));
+		gf_sk_del(sock);
+		return NULL;
+	}
+	gf_sk_set_buffer_size(sock, GF_TRUE, ctx->sockbuf);
+	return sock;
+}
+
+static GF_Err routeout_setup_service(GF_ROUTEOutCtx *ctx, ROUTEService *serv)
+{
+	u32 i;
+	ROUTEPid *rpid;
+	char szLS[GF_MAX_PATH + 1024];
+	char *stsid = NULL;
+
+	serv->sock = routeout_create_socket(ctx, ctx->ip, serv->port);
+	if (!serv->sock) return GF_IP_NETWORK_FAILURE;
+	gf_sk_enable_gso(serv->sock, GF_TRUE);
+	if (ctx->fecr) {
+		serv->rsock = routeout_create_socket(ctx, ctx->ip, serv->port+1);
+		if (!serv->rsock) return GF_IP_NETWORK_FAILURE;
+		serv->repair = gf_malloc(ctx->fecr * ctx->symbol_size);
+		if (!serv->repair) return GF_OUT_OF_MEM;
+	}
+	if (ctx->rate) {
+		serv->pacer = gf_sk_pacer_new(ctx->rate, ctx->spin);
+		if (!serv->pacer) return GF_OUT_OF_MEM;
+	}
+
+	sprintf(szLS, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<S-TSID xmlns=\"tag:atsc.org,2016:XMLSchemas/ATSC3/Delivery/S-TSID/1.0/\">\n"
+		" <RS dIpAddr=\"%s\" dPort=\"%d\" sIpAddr=\"%s\">\n", ctx->ip, serv->port, ctx->ifce ? ctx->ifce : "0.0.0.0");
+	gf_dynstrcat(&stsid, szLS, NULL);
+
+	i=0;
+	while ((rpid = gf_list_enum(serv->pids, &i))) {
+		if (!rpid->template) continue;
+		sprintf(szLS, "  <LS tsi=\"%d\">\n"
+			"   <SrcFlow rt=\"true\">\n"
+			"    <EFDT>\n"
+			"     <FDT-Instance Expires=\"4294967295\" fileTemplate=\"%s\">\n", rpid->tsi, rpid->template);
+		gf_dynstrcat(&stsid, szLS, NULL);
+		if (rpid->init_name) {
+			sprintf(szLS, "      <File Content-Location=\"%s\" TOI=\"%u\"/>\n", rpid->init_name, ROUTEOUT_INIT_TOI);
+			gf_dynstrcat(&stsid, szLS, NULL);
+		}
+		sprintf(szLS, "     </FDT-Instance>\n"
+			"    </EFDT>\n"
+			"    <Payload codePoint=\"%d\" formatID=\"1\" frag=\"0\" order=\"1\"/>\n"
+			"   </SrcFlow>\n", ROUTEOUT_MEDIA_CP);
+		gf_dynstrcat(&stsid, szLS, NULL);
+		//repair flow: FEC encoding ID 5 (Reed-Solomon over GF(2^8), RFC 5510), repair packets on the next UDP port
+		if (ctx->fecr) {
+			sprintf(szLS, "   <RprFlow dPort=\"%d\">\n"
+				"    <FECParameters fecEncodingId=\"5\" maximumSourceBlockLength=\"%d\" encodingSymbolLength=\"%d\" maxNumberOfEncodingSymbols=\"%d\"/>\n"
+				"   </RprFlow>\n", serv->port+1, ctx->fecn, ctx->symbol_size, ctx->fecn + ctx->fecr);
+			gf_dynstrcat(&stsid, szLS, NULL);
+		}
+		gf_dynstrcat(&stsid, "  </LS>\n", NULL);
+	}
+	gf_dynstrcat(&stsid, " </RS>\n</S-TSID>\n", NULL);
+	serv->stsid = stsid;
+	serv->stsid_version = 1;
+	return GF_OK;
+}
+
+//check all services are ready: manifest received and file template known for each stream
+static Bool routeout_check_start(GF_ROUTEOutCtx *ctx)
+{
+	u32 i, j;
+	ROUTEService *serv;
+	ROUTEPid *rpid;
+	GF_Err e;
+
+	if (!gf_list_count(ctx->services)) return GF_FALSE;
+	i=0;
+	while ((rpid = gf_list_enum(ctx->pids, &i))) {
+		if (rpid->is_ignored || rpid->eos) continue;
+		if (!rpid->serv) return GF_FALSE;
+		if (rpid->is_manifest) {
+			if (!rpid->serv->mpd) return GF_FALSE;
+		} else if (!rpid->template) {
+			return GF_FALSE;
+		}
+	}
+	i=0;
+	while ((serv = gf_list_enum(ctx->services, &i))) {
+		if (!serv->mpd) return GF_FALSE;
+	}
+
+	ctx->lls_sock = routeout_create_socket(ctx, ROUTEOUT_LLS_ADDR, ROUTEOUT_LLS_PORT);
+	if (!ctx->lls_sock) {
+		ctx->setup_error = GF_IP_NETWORK_FAILURE;
+		return GF_FALSE;
+	}
+
+	i=0;
+	while ((serv = gf_list_enum(ctx->services, &i))) {
+		e = routeout_setup_service(ctx, serv);
+		if (e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ROUTEOut] Failed to setup service %d: %s\n", serv->service_id, gf_error_to_string(e) ));
+			ctx->setup_error = e;
+			return GF_FALSE;
+		}
+		//the init segments are already queued
+		routeout_queue_signaling(ctx, serv, GF_FALSE);
+		GF_LOG(GF_LOG_INFO, GF_LOG_ATSC, ("[ROUTEOut] Service %d on %s:%d - %d streams - manifest %s\n", serv->service_id, ctx->ip, serv->port, gf_list_count(serv->pids), serv->mpd_name));
+		j=0;
+		while ((rpid = gf_list_enum(serv->pids, &j))) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_ATSC, ("[ROUTEOut] Service %d TSI %d init %s template %s\n", serv->service_id, rpid->tsi, rpid->init_name ? rpid->init_name : "none", rpid->template ? rpid->template : "none"));
+		}
+	}
+	routeout_send_slt(ctx);
+	ctx->started = GF_TRUE;
+	ctx->start_time = ctx->last_carousel = gf_sys_clock_high_res();
+	return GF_TRUE;
+}
+
+//LCT header: V=1 C=0 PSI S=1 O=01 H=0 A=0 B, HDR_LEN, CP, CCI=0, TSI, TOI, EXT_TOL24 or EXT_TOL48
+static u32 routeout_write_lct(u8 *buf, u8 psi, Bool close, u8 cp, u32 tsi, u32 toi, u32 tol)
+{
+	u32 hdr_len = (tol > 0xFFFFFF) ? 6 : 5;
+	buf[0] = 0x10 | psi;
+	buf[1] = 0xA0 | (close ? 1 : 0);
+	buf[2] = hdr_len;
+	buf[3] = cp;
+	memset(buf+4, 0, 4);
+	buf[8] = (tsi>>24) & 0xFF;
+	buf[9] = (tsi>>16) & 0xFF;
+	buf[10] = (tsi>>8) & 0xFF;
+	buf[11] = tsi & 0xFF;
+	buf[12] = (toi>>24) & 0xFF;
+	buf[13] = (toi>>16) & 0xFF;
+	buf[14] = (toi>>8) & 0xFF;
+	buf[15] = toi & 0xFF;
+	if (hdr_len==5) {
+		buf[16] = 194;
+		buf[17] = (tol>>16) & 0xFF;
+		buf[18] = (tol>>8) & 0xFF;
+		buf[19] = tol & 0xFF;
+	} else {
+		buf[16] = 67;
+		buf[17] = 2;
+		buf[18] = buf[19] = 0;
+		buf[20] = (tol>>24) & 0xFF;
+		buf[21] = (tol>>16) & 0xFF;
+		buf[22] = (tol>>8) & 0xFF;
+		buf[23] = tol & 0xFF;
+	}
+	return 4*hdr_len;
+}
+
+/*repair coefficients of the RFC 5510 systematic code for blocks of k source symbols. The generator matrix is
+V(k,k)^-1 x V(k,n) with V(i,j) = alpha^(i*j): the source symbols are the values at alpha^0..alpha^(k-1) of a polynomial
+of degree k-1, and repair symbol ESI k+j is its value at alpha^(k+j). The coefficient of source symbol i is the
+Lagrange basis polynomial L_i evaluated at alpha^(k+j)*/
+static u8 *routeout_fec_get_coefs(GF_ROUTEOutCtx *ctx, u32 k)
+{
+	u32 i, j, m;
+	u8 *coefs = ctx->fec_coefs[k];
+	if (coefs) return coefs;
+	coefs = gf_malloc(k * ctx->fecr);
+	if (!coefs) return NULL;
+
+	for (j=0; j<ctx->fecr; j++) {
+		u8 x = ctx->gf_exp[k+j];
+		for (i=0; i<k; i++) {
+			u8 num = 1, den = 1;
+			for (m=0; m<k; m++) {
+				if (m==i) continue;
+				//subtraction in GF(2^8) is xor
+				num = ctx->gf_mul[256*num + (x ^ ctx->gf_exp[m])];
+				den = ctx->gf_mul[256*den + (ctx->gf_exp[i] ^ ctx->gf_exp[m])];
+			}
+			coefs[j*k + i] = ctx->gf_mul[256*num + ctx->gf_exp[255 - ctx->gf_log[den]]];
+		}
+	}
+	ctx->fec_coefs[k] = coefs;
+	return coefs;
+}
+
+static GF_Err routeout_fec_encode(GF_ROUTEOutCtx *ctx, ROUTEService *serv, const u8 *block, u32 block_len, u32 nb_src)
+{
+	u32 i, j, b, T = ctx->symbol_size;
+	u8 *coefs = routeout_fec_get_coefs(ctx, nb_src);
+	if (!coefs) return GF_OUT_OF_MEM;
+
+	memset(serv->repair, 0, ctx->fecr * T);
+	//the last source symbol of the object is padded with zeros
+	for (i=0; i<nb_src; i++) {
+		const u8 *src = block + i*T;
+		u32 len = MIN(T, block_len - i*T);
+		for (j=0; j<ctx->fecr; j++) {
+			const u8 *row = ctx->gf_mul + 256 * coefs[j*nb_src + i];
+			u8 *dst = serv->repair + j*T;
+			for (b=0; b<len; b++) {
+				dst[b] ^= row[src[b]];
+			}
+		}
+	}
+	return GF_OK;
+}
+
+//source block partitioning of RFC 5052 section 9.1, with a maximum source block length of fecn symbols
+static u32 routeout_get_block(GF_ROUTEOutCtx *ctx, u32 obj_size, u32 sbn, u32 *first_symbol)
+{
+	u32 N, Z, A_large, A_small, I_large, T = ctx->symbol_size;
+	N = (obj_size + T - 1) / T;
+	if (!N) return 0;
+	Z = (N + ctx->fecn - 1) / ctx->fecn;
+	if (sbn >= Z) return 0;
+	A_large = (N + Z - 1) / Z;
+	A_small = N / Z;
+	I_large = N - A_small * Z;
+	if (sbn < I_large) {
+		*first_symbol = sbn * A_large;
+		return A_large;
+	}
+	*first_symbol = I_large * A_large + (sbn - I_large) * A_small;
+	return A_small;
+}
+
+//build the next datagram of the object, returns 0 if the object is done
+static u32 routeout_build_dgram(GF_ROUTEOutCtx *ctx, ROUTEService *serv, ROUTEObject *obj, u8 *buf, Bool *is_repair)
+{
+	u32 hdr_size, block_len, nb_src, first_symbol=0, T = ctx->symbol_size;
+	u64 block_start;
+
+	nb_src = routeout_get_block(ctx, obj->size, obj->sbn, &first_symbol);
+	if (!nb_src) return 0;
+	block_start = (u64) first_symbol * T;
+	block_len = (u32) MIN((u64) nb_src * T, obj->size - block_start);
+
+	if (!obj->esi && ctx->fecr) {
+		if (routeout_fec_encode(ctx, serv, obj->data + block_start, block_len, nb_src) != GF_OK) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ROUTEOut] Failed to allocate FEC coefficients, dropping object TSI %u TOI %u\n", obj->tsi, obj->toi));
+			return 0;
+		}
+	}
+
+	if (obj->esi < nb_src) {
+		u32 offset = (u32) block_start + obj->esi*T;
+		u32 len = MIN(T, obj->size - offset);
+		hdr_size = routeout_write_lct(buf, 2, (offset+len==obj->size) ? GF_TRUE : GF_FALSE, obj->cp, obj->tsi, obj->toi, obj->size);
+		buf[hdr_size] = (offset>>24) & 0xFF;
+		buf[hdr_size+1] = (offset>>16) & 0xFF;
+		buf[hdr_size+2] = (offset>>8) & 0xFF;
+		buf[hdr_size+3] = offset & 0xFF;
+		memcpy(buf + hdr_size + 4, obj->data + offset, len);
+		*is_repair = GF_FALSE;
+		hdr_size += 4 + len;
+	} else {
+		u32 j = obj->esi - nb_src;
+		hdr_size = routeout_write_lct(buf, 0, GF_FALSE, obj->cp, obj->tsi, obj->toi, obj->size);
+		//FEC payload ID: 24 bit source block number, 8 bit encoding symbol ID, repair symbols start at ESI k
+		buf[hdr_size] = (obj->sbn>>16) & 0xFF;
+		buf[hdr_size+1] = (obj->sbn>>8) & 0xFF;
+		buf[hdr_size+2] = obj->sbn & 0xFF;
+		buf[hdr_size+3] = (u8) (nb_src + j);
+		memcpy(buf + hdr_size + 4, serv->repair + j*T, T);
+		*is_repair = GF_TRUE;
+		hdr_size += 4 + T;
+	}
+	obj->esi++;
+	if (obj->esi == nb_src + ctx->fecr) {
+		obj->esi = 0;
+		obj->sbn++;
+	}
+	return hdr_size;
+}
+
+//send datagrams of the service, returns GF_TRUE if blocked by the socket or the pacer
+static Bool routeout_send_service(GF_ROUTEOutCtx *ctx, ROUTEService *serv)
+{
+	u32 nb_dgrams = 0;
+
+	while (nb_dgrams < ROUTEOUT_MAX_DGRAMS) {
+		u32 i, nb=0, nb_sent=0;
+		Bool is_repair=GF_FALSE, batch_repair=GF_FALSE, obj_done=GF_FALSE;
+		const u8 *bufs[ROUTEOUT_MAX_BATCH];
+		GF_Socket *sock;
+		ROUTEObject *obj = gf_list_get(serv->objects, 0);
+		if (!obj) break;
+
+		if (serv->pacer && (gf_sk_pacer_get_delay(serv->pacer) > ROUTEOUT_PACER_MAX_DELAY))
+			return GF_TRUE;
+
+		//build a batch of datagrams for the same socket, stopping at the end of each source block when FEC is used
+		while (nb < ROUTEOUT_MAX_BATCH) {
+			u32 size;
+			ctx->sbns[nb] = obj->sbn;
+			ctx->esis[nb] = obj->esi;
+			bufs[nb] = ctx->batch + nb*ctx->mtu;
+			size = routeout_build_dgram(ctx, serv, obj, (u8 *) bufs[nb], &is_repair);
+			if (!size) {
+				obj_done = GF_TRUE;
+				break;
+			}
+			if (nb && (is_repair != batch_repair)) {
+				obj->sbn = ctx->sbns[nb];
+				obj->esi = ctx->esis[nb];
+				break;
+			}
+			batch_repair = is_repair;
+			ctx->sizes[nb] = size;
+			nb++;
+			if (ctx->fecr && !obj->esi) break;
+		}
+		if (!nb && obj_done) {
+			obj = gf_list_pop_front(serv->objects);
+			serv->nb_objects++;
+			routeout_del_object(ctx, obj);
+			continue;
+		}
+
+		sock = batch_repair ? serv->rsock : serv->sock;
+		if (serv->pacer) {
+			for (i=0; i<nb; i++) {
+				if (gf_sk_pacer_send(serv->pacer, sock, bufs[i], ctx->sizes[i], 0) != GF_OK) break;
+			}
+			nb_sent = i;
+		} else {
+			GF_Err e = gf_sk_send_batch(sock, bufs, ctx->sizes, nb, &nb_sent);
+			if (e && (e != GF_BUFFER_TOO_SMALL) && (e != GF_IP_SOCK_WOULD_BLOCK)) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ROUTEOut] Service %d write error: %s\n", serv->service_id, gf_error_to_string(e) ));
+				nb_sent = nb;
+			}
+		}
+		for (i=0; i<nb_sent; i++) {
+			serv->nb_bytes += ctx->sizes[i];
+		}
+		serv->nb_dgrams += nb_sent;
+		if (batch_repair) serv->nb_repair += nb_sent;
+		nb_dgrams += nb_sent;
+
+		//socket buffer or pacer queue full, resume from the first datagram not sent
+		if (nb_sent < nb) {
+			obj->sbn = ctx->sbns[nb_sent];
+			obj->esi = ctx->esis[nb_sent];
+			return GF_TRUE;
+		}
+	}
+	return GF_FALSE;
+}
+
+static GF_Err routeout_process(GF_Filter *filter)
+{
+	u32 i, nb_eos=0, nb_pids, nb_pck=0;
+	u64 now;
+	Bool blocked=GF_FALSE, pending=GF_FALSE;
+	ROUTEPid *rpid;
+	ROUTEService *serv;
+	GF_ROUTEOutCtx *ctx = (GF_ROUTEOutCtx *) gf_filter_get_udta(filter);
+
+	if (ctx->setup_error) return ctx->setup_error;
+
+	nb_pids = gf_list_count(ctx->pids);
+	for (i=0; i<nb_pids; i++) {
+		rpid = gf_list_get(ctx->pids, i);
+		if (rpid->eos) {
+			nb_eos++;
+			continue;
+		}
+		//wait for the manifest to know the service of the stream
+		if (!rpid->is_ignored && !routeout_map_pid(ctx, rpid)) continue;
+
+		while (1) {
+			GF_FilterPacket *pck;
+			//don't fetch more input than we can send
+			if (ctx->started && (ctx->queued_bytes > ROUTEOUT_MAX_QUEUE)) break;
+
+			pck = gf_filter_pid_get_packet(rpid->pid);
+			if (!pck) {
+				if (gf_filter_pid_is_eos(rpid->pid)) {
+					if (rpid->in_file) routeout_on_file(ctx, rpid);
+					rpid->eos = GF_TRUE;
+					nb_eos++;
+				}
+				break;
+			}
+			routeout_process_packet(ctx, rpid, pck);
+			gf_filter_pid_drop_packet(rpid->pid);
+			nb_pck++;
+		}
+	}
+
+	if (!ctx->started && !routeout_check_start(ctx)) {
+		if (ctx->setup_error) return ctx->setup_error;
+		if (nb_pids && (nb_eos==nb_pids)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ROUTEOut] End of stream before any manifest or segment could be sent\n"));
+			return GF_EOS;
+		}
+		return GF_OK;
+	}
+
+	now = gf_sys_clock_high_res();
+	//let receivers join the services before sending objects
+	if (now < ctx->start_time + ctx->sdelay*1000) {
+		gf_filter_ask_rt_reschedule(filter, (u32) (ctx->start_time + ctx->sdelay*1000 - now));
+		return GF_OK;
+	}
+
+	if (ctx->carousel && (now >= ctx->last_carousel + ctx->carousel*1000)) {
+		ctx->last_carousel = now;
+		routeout_send_slt(ctx);
+		i=0;
+		while ((serv = gf_list_enum(ctx->services, &i))) {
+			routeout_queue_signaling(ctx, serv, GF_TRUE);
+		}
+	}
+
+	i=0;
+	while ((serv = gf_list_enum(ctx->services, &i))) {
+		if (!serv->sock) continue;
+		if (routeout_send_service(ctx, serv)) blocked = GF_TRUE;
+		if (gf_list_count(serv->objects)) pending = GF_TRUE;
+	}
+
+	if (blocked) {
+		gf_filter_ask_rt_reschedule(filter, 1000);
+	} else if (pending) {
+		gf_filter_post_process_task(filter);
+	} else if (nb_eos==nb_pids) {
+		return GF_EOS;
+	} else if (ctx->carousel && !nb_pck) {
+		//no input, wake up for next carousel - new input packets will only be processed after that
+		u64 next = ctx->last_carousel + ctx->carousel*1000;
+		now = gf_sys_clock_high_res();
+		if (next > now)
+			gf_filter_ask_rt_reschedule(filter, (u32) MIN(next - now, ROUTEOUT_IDLE_WAKE));
+	}
+	return GF_OK;
+}
+
+static GF_FilterProbeScore routeout_probe_url(const char *url, const char *mime)
+{
+	if (!strnicmp(url, "route://", 8)) return GF_FPROBE_SUPPORTED;
+	return GF_FPROBE_NOT_SUPPORTED;
+}
+
+static Bool routeout_use_alias(GF_Filter *filter, const char *url, const char *mime)
+{
+	u32 len;
+	char *sep;
+	GF_ROUTEOutCtx *ctx = (GF_ROUTEOutCtx *) gf_filter_get_udta(filter);
+
+	//check we have same destination address and port. If so, accept this destination as a source for our filter
+	sep = strstr(url, "://");
+	if (!sep) return GF_FALSE;
+	sep += 3;
+	sep = strchr(sep, '/');
+	if (!sep) {
+		if (!strcmp(ctx->dst, url)) return GF_TRUE;
+		return GF_FALSE;
+	}
+	len = (u32) (sep - url);
+	if (!strncmp(ctx->dst, url, len)) return GF_TRUE;
+	return GF_FALSE;
+}
+
+#define OFFS(_n)	#_n, offsetof(GF_ROUTEOutCtx, _n)
+
+static const GF_FilterArgs ROUTEOutArgs[] =
+{
+	{ OFFS(dst), "destination URL", GF_PROP_NAME, NULL, NULL, 0},
+	{ OFFS(ext), "file extension of pipe data - see filter help", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(mime), "mime type of pipe data - see filter help", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(ifce), "default multicast interface", GF_PROP_NAME, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(sid), "service ID of the first service, incremented for each additional manifest", GF_PROP_UINT, "1", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(mtu), "maximum UDP payload size of datagrams", GF_PROP_UINT, "1472", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(rate), "send rate in bps of each service, paced from a dedicated thread. If 0, datagrams are sent as fast as possible", GF_PROP_UINT, "0", NULL, 0},
+	{ OFFS(spin), "busy-wait this many microseconds before each paced send instead of sleeping", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(carousel), "interval in ms between repetitions of the SLT, signaling bundle and init segments, 0 disables repetition", GF_PROP_UINT, "1000", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(sdelay), "delay in ms between the first SLT and the first object sent, giving receivers time to join the services", GF_PROP_UINT, "100", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(fec), "forward error correction of media objects\n"
+	"- none: no repair flow\n"
+	"- rs: Reed-Solomon repair symbols over GF(2^8) sent on the port following the service port", GF_PROP_UINT, "none", "none|rs", 0},
+	{ OFFS(fecn), "number of source symbols per FEC source block", GF_PROP_UINT, "32", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(fecr), "number of repair symbols per FEC source block", GF_PROP_UINT, "4", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(sockbuf), "socket send buffer size", GF_PROP_UINT, "4194304", NULL, GF_FS_ARG_HINT_EXPERT},
+	{0}
+};
+
+static const GF_FilterCapability ROUTEOutCaps[] =
+{
+	CAP_UINT(GF_CAPS_INPUT,GF_PROP_PID_STREAM_TYPE, GF_STREAM_FILE),
+	CAP_STRING(GF_CAPS_INPUT,GF_PROP_PID_FILE_EXT, "*"),
+	CAP_STRING(GF_CAPS_INPUT,GF_PROP_PID_MIME, "*"),
+};
+
+
+GF_FilterRegister ROUTEOutRegister = {
+	.name = "routeout",
+	GF_FS_SET_DESCRIPTION("ROUTE output")
+	GF_FS_SET_HELP("This filter sends DASH sessions over ATSC 3.0 ROUTE, as received by the `atscin` filter.\n"
+		"The destination URL is formatted as `route://IP:PORT/MANIFEST`. The filter announces the services in an SLT on the ATSC 3.0 LLS multicast address, "
+		"and sends for each service the signaling bundle (envelope, manifest and S-TSID) on TSI 0 and each representation on its own LCT channel.\n"
+		"Each manifest sent to the same IP and port is a new service, with service ID starting at [-sid]() and UDP port starting at `PORT`, increased by 2 for each service. "
+		"Each service must be output in its own directory.\n"
+		"EX gpac -i source.mp4 -o route://234.1.1.1:1234/live.mpd:dmode=dynamic:profile=live\n"
+		"  \n"
+		"Segments are identified by their segment number (used as TOI) and the file template is derived from the first segment name. "
+		"The segment template must use `$Number$` without zero padding.\n"
+		"Objects are not sent until the manifest and the first segment of each representation are available, so that the S-TSID describes all streams; "
+		"with non real-time sources in static mode, all segments are buffered until the manifest is produced.\n"
+		"  \n"
+		"The SLT, signaling bundle and init segments are repeated every [-carousel]() ms so that receivers can tune in at any time.\n"
+		"  \n"
+		"# Pacing\n"
+		"By default datagrams are sent as fast as possible using batched sends, which allows sending several Gbps on loopback and makes the filter usable as a receiver load generator.\n"
+		"The [-rate]() option paces each service at the given bitrate from a dedicated thread.\n"
+		"EX gpac -i source.mp4 reframer:rt=on @ -o route://234.1.1.1:1234/live.mpd:dmode=dynamic:rate=20m\n"
+		"  \n"
+		"# Forward Error Correction\n"
+		"When [-fec]() is set, each object is split in source blocks of [-fecn]() symbols of `mtu - 28` bytes, and [-fecr]() repair symbols are computed for each block "
+		"using the systematic Reed-Solomon code over GF(2^8) of RFC 5510. Any `k` symbols received out of a block of `k` source symbols allow recovering it.\n"
+		"Objects are partitioned in source blocks of at most [-fecn]() symbols following RFC 5052, so that blocks of an object differ by at most one symbol.\n"
+		"Repair packets use LCT PSI 0 with a FEC payload ID of 24 bit source block number and 8 bit symbol ID (FEC encoding ID 5), and are sent on the port following the service port, announced as `RprFlow` in the S-TSID.\n"
+		"Receivers not supporting FEC ignore the repair flow.\n"
+		)
+	.private_size = sizeof(GF_ROUTEOutCtx),
+	.max_extra_pids = -1,
+	.args = ROUTEOutArgs,
+	.probe_url = routeout_probe_url,
+	.initialize = routeout_initialize,
+	.finalize = routeout_finalize,
+	SETCAPS(ROUTEOutCaps),
+	.configure_pid = routeout_configure_pid,
+	.process = routeout_process,
+	.use_alias = routeout_use_alias
+};
+
+
+const GF_FilterRegister *routeout_register(GF_FilterSession *session)
+{
+	return &ROUTEOutRegister;
+}
+
+#else
+
+const GF_FilterRegister *routeout_register(GF_FilterSession *session)
+{
+	return NULL;
+}
+
+#endif /* GPAC_DISABLE_ATSC */
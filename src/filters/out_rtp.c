@@ -37,6 +37,8 @@
 
 #include "out_rtp.h"
 
+//max duration in us of packets queued in the pacer
+#define RTPOUT_PACER_MAX_DELAY	50000
 
 typedef struct
 {
@@ -54,6 +56,7 @@ typedef struct
 	char *info, *url, *email;
 	s32 runfor, tso;
 	Bool latm;
+	u32 prate, spin;
 
 	/*timeline origin of our session (all tracks) in microseconds*/
 	u64 sys_clock_at_init;
@@ -78,6 +81,9 @@ typedef struct
 	u32 single_stream;
 	GF_FilterCapability in_caps[2];
 	char szExt[10];
+
+	//shared pacer for all streams
+	GF_SockPacer *sk_pacer;
 } GF_RTPOutCtx;
 
 
@@ -477,6 +483,8 @@ GF_Err rtpout_init_streamer(GF_RTPOutStream *stream, const char *ipdest, Bool in
 		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTPOut] Could not initialize RTP for stream %s:  not supported\n", gf_filter_pid_get_name(stream->pid) ));
 		return GF_NOT_SUPPORTED;
 	}
+	//packets of an AU are sent with a single call, see rtpout_process_rtp
+	gf_rtp_streamer_enable_send_batch(stream->rtp, RTPOUT_SEND_BATCH);
 
 	p = gf_filter_pid_get_property(stream->pid, GF_PROP_PID_DELAY);
 	stream->ts_delay = p ? p->value.sint : 0;
@@ -549,6 +557,31 @@ static u16 rtpout_check_next_port(GF_RTPOutCtx *ctx, u16 first_port)
 	return first_port;
 }
 
+//sends all packets queued in the pacer, needed before destroying a stream socket
+static void rtpout_drain_pacer(GF_RTPOutCtx *ctx)
+{
+	if (ctx->sk_pacer)
+		gf_sk_pacer_flush(ctx->sk_pacer, NULL);
+}
+
+//max number of RTP packets produced by the next packet of each stream
+static u32 rtpout_pacer_slots_needed(GF_RTPOutCtx *ctx)
+{
+	u32 i, count, nb_slots = 1;
+	count = gf_list_count(ctx->streams);
+	for (i=0; i<count; i++) {
+		u32 size = 0, nb;
+		GF_RTPOutStream *stream = gf_list_get(ctx->streams, i);
+		GF_FilterPacket *pck = stream->pck ? stream->pck : gf_filter_pid_get_packet(stream->pid);
+		if (!pck) continue;
+		gf_filter_pck_get_data(pck, &size);
+		//payload headers may take a few bytes in each packet, and parameter sets may be injected
+		nb = size / (ctx->mtu / 2) + 4;
+		if (nb > nb_slots) nb_slots = nb;
+	}
+	return nb_slots;
+}
+
 static void rtpout_del_stream(GF_RTPOutStream *st)
 {
 	if (st->rtp) gf_rtp_streamer_del(st->rtp);
@@ -576,6 +609,7 @@ static GF_Err rtpout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is
 		if (t) {
 			if (ctx->active_stream==t) ctx->active_stream = NULL;
 			gf_list_del_item(ctx->streams, t);
+			rtpout_drain_pacer(ctx);
 			rtpout_del_stream(t);
 		}
 		if (!gf_list_count(ctx->streams)) {
@@ -598,6 +632,7 @@ static GF_Err rtpout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is
 		if (stream) {
 			if (ctx->active_stream==stream) ctx->active_stream = NULL;
 			gf_list_del_item(ctx->streams, stream);
+			rtpout_drain_pacer(ctx);
 			rtpout_del_stream(stream);
 		}
 		if (!ctx->dst)
@@ -660,6 +695,8 @@ static GF_Err rtpout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is
 	//init rtp
 	e = rtpout_init_streamer(stream,  ctx->ip ? ctx->ip : "127.0.0.1", ctx->xps, ctx->mpeg4, ctx->latm, payt, ctx->mtu, ctx->ttl, ctx->ifce, GF_FALSE, &ctx->base_pid_id, ctx->single_stream);
 	if (e) return e;
+	if (ctx->sk_pacer)
+		gf_rtp_streamer_set_pacer(stream->rtp, ctx->sk_pacer);
 
 	stream->selected = GF_TRUE;
 
@@ -682,6 +719,12 @@ static GF_Err rtpout_initialize(GF_Filter *filter)
 	if (ctx->payt<96) ctx->payt = 96;
 	if (ctx->payt>127) ctx->payt = 127;
 	ctx->streams = gf_list_new();
+	if (ctx->prate) {
+		ctx->sk_pacer = gf_sk_pacer_new(ctx->prate, ctx->spin);
+		if (!ctx->sk_pacer) return GF_OUT_OF_MEM;
+	}
+	//packets are sent at their mapped timestamp, ask the deadline scheduler to run us within the time tolerance
+	gf_filter_set_latency_budget(filter, ctx->tt ? ctx->tt : 1000);
 
 	if (ctx->dst && (ctx->ext || ctx->mime) ) {
 		//static cap, streamtype = file
@@ -712,6 +755,9 @@ static void rtpout_finalize(GF_Filter *filter)
 {
 	GF_RTPOutCtx *ctx = (GF_RTPOutCtx *) gf_filter_get_udta(filter);
 
+	//flushes pending packets, must be done before destroying the streams
+	if (ctx->sk_pacer) gf_sk_pacer_del(ctx->sk_pacer);
+
 	while (gf_list_count(ctx->streams)) {
 		GF_RTPOutStream *tmp = gf_list_pop_back(ctx->streams);
 		rtpout_del_stream(tmp);
@@ -1046,6 +1092,8 @@ GF_Err rtpout_process_rtp(GF_List *streams, GF_RTPOutStream **active_stream, Boo
 	} else {
 		e = gf_rtp_streamer_send_data(stream->rtp, (char *) pck_data, pck_size, pck_size, cts, dts, stream->current_sap ? 1 : 0, 1, 1, stream->pck_num, duration, stream->sample_desc_index);
 	}
+	//send all packets of the AU
+	gf_rtp_streamer_flush(stream->rtp);
 	gf_filter_pid_drop_packet(stream->pid);
 	stream->pck = NULL;
 
@@ -1085,11 +1133,31 @@ static GF_Err rtpout_process(GF_Filter *filter)
 		}
 	}
 
+	//enough packets queued in the pacer, wait before pushing more
+	if (ctx->sk_pacer) {
+		u64 delay = gf_sk_pacer_get_delay(ctx->sk_pacer);
+		if (delay > RTPOUT_PACER_MAX_DELAY) {
+			gf_filter_ask_rt_reschedule(filter, (u32) (delay - RTPOUT_PACER_MAX_DELAY/2) );
+			return GF_OK;
+		}
+		//not enough room in the pacer queue for the largest pending packet, retry once some packets are sent
+		if (gf_sk_pacer_get_free(ctx->sk_pacer) < rtpout_pacer_slots_needed(ctx)) {
+			gf_filter_ask_rt_reschedule(filter, 1000);
+			return GF_OK;
+		}
+	}
+
 	e = rtpout_process_rtp(ctx->streams, &ctx->active_stream, ctx->loop, ctx->delay, &ctx->active_stream_idx, ctx->sys_clock_at_init, &ctx->active_min_ts_microsec, ctx->microsec_ts_init, &ctx->wait_for_loop, &repost_delay_us, &ctx->first_RTCP_sent, ctx->base_pid_id);
 	if (e) return e;
 
-	if (repost_delay_us)
+	if (repost_delay_us) {
 		gf_filter_ask_rt_reschedule(filter, repost_delay_us);
+		//in deadline scheduler mode, the next run must happen before the send time of the next packet
+		if (ctx->active_min_ts_microsec != (u64) -1) {
+			s64 send_time = (s64) ctx->active_min_ts_microsec + ((s64) ctx->delay) * 1000;
+			if (send_time > 0) gf_filter_set_deadline(filter, (u64) send_time);
+		}
+	}
 
 	return GF_OK;
 }
@@ -1138,6 +1206,8 @@ static const GF_FilterArgs RTPOutArgs[] =
 	{ OFFS(tso), "set timestamp offset in microsecs. Negative value means random initial timestamp", GF_PROP_SINT, "-1", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(xps), "force parameter set injection at each SAP. If not set, only inject if different from SDP ones", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(latm), "use latm for AAC payload format", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(prate), "send packets from a dedicated pacing thread at the given rate in bps, shared by all streams. 0 disables pacing and sends packets at their scheduled time", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(spin), "busy-wait this many microseconds before each paced send instead of sleeping, for sub-100 us precision", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(dst), "URL for direct RTP mode - see filter help", GF_PROP_NAME, NULL, NULL, 0},
 	{ OFFS(ext), "file extension for direct RTP mode - see filter help", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(mime), "set mime type for direct RTP mode - see filter help", GF_PROP_NAME, NULL, NULL, GF_FS_ARG_HINT_ADVANCED},
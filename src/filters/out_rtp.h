@@ -36,7 +36,8 @@
 /*IETF lib*/
 #include <gpac/internal/ietf_dev.h>
 
-
+//max number of RTP packets sent per system call
+#define RTPOUT_SEND_BATCH	GF_RTP_MAX_BATCH
 
 typedef struct
 {
@@ -93,6 +94,8 @@ typedef struct
 	u32 ctrl_id;
 	u32 rtp_id, rtcp_id;
 	u32 mcast_port;
+	/*shared packet ring in RTSP fan-out mode*/
+	struct __rtspout_fanout_ring *fanout_ring;
 } GF_RTPOutStream;
 
 GF_Err rtpout_create_sdp(GF_List *streams, Bool is_rtsp, const char *ip, const char *info, const char *sess_name, const char *url, const char *email, u32 base_pid_id, FILE **sdp_tmp, u64 *session_id);
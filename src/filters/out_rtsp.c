@@ -72,6 +72,8 @@ typedef struct
 	Bool close, loop, dynurl, mpeg4;
 	u32 mcast;
 	Bool latm;
+	Bool fanout;
+	u32 fanring;
 
 	GF_Socket *server_sock;
 	GF_List *sessions;
@@ -131,8 +133,50 @@ typedef struct __rtspout_session
 	Bool request_pending;
 	char *multicast_ip;
 	u64 sdp_id;
+
+	/*fan-out channel: no RTSP connection, packetizes its streams once for all attached clients*/
+	Bool fanout;
+	GF_List *fanout_clients;
+	/*fan-out client: channel the session is attached to and per-stream destinations*/
+	struct __rtspout_session *fanout_src;
+	GF_List *fanout_dests;
+	Bool fanout_join;
 } GF_RTSPOutSession;
 
+typedef struct
+{
+	GF_RTPHeader hdr;
+	/*RTP packet, the first 12 bytes are reserved for the header of each client*/
+	u8 *data;
+	u32 size, alloc;
+} GF_RTSPFanoutSlot;
+
+typedef struct __rtspout_fanout_ring
+{
+	GF_RTSPOutSession *chan;
+	GF_RTSPFanoutSlot *slots;
+	u32 nb_slots;
+	/*number of packets written to the ring and sent to clients since start*/
+	u64 write_idx, flush_idx;
+} GF_RTSPFanoutRing;
+
+typedef struct
+{
+	GF_RTPOutStream *stream;
+	GF_RTPChannel *ch;
+	u32 rtp_id, rtcp_id;
+	/*index of next packet to send in the stream ring*/
+	u64 read_idx;
+	/*client offsets applied to the shared packets*/
+	u16 seq_offset;
+	u32 ts_offset;
+	/*number of packets sent to the client, and BYE state*/
+	u32 nb_sent;
+	Bool bye_sent;
+} GF_RTSPFanoutDest;
+
+static void rtspout_send_event(GF_RTSPOutSession *sess, Bool send_stop, Bool send_play, Double start_range);
+
 
 static void rtspout_send_response(GF_RTSPOutCtx *ctx, GF_RTSPOutSession *sess)
 {
@@ -152,7 +196,12 @@ static void rtspout_send_response(GF_RTSPOutCtx *ctx, GF_RTSPOutSession *sess)
 
 static void rtspout_check_last_sess(GF_RTSPOutCtx *ctx)
 {
-	if (gf_list_count(ctx->sessions) ) return;
+	u32 i, count = gf_list_count(ctx->sessions);
+	//fan-out channels are kept until the end
+	for (i=0; i<count; i++) {
+		GF_RTSPOutSession *sess = gf_list_get(ctx->sessions, i);
+		if (!sess->fanout) return;
+	}
 
 	if (ctx->dst)
 		ctx->done = GF_TRUE;
@@ -172,6 +221,8 @@ static GF_Err rtspout_send_sdp(GF_RTSPOutSession *sess)
 	if (sess->mcast_mirror) {
 		ip = sess->mcast_mirror->multicast_ip;
  		e = rtpout_create_sdp(sess->mcast_mirror->streams, GF_FALSE, ip, sess->ctx->info, "livesession", sess->ctx->url, sess->ctx->email, sess->mcast_mirror->base_pid_id, &sdp_out, &sess->sdp_id);
+	} else if (sess->fanout_src) {
+ 		e = rtpout_create_sdp(sess->fanout_src->streams, GF_TRUE, ip, sess->ctx->info, "livesession", sess->ctx->url, sess->ctx->email, sess->fanout_src->base_pid_id, &sdp_out, &sess->sdp_id);
 	} else {
  		e = rtpout_create_sdp(sess->streams, GF_TRUE, ip, sess->ctx->info, "livesession", sess->ctx->url, sess->ctx->email, sess->base_pid_id, &sdp_out, &sess->sdp_id);
 	}
@@ -198,6 +249,175 @@ static GF_Err rtspout_send_sdp(GF_RTSPOutSession *sess)
 }
 
 
+static void rtspout_fanout_flush(GF_RTSPOutSession *chan)
+{
+	u32 i, j, count = gf_list_count(chan->fanout_clients);
+
+	for (i=0; i<count; i++) {
+		GF_RTSPOutSession *sess = gf_list_get(chan->fanout_clients, i);
+		if ((sess->play_state!=1) || sess->request_pending) continue;
+
+		//write data left over by a slow interleaved client, packets are dropped by the session if its queue is full
+		if (sess->interleave)
+			gf_rtsp_session_flush_interleave_queue(sess->rtsp);
+
+		for (j=0; j<gf_list_count(sess->fanout_dests); j++) {
+			GF_RTSPFanoutDest *dest = gf_list_get(sess->fanout_dests, j);
+			GF_RTSPFanoutRing *ring = dest->stream->fanout_ring;
+			if (!ring || !dest->ch) continue;
+
+			if (dest->read_idx + ring->nb_slots < ring->write_idx) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_RTP, ("[RTSP] Session %s: fan-out client late by "LLU" packets, dropping\n", sess->service_name, ring->write_idx - ring->nb_slots - dest->read_idx));
+				dest->read_idx = ring->write_idx - ring->nb_slots;
+			}
+			while (dest->read_idx < ring->write_idx) {
+				GF_Err e;
+				GF_RTPHeader hdr;
+				GF_RTSPFanoutSlot *slot = &ring->slots[dest->read_idx % ring->nb_slots];
+				dest->read_idx++;
+
+				//only rewrite sequence number and timestamp, SSRC is the one of the client channel
+				hdr = slot->hdr;
+				hdr.SequenceNumber += dest->seq_offset;
+				hdr.TimeStamp += dest->ts_offset;
+				//fast send writes the client header in the reserved bytes before the shared payload
+				e = gf_rtp_send_packet(dest->ch, &hdr, slot->data+12, slot->size, GF_TRUE);
+				if (e) {
+					GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[RTSP] Session %s: failed to send fan-out packet SN %u: %s\n", sess->service_name, hdr.SequenceNumber, gf_error_to_string(e) ));
+					continue;
+				}
+				dest->nb_sent++;
+				//send a first SR right away so that the client can map its timestamps, next ones are sent by the channel
+				if (dest->nb_sent==1) {
+					dest->ch->next_report_time = 0;
+					gf_rtp_send_rtcp_report(dest->ch);
+				}
+			}
+			//source stream is done and all its packets are sent
+			if (dest->stream->bye_sent && (dest->read_idx == ring->write_idx) && !dest->bye_sent) {
+				dest->bye_sent = GF_TRUE;
+				gf_rtp_send_bye(dest->ch);
+			}
+		}
+	}
+	count = gf_list_count(chan->streams);
+	for (i=0; i<count; i++) {
+		GF_RTPOutStream *stream = gf_list_get(chan->streams, i);
+		if (stream->fanout_ring)
+			stream->fanout_ring->flush_idx = stream->fanout_ring->write_idx;
+	}
+}
+
+static void rtspout_fanout_on_packet(void *udta, GF_RTPHeader *header, u8 *payload, u32 payload_size)
+{
+	GF_RTSPFanoutSlot *slot;
+	GF_RTSPFanoutRing *ring = (GF_RTSPFanoutRing *)udta;
+
+	//ring is full, send pending packets before overwriting them
+	if (ring->write_idx - ring->flush_idx >= ring->nb_slots)
+		rtspout_fanout_flush(ring->chan);
+
+	slot = &ring->slots[ring->write_idx % ring->nb_slots];
+	if (slot->alloc < payload_size + 12) {
+		slot->alloc = payload_size + 12;
+		slot->data = gf_realloc(slot->data, slot->alloc);
+		if (!slot->data) {
+			slot->alloc = 0;
+			return;
+		}
+	}
+	memcpy(slot->data + 12, payload, payload_size);
+	slot->size = payload_size;
+	slot->hdr = *header;
+	ring->write_idx++;
+}
+
+static GF_Err rtspout_fanout_setup_ring(GF_RTSPOutSession *chan, GF_RTPOutStream *stream, u32 nb_slots)
+{
+	GF_RTSPFanoutRing *ring = stream->fanout_ring;
+	if (!ring) {
+		GF_SAFEALLOC(ring, GF_RTSPFanoutRing);
+		if (!ring) return GF_OUT_OF_MEM;
+		ring->slots = gf_malloc(sizeof(GF_RTSPFanoutSlot) * nb_slots);
+		if (!ring->slots) {
+			gf_free(ring);
+			return GF_OUT_OF_MEM;
+		}
+		memset(ring->slots, 0, sizeof(GF_RTSPFanoutSlot) * nb_slots);
+		ring->nb_slots = nb_slots;
+		ring->chan = chan;
+		stream->fanout_ring = ring;
+	}
+	return gf_rtp_streamer_set_packet_callback(stream->rtp, rtspout_fanout_on_packet, ring);
+}
+
+static void rtspout_fanout_del_ring(GF_RTSPFanoutRing *ring)
+{
+	u32 i;
+	for (i=0; i<ring->nb_slots; i++) {
+		if (ring->slots[i].data) gf_free(ring->slots[i].data);
+	}
+	gf_free(ring->slots);
+	gf_free(ring);
+}
+
+static GF_RTSPFanoutDest *rtspout_fanout_get_dest(GF_RTSPOutSession *sess, GF_RTPOutStream *stream)
+{
+	u32 i, count = gf_list_count(sess->fanout_dests);
+	for (i=0; i<count; i++) {
+		GF_RTSPFanoutDest *dest = gf_list_get(sess->fanout_dests, i);
+		if (dest->stream == stream) return dest;
+	}
+	return NULL;
+}
+
+static void rtspout_fanout_stop(GF_RTSPOutSession *chan)
+{
+	u32 i, count;
+	if (!chan->play_state) return;
+
+	rtspout_send_event(chan, GF_TRUE, GF_FALSE, 0);
+	chan->play_state = 0;
+	chan->sys_clock_at_init = 0;
+	chan->active_stream = NULL;
+	chan->first_RTCP_sent = GF_FALSE;
+	chan->wait_for_loop = GF_FALSE;
+	count = gf_list_count(chan->streams);
+	for (i=0; i<count; i++) {
+		GF_RTPOutStream *stream = gf_list_get(chan->streams, i);
+		if (stream->pck) {
+			gf_filter_pid_drop_packet(stream->pid);
+			stream->pck = NULL;
+		}
+		stream->ts_offset = 0;
+		stream->microsec_ts_offset = 0;
+		stream->min_dts = GF_FILTER_NO_TS;
+		stream->bye_sent = GF_FALSE;
+	}
+}
+
+static void rtspout_fanout_detach(GF_RTSPOutSession *sess)
+{
+	GF_RTSPOutSession *chan = sess->fanout_src;
+
+	while (gf_list_count(sess->fanout_dests)) {
+		GF_RTSPFanoutDest *dest = gf_list_pop_back(sess->fanout_dests);
+		if (dest->ch) {
+			if (dest->nb_sent && !dest->bye_sent)
+				gf_rtp_send_bye(dest->ch);
+			gf_rtp_del(dest->ch);
+		}
+		gf_free(dest);
+	}
+	sess->fanout_src = NULL;
+	if (!chan) return;
+
+	gf_list_del_item(chan->fanout_clients, sess);
+	//last client gone, stop the channel until a new client plays it
+	if (!gf_list_count(chan->fanout_clients))
+		rtspout_fanout_stop(chan);
+}
+
 static void rtspout_del_stream(GF_RTPOutStream *st)
 {
 	if (st->rtp) gf_rtp_streamer_del(st->rtp);
@@ -206,11 +426,32 @@ static void rtspout_del_stream(GF_RTPOutStream *st)
 		gf_odf_avc_cfg_del(st->avcc);
 	if (st->hvcc)
 		gf_odf_hevc_cfg_del(st->hvcc);
+	if (st->fanout_ring)
+		rtspout_fanout_del_ring(st->fanout_ring);
 	gf_free(st);
 }
 
 static void rtspout_del_session(GF_RTSPOutSession *sess)
 {
+	if (sess->fanout_src)
+		rtspout_fanout_detach(sess);
+	gf_list_del(sess->fanout_dests);
+
+	//fan-out channel, detach all clients and fail pending describes
+	while (gf_list_count(sess->fanout_clients)) {
+		GF_RTSPOutSession *client = gf_list_pop_back(sess->fanout_clients);
+		client->fanout_src = NULL;
+		if (client->rtsp && (client->sdp_state==SDP_WAIT)) {
+			client->sdp_state = SDP_LOADED;
+			client->request_pending = GF_FALSE;
+			gf_rtsp_response_reset(client->response);
+			client->response->ResponseCode = NC_RTSP_Internal_Server_Error;
+			client->response->CSeq = client->command->CSeq;
+			rtspout_send_response(client->ctx, client);
+		}
+	}
+	gf_list_del(sess->fanout_clients);
+
 	//server mode, cleanup
 	while (gf_list_count(sess->streams)) {
 		GF_RTPOutStream *stream = gf_list_pop_back(sess->streams);
@@ -319,6 +560,11 @@ static GF_Err rtspout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool i
 	e = rtpout_init_streamer(stream, ctx->ifce ? ctx->ifce : "127.0.0.1", ctx->xps, ctx->mpeg4, ctx->latm, payt, ctx->mtu, ctx->ttl, ctx->ifce, GF_TRUE, &sess->base_pid_id, 0);
 	if (e) return e;
 
+	if (sess->fanout) {
+		e = rtspout_fanout_setup_ring(sess, stream, ctx->fanring);
+		if (e) return e;
+	}
+
 	if (ctx->loop) {
 		p = gf_filter_pid_get_property(pid, GF_PROP_PID_PLAYBACK_MODE);
 		if (!p || (p->value.uint<GF_PLAYBACK_MODE_SEEK)) {
@@ -376,6 +622,7 @@ static GF_Err rtspout_initialize(GF_Filter *filter)
 	if (!ctx->mtu) ctx->mtu = 1450;
 	if (ctx->payt<96) ctx->payt = 96;
 	if (ctx->payt>127) ctx->payt = 127;
+	if (!ctx->fanring) ctx->fanring = 256;
 	ctx->sessions = gf_list_new();
 
 	port = ctx->port;
@@ -493,6 +740,9 @@ static Bool rtspout_init_clock(GF_RTSPOutCtx *ctx, GF_RTSPOutSession *sess)
 			GF_LOG(GF_LOG_INFO, GF_LOG_RTP, ("[RTSPOut] Session %s: RTP stream %d initial RTP TS set to %d\n", sess->service_name, i+1, stream->rtp_ts_offset));
 		}
 	}
+	//fan-out channel, PLAY responses are sent by each client session
+	if (sess->fanout)
+		return GF_TRUE;
 
 
 	gf_rtsp_response_reset(sess->response);
@@ -552,11 +802,85 @@ static void rtspout_send_event(GF_RTSPOutSession *sess, Bool send_stop, Bool sen
 	}
 }
 
+static void rtspout_fanout_start_client(GF_RTSPOutCtx *ctx, GF_RTSPOutSession *sess)
+{
+	u32 i, count;
+	GF_RTSPOutSession *chan = sess->fanout_src;
+
+	if (!chan) {
+		gf_rtsp_response_reset(sess->response);
+		sess->response->CSeq = sess->last_cseq;
+		sess->response->ResponseCode = NC_RTSP_Internal_Server_Error;
+		rtspout_send_response(ctx, sess);
+		sess->request_pending = GF_FALSE;
+		sess->play_state = 0;
+		return;
+	}
+
+	count = gf_list_count(sess->fanout_dests);
+	//live join, start at the next packet produced by the channel
+	if (!sess->fanout_join) {
+		for (i=0; i<count; i++) {
+			GF_RTSPFanoutDest *dest = gf_list_get(sess->fanout_dests, i);
+			if (!dest->stream->fanout_ring) continue;
+			dest->read_idx = dest->stream->fanout_ring->write_idx;
+			dest->seq_offset = (u16) gf_rand();
+			dest->ts_offset = gf_rand();
+			dest->nb_sent = 0;
+			dest->bye_sent = GF_FALSE;
+		}
+		sess->fanout_join = GF_TRUE;
+	}
+	//wait for the first packet of each stream, used for RTP-Info
+	for (i=0; i<count; i++) {
+		GF_RTSPFanoutDest *dest = gf_list_get(sess->fanout_dests, i);
+		GF_RTSPFanoutRing *ring = dest->stream->fanout_ring;
+		if (!ring) continue;
+		if (ring->write_idx == dest->read_idx) return;
+		if (ring->write_idx - dest->read_idx > ring->nb_slots) {
+			dest->read_idx = ring->write_idx;
+			return;
+		}
+	}
+
+	gf_rtsp_response_reset(sess->response);
+	sess->response->CSeq = sess->last_cseq;
+	sess->response->ResponseCode = NC_RTSP_OK;
+	for (i=0; i<count; i++) {
+		GF_RTPInfo *rtpi;
+		GF_RTSPFanoutDest *dest = gf_list_get(sess->fanout_dests, i);
+		GF_RTSPFanoutRing *ring = dest->stream->fanout_ring;
+		if (!ring) continue;
+
+		GF_SAFEALLOC(rtpi, GF_RTPInfo);
+		if (rtpi) {
+			GF_RTPHeader *hdr = &ring->slots[dest->read_idx % ring->nb_slots].hdr;
+			rtpi->url = gf_malloc(sizeof(char) * (strlen(sess->service_name)+50));
+			sprintf(rtpi->url, "%s/trackID=%d", sess->service_name, dest->stream->ctrl_id);
+			rtpi->seq = (u16) (hdr->SequenceNumber + dest->seq_offset);
+			rtpi->rtp_time = hdr->TimeStamp + dest->ts_offset;
+
+			gf_list_add(sess->response->RTP_Infos, rtpi);
+		}
+	}
+	rtspout_send_response(ctx, sess);
+	sess->request_pending = GF_FALSE;
+	sess->fanout_join = GF_FALSE;
+	GF_LOG(GF_LOG_INFO, GF_LOG_RTP, ("[RTSPOut] Session %s: client %s joined fan-out channel, %d clients\n", sess->service_name, sess->peer_address, gf_list_count(chan->fanout_clients) ));
+}
+
 static GF_Err rtspout_process_rtp(GF_Filter *filter, GF_RTSPOutCtx *ctx, GF_RTSPOutSession *sess)
 {
 	GF_Err e = GF_OK;
 	u32 repost_delay_us=0;
 
+	//fan-out client, packets are sent when processing the channel
+	if (sess->fanout_dests) {
+		if (sess->request_pending)
+			rtspout_fanout_start_client(ctx, sess);
+		return GF_OK;
+	}
+
 	/*init session timeline - all sessions are sync'ed for packet scheduling purposes*/
 	if (!sess->sys_clock_at_init) {
 		if (!rtspout_init_clock(ctx, sess)) return GF_OK;
@@ -579,6 +903,9 @@ static GF_Err rtspout_process_rtp(GF_Filter *filter, GF_RTSPOutCtx *ctx, GF_RTSP
 
 	e = rtpout_process_rtp(sess->streams, &sess->active_stream, sess->loop, ctx->delay, &sess->active_stream_idx, sess->sys_clock_at_init, &sess->active_min_ts_microsec, sess->microsec_ts_init, &sess->wait_for_loop, &repost_delay_us, &sess->first_RTCP_sent, sess->base_pid_id);
 
+	if (sess->fanout)
+		rtspout_fanout_flush(sess);
+
 	if (e) return e;
 	if (ctx->next_wake_us > repost_delay_us)
 		ctx->next_wake_us = (u32) repost_delay_us;
@@ -594,6 +921,15 @@ static GF_Err rtspout_interleave_packet(void *cbk1, void *cbk2, Bool is_rtcp, u8
 	return gf_rtsp_session_write_interleaved(sess->rtsp, idx, pck, pck_size);
 }
 
+static GF_Err rtspout_fanout_interleave_packet(void *cbk1, void *cbk2, Bool is_rtcp, u8 *pck, u32 pck_size)
+{
+	GF_RTSPOutSession *sess = (GF_RTSPOutSession *)cbk1;
+	GF_RTSPFanoutDest *dest = (GF_RTSPFanoutDest *)cbk2;
+
+	if (!sess->rtsp) return GF_IP_CONNECTION_CLOSED;
+	return gf_rtsp_session_write_interleaved(sess->rtsp, is_rtcp ? dest->rtcp_id : dest->rtp_id, pck, pck_size);
+}
+
 void rtspout_on_filter_setup_error(GF_Filter *f, void *on_setup_error_udta, GF_Err e)
 {
 	GF_RTSPOutSession *sess = (GF_RTSPOutSession *)on_setup_error_udta;
@@ -601,7 +937,7 @@ void rtspout_on_filter_setup_error(GF_Filter *f, void *on_setup_error_udta, GF_E
 	gf_list_del_item(sess->filter_srcs, f);
 	if (gf_list_count(sess->filter_srcs)) return;
 
-	if (sess->sdp_state != SDP_LOADED) {
+	if (!sess->fanout && (sess->sdp_state != SDP_LOADED)) {
 		sess->sdp_state = SDP_LOADED;
 		gf_rtsp_response_reset(sess->response);
 		sess->response->ResponseCode = NC_RTSP_Internal_Server_Error;
@@ -673,7 +1009,8 @@ static GF_Err rtspout_check_sdp(GF_Filter *filter, GF_RTSPOutSession *sess)
 	//all streams should be ready - note that we don't know handle dynamic pid insertion in source service yet
 	sess->sdp_state = SDP_LOADED;
 	sess->request_pending = GF_FALSE;
-	rtspout_send_sdp(sess);
+	if (!sess->fanout)
+		rtspout_send_sdp(sess);
 	return GF_OK;
 }
 
@@ -734,6 +1071,84 @@ static char *rtspout_get_local_res_path(GF_RTSPOutCtx *ctx, char *res_path)
 	return src_url;
 }
 
+static GF_Err rtspout_fanout_attach(GF_Filter *filter, GF_RTSPOutCtx *ctx, GF_RTSPOutSession *sess, char *res_path)
+{
+	GF_RTSPOutSession *chan = NULL;
+	u32 i, count = gf_list_count(ctx->sessions);
+	for (i=0; i<count; i++) {
+		GF_RTSPOutSession *a_sess = gf_list_get(ctx->sessions, i);
+		if (a_sess->fanout && !strcmp(a_sess->service_name, res_path)) {
+			chan = a_sess;
+			break;
+		}
+	}
+
+	if (!chan) {
+		GF_Err e;
+		GF_Filter *filter_src;
+		char *src_url = rtspout_get_local_res_path(ctx, res_path);
+		if (!src_url) return GF_URL_ERROR;
+
+		GF_SAFEALLOC(chan, GF_RTSPOutSession);
+		if (!chan) {
+			gf_free(src_url);
+			return GF_OUT_OF_MEM;
+		}
+		chan->ctx = ctx;
+		chan->fanout = GF_TRUE;
+		chan->streams = gf_list_new();
+		chan->filter_srcs = gf_list_new();
+		chan->fanout_clients = gf_list_new();
+		chan->service_name = gf_strdup(res_path);
+
+		filter_src = gf_filter_connect_source(filter, src_url, NULL, GF_FALSE, &e);
+		gf_free(src_url);
+		if (!filter_src) {
+			gf_list_add(ctx->sessions, chan);
+			rtspout_del_session(chan);
+			return e;
+		}
+		gf_list_add(chan->filter_srcs, filter_src);
+		gf_filter_set_setup_failure_callback(filter, filter_src, rtspout_on_filter_setup_error, chan);
+		chan->sdp_state = SDP_WAIT;
+		gf_list_add(ctx->sessions, chan);
+		GF_LOG(GF_LOG_INFO, GF_LOG_RTP, ("[RTSPOut] Created fan-out channel for %s\n", res_path));
+	}
+	if (!sess->fanout_dests)
+		sess->fanout_dests = gf_list_new();
+	sess->fanout_src = chan;
+	gf_list_add(chan->fanout_clients, sess);
+	return GF_OK;
+}
+
+static GF_Err rtspout_fanout_setup(GF_RTSPOutCtx *ctx, GF_RTSPOutSession *sess, GF_RTPOutStream *stream, GF_RTSPTransport *transport)
+{
+	GF_Err e;
+	GF_RTSPFanoutDest *dest = rtspout_fanout_get_dest(sess, stream);
+	if (!dest) {
+		GF_SAFEALLOC(dest, GF_RTSPFanoutDest);
+		if (!dest) return GF_OUT_OF_MEM;
+		dest->stream = stream;
+		gf_list_add(sess->fanout_dests, dest);
+	}
+	if (!dest->ch) dest->ch = gf_rtp_new();
+
+	e = gf_rtp_setup_transport(dest->ch, transport, transport->destination);
+	if (!e) e = gf_rtp_initialize(dest->ch, 0, GF_TRUE, ctx->mtu, 0, 0, ctx->ifce);
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTSPOut] Cannot setup fan-out RTP channel: %s\n", gf_error_to_string(e) ));
+		return e;
+	}
+	if (sess->interleave) {
+		dest->rtp_id = transport->rtpID;
+		dest->rtcp_id = transport->rtcpID;
+		gf_rtp_set_interleave_callbacks(dest->ch, rtspout_fanout_interleave_packet, sess, dest);
+		//never block the shared channel on a slow TCP client, queue up to one ring of packets then drop
+		gf_rtsp_session_set_interleave_queue(sess->rtsp, ctx->fanring * (ctx->mtu+4));
+	}
+	return GF_OK;
+}
+
 static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx *ctx, GF_RTSPOutSession **sess_ptr)
 {
 	GF_Err e;
@@ -741,10 +1156,23 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 	char *ctrl=NULL;
 	u32 stream_ctrl_id=0;
 
+	//fan-out channel, only wait for the streams to be ready
+	if (sess->fanout) {
+		if (sess->sdp_state==SDP_WAIT)
+			return rtspout_check_sdp(filter, sess);
+		return GF_OK;
+	}
+
 	//no rtsp connection on this session
 	if (!sess->rtsp) return GF_OK;
 
 	if (sess->sdp_state==SDP_WAIT) {
+		if (sess->fanout_src) {
+			if (sess->fanout_src->sdp_state != SDP_LOADED) return GF_OK;
+			sess->sdp_state = SDP_LOADED;
+			sess->request_pending = GF_FALSE;
+			return rtspout_send_sdp(sess);
+		}
 		return rtspout_check_sdp(filter, sess);
 	}
 
@@ -772,7 +1200,7 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 		for (i=0; i<count; i++) {
 			Bool swap_sess = GF_FALSE;
 			GF_RTSPOutSession *a_sess = gf_list_get(ctx->sessions, i);
-			if (a_sess->rtsp) continue;
+			if (a_sess->rtsp || a_sess->fanout) continue;
 
 			if (a_sess->sessionID && sess->command->Session && !strcmp(a_sess->sessionID, sess->command->Session) ) {
 				swap_sess = GF_TRUE;
@@ -853,6 +1281,15 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 
 		if (!res_path) {
 			rsp_code = NC_RTSP_Not_Found;
+		} else if (ctx->fanout && !ctx->dst && (res_path[0] != '?') && (res_path[0] != '@')) {
+			//live fan-out, attach to the channel of this resource
+			if (!sess->fanout_src) {
+				e = rtspout_fanout_attach(filter, ctx, sess, res_path);
+				if (e==GF_URL_ERROR) rsp_code = NC_RTSP_Not_Found;
+				else if (e) rsp_code = NC_RTSP_Service_Unavailable;
+			}
+			if (rsp_code == NC_RTSP_OK)
+				sess->sdp_state = (sess->fanout_src->sdp_state==SDP_LOADED) ? SDP_LOADED : SDP_WAIT;
 		} else if (ctx->dst) {
 			if (sess->server_path) {
 				char *sepp = strstr(sess->server_path, "://");
@@ -982,6 +1419,7 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 		u32 rsp_code=NC_RTSP_OK;
 		Bool enable_multicast = GF_FALSE;
 		Bool reset_transport_dest = GF_FALSE;
+		GF_List *streams = sess->fanout_src ? sess->fanout_src->streams : sess->streams;
 
 		if (!ctrl || !transport) {
 			rsp_code = NC_RTSP_Bad_Request;
@@ -990,9 +1428,9 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 		} else if (sess->sessionID && !sess->command->Session) {
 			rsp_code = NC_RTSP_Not_Implemented;
 		} else {
-			u32 i, count = gf_list_count(sess->streams);
+			u32 i, count = gf_list_count(streams);
 			for (i=0; i<count; i++) {
-				stream = gf_list_get(sess->streams, i);
+				stream = gf_list_get(streams, i);
 				if (stream_ctrl_id==stream->ctrl_id)
 					break;
 				stream=NULL;
@@ -1015,7 +1453,7 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 		stream->selected = GF_TRUE;
 		if (transport && (rsp_code==NC_RTSP_OK) ) {
 			if (!transport->IsInterleaved) {
-				u32 st_idx = gf_list_find(sess->streams, stream);
+				u32 st_idx = gf_list_find(streams, stream);
 				transport->port_first = ctx->firstport + 2 * st_idx;
 				transport->port_last = transport->port_first + 1;
 				if (sess->interleave)
@@ -1049,6 +1487,9 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 			else {
 				if (transport->destination && !gf_sk_is_multicast_address(transport->destination)) {
 					rsp_code = NC_RTSP_Bad_Request;
+				} else if (sess->fanout_src) {
+					GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[RTSP] SETUP requests a multicast on a fan-out session, not allowed\n"));
+					rsp_code = NC_RTSP_Unsupported_Transport;
 				} else {
 					if (ctx->mcast != MCAST_OFF) {
 						enable_multicast = GF_TRUE;
@@ -1078,7 +1519,10 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 		if (rsp_code != NC_RTSP_OK) {
 			sess->response->ResponseCode = rsp_code;
 		} else {
-			e = gf_rtp_streamer_init_rtsp(stream->rtp, ctx->mtu, transport, ctx->ifce);
+			if (sess->fanout_src)
+				e = rtspout_fanout_setup(ctx, sess, stream, transport);
+			else
+				e = gf_rtp_streamer_init_rtsp(stream->rtp, ctx->mtu, transport, ctx->ifce);
 			if (e) {
 				sess->response->ResponseCode = NC_RTSP_Internal_Server_Error;
 			} else {
@@ -1098,7 +1542,7 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 		}
 
 
-		if (sess->interleave) {
+		if (sess->interleave && !sess->fanout_src) {
 			stream->rtp_id = transport->rtpID;
 			stream->rtcp_id = transport->rtcpID;
 			gf_rtp_streamer_set_interleave_callbacks(stream->rtp, rtspout_interleave_packet, sess, stream);
@@ -1136,6 +1580,20 @@ static GF_Err rtspout_process_session_signaling(GF_Filter *filter, GF_RTSPOutCtx
 			sess->response->CSeq = sess->command->CSeq;
 			rtspout_send_response(ctx, sess);
 			return GF_OK;
+		} else if (sess->fanout_dests) {
+			GF_RTSPOutSession *chan = sess->fanout_src;
+			//live fan-out, ranges are ignored and the response is sent once the channel is running
+			sess->play_state = 1;
+			sess->last_cseq = sess->command->CSeq;
+			sess->request_pending = GF_TRUE;
+			if (chan) {
+				if (!chan->play_state) {
+					chan->play_state = 1;
+					chan->sys_clock_at_init = 0;
+					chan->loop = (ctx->loop && !chan->loop_disabled) ? GF_TRUE : GF_FALSE;
+				}
+				rtspout_send_event(chan, GF_FALSE, GF_TRUE, 0);
+			}
 		} else {
 			//loop enabled, only if multicast session or single session mode
 			if (ctx->loop && !sess->loop_disabled && (sess->single_session || sess->multicast_ip))
@@ -1217,6 +1675,12 @@ static GF_Err rtspout_process(GF_Filter *filter)
 		GF_RTSPOutSession *sess = gf_list_get(ctx->sessions, i);
 		sess_err = rtspout_process_session_signaling(filter, ctx, &sess);
 		if (sess_err) e |= sess_err;
+		//session destroyed (teardown)
+		if (!sess) {
+			i--;
+			count--;
+			continue;
+		}
 
 		if (sess && sess->play_state) {
 			sess_err = rtspout_process_rtp(filter, ctx, sess);
@@ -1287,6 +1751,8 @@ static const GF_FilterArgs RTSPOutArgs[] =
 				"- on: clients can create multicast sessions\n"
 				"- mirror: clients can create a multicast session. Any later request to the same URL will use that multicast session"
 		, GF_PROP_UINT, "off", "off|on|mirror", GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(fanout), "in server mode, packetize each resource once and share the RTP packets between all clients of that resource - see filter help", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(fanring), "number of RTP packets in the shared ring of each stream in fan-out mode", GF_PROP_UINT, "256", NULL, GF_FS_ARG_HINT_EXPERT},
 
 	{0}
 };
@@ -1319,6 +1785,12 @@ GF_FilterRegister RTSPOutRegister = {
 		"When [-mcast]() is set to `mirror` mode, any DESCRIBE command on a resource already delivered through a multicast session will use that multicast.\n"\
 		"Consequently, only DESCRIBE methods are processed for such sessions, other methods will return Unauthorized.\n"\
 		"\n"\
+		"In server mode, the [-fanout]() option turns each mounted resource into a live channel shared by all its clients.\n"\
+		"The resource is loaded and packetized once when the first client requests it, and RTP packets are stored in a ring of [-fanring]() packets per stream.\n"\
+		"Each client only rewrites the SSRC, sequence number and timestamp of these packets when sending them, either over UDP or interleaved in RTSP.\n"\
+		"Clients joining a running channel start at the current position, PLAY ranges are ignored and multicast setup is not allowed.\n"\
+		"The channel is stopped when its last client leaves and restarted by the next client.\n"\
+		"\n"\
 		"The scheduling algorithm and RTP options are the same as the RTP output filter, see [gpac -h rtpout](rtpout)\n"\
 	)
 	.private_size = sizeof(GF_RTSPOutCtx),
@@ -28,6 +28,22 @@
 #include <gpac/constants.h>
 #include <gpac/network.h>
 
+//max number of datagrams sent per process call
+#define SOCKOUT_MAX_BATCH	64
+//max duration in us of datagrams queued in the pacer
+#define SOCKOUT_PACER_MAX_DELAY	50000
+//max lateness in us of PCR-paced datagrams before resyncing the PCR clock
+#define SOCKOUT_PCR_MAX_LATE	100000
+//max number of datagrams kept until the initial PCR rate is known
+#define SOCKOUT_PCR_INIT_MAX	1024
+
+enum
+{
+	SOCKOUT_PACER_OFF=0,
+	SOCKOUT_PACER_RATE,
+	SOCKOUT_PACER_PCR,
+};
+
 typedef struct
 {
 	GF_Socket *socket;
@@ -42,7 +58,7 @@ typedef struct
 	Double start, speed;
 	char *dst, *mime, *ext, *ifce;
 	Bool listen;
-	u32 maxc, port, sockbuf, ka, kp, rate;
+	u32 maxc, port, sockbuf, ka, kp, rate, pacer, spin;
 	GF_Fraction pckr, pckd;
 
 	GF_Socket *socket;
@@ -66,6 +82,26 @@ typedef struct
 	GF_FilterPacket *rev_pck;
 	u32 next_pckd_idx, next_pckr_idx;
 	u32 nb_pckd_wnd, nb_pckr_wnd;
+
+	//datagram output: queued packets are sent with a single call
+	Bool dgram_batch;
+
+	//paced datagram output
+	GF_SockPacer *sk_pacer;
+	//PCR pacing state: PCR PID, PCR and send time of clock origin and of last PCR, byte position of last PCR
+	u32 pcr_pid;
+	Bool pcr_init;
+	u64 pcr_origin, pcr_origin_time;
+	u64 last_pcr, last_pcr_time, last_pcr_pos;
+	//byte position of next datagram, send time of last datagram, rate measured between last two PCRs
+	u64 byte_pos, last_send_time;
+	u32 pcr_rate;
+	//datagrams kept until the second PCR
+	Bool init_done, init_pcr_found;
+	u64 init_pcr, init_pcr_pos;
+	u8 *init_buf;
+	u32 init_buf_size, init_buf_alloc, nb_init;
+	u32 init_sizes[SOCKOUT_PCR_INIT_MAX];
 } GF_SockOutCtx;
 
 
@@ -158,6 +194,10 @@ static GF_Err sockout_initialize(GF_Filter *filter)
 	}
 	gf_filter_override_caps(filter, ctx->in_caps, 2);
 
+	//paced output, ask the deadline scheduler to run us within 1 ms of the next send time
+	if (ctx->rate && !ctx->pacer)
+		gf_filter_set_latency_budget(filter, 1000);
+
 	/*create our ourput socket*/
 
 	if (!strnicmp(ctx->dst, "udp://", 6)) {
@@ -227,6 +267,30 @@ static GF_Err sockout_initialize(GF_Filter *filter)
 
 	gf_sk_set_buffer_size(ctx->socket, 0, ctx->sockbuf);
 
+	//packet drop/revert tests need per-packet sends
+	if (!ctx->listen && !ctx->pckd.den && !ctx->pckr.den
+		&& ((sock_type == GF_SOCK_TYPE_UDP)
+#ifdef GPAC_HAS_SOCK_UN
+		|| (sock_type == GF_SOCK_TYPE_UDP_UN)
+#endif
+	)) {
+		ctx->dgram_batch = GF_TRUE;
+		gf_sk_enable_gso(ctx->socket, GF_TRUE);
+	}
+
+	if ((ctx->pacer==SOCKOUT_PACER_RATE) && !ctx->rate) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[SockOut] Rate pacing requested but no rate set, disabling pacer\n"));
+		ctx->pacer = SOCKOUT_PACER_OFF;
+	}
+	if (ctx->pacer && !ctx->dgram_batch) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[SockOut] Pacer only available for UDP output without packet drop/revert, disabling pacer\n"));
+		ctx->pacer = SOCKOUT_PACER_OFF;
+	}
+	if (ctx->pacer) {
+		//in PCR mode, the rate is only used for datagrams before the first PCR
+		ctx->sk_pacer = gf_sk_pacer_new(ctx->rate, ctx->spin);
+		if (!ctx->sk_pacer) return GF_OUT_OF_MEM;
+	}
 	return GF_OK;
 }
 
@@ -241,6 +305,9 @@ static void sockout_finalize(GF_Filter *filter)
 		}
 		gf_list_del(ctx->clients);
 	}
+	//flushes pending datagrams, must be done before destroying the socket
+	if (ctx->sk_pacer) gf_sk_pacer_del(ctx->sk_pacer);
+	if (ctx->init_buf) gf_free(ctx->init_buf);
 
 	if (ctx->socket) gf_sk_del(ctx->socket);
 }
@@ -311,6 +378,263 @@ static GF_Err sockout_send_packet(GF_SockOutCtx *ctx, GF_FilterPacket *pck, GF_S
 	return GF_OK;
 }
 
+//get first PCR in TS datagram, on the first PID carrying a PCR
+static Bool sockout_get_pcr(GF_SockOutCtx *ctx, const u8 *data, u32 size, u64 *pcr, u32 *pcr_offset, Bool *is_disc)
+{
+	u32 i;
+	for (i=0; i+188<=size; i+=188) {
+		u32 pid;
+		const u8 *ts = data+i;
+		if (ts[0] != 0x47) return GF_FALSE;
+		//no adaptation field or adaptation field too short for a PCR
+		if (!(ts[3] & 0x20) || (ts[4] < 7)) continue;
+		if (!(ts[5] & 0x10)) continue;
+		pid = ((ts[1] & 0x1f) << 8) | ts[2];
+		if (!ctx->pcr_pid) ctx->pcr_pid = pid;
+		else if (ctx->pcr_pid != pid) continue;
+
+		*pcr = ((u64)ts[6] << 25) | ((u64)ts[7] << 17) | ((u64)ts[8] << 9) | ((u64)ts[9] << 1) | ((u64)ts[10] >> 7);
+		*pcr = *pcr * 300 + (((ts[10] & 1) << 8) | ts[11]);
+		*pcr_offset = i;
+		*is_disc = (ts[5] & 0x80) ? GF_TRUE : GF_FALSE;
+		return GF_TRUE;
+	}
+	return GF_FALSE;
+}
+
+//compute send time of a TS datagram from its PCR, or by extrapolating from the last PCR
+static u64 sockout_get_pcr_time(GF_SockOutCtx *ctx, const u8 *data, u32 size, u64 now)
+{
+	u64 pcr, time;
+	u32 pcr_offset;
+	Bool is_disc;
+
+	if (sockout_get_pcr(ctx, data, size, &pcr, &pcr_offset, &is_disc)) {
+		u64 pcr_pos = ctx->byte_pos + pcr_offset;
+		//PCR discontinuity, wrap or jump of more than 1 sec: resync on the send time of the previous datagram
+		if (ctx->pcr_init && (is_disc || (pcr < ctx->last_pcr) || (pcr - ctx->last_pcr > 27000000))) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[SockOut] PCR discontinuity, resyncing pacer clock\n"));
+			ctx->pcr_init = GF_FALSE;
+		}
+		if (ctx->pcr_init) {
+			time = ctx->pcr_origin_time + (pcr - ctx->pcr_origin) / 27;
+			if (pcr > ctx->last_pcr)
+				ctx->pcr_rate = (u32) ((pcr_pos - ctx->last_pcr_pos) * 8 * 27000000 / (pcr - ctx->last_pcr));
+			//producer cannot keep up (or was paused), restart the clock
+			if (time + SOCKOUT_PCR_MAX_LATE < now) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[SockOut] PCR pacing late by "LLU" us, resyncing pacer clock\n", now - time));
+				ctx->pcr_init = GF_FALSE;
+			}
+		}
+		if (!ctx->pcr_init) {
+			ctx->pcr_init = GF_TRUE;
+			ctx->pcr_origin = pcr;
+			ctx->pcr_origin_time = MAX(now, ctx->last_send_time);
+			time = ctx->pcr_origin_time;
+		}
+		ctx->last_pcr = pcr;
+		ctx->last_pcr_time = time;
+		ctx->last_pcr_pos = pcr_pos;
+		//send time of datagram start
+		if (ctx->pcr_rate)
+			time -= ((u64) pcr_offset) * 8 * 1000000 / ctx->pcr_rate;
+	} else if (!ctx->pcr_init) {
+		//no PCR yet, use pacer rate
+		time = 0;
+	} else {
+		u32 rate = ctx->pcr_rate ? ctx->pcr_rate : ctx->rate;
+		time = ctx->last_pcr_time;
+		if (rate)
+			time += (ctx->byte_pos - ctx->last_pcr_pos) * 8 * 1000000 / rate;
+	}
+	ctx->byte_pos += size;
+	if (time) {
+		if (time < ctx->last_send_time) time = ctx->last_send_time;
+		ctx->last_send_time = time;
+	}
+	return time;
+}
+
+static GF_Err sockout_queue_paced(GF_SockOutCtx *ctx, const u8 *data, u32 size, u64 now)
+{
+	GF_Err e;
+	u64 time = 0;
+	if (ctx->pacer==SOCKOUT_PACER_PCR)
+		time = sockout_get_pcr_time(ctx, data, size, now);
+
+	e = gf_sk_pacer_send(ctx->sk_pacer, ctx->socket, data, size, time);
+	if (e) {
+		//queue full, undo PCR state update and retry later
+		if (ctx->pacer==SOCKOUT_PACER_PCR) ctx->byte_pos -= size;
+		if (e != GF_BUFFER_TOO_SMALL) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[SockOut] Failed to queue datagram: %s\n", gf_error_to_string(e) ));
+		}
+		return e;
+	}
+	ctx->nb_bytes_sent += size;
+	return GF_OK;
+}
+
+//queue datagrams kept until the initial PCR rate is known
+static void sockout_flush_pcr_init(GF_SockOutCtx *ctx)
+{
+	u32 i, pos=0;
+	u64 now = gf_sys_clock_high_res();
+	for (i=0; i<ctx->nb_init; i++) {
+		//pacer queue is larger than our init buffer
+		sockout_queue_paced(ctx, ctx->init_buf + pos, ctx->init_sizes[i], now);
+		pos += ctx->init_sizes[i];
+	}
+	ctx->nb_init = 0;
+	ctx->init_buf_size = 0;
+	ctx->init_done = GF_TRUE;
+}
+
+static GF_Err sockout_send_paced(GF_Filter *filter, GF_SockOutCtx *ctx, const u8 **bufs, u32 *sizes, u32 nb_pck)
+{
+	u32 i=0;
+	u64 now = gf_sys_clock_high_res();
+
+	//datagrams before the second PCR cannot be extrapolated, keep them until the rate can be measured
+	//between the first two PCRs
+	if ((ctx->pacer==SOCKOUT_PACER_PCR) && !ctx->init_done) {
+		for (i=0; i<nb_pck; i++) {
+			u64 pcr;
+			u32 pcr_offset;
+			Bool is_disc;
+			if (ctx->init_buf_size + sizes[i] > ctx->init_buf_alloc) {
+				ctx->init_buf_alloc = MAX(2 * ctx->init_buf_alloc, ctx->init_buf_size + sizes[i]);
+				ctx->init_buf = gf_realloc(ctx->init_buf, ctx->init_buf_alloc);
+				if (!ctx->init_buf) return GF_OUT_OF_MEM;
+			}
+			memcpy(ctx->init_buf + ctx->init_buf_size, bufs[i], sizes[i]);
+			if (sockout_get_pcr(ctx, bufs[i], sizes[i], &pcr, &pcr_offset, &is_disc)) {
+				if (!ctx->init_pcr_found) {
+					ctx->init_pcr_found = GF_TRUE;
+					ctx->init_pcr = pcr;
+					ctx->init_pcr_pos = ctx->init_buf_size + pcr_offset;
+				} else if (pcr > ctx->init_pcr) {
+					ctx->pcr_rate = (u32) ((ctx->init_buf_size + pcr_offset - ctx->init_pcr_pos) * 8 * 27000000 / (pcr - ctx->init_pcr));
+				}
+			}
+			ctx->init_buf_size += sizes[i];
+			ctx->init_sizes[ctx->nb_init] = sizes[i];
+			ctx->nb_init++;
+			if (ctx->pcr_rate || (ctx->nb_init == SOCKOUT_PCR_INIT_MAX)) {
+				i++;
+				sockout_flush_pcr_init(ctx);
+				break;
+			}
+		}
+		ctx->nb_pck_processed += i;
+		gf_filter_pid_drop_packets(ctx->pid, i);
+		bufs += i;
+		sizes += i;
+		nb_pck -= i;
+		i = 0;
+	}
+
+	for (i=0; i<nb_pck; i++) {
+		if (sockout_queue_paced(ctx, bufs[i], sizes[i], now))
+			break;
+	}
+	ctx->nb_pck_processed += i;
+	gf_filter_pid_drop_packets(ctx->pid, i);
+	if (i < nb_pck) {
+		gf_filter_ask_rt_reschedule(filter, 1000);
+	}
+	return GF_OK;
+}
+
+static GF_Err sockout_send_batch(GF_Filter *filter, GF_SockOutCtx *ctx)
+{
+	GF_Err e;
+	u32 i, nb_pck, nb_send, nb_sent=0;
+	GF_FilterPacket *pcks[SOCKOUT_MAX_BATCH];
+	const u8 *bufs[SOCKOUT_MAX_BATCH];
+	u32 sizes[SOCKOUT_MAX_BATCH];
+	u64 now = gf_sys_clock_high_res();
+
+	//enough datagrams queued in the pacer, wait before pushing more
+	if (ctx->sk_pacer) {
+		u64 delay = gf_sk_pacer_get_delay(ctx->sk_pacer);
+		if (delay > SOCKOUT_PACER_MAX_DELAY) {
+			gf_filter_ask_rt_reschedule(filter, (u32) (delay - SOCKOUT_PACER_MAX_DELAY/2) );
+			return GF_OK;
+		}
+	}
+
+	nb_pck = gf_filter_pid_get_packets(ctx->pid, pcks, SOCKOUT_MAX_BATCH);
+	if (!nb_pck) {
+		if (gf_filter_pid_is_eos(ctx->pid)) {
+			if (ctx->sk_pacer) {
+				if (ctx->nb_init) sockout_flush_pcr_init(ctx);
+				gf_sk_pacer_del(ctx->sk_pacer);
+				ctx->sk_pacer = NULL;
+			}
+			gf_sk_del(ctx->socket);
+			ctx->socket = NULL;
+			return GF_EOS;
+		}
+		return GF_OK;
+	}
+	for (i=0; i<nb_pck; i++) {
+		bufs[i] = gf_filter_pck_get_data(pcks[i], &sizes[i]);
+		if (bufs[i]) continue;
+		if (i) {
+			nb_pck = i;
+			break;
+		}
+		//frame interface, send line by line
+		sockout_send_packet(ctx, pcks[0], ctx->socket);
+		gf_filter_pid_drop_packet(ctx->pid);
+		ctx->nb_pck_processed++;
+		return GF_OK;
+	}
+
+	if (ctx->sk_pacer)
+		return sockout_send_paced(filter, ctx, bufs, sizes, nb_pck);
+
+	nb_send = nb_pck;
+	if (ctx->rate) {
+		u64 budget, bytes = ctx->nb_bytes_sent;
+		if (!ctx->start_time) ctx->start_time = now;
+		budget = ctx->rate * (now - ctx->start_time) / 8000000;
+		//send as many datagrams as allowed by the budget, the first one being sent as soon as we are on time
+		nb_send = 0;
+		while ((nb_send < nb_pck) && (bytes <= budget)) {
+			bytes += sizes[nb_send];
+			nb_send++;
+		}
+		if (!nb_send) {
+			u64 diff = ctx->nb_bytes_sent*8*1000000 / ctx->rate - (now - ctx->start_time);
+			gf_filter_ask_rt_reschedule(filter, (u32) MAX(diff, 1000) );
+			//next datagram is due when the rate allows it
+			gf_filter_set_deadline(filter, now + diff);
+			return GF_OK;
+		}
+		if (now > ctx->start_time)
+			fprintf(stderr, "[SockOut] Sending at "LLU" kbps                       \r", ctx->nb_bytes_sent*8*1000/(now - ctx->start_time));
+	}
+
+	e = gf_sk_send_batch(ctx->socket, bufs, sizes, nb_send, &nb_sent);
+	if (e && (e != GF_BUFFER_TOO_SMALL) && (e != GF_IP_SOCK_WOULD_BLOCK)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[SockOut] Write error: %s\n", gf_error_to_string(e) ));
+		nb_sent = nb_send;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[SockOut] Sent %d datagrams out of %d in one call\n", nb_sent, nb_pck));
+	for (i=0; i<nb_sent; i++) {
+		ctx->nb_bytes_sent += sizes[i];
+	}
+	ctx->nb_pck_processed += nb_sent;
+	gf_filter_pid_drop_packets(ctx->pid, nb_sent);
+
+	//socket buffer full or rate budget exhausted, retry remaining datagrams later
+	if (nb_sent < nb_pck)
+		gf_filter_ask_rt_reschedule(filter, 1000);
+	return GF_OK;
+}
+
 
 static GF_Err sockout_process(GF_Filter *filter)
 {
@@ -323,6 +647,10 @@ static GF_Err sockout_process(GF_Filter *filter)
 	if (!ctx->socket)
 		return GF_EOS;
 
+	//datagram output handles pacing on the gathered batch
+	if (ctx->dgram_batch && ctx->pid)
+		return sockout_send_batch(filter, ctx);
+
 	if (ctx->rate) {
 		if (!ctx->start_time) ctx->start_time = gf_sys_clock_high_res();
 		else {
@@ -330,6 +658,8 @@ static GF_Err sockout_process(GF_Filter *filter)
 			if (ctx->nb_bytes_sent*8*1000000 > ctx->rate * now) {
 				u64 diff = ctx->nb_bytes_sent*8*1000000 / ctx->rate - now;
 				gf_filter_ask_rt_reschedule(filter, (u32) MAX(diff, 1000) );
+				//next packet is due when the rate allows it
+				gf_filter_set_deadline(filter, ctx->start_time + now + diff);
 				return GF_OK;
 			} else {
 				fprintf(stderr, "[SockOut] Sending at "LLU" kbps                       \r", ctx->nb_bytes_sent*8*1000/now);
@@ -521,6 +851,11 @@ static const GF_FilterArgs SockOutArgs[] =
 	{ OFFS(start), "set playback start offset. Negative value means percent of media dur with -1 <=> dur", GF_PROP_DOUBLE, "0.0", NULL, 0},
 	{ OFFS(speed), "set playback speed. If speed is negative and start is 0, start is set to -1", GF_PROP_DOUBLE, "1.0", NULL, 0},
 	{ OFFS(rate), "set send rate in bps, disabled by default (as fast as possible)", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(pacer), "send datagrams from a dedicated pacing thread\n"
+	"- off: datagrams are sent from the filter, paced by the [-rate]() option if set\n"
+	"- rate: datagrams are sent at the [-rate]() bitrate\n"
+	"- pcr: datagrams are sent according to the PCR of the MPEG-2 TS they carry, extrapolated between PCRs using the measured rate", GF_PROP_UINT, "off", "off|rate|pcr", GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(spin), "busy-wait this many microseconds before each paced send instead of sleeping, for sub-100 us precision", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(pckr), "reverse packet every N - see filter help", GF_PROP_FRACTION, "0/0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(pckd), "drop packet every N - see filter help", GF_PROP_FRACTION, "0/0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
@@ -545,6 +880,9 @@ GF_FilterRegister SockOutRegister = {
 		"this can be adjusted though the [-kp]() option, however there is no realtime regulation of how fast packets are droped.\n"
 		"If your sources are not real time, consider adding a real-time scheduler in the chain (cf reframer filter), or set the send [-rate]() option.\n"
 		"\n"
+		"For UDP output, the send [-rate]() regulation is done by the filter scheduler and may produce bursts of datagrams. For constant bitrate output, the [-pacer]() option hands datagrams to a dedicated thread sending each of them at its own time, either at the given rate or following the PCR of the TS content.\n"
+		"EX gpac -i source.ts -o udp://234.0.0.1:1234/:pacer=pcr:spin=50\n"
+		"\n"
 		"- UDP sockets are used for destinations URLs formatted as `udp://NAME`\n"
 		"- TCP sockets are used for destinations URLs formatted as `tcp://NAME`\n"
 #ifdef GPAC_HAS_SOCK_UN
@@ -27,13 +27,24 @@
 #include <gpac/constants.h>
 #include <gpac/filters.h>
 #include <gpac/internal/compositor_dev.h>
+#include <gpac/internal/simd_dev.h>
 
 #ifndef GPAC_DISABLE_PLAYER
 
+enum
+{
+	RESAMPLE_MODE_MIX = 0,
+	RESAMPLE_MODE_FIR,
+};
+
+//max number of polyphase branches, above this the phase is rounded to the nearest branch
+#define RESAMPLE_MAX_PHASES	1024
+#define RESAMPLE_MAX_TAPS	512
+
 typedef struct
 {
 	//opts
-	u32 ch, sr, fmt;
+	u32 ch, sr, fmt, mode, taps;
 
 	//internal
 	GF_FilterPid *ipid, *opid;
@@ -52,6 +63,29 @@ typedef struct
 	u32 size, bytes_consumed;
 	Fixed speed;
 	GF_FilterPacket *in_pck;
+
+	//polyphase FIR resampler state
+	Bool use_fir, fir_flushed;
+	//number of filtered channels, input or output whichever is smaller
+	u32 fir_ch;
+	//resampling ratio L/M, L output samples for M input samples
+	u32 fir_l, fir_m;
+	u32 nb_phases, nb_taps, fir_pad;
+	//(nb_phases+1) branches of nb_taps coefficients
+	Float *coefs;
+	//planar history buffer of fir_ch channels, each of buf_stride samples
+	Float *buf;
+	u32 buf_len, buf_stride;
+	//position of first tap in history and fractional position in 1/fir_l units
+	u32 fir_pos, fir_frac;
+	//channel mixing matrix [out][in], applied before filtering if downmixing, after otherwise
+	Float matrix[GF_AUDIO_MIXER_MAX_CHANNELS][GF_AUDIO_MIXER_MAX_CHANNELS];
+	Bool mix_identity, mix_first;
+	Float *in_tmp, *flt_tmp, *mix_tmp;
+	u32 in_tmp_alloc, flt_tmp_alloc, mix_tmp_alloc;
+	u64 fir_nb_in, fir_nb_out, fir_cts_origin;
+	Bool fir_cts_init;
+	u64 fir_nb_samples, fir_time_us;
 } GF_ResampleCtx;
 
 
@@ -115,6 +149,610 @@ static Bool resample_get_channel_volume(void *callback, Fixed *vol)
 	return GF_FALSE;
 }
 
+static u32 resample_gcd(u32 a, u32 b)
+{
+	while (b) {
+		u32 t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+static Double resample_bessel_i0(Double x)
+{
+	u32 k;
+	Double sum = 1, term = 1, hx = x/2;
+	for (k=1; k<64; k++) {
+		term *= (hx/k) * (hx/k);
+		sum += term;
+		if (term < sum * 1e-12) break;
+	}
+	return sum;
+}
+
+static Bool resample_tmp_alloc(Float **buf, u32 *alloc, u32 size)
+{
+	if (*alloc >= size) return GF_TRUE;
+	*buf = gf_realloc(*buf, sizeof(Float) * size);
+	if (! *buf) {
+		*alloc = 0;
+		return GF_FALSE;
+	}
+	*alloc = size;
+	return GF_TRUE;
+}
+
+static GF_Err resample_fir_setup_filter(GF_ResampleCtx *ctx, u32 in_sr, u32 out_sr)
+{
+	u32 p, k, g;
+	Double fc, beta, i0_beta, half;
+
+	g = resample_gcd(in_sr, out_sr);
+	ctx->fir_l = out_sr / g;
+	ctx->fir_m = in_sr / g;
+
+	//no rate change, single unity tap
+	if (ctx->fir_l == ctx->fir_m) {
+		ctx->fir_l = ctx->fir_m = 1;
+		ctx->nb_phases = 1;
+		ctx->nb_taps = 1;
+		ctx->fir_pad = 0;
+		ctx->coefs = gf_realloc(ctx->coefs, sizeof(Float)*2);
+		if (!ctx->coefs) return GF_OUT_OF_MEM;
+		ctx->coefs[0] = ctx->coefs[1] = 1;
+		return GF_OK;
+	}
+
+	ctx->nb_phases = MIN(ctx->fir_l, RESAMPLE_MAX_PHASES);
+	//when downsampling, the filter is stretched by the decimation ratio to keep the same transition band relative to the output rate
+	ctx->nb_taps = MAX(ctx->taps, 8);
+	if (ctx->fir_m > ctx->fir_l)
+		ctx->nb_taps = (u32) ( ((u64) ctx->nb_taps * ctx->fir_m + ctx->fir_l - 1) / ctx->fir_l);
+	ctx->nb_taps = (ctx->nb_taps + 3) & ~3;
+	if (ctx->nb_taps > RESAMPLE_MAX_TAPS) ctx->nb_taps = RESAMPLE_MAX_TAPS;
+	ctx->fir_pad = ctx->nb_taps/2 - 1;
+
+	ctx->coefs = gf_realloc(ctx->coefs, sizeof(Float) * (ctx->nb_phases+1) * ctx->nb_taps);
+	if (!ctx->coefs) return GF_OUT_OF_MEM;
+
+	//cutoff in cycles per input sample, slightly below Nyquist of the lowest rate
+	fc = 0.5 * 0.91;
+	if (ctx->fir_m > ctx->fir_l) fc = fc * ctx->fir_l / ctx->fir_m;
+	//Kaiser window, about 80 dB stopband attenuation
+	beta = 8.0;
+	i0_beta = resample_bessel_i0(beta);
+	half = ctx->nb_taps / 2;
+
+	//one extra branch for the next integer position, so that rounding the phase up never needs a special case
+	for (p=0; p<=ctx->nb_phases; p++) {
+		Double sum = 0;
+		Float *c = ctx->coefs + p*ctx->nb_taps;
+		for (k=0; k<ctx->nb_taps; k++) {
+			Double v, w, r;
+			Double d = (Double) k - ctx->fir_pad - (Double) p / ctx->nb_phases;
+			v = 2*fc*d;
+			v = (v==0) ? 2*fc : 2*fc*sin(GF_PI*v) / (GF_PI*v);
+			r = d / half;
+			w = (r*r < 1) ? resample_bessel_i0(beta * sqrt(1 - r*r)) / i0_beta : 0;
+			c[k] = (Float) (v * w);
+			sum += c[k];
+		}
+		//unity gain at DC for each branch
+		for (k=0; k<ctx->nb_taps; k++) c[k] = (Float) (c[k] / sum);
+	}
+	return GF_OK;
+}
+
+static u32 resample_ch_idx(u64 layout, u64 ch)
+{
+	u32 idx = 0;
+	u64 mask = 1;
+	if (!(layout & ch)) return GF_AUDIO_MIXER_MAX_CHANNELS;
+	while (mask != ch) {
+		if (layout & mask) idx++;
+		mask <<= 1;
+	}
+	return idx;
+}
+
+static u32 resample_nb_bits(u64 layout)
+{
+	u32 nb = 0;
+	while (layout) {
+		if (layout & 1) nb++;
+		layout >>= 1;
+	}
+	return nb;
+}
+
+#define RESAMPLE_CH_LEFT	(GF_AUDIO_CH_SURROUND_LEFT|GF_AUDIO_CH_FRONT_CENTER_LEFT|GF_AUDIO_CH_REAR_SURROUND_LEFT|GF_AUDIO_CH_SURROUND_DIRECT_LEFT|GF_AUDIO_CH_SIDE_SURROUND_LEFT|GF_AUDIO_CH_WIDE_FRONT_LEFT|GF_AUDIO_CH_FRONT_TOP_LEFT|GF_AUDIO_CH_SURROUND_TOP_LEFT|GF_AUDIO_CH_SIDE_SURROUND_TOP_LEFT|GF_AUDIO_CH_FRONT_BOTTOM_LEFT|GF_AUDIO_CH_SURROUND_BOTTOM_LEFT|GF_AUDIO_CH_SCREEN_EDGE_LEFT|GF_AUDIO_CH_BACK_SURROUND_LEFT)
+#define RESAMPLE_CH_RIGHT	(GF_AUDIO_CH_SURROUND_RIGHT|GF_AUDIO_CH_FRONT_CENTER_RIGHT|GF_AUDIO_CH_REAR_SURROUND_RIGHT|GF_AUDIO_CH_SURROUND_DIRECT_RIGHT|GF_AUDIO_CH_SIDE_SURROUND_RIGHT|GF_AUDIO_CH_WIDE_FRONT_RIGHT|GF_AUDIO_CH_FRONT_TOP_RIGHT|GF_AUDIO_CH_SURROUND_TOP_RIGHT|GF_AUDIO_CH_SIDE_SURROUND_TOP_RIGHT|GF_AUDIO_CH_FRONT_BOTTOM_RIGHT|GF_AUDIO_CH_SURROUND_BOTTOM_RIGHT|GF_AUDIO_CH_SCREEN_EDGE_RIGHT|GF_AUDIO_CH_BACK_SURROUND_RIGHT)
+#define RESAMPLE_CH_LFE		(GF_AUDIO_CH_LFE|GF_AUDIO_CH_LFE2)
+
+/*builds the channel mixing matrix from input and output layouts:
+- channels present in both layouts are copied
+- mono input goes to center if present, otherwise to left and right
+- mono output is the average of all non-LFE input channels
+- missing left/right channels are folded at -3dB in front left/right, missing center channels in both, LFE is dropped
+*/
+static void resample_fir_setup_matrix(GF_ResampleCtx *ctx, u32 nb_in, u64 in_layout, u32 nb_out, u64 out_layout)
+{
+	u32 i, o;
+	Float *m;
+	const Float att = (Float) 0.7071067811865476;
+	u32 out_l = resample_ch_idx(out_layout, GF_AUDIO_CH_FRONT_LEFT);
+	u32 out_r = resample_ch_idx(out_layout, GF_AUDIO_CH_FRONT_RIGHT);
+	u32 out_c = resample_ch_idx(out_layout, GF_AUDIO_CH_FRONT_CENTER);
+
+	memset(ctx->matrix, 0, sizeof(ctx->matrix));
+
+	//layouts not matching channel counts, map by index
+	if ((resample_nb_bits(in_layout) != nb_in) || (resample_nb_bits(out_layout) != nb_out)) {
+		for (o=0; o<nb_out; o++) {
+			if (nb_out==1) {
+				for (i=0; i<nb_in; i++) ctx->matrix[0][i] = (Float) 1.0 / nb_in;
+			} else if (nb_in==1) {
+				ctx->matrix[o][0] = (o<2) ? 1 : 0;
+			} else if (o<nb_in) {
+				ctx->matrix[o][o] = 1;
+			}
+		}
+	} else {
+		u32 nb_mono_src = 0;
+		u64 ch = 1;
+		i = 0;
+		for (ch=1; i<nb_in; ch<<=1) {
+			if (!(in_layout & ch)) continue;
+			if (! (ch & RESAMPLE_CH_LFE)) nb_mono_src++;
+			i++;
+		}
+		i = 0;
+		for (ch=1; i<nb_in; ch<<=1) {
+			if (!(in_layout & ch)) continue;
+			o = resample_ch_idx(out_layout, ch);
+			if (nb_out==1) {
+				if (! (ch & RESAMPLE_CH_LFE) && nb_mono_src) ctx->matrix[0][i] = (Float) 1.0 / nb_mono_src;
+			} else if (o<GF_AUDIO_MIXER_MAX_CHANNELS) {
+				ctx->matrix[o][i] = 1;
+			} else if (nb_in==1) {
+				if (out_c<GF_AUDIO_MIXER_MAX_CHANNELS) ctx->matrix[out_c][i] = 1;
+				else {
+					if (out_l<GF_AUDIO_MIXER_MAX_CHANNELS) ctx->matrix[out_l][i] = 1;
+					if (out_r<GF_AUDIO_MIXER_MAX_CHANNELS) ctx->matrix[out_r][i] = 1;
+				}
+			} else if (ch & RESAMPLE_CH_LFE) {
+			} else if (ch & RESAMPLE_CH_LEFT) {
+				if (out_l<GF_AUDIO_MIXER_MAX_CHANNELS) ctx->matrix[out_l][i] = att;
+			} else if (ch & RESAMPLE_CH_RIGHT) {
+				if (out_r<GF_AUDIO_MIXER_MAX_CHANNELS) ctx->matrix[out_r][i] = att;
+			} else {
+				if (out_l<GF_AUDIO_MIXER_MAX_CHANNELS) ctx->matrix[out_l][i] = att;
+				if (out_r<GF_AUDIO_MIXER_MAX_CHANNELS) ctx->matrix[out_r][i] = att;
+				if ((out_l>=GF_AUDIO_MIXER_MAX_CHANNELS) && (out_r>=GF_AUDIO_MIXER_MAX_CHANNELS) && (out_c<GF_AUDIO_MIXER_MAX_CHANNELS))
+					ctx->matrix[out_c][i] = 1;
+			}
+			i++;
+		}
+	}
+
+	ctx->mix_identity = (nb_in==nb_out) ? GF_TRUE : GF_FALSE;
+	for (o=0; o<nb_out && ctx->mix_identity; o++) {
+		m = ctx->matrix[o];
+		for (i=0; i<nb_in; i++) {
+			if (m[i] != ((i==o) ? 1 : 0)) {
+				ctx->mix_identity = GF_FALSE;
+				break;
+			}
+		}
+	}
+	ctx->mix_first = (nb_out <= nb_in) ? GF_TRUE : GF_FALSE;
+}
+
+static void resample_fir_reset(GF_ResampleCtx *ctx)
+{
+	u32 i;
+	//prefill history so that the first output sample is aligned with the first input sample
+	ctx->buf_len = ctx->fir_pad;
+	for (i=0; i<ctx->fir_ch; i++) {
+		memset(ctx->buf + i*ctx->buf_stride, 0, sizeof(Float) * ctx->fir_pad);
+	}
+	ctx->fir_pos = 0;
+	ctx->fir_frac = 0;
+	ctx->fir_nb_in = ctx->fir_nb_out = 0;
+	ctx->fir_cts_init = GF_FALSE;
+	ctx->fir_flushed = GF_FALSE;
+}
+
+static GF_Err resample_fir_output(GF_ResampleCtx *ctx, GF_FilterPacket *src_pck, Bool flush);
+
+//output all pending samples and restart from an empty history, timing is taken from the next input packet
+static GF_Err resample_fir_flush(GF_ResampleCtx *ctx)
+{
+	GF_Err e = GF_OK;
+	if (ctx->fir_cts_init)
+		e = resample_fir_output(ctx, NULL, GF_TRUE);
+	resample_fir_reset(ctx);
+	return e;
+}
+
+static GF_Err resample_setup_fir(GF_ResampleCtx *ctx)
+{
+	GF_Err e;
+	u32 nb_in = ctx->input_ai.chan;
+	ctx->use_fir = GF_FALSE;
+	if (ctx->passthrough || (ctx->mode != RESAMPLE_MODE_FIR) || (ctx->speed != FIX_ONE)) return GF_OK;
+	if (!nb_in || (nb_in > GF_AUDIO_MIXER_MAX_CHANNELS) || (ctx->nb_ch > GF_AUDIO_MIXER_MAX_CHANNELS)) return GF_OK;
+	if (!gf_audio_fmt_bit_depth(ctx->input_ai.afmt) || !gf_audio_fmt_bit_depth(ctx->afmt)) return GF_OK;
+	//filtering is done on floats, keep the mixer for sources with more than 24 bits of precision
+	switch (ctx->input_ai.afmt) {
+	case GF_AUDIO_FMT_S32:
+	case GF_AUDIO_FMT_S32P:
+	case GF_AUDIO_FMT_DBL:
+	case GF_AUDIO_FMT_DBLP:
+		GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[Resample] FIR mode not used for %s input, using mixer\n", gf_audio_fmt_name(ctx->input_ai.afmt) ));
+		return GF_OK;
+	default:
+		break;
+	}
+
+	e = resample_fir_setup_filter(ctx, ctx->input_ai.samplerate, ctx->freq);
+	if (e) return e;
+	resample_fir_setup_matrix(ctx, nb_in, ctx->input_ai.ch_layout, ctx->nb_ch, ctx->ch_cfg);
+	ctx->fir_ch = MIN(nb_in, ctx->nb_ch);
+	if (ctx->mix_identity) ctx->fir_ch = nb_in;
+
+	if (ctx->buf_stride < ctx->nb_taps + 1024) {
+		ctx->buf_stride = ctx->nb_taps + 1024;
+		if (ctx->buf) gf_free(ctx->buf);
+		ctx->buf = NULL;
+	}
+	if (!ctx->buf) ctx->buf = gf_malloc(sizeof(Float) * ctx->buf_stride * GF_AUDIO_MIXER_MAX_CHANNELS);
+	if (!ctx->buf) return GF_OUT_OF_MEM;
+
+	resample_fir_reset(ctx);
+	ctx->use_fir = GF_TRUE;
+
+	GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[Resample] Setup FIR resampler %d Hz %d channels to %d Hz %d channels: %d/%d ratio, %d branches of %d taps\n",
+		ctx->input_ai.samplerate, nb_in, ctx->freq, ctx->nb_ch, ctx->fir_l, ctx->fir_m, ctx->nb_phases, ctx->nb_taps));
+	return GF_OK;
+}
+
+//make sure the history can hold nb_samples more samples, moving it to a larger buffer if needed
+static GF_Err resample_fir_grow(GF_ResampleCtx *ctx, u32 nb_samples)
+{
+	u32 i, stride;
+	Float *buf;
+	if (ctx->buf_len + nb_samples <= ctx->buf_stride) return GF_OK;
+	stride = ctx->buf_len + nb_samples + 1024;
+	buf = gf_malloc(sizeof(Float) * stride * GF_AUDIO_MIXER_MAX_CHANNELS);
+	if (!buf) return GF_OUT_OF_MEM;
+	for (i=0; i<ctx->fir_ch; i++) {
+		memcpy(buf + i*stride, ctx->buf + i*ctx->buf_stride, sizeof(Float) * ctx->buf_len);
+	}
+	gf_free(ctx->buf);
+	ctx->buf = buf;
+	ctx->buf_stride = stride;
+	return GF_OK;
+}
+
+/*converts nb_samp samples of each channel to float planar, dst channels spaced by dst_stride*/
+static void resample_to_float(Float *dst, u32 dst_stride, const u8 *data, u32 afmt, u32 nb_ch, u32 nb_samp, u32 planar_stride)
+{
+	u32 i, j;
+	u32 bytes = gf_audio_fmt_bit_depth(afmt) / 8;
+	Bool planar = gf_audio_fmt_is_planar(afmt);
+	u32 step = planar ? 1 : nb_ch;
+
+	for (j=0; j<nb_ch; j++) {
+		Float *out = dst + j*dst_stride;
+		const u8 *src = data + (planar ? j*planar_stride : j*bytes);
+		switch (afmt) {
+		case GF_AUDIO_FMT_U8:
+		case GF_AUDIO_FMT_U8P:
+			for (i=0; i<nb_samp; i++) out[i] = ((s32) src[i*step] - 128) * (Float) (1.0/128);
+			break;
+		case GF_AUDIO_FMT_S16:
+		case GF_AUDIO_FMT_S16P:
+			for (i=0; i<nb_samp; i++) out[i] = ((const s16 *)src)[i*step] * (Float) (1.0/32768);
+			break;
+		case GF_AUDIO_FMT_S24:
+		case GF_AUDIO_FMT_S24P:
+			for (i=0; i<nb_samp; i++) {
+				const u8 *ptr = src + 3*i*step;
+				s32 v = (s32) ( ((u32)ptr[0]<<8) | ((u32)ptr[1]<<16) | ((u32)ptr[2]<<24) );
+				out[i] = (v >> 8) * (Float) (1.0/8388608);
+			}
+			break;
+		case GF_AUDIO_FMT_S32:
+		case GF_AUDIO_FMT_S32P:
+			for (i=0; i<nb_samp; i++) out[i] = (Float) ( ((const s32 *)src)[i*step] * (1.0/2147483648.0) );
+			break;
+		case GF_AUDIO_FMT_FLT:
+		case GF_AUDIO_FMT_FLTP:
+			for (i=0; i<nb_samp; i++) out[i] = ((const Float *)src)[i*step];
+			break;
+		case GF_AUDIO_FMT_DBL:
+		case GF_AUDIO_FMT_DBLP:
+			for (i=0; i<nb_samp; i++) out[i] = (Float) ((const Double *)src)[i*step];
+			break;
+		}
+	}
+}
+
+static GFINLINE s32 resample_flt_to_int(Double v, Double scale, s32 min, s32 max)
+{
+	v *= scale;
+	v = (v<0) ? v - 0.5 : v + 0.5;
+	if (v <= min) return min;
+	if (v >= max) return max;
+	return (s32) v;
+}
+
+/*converts float planar samples to the output format, src channels spaced by src_stride*/
+static void resample_from_float(u8 *data, u32 afmt, const Float *src, u32 src_stride, u32 nb_ch, u32 nb_samp)
+{
+	u32 i, j;
+	u32 bytes = gf_audio_fmt_bit_depth(afmt) / 8;
+	Bool planar = gf_audio_fmt_is_planar(afmt);
+	u32 step = planar ? 1 : nb_ch;
+
+	for (j=0; j<nb_ch; j++) {
+		const Float *in = src + j*src_stride;
+		u8 *dst = data + (planar ? j*nb_samp*bytes : j*bytes);
+		switch (afmt) {
+		case GF_AUDIO_FMT_U8:
+		case GF_AUDIO_FMT_U8P:
+			for (i=0; i<nb_samp; i++) dst[i*step] = (u8) (resample_flt_to_int(in[i], 128, -128, 127) + 128);
+			break;
+		case GF_AUDIO_FMT_S16:
+		case GF_AUDIO_FMT_S16P:
+			for (i=0; i<nb_samp; i++) ((s16 *)dst)[i*step] = (s16) resample_flt_to_int(in[i], 32768, -32768, 32767);
+			break;
+		case GF_AUDIO_FMT_S24:
+		case GF_AUDIO_FMT_S24P:
+			for (i=0; i<nb_samp; i++) {
+				u8 *ptr = dst + 3*i*step;
+				s32 v = resample_flt_to_int(in[i], 8388608, -8388608, 8388607);
+				ptr[0] = v & 0xFF;
+				ptr[1] = (v>>8) & 0xFF;
+				ptr[2] = (v>>16) & 0xFF;
+			}
+			break;
+		case GF_AUDIO_FMT_S32:
+		case GF_AUDIO_FMT_S32P:
+			for (i=0; i<nb_samp; i++) ((s32 *)dst)[i*step] = resample_flt_to_int(in[i], 2147483648.0, GF_INT_MIN, GF_INT_MAX);
+			break;
+		case GF_AUDIO_FMT_FLT:
+		case GF_AUDIO_FMT_FLTP:
+			for (i=0; i<nb_samp; i++) ((Float *)dst)[i*step] = in[i];
+			break;
+		case GF_AUDIO_FMT_DBL:
+		case GF_AUDIO_FMT_DBLP:
+			for (i=0; i<nb_samp; i++) ((Double *)dst)[i*step] = in[i];
+			break;
+		}
+	}
+}
+
+/*applies the mixing matrix, each channel spaced by stride*/
+static void resample_mix(GF_ResampleCtx *ctx, Float *dst, u32 nb_out, const Float *src, u32 nb_in, u32 stride, u32 nb_samp)
+{
+	u32 i, j, o;
+	for (o=0; o<nb_out; o++) {
+		Float *out = dst + o*stride;
+		memset(out, 0, sizeof(Float)*nb_samp);
+		for (j=0; j<nb_in; j++) {
+			const Float *in = src + j*stride;
+			Float m = ctx->matrix[o][j];
+			if (!m) continue;
+			for (i=0; i<nb_samp; i++) out[i] += m * in[i];
+		}
+	}
+}
+
+static GFINLINE Float resample_fir_dot(const Float *s, const Float *c, u32 nb_taps)
+{
+	u32 k;
+	Float sum0=0, sum1=0, sum2=0, sum3=0;
+#ifdef GPAC_HAS_SSE2
+	if (!(nb_taps & 3)) {
+		__m128 acc0 = _mm_setzero_ps();
+		__m128 acc1 = _mm_setzero_ps();
+		for (k=0; k+8 <= nb_taps; k+=8) {
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(s+k), _mm_loadu_ps(c+k)));
+			acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(s+k+4), _mm_loadu_ps(c+k+4)));
+		}
+		if (k<nb_taps)
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(s+k), _mm_loadu_ps(c+k)));
+		acc0 = _mm_add_ps(acc0, acc1);
+		acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+		acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+		return _mm_cvtss_f32(acc0);
+	}
+#endif
+	for (k=0; k+4 <= nb_taps; k+=4) {
+		sum0 += s[k] * c[k];
+		sum1 += s[k+1] * c[k+1];
+		sum2 += s[k+2] * c[k+2];
+		sum3 += s[k+3] * c[k+3];
+	}
+	for (; k<nb_taps; k++) sum0 += s[k] * c[k];
+	return sum0 + sum1 + sum2 + sum3;
+}
+
+/*filters the history into flt_tmp, returns the number of output samples*/
+static u32 resample_fir_run(GF_ResampleCtx *ctx, u64 max_out)
+{
+	u32 j, nb_out=0, max_samp;
+	u32 nb_taps = ctx->nb_taps;
+	u32 pos = ctx->fir_pos;
+	u32 frac = ctx->fir_frac;
+
+	if (ctx->buf_len < pos + nb_taps) return 0;
+	max_samp = (u32) ( ((u64) (ctx->buf_len - pos - nb_taps + 1) * ctx->fir_l + ctx->fir_m - 1) / ctx->fir_m ) + 1;
+	if (max_samp > max_out) max_samp = (u32) max_out;
+	if (!max_samp) return 0;
+	if (!resample_tmp_alloc(&ctx->flt_tmp, &ctx->flt_tmp_alloc, max_samp * ctx->fir_ch))
+		return 0;
+
+	while ((nb_out < max_samp) && (pos + nb_taps <= ctx->buf_len)) {
+		const Float *c;
+		u32 phase = frac;
+		if (ctx->nb_phases != ctx->fir_l)
+			phase = (u32) ( ((u64) frac * ctx->nb_phases + ctx->fir_l/2) / ctx->fir_l);
+		//last branch uses one more sample, make sure we have it
+		if ((phase == ctx->nb_phases) && (pos + nb_taps + 1 > ctx->buf_len))
+			break;
+		c = ctx->coefs + phase*nb_taps;
+
+		for (j=0; j<ctx->fir_ch; j++) {
+			ctx->flt_tmp[j*max_samp + nb_out] = resample_fir_dot(ctx->buf + j*ctx->buf_stride + pos, c, nb_taps);
+		}
+		nb_out++;
+
+		frac += ctx->fir_m;
+		if (frac >= ctx->fir_l) {
+			pos += frac / ctx->fir_l;
+			frac %= ctx->fir_l;
+		}
+	}
+	ctx->fir_pos = pos;
+	ctx->fir_frac = frac;
+
+	//compact planar temp buffer to nb_out stride
+	if (nb_out < max_samp) {
+		for (j=1; j<ctx->fir_ch; j++) {
+			memmove(ctx->flt_tmp + j*nb_out, ctx->flt_tmp + j*max_samp, sizeof(Float)*nb_out);
+		}
+	}
+	return nb_out;
+}
+
+static GF_Err resample_fir_push(GF_ResampleCtx *ctx, const u8 *data, u32 size)
+{
+	GF_Err e;
+	u32 j, nb_samp, planar_stride;
+	u32 nb_in = ctx->input_ai.chan;
+	u32 bps = gf_audio_fmt_bit_depth(ctx->input_ai.afmt) / 8;
+
+	nb_samp = size / (bps * nb_in);
+	if (!nb_samp) return GF_OK;
+	planar_stride = size / nb_in;
+
+	e = resample_fir_grow(ctx, nb_samp);
+	if (e) return e;
+
+	if (ctx->mix_identity || !ctx->mix_first) {
+		resample_to_float(ctx->buf + ctx->buf_len, ctx->buf_stride, data, ctx->input_ai.afmt, nb_in, nb_samp, planar_stride);
+	} else {
+		if (!resample_tmp_alloc(&ctx->in_tmp, &ctx->in_tmp_alloc, nb_samp * nb_in)) return GF_OUT_OF_MEM;
+		if (!resample_tmp_alloc(&ctx->mix_tmp, &ctx->mix_tmp_alloc, nb_samp * ctx->fir_ch)) return GF_OUT_OF_MEM;
+		resample_to_float(ctx->in_tmp, nb_samp, data, ctx->input_ai.afmt, nb_in, nb_samp, planar_stride);
+		resample_mix(ctx, ctx->mix_tmp, ctx->fir_ch, ctx->in_tmp, nb_in, nb_samp, nb_samp);
+		for (j=0; j<ctx->fir_ch; j++) {
+			memcpy(ctx->buf + j*ctx->buf_stride + ctx->buf_len, ctx->mix_tmp + j*nb_samp, sizeof(Float)*nb_samp);
+		}
+	}
+	ctx->buf_len += nb_samp;
+	ctx->fir_nb_in += nb_samp;
+	return GF_OK;
+}
+
+static GF_Err resample_fir_output(GF_ResampleCtx *ctx, GF_FilterPacket *src_pck, Bool flush)
+{
+	u8 *output;
+	u32 j, nb_out, osize;
+	u64 cts, max_out;
+	const Float *samples;
+	GF_FilterPacket *dstpck;
+	u64 clock = gf_sys_clock_high_res();
+
+	//total number of output samples for the input received so far
+	max_out = (ctx->fir_nb_in * ctx->fir_l + ctx->fir_m - 1) / ctx->fir_m;
+	if (max_out <= ctx->fir_nb_out) return GF_OK;
+	max_out -= ctx->fir_nb_out;
+
+	if (flush) {
+		GF_Err e = resample_fir_grow(ctx, ctx->nb_taps + 1);
+		if (e) return e;
+		for (j=0; j<ctx->fir_ch; j++) {
+			memset(ctx->buf + j*ctx->buf_stride + ctx->buf_len, 0, sizeof(Float) * (ctx->nb_taps + 1));
+		}
+		ctx->buf_len += ctx->nb_taps + 1;
+	}
+
+	nb_out = resample_fir_run(ctx, max_out);
+
+	//discard consumed history
+	if (ctx->fir_pos) {
+		u32 remain = ctx->buf_len - ctx->fir_pos;
+		for (j=0; j<ctx->fir_ch; j++) {
+			Float *buf = ctx->buf + j*ctx->buf_stride;
+			memmove(buf, buf + ctx->fir_pos, sizeof(Float) * remain);
+		}
+		ctx->buf_len = remain;
+		ctx->fir_pos = 0;
+	}
+	if (!nb_out) return GF_OK;
+
+	samples = ctx->flt_tmp;
+	if (!ctx->mix_identity && !ctx->mix_first) {
+		if (!resample_tmp_alloc(&ctx->mix_tmp, &ctx->mix_tmp_alloc, nb_out * ctx->nb_ch)) return GF_OUT_OF_MEM;
+		resample_mix(ctx, ctx->mix_tmp, ctx->nb_ch, ctx->flt_tmp, ctx->fir_ch, nb_out, nb_out);
+		samples = ctx->mix_tmp;
+	}
+
+	osize = nb_out * ctx->nb_ch * gf_audio_fmt_bit_depth(ctx->afmt) / 8;
+	dstpck = gf_filter_pck_new_alloc(ctx->opid, osize, &output);
+	if (!dstpck) return GF_OUT_OF_MEM;
+	if (src_pck) gf_filter_pck_merge_properties(src_pck, dstpck);
+
+	resample_from_float(output, ctx->afmt, samples, nb_out, ctx->nb_ch, nb_out);
+
+	cts = ctx->fir_cts_origin;
+	if (ctx->timescale==ctx->freq) cts += ctx->fir_nb_out;
+	else cts += ctx->fir_nb_out * ctx->timescale / ctx->freq;
+	gf_filter_pck_set_dts(dstpck, cts);
+	gf_filter_pck_set_cts(dstpck, cts);
+	gf_filter_pck_set_duration(dstpck, (u32) (((u64) nb_out) * ctx->timescale / ctx->freq) );
+	gf_filter_pck_send(dstpck);
+
+	ctx->fir_nb_out += nb_out;
+	ctx->fir_nb_samples += nb_out * ctx->nb_ch;
+	ctx->fir_time_us += gf_sys_clock_high_res() - clock;
+	return GF_OK;
+}
+
+static GF_Err resample_process_fir(GF_ResampleCtx *ctx)
+{
+	GF_Err e;
+	u64 clock = gf_sys_clock_high_res();
+	u64 cts = gf_filter_pck_get_cts(ctx->in_pck);
+
+	//timestamp discontinuity, flush and restart from the new timestamp
+	if (ctx->fir_cts_init && (cts != GF_FILTER_NO_TS)) {
+		u64 exp_cts = ctx->fir_cts_origin;
+		if (ctx->timescale==ctx->input_ai.samplerate) exp_cts += ctx->fir_nb_in;
+		else exp_cts += ctx->fir_nb_in * ctx->timescale / ctx->input_ai.samplerate;
+
+		if ((cts + ctx->timescale/50 < exp_cts) || (cts > exp_cts + ctx->timescale/50)) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[Resample] Timestamp discontinuity (got "LLU" expected "LLU"), resetting FIR resampler\n", cts, exp_cts));
+			e = resample_fir_flush(ctx);
+			if (e) return e;
+		}
+	}
+	if (!ctx->fir_cts_init) {
+		ctx->fir_cts_origin = (cts != GF_FILTER_NO_TS) ? cts : 0;
+		ctx->fir_cts_init = GF_TRUE;
+	}
+	ctx->fir_flushed = GF_FALSE;
+	e = resample_fir_push(ctx, (const u8 *) ctx->data, ctx->size);
+	ctx->fir_time_us += gf_sys_clock_high_res() - clock;
+	if (e) return e;
+	return resample_fir_output(ctx, ctx->in_pck, GF_FALSE);
+}
+
 static GF_Err resample_initialize(GF_Filter *filter)
 {
 	GF_ResampleCtx *ctx = gf_filter_get_udta(filter);
@@ -137,6 +775,15 @@ static void resample_finalize(GF_Filter *filter)
 	GF_ResampleCtx *ctx = gf_filter_get_udta(filter);
 	if (ctx->mixer) gf_mixer_del(ctx->mixer);
 	if (ctx->in_pck && ctx->ipid) gf_filter_pid_drop_packet(ctx->ipid);
+
+	if (ctx->fir_time_us) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[Resample] FIR resampled "LLU" samples in "LLU" ms - %.02f M channel samples per second\n", ctx->fir_nb_samples, ctx->fir_time_us/1000, ((Double) ctx->fir_nb_samples) / ctx->fir_time_us));
+	}
+	if (ctx->coefs) gf_free(ctx->coefs);
+	if (ctx->buf) gf_free(ctx->buf);
+	if (ctx->in_tmp) gf_free(ctx->in_tmp);
+	if (ctx->flt_tmp) gf_free(ctx->flt_tmp);
+	if (ctx->mix_tmp) gf_free(ctx->mix_tmp);
 }
 
 
@@ -221,7 +868,7 @@ static GF_Err resample_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool
 	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_AUDIO_FORMAT, &PROP_UINT(ctx->afmt));
 	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_NUM_CHANNELS, &PROP_UINT(ctx->nb_ch));
 	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_CHANNEL_LAYOUT, &PROP_LONGUINT(ctx->ch_cfg));
-	return GF_OK;
+	return resample_setup_fir(ctx);
 }
 
 
@@ -243,6 +890,11 @@ static GF_Err resample_process(GF_Filter *filter)
 
 			if (!ctx->in_pck) {
 				if (gf_filter_pid_is_eos(ctx->ipid)) {
+					if (ctx->use_fir && !ctx->fir_flushed) {
+						GF_Err e = resample_fir_flush(ctx);
+						ctx->fir_flushed = GF_TRUE;
+						if (e) return e;
+					}
 					if (ctx->opid)
 						gf_filter_pid_set_eos(ctx->opid);
 					return GF_EOS;
@@ -259,6 +911,15 @@ static GF_Err resample_process(GF_Filter *filter)
 			ctx->in_pck = NULL;
 			continue;
 		}
+		if (ctx->use_fir) {
+			GF_Err e = resample_process_fir(ctx);
+			gf_filter_pid_drop_packet(ctx->ipid);
+			ctx->in_pck = NULL;
+			ctx->data = NULL;
+			ctx->size = ctx->bytes_consumed = 0;
+			if (e) return e;
+			continue;
+		}
 
 		osize = ctx->size * ctx->nb_ch * bps;
 		osize /= ctx->input_ai.chan * gf_audio_fmt_bit_depth(ctx->input_ai.afmt);
@@ -298,6 +959,22 @@ static GF_Err resample_process(GF_Filter *filter)
 	return GF_OK;
 }
 
+static Bool resample_process_event(GF_Filter *filter, const GF_FilterEvent *evt)
+{
+	GF_ResampleCtx *ctx = gf_filter_get_udta(filter);
+	switch (evt->base.type) {
+	//stop or (re)start, including seek: drop filter history, timing restarts from next input packet
+	case GF_FEVT_STOP:
+	case GF_FEVT_PLAY:
+		if (ctx->use_fir) resample_fir_reset(ctx);
+		break;
+	default:
+		break;
+	}
+	//forward upstream
+	return GF_FALSE;
+}
+
 static GF_Err resample_reconfigure_output(GF_Filter *filter, GF_FilterPid *pid)
 {
 	u32 sr, nb_ch, afmt;
@@ -355,7 +1032,7 @@ static GF_Err resample_reconfigure_output(GF_Filter *filter, GF_FilterPid *pid)
 		gf_filter_pid_send_event(ctx->ipid, &evt);
 	}
 
-	return GF_OK;
+	return resample_setup_fir(ctx);
 }
 
 static const GF_FilterCapability ResamplerCaps[] =
@@ -372,13 +1049,21 @@ static const GF_FilterArgs ResamplerArgs[] =
 	{ OFFS(ch), "desired number of output audio channels - 0 for auto", GF_PROP_UINT, "0", NULL, 0},
 	{ OFFS(sr), "desired sample rate of output audio - 0 for auto", GF_PROP_UINT, "0", NULL, 0},
 	{ OFFS(fmt), "desired format of output audio - none for auto", GF_PROP_PCMFMT, "none", NULL, 0},
+	{ OFFS(mode), "resampling mode\n"
+	"- mix: use the audio mixer, linear interpolation\n"
+	"- fir: use polyphase windowed-sinc filters, the audio mixer is still used when playback speed is not 1 or for s32 and double input", GF_PROP_UINT, "mix", "mix|fir", GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(taps), "number of filter taps per polyphase branch in fir mode, increased by the decimation ratio when downsampling", GF_PROP_UINT, "64", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
 GF_FilterRegister ResamplerRegister = {
 	.name = "resample",
 	GF_FS_SET_DESCRIPTION("Audio resampler")
-	GF_FS_SET_HELP("This filter resamples raw audio to a target sample rate, number of channels or audio format.")
+	GF_FS_SET_HELP("This filter resamples raw audio to a target sample rate, number of channels or audio format.\n"
+	"\n"
+	"In [-mode]() `fir`, sample rate conversion uses a bank of Kaiser-windowed sinc filters, one per phase of the reduced L/M resampling ratio (up to 1024 phases), "
+	"and processing is done on float planar samples; s32 and double input formats always use the audio mixer. Channel remapping uses a mixing matrix: channels missing in the output layout are folded at -3dB in front left/right, LFE is dropped when downmixing.\n"
+	"In [-mode]() `mix`, the audio mixer of the compositor is used, with linear interpolation.")
 	.private_size = sizeof(GF_ResampleCtx),
 	.initialize = resample_initialize,
 	.finalize = resample_finalize,
@@ -386,6 +1071,7 @@ GF_FilterRegister ResamplerRegister = {
 	SETCAPS(ResamplerCaps),
 	.configure_pid = resample_configure_pid,
 	.process = resample_process,
+	.process_event = resample_process_event,
 	.reconfigure_output = resample_reconfigure_output,
 };
 
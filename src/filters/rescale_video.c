@@ -0,0 +1,1094 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / native video rescaler filter
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/filters.h>
+#include <gpac/constants.h>
+#include <gpac/color.h>
+#include <gpac/thread.h>
+#include <gpac/internal/simd_dev.h>
+#include <math.h>
+
+enum
+{
+	RESCALE_POINT = 0,
+	RESCALE_BILINEAR,
+	RESCALE_BICUBIC,
+	RESCALE_LANCZOS,
+};
+
+//filter coefficients are signed 12 bits fixed point (sum is 4096)
+#define RESCALE_COEF_BITS	12
+//number of fractional bits kept after the vertical pass
+#define RESCALE_INTER_BITS	6
+
+#define RESCALE_PI	3.14159265358979
+
+#define RESCALE_NONE	0xFF
+
+//extra samples allocated after the intermediate row, read with null coefficients by SIMD code
+#define RESCALE_TMP_PAD	8
+
+//component layout of a pixel format: components are Y/U/V/A for YUV formats and R/G/B/A for RGB formats
+typedef struct
+{
+	u32 pfmt;
+	Bool is_rgb;
+	u32 bits;
+	//plane index, offset and step in samples, log2 of horizontal and vertical subsampling
+	//plane is RESCALE_NONE if component is not present
+	u8 plane[4], offset[4], step[4], sub_x[4], sub_y[4];
+	//offset of padding byte in packed RGB formats, or RESCALE_NONE
+	u8 pad;
+} RescaleFormat;
+
+#define _N	RESCALE_NONE
+static const RescaleFormat RescaleFormats[] =
+{
+	{GF_PIXEL_GREYSCALE, GF_FALSE, 8, {0,_N,_N,_N}, {0,0,0,0}, {1,0,0,0}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_YUV, GF_FALSE, 8, {0,1,2,_N}, {0,0,0,0}, {1,1,1,0}, {0,1,1,0}, {0,1,1,0}, _N},
+	{GF_PIXEL_YUV_10, GF_FALSE, 10, {0,1,2,_N}, {0,0,0,0}, {1,1,1,0}, {0,1,1,0}, {0,1,1,0}, _N},
+	{GF_PIXEL_YUVA, GF_FALSE, 8, {0,1,2,3}, {0,0,0,0}, {1,1,1,1}, {0,1,1,0}, {0,1,1,0}, _N},
+	{GF_PIXEL_YUV422, GF_FALSE, 8, {0,1,2,_N}, {0,0,0,0}, {1,1,1,0}, {0,1,1,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_YUV422_10, GF_FALSE, 10, {0,1,2,_N}, {0,0,0,0}, {1,1,1,0}, {0,1,1,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_YUV444, GF_FALSE, 8, {0,1,2,_N}, {0,0,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_YUV444_10, GF_FALSE, 10, {0,1,2,_N}, {0,0,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_YUVA444, GF_FALSE, 8, {0,1,2,3}, {0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_NV12, GF_FALSE, 8, {0,1,1,_N}, {0,0,1,0}, {1,2,2,0}, {0,1,1,0}, {0,1,1,0}, _N},
+	{GF_PIXEL_NV21, GF_FALSE, 8, {0,1,1,_N}, {0,1,0,0}, {1,2,2,0}, {0,1,1,0}, {0,1,1,0}, _N},
+	{GF_PIXEL_NV12_10, GF_FALSE, 10, {0,1,1,_N}, {0,0,1,0}, {1,2,2,0}, {0,1,1,0}, {0,1,1,0}, _N},
+	{GF_PIXEL_NV21_10, GF_FALSE, 10, {0,1,1,_N}, {0,1,0,0}, {1,2,2,0}, {0,1,1,0}, {0,1,1,0}, _N},
+	{GF_PIXEL_YUYV, GF_FALSE, 8, {0,0,0,_N}, {0,1,3,0}, {2,4,4,0}, {0,1,1,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_YVYU, GF_FALSE, 8, {0,0,0,_N}, {0,3,1,0}, {2,4,4,0}, {0,1,1,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_UYVY, GF_FALSE, 8, {0,0,0,_N}, {1,0,2,0}, {2,4,4,0}, {0,1,1,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_VYUY, GF_FALSE, 8, {0,0,0,_N}, {1,2,0,0}, {2,4,4,0}, {0,1,1,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_RGB, GF_TRUE, 8, {0,0,0,_N}, {0,1,2,0}, {3,3,3,0}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_BGR, GF_TRUE, 8, {0,0,0,_N}, {2,1,0,0}, {3,3,3,0}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_RGBA, GF_TRUE, 8, {0,0,0,0}, {0,1,2,3}, {4,4,4,4}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_ARGB, GF_TRUE, 8, {0,0,0,0}, {1,2,3,0}, {4,4,4,4}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_BGRA, GF_TRUE, 8, {0,0,0,0}, {2,1,0,3}, {4,4,4,4}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_ABGR, GF_TRUE, 8, {0,0,0,0}, {3,2,1,0}, {4,4,4,4}, {0,0,0,0}, {0,0,0,0}, _N},
+	{GF_PIXEL_RGBX, GF_TRUE, 8, {0,0,0,_N}, {0,1,2,0}, {4,4,4,0}, {0,0,0,0}, {0,0,0,0}, 3},
+	{GF_PIXEL_XRGB, GF_TRUE, 8, {0,0,0,_N}, {1,2,3,0}, {4,4,4,0}, {0,0,0,0}, {0,0,0,0}, 0},
+	{GF_PIXEL_BGRX, GF_TRUE, 8, {0,0,0,_N}, {2,1,0,0}, {4,4,4,0}, {0,0,0,0}, {0,0,0,0}, 3},
+	{GF_PIXEL_XBGR, GF_TRUE, 8, {0,0,0,_N}, {3,2,1,0}, {4,4,4,0}, {0,0,0,0}, {0,0,0,0}, 0},
+};
+#undef _N
+
+static const RescaleFormat *rescale_get_format(u32 pfmt)
+{
+	u32 i, count = sizeof(RescaleFormats) / sizeof(RescaleFormat);
+	for (i=0; i<count; i++) {
+		if (RescaleFormats[i].pfmt == pfmt) return &RescaleFormats[i];
+	}
+	return NULL;
+}
+
+//filter table for one direction: for each output sample, index of first source sample and nb_taps coefficients
+typedef struct
+{
+	u32 nb_taps, dst_len;
+	u32 *pos;
+	s16 *coefs;
+	//coefficients padded with zeros to a multiple of 8 taps, for SIMD horizontal pass
+	u32 simd_taps;
+	s16 *simd_coefs;
+} RescaleTable;
+
+typedef struct
+{
+	//set if component is present in output
+	Bool active;
+	//set if component is not present in input, output is filled with fill_val
+	Bool fill;
+	u32 fill_val;
+	u32 src_plane, src_offset, src_step, src_w, src_h;
+	u32 dst_plane, dst_offset, dst_step, dst_w, dst_h, dst_sub_y;
+	//right shift applied to the final accumulator, also converts bit depth
+	u32 shift;
+	u32 max_val;
+	RescaleTable htab, vtab;
+	//set if intermediate values fit on 16 bits and the horizontal SIMD pass can be used
+	Bool h_simd;
+} RescaleComp;
+
+typedef struct _rescale_ctx GF_RescaleCtx;
+
+typedef struct
+{
+	GF_RescaleCtx *ctx;
+	GF_Thread *th;
+	GF_Semaphore *start;
+	//first and last+1 output rows (luma) of the band
+	u32 y_start, y_end;
+	//vertical pass output, one row of source samples
+	s32 *tmp;
+} RescaleBand;
+
+struct _rescale_ctx
+{
+	//options
+	GF_PropVec2i osize;
+	u32 ofmt, scale, threads;
+
+	//internal data
+	GF_FilterPid *ipid, *opid;
+	u32 w, h, stride, stride_uv, s_pfmt, o_pfmt;
+	Bool passthrough;
+
+	u32 dst_stride[5];
+	u32 src_stride[5];
+	u32 nb_planes, nb_src_planes, out_size, out_src_size, src_uv_height, dst_uv_height, ow, oh;
+
+	const RescaleFormat *src_fmt, *dst_fmt;
+	RescaleComp comps[4];
+	u32 max_src_w;
+
+	//YUV to RGB: scaling is done in a YUV 4:4:4 intermediate frame, then converted by bands using gf_stretch_bits
+	Bool use_inter;
+	u8 *inter;
+	u32 inter_size, inter_stride;
+	//alpha component, scaled directly in output frame after conversion
+	RescaleComp inter_alpha;
+
+	u8 *src_planes[5];
+	u8 *dst_planes[5];
+	u8 *out_planes[5];
+
+	RescaleBand *bands;
+	u32 nb_bands;
+	GF_Semaphore *bands_done;
+	Bool bands_exit;
+
+	u64 nb_frames, process_time_us;
+};
+
+static Double rescale_kernel(u32 mode, Double x)
+{
+	if (x<0) x = -x;
+	switch (mode) {
+	case RESCALE_BILINEAR:
+		return (x<1) ? 1-x : 0;
+	case RESCALE_BICUBIC:
+		//Keys cubic convolution, a=-0.5
+		if (x<1) return (1.5*x - 2.5)*x*x + 1;
+		if (x<2) return ((-0.5*x + 2.5)*x - 4)*x + 2;
+		return 0;
+	case RESCALE_LANCZOS:
+		if (x<1e-8) return 1;
+		if (x>=3) return 0;
+		return 3 * sin(RESCALE_PI*x) * sin(RESCALE_PI*x/3) / (RESCALE_PI*RESCALE_PI*x*x);
+	}
+	return 0;
+}
+
+static void rescale_table_reset(RescaleTable *tab)
+{
+	if (tab->pos) gf_free(tab->pos);
+	if (tab->coefs) gf_free(tab->coefs);
+	if (tab->simd_coefs) gf_free(tab->simd_coefs);
+	memset(tab, 0, sizeof(RescaleTable));
+}
+
+static GF_Err rescale_table_setup(RescaleTable *tab, u32 mode, u32 src_len, u32 dst_len)
+{
+	u32 i, j, nb_taps;
+	Double scale, support, fscale;
+	Double *weights;
+
+	rescale_table_reset(tab);
+	if (!src_len || !dst_len) return GF_BAD_PARAM;
+
+	scale = ((Double)src_len) / dst_len;
+	//widen kernel when downscaling to avoid aliasing
+	fscale = (scale>1) ? scale : 1;
+	support = 0;
+	switch (mode) {
+	case RESCALE_BILINEAR: support = 1; break;
+	case RESCALE_BICUBIC: support = 2; break;
+	case RESCALE_LANCZOS: support = 3; break;
+	}
+	if ((src_len==dst_len) || !support) {
+		nb_taps = 1;
+	} else {
+		nb_taps = 2 * (u32) ceil(support*fscale);
+		if (nb_taps > src_len) nb_taps = src_len;
+	}
+	tab->nb_taps = nb_taps;
+	tab->dst_len = dst_len;
+	tab->pos = gf_malloc(sizeof(u32) * dst_len);
+	tab->coefs = gf_malloc(sizeof(s16) * dst_len * nb_taps);
+	weights = gf_malloc(sizeof(Double) * nb_taps);
+	if (!tab->pos || !tab->coefs || !weights) {
+		if (weights) gf_free(weights);
+		rescale_table_reset(tab);
+		return GF_OUT_OF_MEM;
+	}
+
+	for (i=0; i<dst_len; i++) {
+		s32 left, start, max_idx=0;
+		s32 total = 0;
+		Double sum = 0, max_w = -1;
+		s16 *coefs = tab->coefs + i*nb_taps;
+		Double center = (i + 0.5) * scale - 0.5;
+
+		if (nb_taps==1) {
+			s32 p = (src_len==dst_len) ? (s32) i : (s32) floor((i + 0.5) * scale);
+			if (p >= (s32) src_len) p = src_len-1;
+			tab->pos[i] = p;
+			coefs[0] = 1<<RESCALE_COEF_BITS;
+			continue;
+		}
+
+		left = (s32) floor(center - support*fscale) + 1;
+		start = left;
+		if (start > (s32) (src_len - nb_taps)) start = src_len - nb_taps;
+		if (start < 0) start = 0;
+
+		memset(weights, 0, sizeof(Double) * nb_taps);
+		for (j=0; j < 2 * (u32) ceil(support*fscale); j++) {
+			s32 idx = left + j;
+			Double w = rescale_kernel(mode, (idx - center) / fscale);
+			//fold samples outside the source on the edges
+			if (idx<0) idx = 0;
+			else if (idx >= (s32) src_len) idx = src_len-1;
+			weights[idx - start] += w;
+			sum += w;
+		}
+		for (j=0; j<nb_taps; j++) {
+			s32 c = (s32) floor(weights[j] * (1<<RESCALE_COEF_BITS) / sum + 0.5);
+			coefs[j] = (s16) c;
+			total += c;
+			if (weights[j] > max_w) {
+				max_w = weights[j];
+				max_idx = j;
+			}
+		}
+		//push rounding error on the main tap so that flat areas are preserved
+		coefs[max_idx] += (1<<RESCALE_COEF_BITS) - total;
+		tab->pos[i] = start;
+	}
+	gf_free(weights);
+	return GF_OK;
+}
+
+//vertical pass: filters nb_taps source rows into tmp, keeping RESCALE_INTER_BITS of precision
+static void rescale_vert_8(s32 *tmp, const u8 *src, u32 src_stride, u32 step, u32 width, const s16 *coefs, u32 nb_taps)
+{
+	u32 x, k;
+	if (nb_taps==1) {
+		if (step==1) {
+			for (x=0; x<width; x++) tmp[x] = ((s32) src[x]) << RESCALE_INTER_BITS;
+		} else {
+			for (x=0; x<width; x++) tmp[x] = ((s32) src[x*step]) << RESCALE_INTER_BITS;
+		}
+		return;
+	}
+	for (k=0; k<nb_taps; k++) {
+		const u8 *row = src + k*src_stride;
+		s32 c = coefs[k];
+		if (!k) {
+			if (step==1) {
+				for (x=0; x<width; x++) tmp[x] = c * row[x];
+			} else {
+				for (x=0; x<width; x++) tmp[x] = c * row[x*step];
+			}
+		} else if (step==1) {
+			for (x=0; x<width; x++) tmp[x] += c * row[x];
+		} else {
+			for (x=0; x<width; x++) tmp[x] += c * row[x*step];
+		}
+	}
+	for (x=0; x<width; x++)
+		tmp[x] = (tmp[x] + (1<<(RESCALE_COEF_BITS-RESCALE_INTER_BITS-1))) >> (RESCALE_COEF_BITS-RESCALE_INTER_BITS);
+}
+
+static void rescale_vert_16(s32 *tmp, const u8 *src, u32 src_stride, u32 step, u32 width, const s16 *coefs, u32 nb_taps)
+{
+	u32 x, k;
+	if (nb_taps==1) {
+		const u16 *row = (const u16 *)src;
+		for (x=0; x<width; x++) tmp[x] = ((s32) row[x*step]) << RESCALE_INTER_BITS;
+		return;
+	}
+	for (k=0; k<nb_taps; k++) {
+		const u16 *row = (const u16 *) (src + k*src_stride);
+		s32 c = coefs[k];
+		if (!k) {
+			for (x=0; x<width; x++) tmp[x] = c * row[x*step];
+		} else {
+			for (x=0; x<width; x++) tmp[x] += c * row[x*step];
+		}
+	}
+	for (x=0; x<width; x++)
+		tmp[x] = (tmp[x] + (1<<(RESCALE_COEF_BITS-RESCALE_INTER_BITS-1))) >> (RESCALE_COEF_BITS-RESCALE_INTER_BITS);
+}
+
+//horizontal pass: filters tmp into the destination row, converting bit depth
+//common tap counts are expanded with a constant loop bound so that the compiler can unroll them
+#define RESCALE_HORIZ_LOOP(_type, _taps) \
+	for (x=0; x<width; x++) { \
+		const s32 *t = tmp + pos[x]; \
+		s32 acc = 0; \
+		for (k=0; k<_taps; k++) acc += coefs[k] * t[k]; \
+		coefs += _taps; \
+		acc = (acc + round) >> shift; \
+		if (acc<0) acc = 0; \
+		else if (acc > (s32) max_val) acc = max_val; \
+		out[x*step] = (_type) acc; \
+	}
+
+#define RESCALE_HORIZ(_type) \
+	u32 x, k; \
+	s32 round = (1<<shift) >> 1; \
+	_type *out = (_type *) dst; \
+	switch (nb_taps) { \
+	case 1: \
+		for (x=0; x<width; x++) { \
+			s32 v = (tmp[pos[x]] * (1<<RESCALE_COEF_BITS) + round) >> shift; \
+			if (v<0) v = 0; \
+			else if (v > (s32) max_val) v = max_val; \
+			out[x*step] = (_type) v; \
+		} \
+		break; \
+	case 2: RESCALE_HORIZ_LOOP(_type, 2) break; \
+	case 4: RESCALE_HORIZ_LOOP(_type, 4) break; \
+	case 6: RESCALE_HORIZ_LOOP(_type, 6) break; \
+	case 8: RESCALE_HORIZ_LOOP(_type, 8) break; \
+	case 10: RESCALE_HORIZ_LOOP(_type, 10) break; \
+	case 12: RESCALE_HORIZ_LOOP(_type, 12) break; \
+	default: RESCALE_HORIZ_LOOP(_type, nb_taps) break; \
+	}
+
+static void rescale_horiz_8(u8 *dst, u32 step, u32 width, const s32 *tmp, const u32 *pos, const s16 *coefs, u32 nb_taps, u32 shift, u32 max_val)
+{
+	RESCALE_HORIZ(u8)
+}
+static void rescale_horiz_16(u8 *dst, u32 step, u32 width, const s32 *tmp, const u32 *pos, const s16 *coefs, u32 nb_taps, u32 shift, u32 max_val)
+{
+	RESCALE_HORIZ(u16)
+}
+
+#ifdef GPAC_HAS_SSE2
+//max number of vertical taps handled by the SSE2 vertical pass
+#define RESCALE_SIMD_MAX_TAPS	64
+
+//SSE2 vertical pass for contiguous samples on 15 bits at most: taps are processed by pairs using madd
+//on interleaved rows - results are identical to the C version
+static void rescale_vert_sse2(s32 *tmp, const u8 *src, u32 src_stride, u32 width, const s16 *coefs, u32 nb_taps, Bool is_16)
+{
+	u32 x, k, nb_pairs;
+	__m128i cpairs[RESCALE_SIMD_MAX_TAPS/2];
+	const u8 *rows[RESCALE_SIMD_MAX_TAPS];
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi32(1<<(RESCALE_COEF_BITS-RESCALE_INTER_BITS-1));
+
+	nb_pairs = (nb_taps+1) / 2;
+	for (k=0; k<nb_pairs; k++) {
+		//odd number of taps: last row is paired with itself and a null coefficient
+		u16 c0 = (u16) coefs[2*k];
+		u16 c1 = (2*k+1<nb_taps) ? (u16) coefs[2*k+1] : 0;
+		cpairs[k] = _mm_set1_epi32((s32) ((u32) c0 | ((u32) c1 << 16)));
+		rows[2*k] = src + 2*k*src_stride;
+		rows[2*k+1] = (2*k+1<nb_taps) ? rows[2*k] + src_stride : rows[2*k];
+	}
+
+	x = 0;
+	if (is_16) {
+		for (; x+8<=width; x+=8) {
+			__m128i acc_lo = zero;
+			__m128i acc_hi = zero;
+			for (k=0; k<nb_pairs; k++) {
+				__m128i r0 = _mm_loadu_si128((const __m128i *) (((const u16 *)rows[2*k]) + x));
+				__m128i r1 = _mm_loadu_si128((const __m128i *) (((const u16 *)rows[2*k+1]) + x));
+				acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(_mm_unpacklo_epi16(r0, r1), cpairs[k]));
+				acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(_mm_unpackhi_epi16(r0, r1), cpairs[k]));
+			}
+			_mm_storeu_si128((__m128i *) (tmp + x), _mm_srai_epi32(_mm_add_epi32(acc_lo, round), RESCALE_COEF_BITS-RESCALE_INTER_BITS));
+			_mm_storeu_si128((__m128i *) (tmp + x + 4), _mm_srai_epi32(_mm_add_epi32(acc_hi, round), RESCALE_COEF_BITS-RESCALE_INTER_BITS));
+		}
+	} else {
+		for (; x+16<=width; x+=16) {
+			__m128i acc0 = zero;
+			__m128i acc1 = zero;
+			__m128i acc2 = zero;
+			__m128i acc3 = zero;
+			for (k=0; k<nb_pairs; k++) {
+				__m128i r0 = _mm_loadu_si128((const __m128i *) (rows[2*k] + x));
+				__m128i r1 = _mm_loadu_si128((const __m128i *) (rows[2*k+1] + x));
+				//interleave samples of both rows as 16 bit values
+				__m128i lo = _mm_unpacklo_epi8(r0, r1);
+				__m128i hi = _mm_unpackhi_epi8(r0, r1);
+				acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), cpairs[k]));
+				acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), cpairs[k]));
+				acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), cpairs[k]));
+				acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), cpairs[k]));
+			}
+			_mm_storeu_si128((__m128i *) (tmp + x), _mm_srai_epi32(_mm_add_epi32(acc0, round), RESCALE_COEF_BITS-RESCALE_INTER_BITS));
+			_mm_storeu_si128((__m128i *) (tmp + x + 4), _mm_srai_epi32(_mm_add_epi32(acc1, round), RESCALE_COEF_BITS-RESCALE_INTER_BITS));
+			_mm_storeu_si128((__m128i *) (tmp + x + 8), _mm_srai_epi32(_mm_add_epi32(acc2, round), RESCALE_COEF_BITS-RESCALE_INTER_BITS));
+			_mm_storeu_si128((__m128i *) (tmp + x + 12), _mm_srai_epi32(_mm_add_epi32(acc3, round), RESCALE_COEF_BITS-RESCALE_INTER_BITS));
+		}
+	}
+	for (; x<width; x++) {
+		s32 acc = 0;
+		for (k=0; k<nb_taps; k++) {
+			const u8 *row = src + k*src_stride;
+			acc += coefs[k] * (is_16 ? ((const u16 *)row)[x] : row[x]);
+		}
+		tmp[x] = (acc + (1<<(RESCALE_COEF_BITS-RESCALE_INTER_BITS-1))) >> (RESCALE_COEF_BITS-RESCALE_INTER_BITS);
+	}
+}
+
+//SSE2 horizontal pass, 4 output samples at a time: intermediate values are packed to 16 bits and filtered with madd
+//using the coefficient table padded to a multiple of 8 taps. Only used when the vertical pass cannot produce values
+//out of the 16 bit range (see h_simd), the intermediate row must be readable up to RESCALE_TMP_PAD samples after its end
+static void rescale_horiz_sse2(u8 *dst, u32 step, u32 width, const s32 *tmp, const u32 *pos, const s16 *coefs, u32 nb_taps, u32 shift, u32 max_val, Bool is_16)
+{
+	u32 x, k, p;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi32((1<<shift) >> 1);
+	const __m128i vmax = _mm_set1_epi16((s16) max_val);
+
+	for (x=0; x<width; x+=4) {
+		__m128i acc[4], s01, s23, sum;
+		u32 nb = (width - x < 4) ? width - x : 4;
+		for (p=0; p<4; p++) {
+			//past the end of the row, compute first sample again
+			u32 idx = (p<nb) ? x+p : x;
+			const s32 *t = tmp + pos[idx];
+			const s16 *c = coefs + idx*nb_taps;
+			acc[p] = zero;
+			for (k=0; k<nb_taps; k+=8) {
+				__m128i v = _mm_packs_epi32(_mm_loadu_si128((const __m128i *) (t+k)), _mm_loadu_si128((const __m128i *) (t+k+4)));
+				acc[p] = _mm_add_epi32(acc[p], _mm_madd_epi16(v, _mm_loadu_si128((const __m128i *) (c+k))));
+			}
+		}
+		//transpose and sum partial results of the 4 samples
+		s01 = _mm_add_epi32(_mm_unpacklo_epi32(acc[0], acc[1]), _mm_unpackhi_epi32(acc[0], acc[1]));
+		s23 = _mm_add_epi32(_mm_unpacklo_epi32(acc[2], acc[3]), _mm_unpackhi_epi32(acc[2], acc[3]));
+		sum = _mm_add_epi32(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+		sum = _mm_srai_epi32(_mm_add_epi32(sum, round), shift);
+		//clamp to [0, max_val], max_val is below the 16 bit saturation of packs
+		sum = _mm_packs_epi32(sum, sum);
+		sum = _mm_min_epi16(_mm_max_epi16(sum, zero), vmax);
+
+		if (is_16) {
+			u16 res[8];
+			_mm_storeu_si128((__m128i *) res, sum);
+			if ((step==1) && (nb==4)) memcpy(((u16 *)dst) + x, res, 8);
+			else for (p=0; p<nb; p++) ((u16 *)dst)[(x+p)*step] = res[p];
+		} else {
+			u32 res = (u32) _mm_cvtsi128_si32(_mm_packus_epi16(sum, sum));
+			if ((step==1) && (nb==4)) memcpy(dst + x, &res, 4);
+			else for (p=0; p<nb; p++) dst[(x+p)*step] = (u8) (res >> (8*p));
+		}
+	}
+}
+#endif
+
+static void rescale_comp_rows(RescaleComp *rc, u8 **src_planes, u32 *src_stride, u8 **dst_planes, u32 *dst_stride, u32 src_bits, u32 dst_bits, s32 *tmp, u32 y_start, u32 y_end)
+{
+	u32 y;
+	u32 s_bps = (src_bits>8) ? 2 : 1;
+	u32 d_bps = (dst_bits>8) ? 2 : 1;
+	u32 s_stride = src_stride[rc->src_plane];
+	u32 d_stride = dst_stride[rc->dst_plane];
+
+	for (y=y_start; y<y_end; y++) {
+		u8 *dst = dst_planes[rc->dst_plane] + y*d_stride + rc->dst_offset*d_bps;
+		if (rc->fill) {
+			u32 x;
+			if (d_bps==1) {
+				for (x=0; x<rc->dst_w; x++) dst[x*rc->dst_step] = (u8) rc->fill_val;
+			} else {
+				for (x=0; x<rc->dst_w; x++) ((u16 *)dst)[x*rc->dst_step] = (u16) rc->fill_val;
+			}
+			continue;
+		} else {
+			u32 nb_taps = rc->vtab.nb_taps;
+			const s16 *coefs = rc->vtab.coefs + y*nb_taps;
+			const u8 *src = src_planes[rc->src_plane] + rc->vtab.pos[y]*s_stride + rc->src_offset*s_bps;
+#ifdef GPAC_HAS_SSE2
+			if ((rc->src_step==1) && (nb_taps>1) && (nb_taps<=RESCALE_SIMD_MAX_TAPS) && (src_bits<16))
+				rescale_vert_sse2(tmp, src, s_stride, rc->src_w, coefs, nb_taps, (s_bps==2) ? GF_TRUE : GF_FALSE);
+			else
+#endif
+			if (s_bps==1)
+				rescale_vert_8(tmp, src, s_stride, rc->src_step, rc->src_w, coefs, nb_taps);
+			else
+				rescale_vert_16(tmp, src, s_stride, rc->src_step, rc->src_w, coefs, nb_taps);
+
+#ifdef GPAC_HAS_SSE2
+			if (rc->h_simd)
+				rescale_horiz_sse2(dst, rc->dst_step, rc->dst_w, tmp, rc->htab.pos, rc->htab.simd_coefs, rc->htab.simd_taps, rc->shift, rc->max_val, (d_bps==2) ? GF_TRUE : GF_FALSE);
+			else
+#endif
+			if (d_bps==1)
+				rescale_horiz_8(dst, rc->dst_step, rc->dst_w, tmp, rc->htab.pos, rc->htab.coefs, rc->htab.nb_taps, rc->shift, rc->max_val);
+			else
+				rescale_horiz_16(dst, rc->dst_step, rc->dst_w, tmp, rc->htab.pos, rc->htab.coefs, rc->htab.nb_taps, rc->shift, rc->max_val);
+		}
+	}
+}
+
+static void rescale_process_band(GF_RescaleCtx *ctx, RescaleBand *band)
+{
+	u32 i;
+	const RescaleFormat *dfmt = ctx->use_inter ? rescale_get_format(GF_PIXEL_YUV444) : ctx->dst_fmt;
+	u8 **dst_planes = ctx->use_inter ? ctx->out_planes : ctx->dst_planes;
+	u32 inter_stride[5];
+
+	if (ctx->use_inter) {
+		inter_stride[0] = inter_stride[1] = inter_stride[2] = ctx->inter_stride;
+	}
+
+	for (i=0; i<4; i++) {
+		u32 y_start, y_end;
+		RescaleComp *rc = &ctx->comps[i];
+		if (!rc->active) continue;
+
+		y_start = band->y_start >> rc->dst_sub_y;
+		y_end = (band->y_end == ctx->oh) ? rc->dst_h : (band->y_end >> rc->dst_sub_y);
+		rescale_comp_rows(rc, ctx->src_planes, ctx->src_stride, dst_planes, ctx->use_inter ? inter_stride : ctx->dst_stride, ctx->src_fmt->bits, dfmt->bits, band->tmp, y_start, y_end);
+	}
+
+	if (ctx->use_inter) {
+		GF_VideoSurface src, dst;
+		u32 nb_rows = band->y_end - band->y_start;
+		if (!nb_rows) return;
+
+		memset(&src, 0, sizeof(GF_VideoSurface));
+		src.width = ctx->ow;
+		src.height = nb_rows;
+		src.pitch_y = ctx->inter_stride;
+		src.pixel_format = GF_PIXEL_YUV444;
+		src.video_buffer = ctx->out_planes[0] + band->y_start * ctx->inter_stride;
+		src.u_ptr = ctx->out_planes[1] + band->y_start * ctx->inter_stride;
+		src.v_ptr = ctx->out_planes[2] + band->y_start * ctx->inter_stride;
+
+		memset(&dst, 0, sizeof(GF_VideoSurface));
+		dst.width = ctx->ow;
+		dst.height = nb_rows;
+		dst.pitch_y = ctx->dst_stride[0];
+		dst.pixel_format = ctx->o_pfmt;
+		dst.video_buffer = ctx->dst_planes[0] + band->y_start * ctx->dst_stride[0];
+		gf_stretch_bits(&dst, &src, NULL, NULL, 0xFF, GF_FALSE, NULL, NULL);
+
+		if (ctx->inter_alpha.active) {
+			rescale_comp_rows(&ctx->inter_alpha, ctx->src_planes, ctx->src_stride, ctx->dst_planes, ctx->dst_stride, ctx->src_fmt->bits, 8, band->tmp, band->y_start, band->y_end);
+		}
+	}
+	//set padding bytes of output
+	else if (ctx->dst_fmt->pad != RESCALE_NONE) {
+		u32 y, x;
+		for (y=band->y_start; y<band->y_end; y++) {
+			u8 *dst = ctx->dst_planes[0] + y*ctx->dst_stride[0] + ctx->dst_fmt->pad;
+			for (x=0; x<ctx->ow; x++) dst[4*x] = 0xFF;
+		}
+	}
+}
+
+static u32 rescale_band_proc(void *par)
+{
+	RescaleBand *band = (RescaleBand *)par;
+	while (1) {
+		gf_sema_wait(band->start);
+		if (band->ctx->bands_exit) break;
+		rescale_process_band(band->ctx, band);
+		gf_sema_notify(band->ctx->bands_done, 1);
+	}
+	return 0;
+}
+
+static void rescale_setup_planes(u8 **planes, u8 *data, u32 nb_planes, u32 *stride, u32 height, u32 uv_height)
+{
+	memset(planes, 0, sizeof(u8 *) * 5);
+	planes[0] = data;
+	if (nb_planes>=2) planes[1] = planes[0] + stride[0] * height;
+	if (nb_planes>=3) planes[2] = planes[1] + stride[1] * uv_height;
+	if (nb_planes>=4) planes[3] = planes[2] + stride[2] * uv_height;
+}
+
+static GF_Err rescale_process(GF_Filter *filter)
+{
+	const char *data;
+	u8 *output;
+	u32 i, size;
+	u64 clock;
+	GF_FilterPacket *dst_pck;
+	GF_FilterFrameInterface *frame_ifce;
+	GF_RescaleCtx *ctx = gf_filter_get_udta(filter);
+	GF_FilterPacket *pck = gf_filter_pid_get_packet(ctx->ipid);
+
+	if (!pck) {
+		if (gf_filter_pid_is_eos(ctx->ipid)) {
+			gf_filter_pid_set_eos(ctx->opid);
+			return GF_EOS;
+		}
+		return GF_OK;
+	}
+
+	if (ctx->passthrough) {
+		gf_filter_pck_forward(pck, ctx->opid);
+		gf_filter_pid_drop_packet(ctx->ipid);
+		return GF_OK;
+	}
+	//not yet configured
+	if (!ctx->src_fmt || !ctx->dst_fmt)
+		return GF_OK;
+
+	data = gf_filter_pck_get_data(pck, &size);
+	frame_ifce = gf_filter_pck_get_frame_interface(pck);
+	//we may have bigger input (padding) but shall not have smaller
+	if (data && (ctx->out_src_size > size) ) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_MEDIA, ("[Rescale] Mismatched in source size, expected %d got %d - stride issue ?\n", ctx->out_src_size, size));
+		gf_filter_pid_drop_packet(ctx->ipid);
+		return GF_NOT_SUPPORTED;
+	}
+
+	if (data) {
+		rescale_setup_planes(ctx->src_planes, (u8 *) data, ctx->nb_src_planes, ctx->src_stride, ctx->h, ctx->src_uv_height);
+	} else if (frame_ifce && frame_ifce->get_plane) {
+		memset(ctx->src_planes, 0, sizeof(ctx->src_planes));
+		for (i=0; i<ctx->nb_src_planes; i++) {
+			if (frame_ifce->get_plane(frame_ifce, i, (const u8 **) &ctx->src_planes[i], &ctx->src_stride[i])!=GF_OK)
+				break;
+		}
+	} else {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_MEDIA, ("[Rescale] No data associated with packet, not supported\n"));
+		gf_filter_pid_drop_packet(ctx->ipid);
+		return GF_NOT_SUPPORTED;
+	}
+
+	dst_pck = gf_filter_pck_new_alloc(ctx->opid, ctx->out_size, &output);
+	if (!dst_pck) {
+		gf_filter_pid_drop_packet(ctx->ipid);
+		return GF_OUT_OF_MEM;
+	}
+	gf_filter_pck_merge_properties(pck, dst_pck);
+	rescale_setup_planes(ctx->dst_planes, output, ctx->nb_planes, ctx->dst_stride, ctx->oh, ctx->dst_uv_height);
+
+	clock = gf_sys_clock_high_res();
+	//bands 1 and more on worker threads, band 0 on the filter thread
+	for (i=1; i<ctx->nb_bands; i++) {
+		gf_sema_notify(ctx->bands[i].start, 1);
+	}
+	rescale_process_band(ctx, &ctx->bands[0]);
+	for (i=1; i<ctx->nb_bands; i++) {
+		gf_sema_wait(ctx->bands_done);
+	}
+	ctx->process_time_us += gf_sys_clock_high_res() - clock;
+	ctx->nb_frames++;
+
+	gf_filter_pck_send(dst_pck);
+	gf_filter_pid_drop_packet(ctx->ipid);
+	return GF_OK;
+}
+
+//number of samples of a component fitting in a row, some formats have chroma strides smaller than the chroma width for odd widths
+static u32 rescale_max_samples(u32 stride, u32 bits, u32 offset, u32 step)
+{
+	u32 nb = (bits>8) ? stride/2 : stride;
+	if (nb <= offset) return 0;
+	return (nb - offset + step - 1) / step;
+}
+
+static GF_Err rescale_setup_comp(GF_RescaleCtx *ctx, RescaleComp *rc, u32 c, const RescaleFormat *sfmt, const RescaleFormat *dfmt, u32 *dst_stride)
+{
+	u32 max_w;
+	GF_Err e;
+	memset(&rc->htab, 0, sizeof(RescaleTable));
+	memset(&rc->vtab, 0, sizeof(RescaleTable));
+	rc->active = rc->fill = rc->h_simd = GF_FALSE;
+	if (dfmt->plane[c] == RESCALE_NONE) return GF_OK;
+
+	rc->active = GF_TRUE;
+	rc->dst_plane = dfmt->plane[c];
+	rc->dst_offset = dfmt->offset[c];
+	rc->dst_step = dfmt->step[c];
+	rc->dst_sub_y = dfmt->sub_y[c];
+	rc->dst_w = (ctx->ow + (1<<dfmt->sub_x[c]) - 1) >> dfmt->sub_x[c];
+	rc->dst_h = (rc->dst_plane && dfmt->sub_y[c]) ? ctx->dst_uv_height : ctx->oh;
+	max_w = rescale_max_samples(dst_stride[rc->dst_plane], dfmt->bits, rc->dst_offset, rc->dst_step);
+	if (rc->dst_w > max_w) rc->dst_w = max_w;
+	rc->max_val = (1<<dfmt->bits) - 1;
+
+	if (sfmt->plane[c] == RESCALE_NONE) {
+		rc->fill = GF_TRUE;
+		//missing alpha is opaque, missing chroma is grey
+		rc->fill_val = (c==3) ? rc->max_val : (1<<(dfmt->bits-1));
+		return GF_OK;
+	}
+	rc->src_plane = sfmt->plane[c];
+	rc->src_offset = sfmt->offset[c];
+	rc->src_step = sfmt->step[c];
+	rc->src_w = (ctx->w + (1<<sfmt->sub_x[c]) - 1) >> sfmt->sub_x[c];
+	rc->src_h = (rc->src_plane && sfmt->sub_y[c]) ? ctx->src_uv_height : ctx->h;
+	max_w = rescale_max_samples(ctx->src_stride[rc->src_plane], sfmt->bits, rc->src_offset, rc->src_step);
+	if (rc->src_w > max_w) rc->src_w = max_w;
+	rc->shift = RESCALE_COEF_BITS + RESCALE_INTER_BITS + sfmt->bits - dfmt->bits;
+	if (rc->src_w > ctx->max_src_w) ctx->max_src_w = rc->src_w;
+
+	e = rescale_table_setup(&rc->htab, ctx->scale, rc->src_w, rc->dst_w);
+	if (!e) e = rescale_table_setup(&rc->vtab, ctx->scale, rc->src_h, rc->dst_h);
+
+#ifdef GPAC_HAS_SSE2
+	//8 bit samples filtered vertically stay on 16 bits unless the vertical coefficients overshoot too much
+	//taps are padded to 8, below 7 taps the padding costs more than the scalar loop
+	if (!e && (sfmt->bits==8) && (rc->htab.nb_taps>6)) {
+		u32 i, k, max_sum = 0;
+		for (i=0; i<rc->vtab.dst_len; i++) {
+			u32 sum = 0;
+			const s16 *coefs = rc->vtab.coefs + i*rc->vtab.nb_taps;
+			for (k=0; k<rc->vtab.nb_taps; k++) sum += ABS(coefs[k]);
+			if (sum > max_sum) max_sum = sum;
+		}
+		if (255 * max_sum + (1<<(RESCALE_COEF_BITS-RESCALE_INTER_BITS-1)) < (32768 << (RESCALE_COEF_BITS-RESCALE_INTER_BITS))) {
+			RescaleTable *tab = &rc->htab;
+			tab->simd_taps = (tab->nb_taps + 7) & ~7;
+			tab->simd_coefs = gf_malloc(sizeof(s16) * tab->simd_taps * tab->dst_len);
+			if (!tab->simd_coefs) return GF_OUT_OF_MEM;
+			memset(tab->simd_coefs, 0, sizeof(s16) * tab->simd_taps * tab->dst_len);
+			for (i=0; i<tab->dst_len; i++)
+				memcpy(tab->simd_coefs + i*tab->simd_taps, tab->coefs + i*tab->nb_taps, sizeof(s16) * tab->nb_taps);
+			rc->h_simd = GF_TRUE;
+		}
+	}
+#endif
+	return e;
+}
+
+static void rescale_reset_comps(GF_RescaleCtx *ctx)
+{
+	u32 i;
+	for (i=0; i<4; i++) {
+		rescale_table_reset(&ctx->comps[i].htab);
+		rescale_table_reset(&ctx->comps[i].vtab);
+	}
+	rescale_table_reset(&ctx->inter_alpha.htab);
+	rescale_table_reset(&ctx->inter_alpha.vtab);
+}
+
+static GF_Err rescale_setup(GF_RescaleCtx *ctx)
+{
+	u32 i;
+	u32 inter_stride[5];
+	GF_Err e;
+	const RescaleFormat *dfmt;
+
+	rescale_reset_comps(ctx);
+	ctx->max_src_w = 0;
+	ctx->use_inter = GF_FALSE;
+	dfmt = ctx->dst_fmt;
+	if (ctx->src_fmt->is_rgb != ctx->dst_fmt->is_rgb) {
+		if (ctx->src_fmt->is_rgb) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_MEDIA, ("[Rescale] RGB to YUV conversion not supported\n"));
+			return GF_NOT_SUPPORTED;
+		}
+		ctx->use_inter = GF_TRUE;
+		dfmt = rescale_get_format(GF_PIXEL_YUV444);
+		//make sure gf_stretch_bits can read an extra column and row
+		ctx->inter_stride = ctx->ow + 1;
+		ctx->inter_size = ctx->inter_stride * (ctx->oh + 1) * 3;
+		ctx->inter = gf_realloc(ctx->inter, ctx->inter_size);
+		if (!ctx->inter) return GF_OUT_OF_MEM;
+		memset(ctx->inter, 0, ctx->inter_size);
+		ctx->out_planes[0] = ctx->inter;
+		ctx->out_planes[1] = ctx->inter + ctx->inter_stride * (ctx->oh + 1);
+		ctx->out_planes[2] = ctx->inter + 2 * ctx->inter_stride * (ctx->oh + 1);
+		for (i=0; i<5; i++) inter_stride[i] = ctx->inter_stride;
+	}
+
+	for (i=0; i<4; i++) {
+		e = rescale_setup_comp(ctx, &ctx->comps[i], i, ctx->src_fmt, dfmt, ctx->use_inter ? inter_stride : ctx->dst_stride);
+		if (e) return e;
+	}
+	if (ctx->use_inter) {
+		//the intermediate frame has no alpha, scale it directly in the output frame
+		e = rescale_setup_comp(ctx, &ctx->inter_alpha, 3, ctx->src_fmt, ctx->dst_fmt, ctx->dst_stride);
+		if (e) return e;
+		//conversion already sets alpha to opaque
+		if (ctx->inter_alpha.fill) ctx->inter_alpha.active = GF_FALSE;
+	}
+
+	for (i=0; i<ctx->nb_bands; i++) {
+		RescaleBand *band = &ctx->bands[i];
+		//bands start on even rows so that subsampled chroma rows are not shared between bands
+		band->y_start = (ctx->oh * i / ctx->nb_bands) & ~1;
+		band->y_end = (i+1==ctx->nb_bands) ? ctx->oh : ((ctx->oh * (i+1) / ctx->nb_bands) & ~1);
+		band->tmp = gf_realloc(band->tmp, sizeof(s32) * (ctx->max_src_w + RESCALE_TMP_PAD));
+		if (!band->tmp) return GF_OUT_OF_MEM;
+		memset(band->tmp, 0, sizeof(s32) * (ctx->max_src_w + RESCALE_TMP_PAD));
+	}
+	return GF_OK;
+}
+
+static GF_Err rescale_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_remove)
+{
+	const GF_PropertyValue *p;
+	u32 w, h, stride, stride_uv, pfmt;
+	GF_Fraction sar;
+	GF_RescaleCtx *ctx = gf_filter_get_udta(filter);
+
+	if (is_remove) {
+		if (ctx->opid) {
+			gf_filter_pid_remove(ctx->opid);
+		}
+		return GF_OK;
+	}
+	if (! gf_filter_pid_check_caps(pid))
+		return GF_NOT_SUPPORTED;
+
+	if (!ctx->opid) {
+		ctx->opid = gf_filter_pid_new(filter);
+	}
+	if (!ctx->ipid) {
+		ctx->ipid = pid;
+	}
+
+	w = h = pfmt = stride = stride_uv = 0;
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_WIDTH);
+	if (p) w = p->value.uint;
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_HEIGHT);
+	if (p) h = p->value.uint;
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_STRIDE);
+	if (p) stride = p->value.uint;
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_STRIDE_UV);
+	if (p) stride_uv = p->value.uint;
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_PIXFMT);
+	if (p) pfmt = p->value.uint;
+	p = gf_filter_pid_get_property(pid, GF_PROP_PID_SAR);
+	if (p) sar = p->value.frac;
+	else sar.den = sar.num = 1;
+
+	if (!w || !h || !pfmt) {
+		return GF_OK;
+	}
+	//copy properties at init or reconfig
+	gf_filter_pid_copy_properties(ctx->opid, ctx->ipid);
+
+	ctx->o_pfmt = ctx->ofmt ? ctx->ofmt : pfmt;
+	ctx->ow = ctx->osize.x ? ctx->osize.x : w;
+	ctx->oh = ctx->osize.y ? ctx->osize.y : h;
+	ctx->passthrough = GF_FALSE;
+	//packed YUV 4:2:2 needs an even width
+	switch (ctx->o_pfmt) {
+	case GF_PIXEL_YUYV:
+	case GF_PIXEL_YVYU:
+	case GF_PIXEL_UYVY:
+	case GF_PIXEL_VYUY:
+		if (ctx->ow % 2) ctx->ow++;
+		break;
+	}
+
+	if ((ctx->ow == w) && (ctx->oh == h) && (ctx->o_pfmt == pfmt)) {
+		memset(ctx->dst_stride, 0, sizeof(ctx->dst_stride));
+		ctx->dst_stride[0] = stride;
+		ctx->dst_stride[1] = stride_uv;
+		gf_pixel_get_size_info(pfmt, w, h, &ctx->out_size, &ctx->dst_stride[0], &ctx->dst_stride[1], &ctx->nb_planes, &ctx->dst_uv_height);
+		ctx->passthrough = GF_TRUE;
+	} else {
+		Bool res;
+		GF_Err e;
+		ctx->src_fmt = rescale_get_format(pfmt);
+		ctx->dst_fmt = rescale_get_format(ctx->o_pfmt);
+		if (!ctx->src_fmt || !ctx->dst_fmt) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_MEDIA, ("[Rescale] Unsupported %s pixel format %s\n", ctx->src_fmt ? "output" : "input", gf_pixel_fmt_name(ctx->src_fmt ? ctx->o_pfmt : pfmt) ));
+			ctx->src_fmt = ctx->dst_fmt = NULL;
+			return GF_NOT_SUPPORTED;
+		}
+
+		//get layout info for source
+		memset(ctx->src_stride, 0, sizeof(ctx->src_stride));
+		ctx->src_stride[0] = stride;
+		ctx->src_stride[1] = stride_uv;
+		res = gf_pixel_get_size_info(pfmt, w, h, &ctx->out_src_size, &ctx->src_stride[0], &ctx->src_stride[1], &ctx->nb_src_planes, &ctx->src_uv_height);
+		if (!res) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_MEDIA, ("[Rescale] Failed to query source pixel format characteristics\n"));
+			return GF_NOT_SUPPORTED;
+		}
+		if (ctx->nb_src_planes==3) ctx->src_stride[2] = ctx->src_stride[1];
+		if (ctx->nb_src_planes==4) {
+			ctx->src_stride[2] = ctx->src_stride[1];
+			ctx->src_stride[3] = ctx->src_stride[0];
+		}
+
+		//get layout info for dest
+		memset(ctx->dst_stride, 0, sizeof(ctx->dst_stride));
+		res = gf_pixel_get_size_info(ctx->o_pfmt, ctx->ow, ctx->oh, &ctx->out_size, &ctx->dst_stride[0], &ctx->dst_stride[1], &ctx->nb_planes, &ctx->dst_uv_height);
+		if (!res) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_MEDIA, ("[Rescale] Failed to query output pixel format characteristics\n"));
+			return GF_NOT_SUPPORTED;
+		}
+		if (ctx->nb_planes==3) ctx->dst_stride[2] = ctx->dst_stride[1];
+		if (ctx->nb_planes==4) {
+			ctx->dst_stride[2] = ctx->dst_stride[1];
+			ctx->dst_stride[3] = ctx->dst_stride[0];
+		}
+
+		ctx->w = w;
+		ctx->h = h;
+		ctx->s_pfmt = pfmt;
+		ctx->stride = stride;
+		ctx->stride_uv = stride_uv;
+		e = rescale_setup(ctx);
+		if (e) {
+			ctx->src_fmt = ctx->dst_fmt = NULL;
+			return e;
+		}
+		GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[Rescale] Setup rescaler from %dx%d fmt %s to %dx%d fmt %s using %d bands\n", w, h, gf_pixel_fmt_name(pfmt), ctx->ow, ctx->oh, gf_pixel_fmt_name(ctx->o_pfmt), ctx->nb_bands));
+	}
+
+	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_WIDTH, &PROP_UINT(ctx->ow));
+	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_HEIGHT, &PROP_UINT(ctx->oh));
+	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_STRIDE, &PROP_UINT(ctx->dst_stride[0]));
+	if (ctx->nb_planes>1)
+		gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_STRIDE_UV, &PROP_UINT(ctx->dst_stride[1]));
+	else
+		gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_STRIDE_UV, NULL);
+
+	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_CODECID, &PROP_UINT(GF_CODECID_RAW));
+	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_PIXFMT, &PROP_UINT(ctx->o_pfmt));
+	gf_filter_pid_set_property(ctx->opid, GF_PROP_PID_SAR, &PROP_FRAC(sar) );
+
+	//an access unit corresponds to a single packet
+	gf_filter_pid_set_framing_mode(pid, GF_TRUE);
+	return GF_OK;
+}
+
+static GF_Err rescale_reconfigure_output(GF_Filter *filter, GF_FilterPid *pid)
+{
+	const GF_PropertyValue *p;
+	GF_RescaleCtx *ctx = gf_filter_get_udta(filter);
+	if (ctx->opid != pid) return GF_BAD_PARAM;
+
+	p = gf_filter_pid_caps_query(pid, GF_PROP_PID_WIDTH);
+	if (p) ctx->osize.x = p->value.uint;
+
+	p = gf_filter_pid_caps_query(pid, GF_PROP_PID_HEIGHT);
+	if (p) ctx->osize.y = p->value.uint;
+
+	p = gf_filter_pid_caps_query(pid, GF_PROP_PID_PIXFMT);
+	if (p) ctx->ofmt = p->value.uint;
+	return rescale_configure_pid(filter, ctx->ipid, GF_FALSE);
+}
+
+static GF_Err rescale_initialize(GF_Filter *filter)
+{
+	u32 i;
+	GF_RescaleCtx *ctx = gf_filter_get_udta(filter);
+
+	ctx->nb_bands = ctx->threads + 1;
+	ctx->bands = gf_malloc(sizeof(RescaleBand) * ctx->nb_bands);
+	if (!ctx->bands) return GF_OUT_OF_MEM;
+	memset(ctx->bands, 0, sizeof(RescaleBand) * ctx->nb_bands);
+	ctx->bands[0].ctx = ctx;
+
+	if (ctx->threads) {
+		ctx->bands_done = gf_sema_new(ctx->threads, 0);
+		for (i=1; i<ctx->nb_bands; i++) {
+			RescaleBand *band = &ctx->bands[i];
+			band->ctx = ctx;
+			band->start = gf_sema_new(1, 0);
+			band->th = gf_th_new("RescaleBand");
+			gf_th_run(band->th, rescale_band_proc, band);
+		}
+	}
+	return GF_OK;
+}
+
+static void rescale_finalize(GF_Filter *filter)
+{
+	u32 i;
+	GF_RescaleCtx *ctx = gf_filter_get_udta(filter);
+
+	if (ctx->nb_frames && ctx->process_time_us) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_MEDIA, ("[Rescale] Processed "LLU" frames in "LLU" ms - %.02f FPS\n", ctx->nb_frames, ctx->process_time_us/1000, ((Double) ctx->nb_frames) * 1000000 / ctx->process_time_us));
+	}
+	if (ctx->bands) {
+		ctx->bands_exit = GF_TRUE;
+		for (i=1; i<ctx->nb_bands; i++) {
+			gf_sema_notify(ctx->bands[i].start, 1);
+		}
+		for (i=0; i<ctx->nb_bands; i++) {
+			RescaleBand *band = &ctx->bands[i];
+			if (band->th) gf_th_del(band->th);
+			if (band->start) gf_sema_del(band->start);
+			if (band->tmp) gf_free(band->tmp);
+		}
+		gf_free(ctx->bands);
+	}
+	if (ctx->bands_done) gf_sema_del(ctx->bands_done);
+	rescale_reset_comps(ctx);
+	if (ctx->inter) gf_free(ctx->inter);
+}
+
+#define OFFS(_n)	#_n, offsetof(GF_RescaleCtx, _n)
+static GF_FilterArgs RescaleArgs[] =
+{
+	{ OFFS(osize), "size of output video. When not set, input size is used", GF_PROP_VEC2I, NULL, NULL, 0},
+	{ OFFS(ofmt), "pixel format for output video. When not set, input format is used", GF_PROP_PIXFMT, "none", NULL, 0},
+	{ OFFS(scale), "scaling mode\n"
+	"- point: nearest neighbour\n"
+	"- bilinear: bilinear interpolation\n"
+	"- bicubic: bicubic interpolation\n"
+	"- lanczos: lanczos interpolation with 3 lobes", GF_PROP_UINT, "bicubic", "point|bilinear|bicubic|lanczos", GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(threads), "number of worker threads, each processing a horizontal band of the output frame. 0 processes the whole frame on the filter thread", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{0}
+};
+
+static const GF_FilterCapability RescaleCaps[] =
+{
+	CAP_UINT(GF_CAPS_INPUT_OUTPUT,GF_PROP_PID_STREAM_TYPE, GF_STREAM_VISUAL),
+	CAP_UINT(GF_CAPS_INPUT_OUTPUT,GF_PROP_PID_CODECID, GF_CODECID_RAW)
+};
+
+GF_FilterRegister RescaleRegister = {
+	.name = "rescale",
+	GF_FS_SET_DESCRIPTION("Video rescaler")
+	GF_FS_SET_HELP("This filter rescales raw video frames and converts their pixel format without external libraries.\n"
+	"Scaling is done by separable filters in fixed point, vertical then horizontal, on each component of the frame.\n"
+	"Conversions between YUV formats (planar, semi-planar, packed, 8 and 10 bits) and between RGB formats are done while scaling. "
+	"YUV to RGB conversion is done by scaling in YUV 4:4:4 and converting the result. RGB to YUV conversion is not supported.\n"
+	"The output frame can be split in [-threads]()+1 horizontal bands processed in parallel.\n"
+	"Throughput is logged when the filter is destroyed, using `-logs=media@info`.\n"
+	"This filter is only loaded when explicitly set in the chain.")
+	.private_size = sizeof(GF_RescaleCtx),
+	.flags = GF_FS_REG_EXPLICIT_ONLY,
+	.args = RescaleArgs,
+	.initialize = rescale_initialize,
+	.configure_pid = rescale_configure_pid,
+	SETCAPS(RescaleCaps),
+	.finalize = rescale_finalize,
+	.process = rescale_process,
+	.reconfigure_output = rescale_reconfigure_output,
+};
+
+
+const GF_FilterRegister *rescale_register(GF_FilterSession *session)
+{
+	RescaleArgs[1].min_max_enum = gf_pixel_fmt_all_names();
+	return &RescaleRegister;
+}
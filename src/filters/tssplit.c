@@ -150,23 +150,28 @@ static Bool m2tssplit_process_event(GF_Filter *filter, const GF_FilterEvent *evt
 	return GF_FALSE;
 }
 
+//max number of input packets processed per call
+#define M2TSSPLIT_MAX_BATCH	32
+
 GF_Err m2tssplit_process(GF_Filter *filter)
 {
 	GF_M2TSSplitCtx *ctx = gf_filter_get_udta(filter);
-	GF_FilterPacket *pck;
+	GF_FilterPacket *pcks[M2TSSPLIT_MAX_BATCH];
 	const u8 *data;
-	u32 data_size;
-	pck = gf_filter_pid_get_packet(ctx->ipid);
-	if (!pck) {
+	u32 i, data_size, nb_pcks;
+	nb_pcks = gf_filter_pid_get_packets(ctx->ipid, pcks, M2TSSPLIT_MAX_BATCH);
+	if (!nb_pcks) {
 		if (gf_filter_pid_is_eos(ctx->ipid))
 			m2tssplit_flush(ctx);
 		return GF_OK;
 	}
-	data = gf_filter_pck_get_data(pck, &data_size);
-	if (data) {
-		gf_m2ts_process_data(ctx->dmx, (u8 *)data, data_size);
+	for (i=0; i<nb_pcks; i++) {
+		data = gf_filter_pck_get_data(pcks[i], &data_size);
+		if (data) {
+			gf_m2ts_process_data(ctx->dmx, (u8 *)data, data_size);
+		}
 	}
-	gf_filter_pid_drop_packet(ctx->ipid);
+	gf_filter_pid_drop_packets(ctx->ipid, nb_pcks);
 	return GF_OK;
 }
 
@@ -51,45 +51,8 @@ typedef struct
 	u32 dst_width, dst_height;
 	s32 src_x, src_y;
 	Bool packed_422;
-
-	GF_List *frames, *frames_res;
 } GF_VCropCtx;
 
-typedef struct
-{
-	GF_FilterFrameInterface frame_ifce;
-
-	//reference to the source packet
-	GF_FilterPacket *pck;
-	u8 *planes[5];
-	u32 stride[5];
-
-	GF_VCropCtx *ctx;
-} GF_VCropFrame;
-
-
-GF_Err vcrop_frame_get_plane(GF_FilterFrameInterface *frame, u32 plane_idx, const u8 **outPlane, u32 *outStride)
-{
-	GF_VCropFrame *vframe = frame->user_data;
-
-	if (plane_idx>=vframe->ctx->nb_planes) return GF_BAD_PARAM;
-	if (outPlane) *outPlane = vframe->planes[plane_idx];
-	if (outStride) *outStride = vframe->stride[plane_idx];
-	return GF_OK;
-}
-
-void vcrop_packet_destruct(GF_Filter *filter, GF_FilterPid *pid, GF_FilterPacket *pck)
-{
-	GF_VCropFrame *vframe;
-	GF_FilterFrameInterface *frame_ifce = gf_filter_pck_get_frame_interface(pck);
-	if (!frame_ifce) return;
-	vframe = frame_ifce->user_data;
-	assert(vframe->pck);
-	gf_filter_pck_unref(vframe->pck);
-	vframe->pck = NULL;
-	gf_list_add(vframe->ctx->frames_res, vframe);
-}
-
 
 static GF_Err vcrop_process(GF_Filter *filter)
 {
@@ -180,40 +143,34 @@ static GF_Err vcrop_process(GF_Filter *filter)
 	}
 
 	if (ctx->use_reference) {
-		GF_VCropFrame *vframe = gf_list_pop_back(ctx->frames_res);
-		if (!vframe) {
-			GF_SAFEALLOC(vframe, GF_VCropFrame);
-			if (!vframe) return GF_OUT_OF_MEM;
-		}
-		vframe->ctx = ctx;
-		memcpy(vframe->stride, ctx->src_stride, sizeof(vframe->stride));
+		u8 *view_planes[4];
+		memset(view_planes, 0, sizeof(view_planes));
 		if (ctx->packed_422) {
-			vframe->planes[0] = src_planes[0] + s_off_x * bps * 2 + ctx->src_stride[0] * s_off_y;
+			view_planes[0] = src_planes[0] + s_off_x * bps * 2 + ctx->src_stride[0] * s_off_y;
 		} else {
-			vframe->planes[0] = src_planes[0] + s_off_x * bps + ctx->src_stride[0] * s_off_y;
+			view_planes[0] = src_planes[0] + s_off_x * bps + ctx->src_stride[0] * s_off_y;
 		}
 		//nv12/21
 		if (ctx->nb_planes==2) {
-			vframe->planes[1] = src_planes[1] + s_off_x * bps + ctx->src_stride[1] * s_off_y/2;
+			view_planes[1] = src_planes[1] + s_off_x * bps + ctx->src_stride[1] * s_off_y/2;
 		} else if (ctx->nb_planes>=3) {
 			u32 div_x, div_y;
 			//alpha/depth/other plane, treat as luma plane
 			if (ctx->nb_planes==4) {
-				vframe->planes[3] = src_planes[3] + s_off_x * bps + ctx->src_stride[3] * s_off_y;
+				view_planes[3] = src_planes[3] + s_off_x * bps + ctx->src_stride[3] * s_off_y;
 			}
 			div_x = (ctx->src_stride[1]==ctx->src_stride[0]) ? 1 : 2;
 			div_y = (ctx->src_uv_height==ctx->h) ? 1 : 2;
 
-			vframe->planes[1] = src_planes[1] + s_off_x * bps / div_x + ctx->src_stride[1] * s_off_y / div_y;
-			vframe->planes[2] =src_planes[2] + s_off_x * bps / div_x + ctx->src_stride[2] * s_off_y / div_y;
+			view_planes[1] = src_planes[1] + s_off_x * bps / div_x + ctx->src_stride[1] * s_off_y / div_y;
+			view_planes[2] = src_planes[2] + s_off_x * bps / div_x + ctx->src_stride[2] * s_off_y / div_y;
+		}
+		//the view keeps a reference to the input packet
+		dst_pck = gf_filter_pck_new_frame_view(ctx->opid, pck, ctx->nb_planes, view_planes, ctx->src_stride);
+		if (!dst_pck) {
+			gf_filter_pid_drop_packet(ctx->ipid);
+			return GF_OUT_OF_MEM;
 		}
-		vframe->frame_ifce.user_data = vframe;
-		vframe->frame_ifce.get_plane = vcrop_frame_get_plane;
-		dst_pck = gf_filter_pck_new_frame_interface(ctx->opid, &vframe->frame_ifce, vcrop_packet_destruct);
-		//keep a ref to input packet
-		vframe->pck = pck;
-		gf_filter_pck_ref(&vframe->pck);
-		gf_filter_pck_merge_properties(pck, dst_pck);
 		gf_filter_pck_send(dst_pck);
 		//remove input packet
 		gf_filter_pid_drop_packet(ctx->ipid);
@@ -502,11 +459,6 @@ static GF_Err vcrop_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_
 		else if (ctx->src_y + ctx->dst_height > h) ctx->use_reference = GF_FALSE;
 		else ctx->use_reference = ctx->copy ? GF_FALSE : GF_TRUE;
 
-		if (ctx->use_reference) {
-			if (!ctx->frames) ctx->frames = gf_list_new();
-			if (!ctx->frames_res) ctx->frames_res = gf_list_new();
-		}
-
 		//get layout info for source
 		memset(ctx->src_stride, 0, sizeof(ctx->src_stride));
 		if (ctx->stride) ctx->src_stride[0] = ctx->stride;
@@ -564,26 +516,6 @@ static GF_Err vcrop_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_
 	return GF_OK;
 }
 
-void vcrop_finalize(GF_Filter *filter)
-{
-	GF_VCropCtx *ctx = gf_filter_get_udta(filter);
-	if (ctx->frames) {
-		while (gf_list_count(ctx->frames)) {
-			GF_VCropFrame *vframe = gf_list_pop_back(ctx->frames);
-			gf_free(vframe);
-		}
-		gf_list_del(ctx->frames);
-	}
-	if (ctx->frames_res) {
-		while (gf_list_count(ctx->frames_res)) {
-			GF_VCropFrame *vframe = gf_list_pop_back(ctx->frames_res);
-			gf_free(vframe);
-		}
-		gf_list_del(ctx->frames_res);
-	}
-}
-
-
 #define OFFS(_n)	#_n, offsetof(GF_VCropCtx, _n)
 static GF_FilterArgs VCropArgs[] =
 {
@@ -615,7 +547,6 @@ GF_FilterRegister VCropRegister = {
 	.configure_pid = vcrop_configure_pid,
 	SETCAPS(VCropCaps),
 	.process = vcrop_process,
-	.finalize = vcrop_finalize,
 };
 
 
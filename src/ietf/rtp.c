@@ -55,6 +55,8 @@ void gf_rtp_del(GF_RTPChannel *ch)
 	if (ch->net_info.Profile) gf_free(ch->net_info.Profile);
 	if (ch->po) gf_rtp_reorderer_del(ch->po);
 	if (ch->send_buffer) gf_free(ch->send_buffer);
+	if (ch->rcv_batch_buf) gf_free(ch->rcv_batch_buf);
+	if (ch->snd_batch_buf) gf_free(ch->snd_batch_buf);
 
 	if (ch->CName) gf_free(ch->CName);
 	if (ch->s_name) gf_free(ch->s_name);
@@ -123,6 +125,7 @@ void gf_rtp_reset_buffers(GF_RTPChannel *ch)
 	if (ch->rtp) gf_sk_reset(ch->rtp);
 	if (ch->rtcp) gf_sk_reset(ch->rtcp);
 	if (ch->po) gf_rtp_reorderer_reset(ch->po);
+	ch->rcv_batch_count = ch->rcv_batch_pos = 0;
 	ch->first_SR = 1;
 }
 
@@ -374,6 +377,53 @@ u32 gf_rtp_flush_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size)
 	return 0;
 }
 
+static GF_Err rtp_read_batched(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size, u32 *size)
+{
+	GF_Err e;
+	*size = 0;
+	if (ch->rcv_batch_pos == ch->rcv_batch_count) {
+		u32 i;
+		u8 *bufs[GF_RTP_MAX_BATCH];
+		u32 slot = MIN(buffer_size, 0x10000);
+
+		ch->rcv_batch_pos = ch->rcv_batch_count = 0;
+		if (ch->rcv_batch_slot != slot) {
+			ch->rcv_batch_buf = gf_realloc(ch->rcv_batch_buf, slot * ch->rcv_batch_max);
+			if (!ch->rcv_batch_buf) {
+				ch->rcv_batch_slot = 0;
+				return GF_OUT_OF_MEM;
+			}
+			ch->rcv_batch_slot = slot;
+		}
+		for (i=0; i<ch->rcv_batch_max; i++)
+			bufs[i] = ch->rcv_batch_buf + i * slot;
+
+		e = gf_sk_receive_batch(ch->rtp, bufs, slot, ch->rcv_batch_sizes, ch->rcv_batch_max, &ch->rcv_batch_count);
+		if (e) return e;
+	}
+	if (ch->rcv_batch_pos == ch->rcv_batch_count) return GF_IP_NETWORK_EMPTY;
+
+	*size = MIN(ch->rcv_batch_sizes[ch->rcv_batch_pos], buffer_size);
+	memcpy(buffer, ch->rcv_batch_buf + ch->rcv_batch_pos * ch->rcv_batch_slot, *size);
+	ch->rcv_batch_pos++;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_enable_read_batch(GF_RTPChannel *ch, u32 nb_packets)
+{
+	if (!ch) return GF_BAD_PARAM;
+	if (nb_packets > GF_RTP_MAX_BATCH) nb_packets = GF_RTP_MAX_BATCH;
+	if (nb_packets != ch->rcv_batch_max) {
+		//drop any pending packet
+		if (ch->rcv_batch_buf) gf_free(ch->rcv_batch_buf);
+		ch->rcv_batch_buf = NULL;
+		ch->rcv_batch_slot = ch->rcv_batch_count = ch->rcv_batch_pos = 0;
+	}
+	ch->rcv_batch_max = (nb_packets>1) ? nb_packets : 0;
+	return GF_OK;
+}
+
 GF_EXPORT
 u32 gf_rtp_read_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size)
 {
@@ -383,7 +433,10 @@ u32 gf_rtp_read_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size)
 	//only if the socket exist (otherwise RTSP interleaved channel)
 	if (!ch || !ch->rtp) return 0;
 
-	if (ch->no_select) {
+next_pck:
+	if (ch->rcv_batch_max) {
+		e = rtp_read_batched(ch, buffer, buffer_size, &res);
+	} else if (ch->no_select) {
 		e = gf_sk_receive_no_select(ch->rtp, buffer, buffer_size, &res);
 	} else {
 		e = gf_sk_receive(ch->rtp, buffer, buffer_size, &res);
@@ -410,6 +463,10 @@ u32 gf_rtp_read_rtp(GF_RTPChannel *ch, u8 *buffer, u32 buffer_size)
 			memcpy(buffer, pck, res);
 			gf_free(pck);
 		}
+		//packet kept by reorderer, don't leave batched packets behind since the socket may no longer be readable
+		else if (ch->rcv_batch_pos < ch->rcv_batch_count) {
+			goto next_pck;
+		}
 	}
 	/*monitor keep-alive period*/
 	if (ch->nat_keepalive_time_period && !ch->send_interleave) {
@@ -616,6 +673,50 @@ Double gf_rtp_get_current_time(GF_RTPChannel *ch)
 
 
 
+GF_EXPORT
+GF_Err gf_rtp_enable_send_batch(GF_RTPChannel *ch, u32 nb_packets)
+{
+	if (!ch) return GF_BAD_PARAM;
+	if (nb_packets > GF_RTP_MAX_BATCH) nb_packets = GF_RTP_MAX_BATCH;
+	if (nb_packets != ch->snd_batch_max) {
+		gf_rtp_flush_send(ch);
+		if (ch->snd_batch_buf) gf_free(ch->snd_batch_buf);
+		ch->snd_batch_buf = NULL;
+	}
+	ch->snd_batch_max = (nb_packets>1) ? nb_packets : 0;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_set_pacer(GF_RTPChannel *ch, GF_SockPacer *pacer)
+{
+	if (!ch) return GF_BAD_PARAM;
+	gf_rtp_flush_send(ch);
+	ch->sk_pacer = pacer;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_flush_send(GF_RTPChannel *ch)
+{
+	GF_Err e;
+	u32 i, nb_sent=0;
+	const u8 *bufs[GF_RTP_MAX_BATCH];
+	if (!ch) return GF_BAD_PARAM;
+	if (!ch->snd_batch_count) return GF_OK;
+
+	for (i=0; i<ch->snd_batch_count; i++)
+		bufs[i] = ch->snd_batch_buf + i * ch->send_buffer_size;
+
+	e = gf_sk_send_batch(ch->rtp, bufs, ch->snd_batch_sizes, ch->snd_batch_count, &nb_sent);
+	if (e) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_RTP, ("[RTP] Failed to send %d queued packets: %s\n", ch->snd_batch_count - nb_sent, gf_error_to_string(e) ));
+	}
+	//same as unbatched sends, packets failing to be sent are lost
+	ch->snd_batch_count = 0;
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, u8 *pck, u32 pck_size, Bool fast_send)
 {
@@ -665,11 +766,34 @@ GF_Err gf_rtp_send_packet(GF_RTPChannel *ch, GF_RTPHeader *rtp_hdr, u8 *pck, u32
 		}
 	}
 	//copy payload
-	else if (fast_send) {
-		e = gf_sk_send(ch->rtp, hdr, pck_size+12);
-	} else {
-		memcpy(ch->send_buffer + Start, pck, pck_size);
-		e = gf_sk_send(ch->rtp, ch->send_buffer, Start + pck_size);
+	else {
+		u8 *data;
+		u32 size;
+		if (fast_send) {
+			data = hdr;
+			size = pck_size+12;
+		} else {
+			memcpy(ch->send_buffer + Start, pck, pck_size);
+			data = ch->send_buffer;
+			size = Start + pck_size;
+		}
+		if (ch->sk_pacer) {
+			//pacer queue full, the caller shall check gf_sk_pacer_get_free before sending and retry later
+			e = gf_sk_pacer_send(ch->sk_pacer, ch->rtp, data, size, 0);
+		} else if (ch->snd_batch_max) {
+			if (!ch->snd_batch_buf) {
+				ch->snd_batch_buf = gf_malloc(ch->send_buffer_size * ch->snd_batch_max);
+				if (!ch->snd_batch_buf) return GF_OUT_OF_MEM;
+			}
+			memcpy(ch->snd_batch_buf + ch->snd_batch_count * ch->send_buffer_size, data, size);
+			ch->snd_batch_sizes[ch->snd_batch_count] = size;
+			ch->snd_batch_count++;
+			e = GF_OK;
+			if (ch->snd_batch_count == ch->snd_batch_max)
+				e = gf_rtp_flush_send(ch);
+		} else {
+			e = gf_sk_send(ch->rtp, data, size);
+		}
 	}
 	if (e) return e;
 
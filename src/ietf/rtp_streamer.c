@@ -47,6 +47,14 @@ struct __rtp_streamer
 	u32 payload_len, buffer_alloc;
 
 	Double ts_scale;
+
+	/*packet callback replacing the RTP channel, if any*/
+	void (*on_packet)(void *udta, GF_RTPHeader *header, u8 *payload, u32 payload_size);
+	void *on_packet_udta;
+
+	/*number of packets per batched send, applied to the channel once created*/
+	u32 send_batch;
+	GF_SockPacer *sk_pacer;
 };
 
 
@@ -58,8 +66,14 @@ static void rtp_stream_on_new_packet(void *cbk, GF_RTPHeader *header)
 
 static void rtp_stream_on_packet_done(void *cbk, GF_RTPHeader *header)
 {
+	GF_Err e;
 	GF_RTPStreamer *rtp = (GF_RTPStreamer*)cbk;
-	GF_Err e = gf_rtp_send_packet(rtp->channel, header, rtp->buffer+12, rtp->payload_len, GF_TRUE);
+	if (rtp->on_packet) {
+		rtp->on_packet(rtp->on_packet_udta, header, rtp->buffer+12, rtp->payload_len);
+		rtp->payload_len = 0;
+		return;
+	}
+	e = gf_rtp_send_packet(rtp->channel, header, rtp->buffer+12, rtp->payload_len, GF_TRUE);
 
 #ifndef GPAC_DISABLE_LOG
 	if (e) {
@@ -112,6 +126,10 @@ GF_Err gf_rtp_streamer_init_rtsp(GF_RTPStreamer *rtp, u32 path_mtu, GF_RTSPTrans
 		GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("Cannot initialize RTP sockets: %s\n", gf_error_to_string(res) ));
 		return res;
 	}
+	if (rtp->send_batch)
+		gf_rtp_enable_send_batch(rtp->channel, rtp->send_batch);
+	if (rtp->sk_pacer)
+		gf_rtp_set_pacer(rtp->channel, rtp->sk_pacer);
 	return GF_OK;
 }
 static GF_Err rtp_stream_init_channel(GF_RTPStreamer *rtp, u32 path_mtu, const char * dest, int port, int ttl, const char *ifce_addr)
@@ -772,6 +790,7 @@ void gf_rtp_streamer_disable_auto_rtcp(GF_RTPStreamer *streamer)
 GF_EXPORT
 GF_Err gf_rtp_streamer_send_rtcp(GF_RTPStreamer *streamer, Bool force_ts, u32 rtp_ts, u32 force_ntp_type, u32 ntp_sec, u32 ntp_frac)
 {
+	if (!streamer->channel) return GF_BAD_PARAM;
 	if (force_ts) streamer->channel->last_pck_ts = rtp_ts;
 	streamer->channel->forced_ntp_sec = force_ntp_type ? ntp_sec : 0;
 	streamer->channel->forced_ntp_frac = force_ntp_type ? ntp_frac : 0;
@@ -783,6 +802,7 @@ GF_Err gf_rtp_streamer_send_rtcp(GF_RTPStreamer *streamer, Bool force_ts, u32 rt
 GF_EXPORT
 GF_Err gf_rtp_streamer_send_bye(GF_RTPStreamer *streamer)
 {
+	if (!streamer->channel) return GF_BAD_PARAM;
 	return gf_rtp_send_bye(streamer->channel);
 }
 
@@ -805,5 +825,39 @@ GF_Err gf_rtp_streamer_set_interleave_callbacks(GF_RTPStreamer *streamer, gf_rtp
  	return gf_rtp_set_interleave_callbacks(streamer->channel, RTP_TCPCallback, cbk1, cbk2);
 }
 
+GF_EXPORT
+GF_Err gf_rtp_streamer_set_packet_callback(GF_RTPStreamer *streamer, void (*on_packet)(void *udta, GF_RTPHeader *header, u8 *payload, u32 payload_size), void *udta)
+{
+	if (!streamer) return GF_BAD_PARAM;
+	streamer->on_packet = on_packet;
+	streamer->on_packet_udta = udta;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtp_streamer_enable_send_batch(GF_RTPStreamer *streamer, u32 nb_packets)
+{
+	if (!streamer) return GF_BAD_PARAM;
+	streamer->send_batch = nb_packets;
+	if (!streamer->channel) return GF_OK;
+	return gf_rtp_enable_send_batch(streamer->channel, nb_packets);
+}
+
+GF_EXPORT
+GF_Err gf_rtp_streamer_set_pacer(GF_RTPStreamer *streamer, GF_SockPacer *pacer)
+{
+	if (!streamer) return GF_BAD_PARAM;
+	streamer->sk_pacer = pacer;
+	if (!streamer->channel) return GF_OK;
+	return gf_rtp_set_pacer(streamer->channel, pacer);
+}
+
+GF_EXPORT
+GF_Err gf_rtp_streamer_flush(GF_RTPStreamer *streamer)
+{
+	if (!streamer || !streamer->channel) return GF_BAD_PARAM;
+	return gf_rtp_flush_send(streamer->channel);
+}
+
 #endif /*GPAC_DISABLE_STREAMING && GPAC_DISABLE_ISOM*/
 
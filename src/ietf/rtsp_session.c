@@ -210,6 +210,7 @@ void gf_rtsp_session_del(GF_RTSPSession *sess)
 	gf_list_del(sess->TCPChannels);
 	if (sess->rtsp_pck_buf) gf_free(sess->rtsp_pck_buf);
 	gf_free(sess->tcp_buffer);
+	if (sess->il_queue) gf_free(sess->il_queue);
 
 	gf_free(sess);
 }
@@ -299,6 +300,19 @@ GF_Err gf_rtsp_check_connection(GF_RTSPSession *sess)
 }
 
 
+//wait until queued interleaved data is written, so that RTSP messages are not inserted in a partially written packet
+static GF_Err gf_rtsp_drain_interleave_queue(GF_RTSPSession *sess)
+{
+	u32 now = gf_sys_clock();
+	while (1) {
+		GF_Err e = gf_rtsp_session_flush_interleave_queue(sess);
+		if (e != GF_IP_SOCK_WOULD_BLOCK) return e;
+		if (gf_sys_clock() - now > 30000) return GF_IP_NETWORK_FAILURE;
+		gf_sleep(1);
+	}
+	return GF_OK;
+}
+
 GF_Err gf_rtsp_send_data(GF_RTSPSession *sess, u8 *buffer, u32 Size)
 {
 	GF_Err e;
@@ -307,6 +321,11 @@ GF_Err gf_rtsp_send_data(GF_RTSPSession *sess, u8 *buffer, u32 Size)
 	e = gf_rtsp_check_connection(sess);
 	if (e) return e;
 
+	if (sess->il_queue_size) {
+		e = gf_rtsp_drain_interleave_queue(sess);
+		if (e) return e;
+	}
+
 	//RTSP requests on HTTP are base 64 encoded
 	if (sess->HasTunnel) {
 		char buf64[3000];
@@ -720,6 +739,23 @@ GF_Err gf_rtsp_get_remote_address(GF_RTSPSession *sess, char *buf)
 	return gf_sk_get_remote_address(sess->connection, buf);
 }
 
+static GF_Err rtsp_il_queue_append(GF_RTSPSession *sess, u8 *hdr, u32 hdr_size, u8 *pck, u32 pck_size)
+{
+	u32 size = sess->il_queue_size + hdr_size + pck_size;
+	if (size > sess->il_queue_alloc) {
+		sess->il_queue_alloc = MAX(size, sess->il_queue_max);
+		sess->il_queue = gf_realloc(sess->il_queue, sess->il_queue_alloc);
+		if (!sess->il_queue) {
+			sess->il_queue_alloc = sess->il_queue_size = 0;
+			return GF_OUT_OF_MEM;
+		}
+	}
+	if (hdr_size) memcpy(sess->il_queue + sess->il_queue_size, hdr, hdr_size);
+	if (pck_size) memcpy(sess->il_queue + sess->il_queue_size + hdr_size, pck, pck_size);
+	sess->il_queue_size = size;
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_rtsp_session_write_interleaved(GF_RTSPSession *sess, u32 idx, u8 *pck, u32 pck_size)
 {
@@ -732,9 +768,64 @@ GF_Err gf_rtsp_session_write_interleaved(GF_RTSPSession *sess, u32 idx, u8 *pck,
 	streamID[2] = (pck_size>>8) & 0xFF;
 	streamID[3] = pck_size & 0xFF;
 
-	e = gf_sk_send_wait(sess->connection, streamID, 4, 20);
-	e |= gf_sk_send_wait(sess->connection, pck, pck_size, 20);
-	return e;
+	if (!sess->il_queue_max) {
+		e = gf_sk_send_wait(sess->connection, streamID, 4, 20);
+		e |= gf_sk_send_wait(sess->connection, pck, pck_size, 20);
+		return e;
+	}
+
+	//queue mode, never wait for the connection
+	e = gf_rtsp_session_flush_interleave_queue(sess);
+	if (e==GF_OK) {
+		u32 written=0, hdr_written;
+		e = gf_sk_send_ex(sess->connection, streamID, 4, &written);
+		hdr_written = written;
+		written = 0;
+		if (hdr_written==4) {
+			e = gf_sk_send_ex(sess->connection, pck, pck_size, &written);
+		}
+		if (e && (e!=GF_IP_SOCK_WOULD_BLOCK) && (e!=GF_IP_NETWORK_EMPTY)) return e;
+		if (hdr_written) {
+			//packet partially written, queue the remaining bytes whatever the queue size to keep framing
+			e = rtsp_il_queue_append(sess, streamID + hdr_written, 4 - hdr_written, pck + written, pck_size - written);
+			return e;
+		}
+	} else if ((e!=GF_IP_SOCK_WOULD_BLOCK) && (e!=GF_IP_NETWORK_EMPTY)) {
+		return e;
+	}
+
+	//slow connection, queue the packet or drop it
+	if (sess->il_queue_size + 4 + pck_size > sess->il_queue_max) {
+		sess->il_nb_dropped++;
+		GF_LOG((sess->il_nb_dropped % 100 == 1) ? GF_LOG_WARNING : GF_LOG_DEBUG, GF_LOG_RTP, ("[RTSP] Interleaved queue full, %u packets dropped\n", sess->il_nb_dropped));
+		return GF_IP_SOCK_WOULD_BLOCK;
+	}
+	return rtsp_il_queue_append(sess, streamID, 4, pck, pck_size);
+}
+
+GF_EXPORT
+GF_Err gf_rtsp_session_set_interleave_queue(GF_RTSPSession *sess, u32 max_size)
+{
+	if (!sess) return GF_BAD_PARAM;
+	sess->il_queue_max = max_size;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_rtsp_session_flush_interleave_queue(GF_RTSPSession *sess)
+{
+	GF_Err e;
+	u32 written=0;
+	if (!sess || !sess->connection) return GF_BAD_PARAM;
+	if (!sess->il_queue_size) return GF_OK;
+
+	e = gf_sk_send_ex(sess->connection, sess->il_queue, sess->il_queue_size, &written);
+	if (written) {
+		memmove(sess->il_queue, sess->il_queue + written, sess->il_queue_size - written);
+		sess->il_queue_size -= written;
+	}
+	if (e && (e!=GF_IP_SOCK_WOULD_BLOCK) && (e!=GF_IP_NETWORK_EMPTY)) return e;
+	return sess->il_queue_size ? GF_IP_SOCK_WOULD_BLOCK : GF_OK;
 }
 
 #endif /*GPAC_DISABLE_STREAMING*/
@@ -1832,14 +1832,15 @@ static JSValue file_constructor(JSContext *ctx, JSValueConst new_target, int arg
 static int js_gpaccore_init(JSContext *ctx, JSModuleDef *m)
 {
 	JSValue proto, ctor;
-	if (!bitstream_class_id) {
-		JS_NewClassID(&bitstream_class_id);
+	//classes must be registered in each runtime (filters may use their own runtime)
+	if (!JS_IsRegisteredClass(JS_GetRuntime(ctx), bitstream_class_id)) {
+		gf_js_new_class_id(&bitstream_class_id);
 		JS_NewClass(JS_GetRuntime(ctx), bitstream_class_id, &bitstreamClass);
 
-		JS_NewClassID(&sha1_class_id);
+		gf_js_new_class_id(&sha1_class_id);
 		JS_NewClass(JS_GetRuntime(ctx), sha1_class_id, &sha1Class);
 
-		JS_NewClassID(&file_class_id);
+		gf_js_new_class_id(&file_class_id);
 		JS_NewClass(JS_GetRuntime(ctx), file_class_id, &fileClass);
 	}
 
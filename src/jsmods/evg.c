@@ -44,6 +44,7 @@
 #include "../scenegraph/qjs_common.h"
 
 #include <gpac/internal/compositor_dev.h>
+#include <gpac/internal/simd_dev.h>
 
 /*for texture from png/rgb*/
 #include <gpac/bitstream.h>
@@ -201,6 +202,7 @@ typedef struct
 	Bool center_coords;
 	GF_EVGSurface *surface;
 	u32 composite_op;
+	u32 nb_threads;
 	JSValue alpha_cbk;
 	JSValue frag_shader;
 	Bool frag_is_cbk;
@@ -360,6 +362,7 @@ enum
 	GF_EVG_DEPTH_BUFFER,
 	GF_EVG_DEPTH_TEST,
 	GF_EVG_WRITE_DEPTH,
+	GF_EVG_THREADS,
 };
 
 u8 evg_get_alpha(void *cbk, u8 src_alpha, s32 x, s32 y)
@@ -497,6 +500,7 @@ static JSValue canvas_getProperty(JSContext *c, JSValueConst obj, int magic)
 	case GF_EVG_CENTERED: return JS_NewBool(c, canvas->center_coords);
 	case GF_EVG_COMPOSITE_OP: return JS_NewInt32(c, canvas->composite_op);
 	case GF_EVG_ALPHA_FUN: return JS_DupValue(c, canvas->alpha_cbk);
+	case GF_EVG_THREADS: return JS_NewInt32(c, canvas->nb_threads);
 	}
 	return JS_UNDEFINED;
 }
@@ -587,6 +591,17 @@ static JSValue canvas_setProperty(JSContext *c, JSValueConst obj, JSValueConst v
 			gf_evg_surface_set_alpha_callback(canvas->surface, evg_get_alpha, canvas);
 		}
 		return JS_UNDEFINED;
+	case GF_EVG_THREADS:
+	{
+		s32 nb_threads;
+		GF_Err e;
+		if (JS_ToInt32(c, &nb_threads, value)) return JS_EXCEPTION;
+		if (nb_threads<0) return js_throw_err_msg(c, GF_BAD_PARAM, "Invalid number of threads %d", nb_threads);
+		e = gf_evg_surface_set_threads(canvas->surface, (u32) nb_threads);
+		if (e) return js_throw_err(c, e);
+		canvas->nb_threads = (u32) nb_threads;
+		return JS_UNDEFINED;
+	}
 	}
 	return JS_UNDEFINED;
 }
@@ -767,6 +782,7 @@ static const JSCFunctionListEntry canvas_funcs[] =
 	JS_CGETSET_MAGIC_DEF("matrix3d", NULL, canvas_setProperty, GF_EVG_MATRIX_3D),
 	JS_CGETSET_MAGIC_DEF("compositeOperation", canvas_getProperty, canvas_setProperty, GF_EVG_COMPOSITE_OP),
 	JS_CGETSET_MAGIC_DEF("on_alpha", canvas_getProperty, canvas_setProperty, GF_EVG_ALPHA_FUN),
+	JS_CGETSET_MAGIC_DEF("threads", canvas_getProperty, canvas_setProperty, GF_EVG_THREADS),
 	JS_CFUNC_DEF("clear", 0, canvas_clear),
 	JS_CFUNC_DEF("clearf", 0, canvas_clearf),
 	JS_CFUNC_DEF("fill", 0, canvas_fill),
@@ -1239,16 +1255,6 @@ static GFINLINE Float _modf(Float x, Float y)
 
 
 
-#if defined(WIN32) && !defined(__GNUC__)
-# include <intrin.h>
-# define GPAC_HAS_SSE2
-#else
-# ifdef __SSE2__
-#  include <emmintrin.h>
-#  define GPAC_HAS_SSE2
-# endif
-#endif
-
 #ifdef GPAC_HAS_SSE2
 
 static Float evg_float_clamp(Float val, Float minval, Float maxval)
@@ -6359,53 +6365,53 @@ static int js_evg_load_module(JSContext *c, JSModuleDef *m)
 	JSValue proto;
 	JSValue global;
 
-	if (!canvas_class_id) {
+	if (!JS_IsRegisteredClass(JS_GetRuntime(c), canvas_class_id)) {
 		JSRuntime *rt = JS_GetRuntime(c);
 
-		JS_NewClassID(&canvas_class_id);
+		gf_js_new_class_id(&canvas_class_id);
 		JS_NewClass(rt, canvas_class_id, &canvas_class);
 
-		JS_NewClassID(&path_class_id);
+		gf_js_new_class_id(&path_class_id);
 		JS_NewClass(rt, path_class_id, &path_class);
 
-		JS_NewClassID(&mx2d_class_id);
+		gf_js_new_class_id(&mx2d_class_id);
 		JS_NewClass(rt, mx2d_class_id, &mx2d_class);
 
-		JS_NewClassID(&colmx_class_id);
+		gf_js_new_class_id(&colmx_class_id);
 		JS_NewClass(rt, colmx_class_id, &colmx_class);
 
-		JS_NewClassID(&stencil_class_id);
+		gf_js_new_class_id(&stencil_class_id);
 		JS_NewClass(rt, stencil_class_id, &stencil_class);
 
-		JS_NewClassID(&texture_class_id);
+		gf_js_new_class_id(&texture_class_id);
 		JS_NewClass(rt, texture_class_id, &texture_class);
 
-		JS_NewClassID(&text_class_id);
+		gf_js_new_class_id(&text_class_id);
 		JS_NewClass(rt, text_class_id, &text_class);
 
-		JS_NewClassID(&matrix_class_id);
+		gf_js_new_class_id(&matrix_class_id);
 		JS_NewClass(rt, matrix_class_id, &matrix_class);
 
-		JS_NewClassID(&canvas3d_class_id);
+		gf_js_new_class_id(&canvas3d_class_id);
 		JS_NewClass(rt, canvas3d_class_id, &canvas3d_class);
 
-		JS_NewClassID(&shader_class_id);
+		gf_js_new_class_id(&shader_class_id);
 		JS_NewClass(rt, shader_class_id, &shader_class);
 
-		JS_NewClassID(&vai_class_id);
+		gf_js_new_class_id(&vai_class_id);
 		JS_NewClass(rt, vai_class_id, &vai_class);
 
-		JS_NewClassID(&va_class_id);
+		gf_js_new_class_id(&va_class_id);
 		JS_NewClass(rt, va_class_id, &va_class);
 
 #ifdef EVG_USE_JS_SHADER
-		JS_NewClassID(&fragment_class_id);
+		gf_js_new_class_id(&fragment_class_id);
 		JS_NewClass(rt, fragment_class_id, &fragment_class);
 
-		JS_NewClassID(&vertex_class_id);
+		gf_js_new_class_id(&vertex_class_id);
 		JS_NewClass(rt, vertex_class_id, &vertex_class);
 
-		JS_NewClassID(&vaires_class_id);
+		gf_js_new_class_id(&vaires_class_id);
 		JS_NewClass(rt, vaires_class_id, &vaires_class);
 #endif// EVG_USE_JS_SHADER
 
@@ -1801,20 +1801,20 @@ static int js_scene_init(JSContext *c, JSModuleDef *m)
 	}
 
 	if (!scene_class_id) {
-		JS_NewClassID(&scene_class_id);
+		gf_js_new_class_id(&scene_class_id);
 		JS_NewClass(JS_GetRuntime(c), scene_class_id, &sceneClass);
 
-		JS_NewClassID(&odm_class_id);
+		gf_js_new_class_id(&odm_class_id);
 		JS_NewClass(JS_GetRuntime(c), odm_class_id, &odmClass);
 	}
 	JSValue proto = JS_NewObjectClass(c, odm_class_id);
 	JS_SetPropertyFunctionList(c, proto, odm_funcs, countof(odm_funcs));
 	JS_SetClassProto(c, odm_class_id, proto);
 
-	JS_NewClassID(&gpacevt_class_id);
+	gf_js_new_class_id(&gpacevt_class_id);
 	JS_NewClass(JS_GetRuntime(c), gpacevt_class_id, &gpacEvtClass);
 
-	JS_NewClassID(&any_class_id);
+	gf_js_new_class_id(&any_class_id);
 	JS_NewClass(JS_GetRuntime(c), any_class_id, &anyClass);
 
 	JSValue global = JS_GetGlobalObject(c);
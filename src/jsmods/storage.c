@@ -33,24 +33,44 @@
 #ifdef GPAC_HAS_QJS
 
 #include <gpac/config_file.h>
+#include <gpac/thread.h>
 #include "../scenegraph/qjs_common.h"
 
 
 static JSClassID storage_class_id = 0;
-GF_List *all_storages = NULL;
+
+//a storage file may be opened by several scripts, possibly in different runtimes running concurrently
+typedef struct
+{
+	GF_Config *cfg;
+	GF_Mutex *mx;
+	u32 nb_refs;
+} GF_JSStorage;
+
+//list of opened storages, protected by the JS global lock
+static GF_List *all_storages = NULL;
 
 static void storage_finalize(JSRuntime *rt, JSValue obj)
 {
-	GF_Config *cfg = JS_GetOpaque(obj, storage_class_id);
-	if (!cfg) return;
-	if (all_storages) {
-		gf_list_del_item(all_storages, cfg);
-		if (!gf_list_count(all_storages)) {
-			gf_list_del(all_storages);
-			all_storages = NULL;
-		}
+	GF_JSStorage *storage = JS_GetOpaque(obj, storage_class_id);
+	if (!storage) return;
+
+	gf_js_global_lock(GF_TRUE);
+	storage->nb_refs--;
+	if (storage->nb_refs) {
+		gf_js_global_lock(GF_FALSE);
+		return;
 	}
-	gf_cfg_del(cfg);
+	gf_list_del_item(all_storages, storage);
+	if (!gf_list_count(all_storages)) {
+		gf_list_del(all_storages);
+		all_storages = NULL;
+	}
+	gf_js_global_lock(GF_FALSE);
+
+	gf_cfg_del(storage->cfg);
+	gf_mx_del(storage->mx);
+	gf_free(storage);
 }
 
 JSClassDef storageClass = {
@@ -64,8 +84,9 @@ static JSValue js_storage_get_option(JSContext *ctx, JSValueConst this_val, int
 	const char *opt = NULL;
 	const char *sec_name, *key_name;
 	s32 idx = -1;
-	GF_Config *config = JS_GetOpaque(this_val, storage_class_id);
-	if (!config) return JS_EXCEPTION;
+	JSValue res;
+	GF_JSStorage *storage = JS_GetOpaque(this_val, storage_class_id);
+	if (!storage) return JS_EXCEPTION;
 	if (argc < 2) return JS_EXCEPTION;
 
 	if (!JS_IsString(argv[0])) return JS_EXCEPTION;
@@ -84,28 +105,28 @@ static JSValue js_storage_get_option(JSContext *ctx, JSValueConst this_val, int
 		key_name = JS_ToCString(ctx, argv[1]);
 	}
 
+	//option value may be modified by another script, create the string while holding the lock
+	gf_mx_p(storage->mx);
 	if (key_name) {
-		opt = gf_cfg_get_key(config, sec_name, key_name);
+		opt = gf_cfg_get_key(storage->cfg, sec_name, key_name);
 	} else if (idx>=0) {
-		opt = gf_cfg_get_key_name(config, sec_name, idx);
+		opt = gf_cfg_get_key_name(storage->cfg, sec_name, idx);
 	} else {
 		opt = NULL;
 	}
+	res = opt ? JS_NewString(ctx, opt) : JS_NULL;
+	gf_mx_v(storage->mx);
 
 	JS_FreeCString(ctx, key_name);
 	JS_FreeCString(ctx, sec_name);
-
-	if (opt) {
-		return JS_NewString(ctx, opt);
-	}
-	return JS_NULL;
+	return res;
 }
 
 static JSValue js_storage_set_option(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv)
 {
 	const char *sec_name, *key_name, *key_val;
-	GF_Config *config = JS_GetOpaque(this_val, storage_class_id);
-	if (!config) return JS_EXCEPTION;
+	GF_JSStorage *storage = JS_GetOpaque(this_val, storage_class_id);
+	if (!storage) return JS_EXCEPTION;
 	if (argc < 3) return JS_EXCEPTION;
 
 	if (!JS_IsString(argv[0])) return JS_EXCEPTION;
@@ -121,7 +142,9 @@ static JSValue js_storage_set_option(JSContext *ctx, JSValueConst this_val, int
 	if (JS_IsString(argv[2]))
 		key_val = JS_ToCString(ctx, argv[2]);
 
-	gf_cfg_set_key(config, sec_name, key_name, key_val);
+	gf_mx_p(storage->mx);
+	gf_cfg_set_key(storage->cfg, sec_name, key_name, key_val);
+	gf_mx_v(storage->mx);
 
 	JS_FreeCString(ctx, sec_name);
 	JS_FreeCString(ctx, key_name);
@@ -131,9 +154,11 @@ static JSValue js_storage_set_option(JSContext *ctx, JSValueConst this_val, int
 
 static JSValue js_storage_save(JSContext *ctx, JSValueConst this_val, int argc, JSValueConst *argv)
 {
-	GF_Config *config = JS_GetOpaque(this_val, storage_class_id);
-	if (!config) return JS_EXCEPTION;
-	gf_cfg_save(config);
+	GF_JSStorage *storage = JS_GetOpaque(this_val, storage_class_id);
+	if (!storage) return JS_EXCEPTION;
+	gf_mx_p(storage->mx);
+	gf_cfg_save(storage->cfg);
+	gf_mx_v(storage->mx);
 	return JS_UNDEFINED;
 }
 
@@ -147,7 +172,7 @@ static JSValue storage_constructor(JSContext *ctx, JSValueConst new_target, int
 {
 	char szFile[GF_MAX_PATH];
 	JSValue anobj;
-	GF_Config *storage = NULL;
+	GF_JSStorage *storage = NULL;
 	const char *storage_url = NULL;
 	u32 i, count;
 	u8 hash[20];
@@ -167,43 +192,54 @@ static JSValue storage_constructor(JSContext *ctx, JSValueConst new_target, int
 	}
 	strcat(szFile, ".cfg");
 
+	anobj = JS_NewObjectClass(ctx, storage_class_id);
+	if (JS_IsException(anobj)) {
+		JS_FreeCString(ctx, storage_url);
+		return anobj;
+	}
+
+	gf_js_global_lock(GF_TRUE);
 	count = gf_list_count(all_storages);
 	for (i=0; i<count; i++) {
-		GF_Config *a_cfg = gf_list_get(all_storages, i);
-		const char *cfg_name = gf_cfg_get_filename(a_cfg);
+		GF_JSStorage *a_storage = gf_list_get(all_storages, i);
+		const char *cfg_name = gf_cfg_get_filename(a_storage->cfg);
 
 		if (strstr(cfg_name, szFile)) {
-			storage = a_cfg;
+			storage = a_storage;
 			break;
 		}
 	}
 
 	if (!storage) {
 		const char *storage_dir = gf_opts_get_key("core", "store-dir");
-
-		storage = gf_cfg_force_new(storage_dir, szFile);
-		if (storage) {
-			gf_cfg_set_key(storage, "GPAC", "StorageURL", storage_url);
-			gf_list_add(all_storages, storage);
+		GF_Config *cfg = gf_cfg_force_new(storage_dir, szFile);
+		if (cfg) {
+			GF_SAFEALLOC(storage, GF_JSStorage);
+			if (storage) {
+				storage->cfg = cfg;
+				storage->mx = gf_mx_new("JSStorage");
+				gf_cfg_set_key(cfg, "GPAC", "StorageURL", storage_url);
+				if (!all_storages) all_storages = gf_list_new();
+				gf_list_add(all_storages, storage);
+			} else {
+				gf_cfg_del(cfg);
+			}
 		}
 	}
+	if (storage) storage->nb_refs++;
+	gf_js_global_lock(GF_FALSE);
 
 	JS_FreeCString(ctx, storage_url);
 
-	anobj = JS_NewObjectClass(ctx, storage_class_id);
-	if (JS_IsException(anobj)) return anobj;
 	JS_SetOpaque(anobj, storage);
 	return anobj;
 }
 
 static int js_storage_init(JSContext *c, JSModuleDef *m)
 {
-	if (!storage_class_id) {
-		JS_NewClassID(&storage_class_id);
+	if (!JS_IsRegisteredClass(JS_GetRuntime(c), storage_class_id)) {
+		gf_js_new_class_id(&storage_class_id);
 		JS_NewClass(JS_GetRuntime(c), storage_class_id, &storageClass);
-
-		assert(!all_storages);
-		all_storages = gf_list_new();
 	}
 
 	JSValue proto = JS_NewObjectClass(c, storage_class_id);
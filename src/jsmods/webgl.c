@@ -1979,9 +1979,9 @@ static int js_webgl_load_module(JSContext *c, JSModuleDef *m)
 	JSValue proto;
 	JSRuntime *rt = JS_GetRuntime(c);
 
-	if (!WebGLRenderingContextBase_class_id) {
+	if (!JS_IsRegisteredClass(rt, WebGLRenderingContextBase_class_id)) {
 #define INITCLASS(_name)\
-		JS_NewClassID(& _name##_class_id);\
+		gf_js_new_class_id(& _name##_class_id);\
 		JS_NewClass(rt, _name##_class_id, & _name##_class);\
 
 		INITCLASS(WebGLRenderingContextBase)
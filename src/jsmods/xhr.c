@@ -1397,8 +1397,8 @@ static void xml_http_gc_mark(JSRuntime *rt, JSValueConst val, JS_MarkFunc *mark_
 
 static JSValue xhr_load_class(JSContext *c)
 {
-	if (! xhrClass.class_id) {
-		JS_NewClassID(&xhrClass.class_id);
+	if (! JS_IsRegisteredClass(JS_GetRuntime(c), xhrClass.class_id)) {
+		gf_js_new_class_id(&xhrClass.class_id);
 		xhrClass.class.class_name = "XMLHttpRequest";
 		xhrClass.class.finalizer = xml_http_finalize;
 		xhrClass.class.gc_mark = xml_http_gc_mark;
@@ -30,10 +30,19 @@
 #include <gpac/network.h>
 #include <gpac/bitstream.h>
 #include <gpac/xml.h>
+#include <gpac/thread.h>
 
 #define GF_ATSC_MCAST_ADDR	"224.0.23.60"
 #define GF_ATSC_MCAST_PORT	4937
 #define GF_ATSC_SOCK_SIZE	0x80000
+//max size of a ROUTE datagram
+#define GF_ATSC_DGRAM_SIZE	10000
+//max number of datagrams fetched in one receive call
+#define GF_ATSC_BATCH	32
+//number of datagrams buffered by a reception thread
+#define GF_ATSC_WORKER_SLOTS	256
+//max number of released object buffers kept for reuse
+#define GF_ATSC_MAX_POOL	8
 
 typedef struct
 {
@@ -95,7 +104,29 @@ typedef struct
 
 typedef struct
 {
+	GF_Thread *th;
+	GF_Mutex *mx;
 	GF_Socket *sock;
+	GF_SockGroup *group;
+	Bool run, active;
+	//ring of received datagrams, filled by the reception thread and consumed by the demuxer
+	u8 *slab;
+	u32 sizes[GF_ATSC_WORKER_SLOTS];
+	u32 first, count;
+	u64 nb_recv;
+	u32 nb_full;
+} GF_ATSCWorker;
+
+typedef struct
+{
+	u8 *data;
+	u32 alloc_size;
+} GF_ATSCPayload;
+
+typedef struct
+{
+	GF_Socket *sock;
+	GF_ATSCWorker *worker;
 
 	GF_List *channels;
 } GF_ATSCRouteSession;
@@ -113,6 +144,7 @@ typedef struct
 	u32 protocol;
 	u32 mpd_version, stsid_version;
 	GF_Socket *sock;
+	GF_ATSCWorker *worker;
 	u32 secondary_sockets;
 	GF_List *objects;
 	GF_LCTObject *last_active_obj;
@@ -152,6 +184,15 @@ struct __gf_atscdmx {
 
 	GF_SockGroup *active_sockets;
 
+	//one reception thread per ROUTE session socket
+	Bool threaded;
+	u8 *rcv_bufs[GF_ATSC_BATCH];
+	u32 rcv_sizes[GF_ATSC_BATCH];
+
+	//object buffers held by the user, and released buffers available for new objects
+	GF_Mutex *pool_mx;
+	GF_List *held_payloads, *payload_pool;
+	GF_LCTObject *dispatch_obj;
 
 	void (*on_event)(void *udta, GF_ATSCEventType evt, u32 evt_param, GF_ATSCEventFileInfo *info);
 	void *udta;
@@ -163,8 +204,92 @@ struct __gf_atscdmx {
 	u64 first_pck_time, last_pck_time;
 };
 
+static u32 gf_atsc3_worker_run(void *par)
+{
+	u8 *bufs[GF_ATSC_BATCH];
+	GF_ATSCWorker *w = (GF_ATSCWorker *) par;
+
+	while (w->run) {
+		u32 i, start, nb_free, nb_read=0;
+		GF_Err e;
+		if (!w->active) {
+			gf_sleep(10);
+			continue;
+		}
+		gf_mx_p(w->mx);
+		start = (w->first + w->count) % GF_ATSC_WORKER_SLOTS;
+		nb_free = GF_ATSC_WORKER_SLOTS - w->count;
+		gf_mx_v(w->mx);
+		//only use contiguous slots
+		if (nb_free > GF_ATSC_WORKER_SLOTS - start) nb_free = GF_ATSC_WORKER_SLOTS - start;
+		if (nb_free > GF_ATSC_BATCH) nb_free = GF_ATSC_BATCH;
+		if (!nb_free) {
+			//demuxer is late, let the socket buffer absorb the burst
+			w->nb_full++;
+			gf_sleep(1);
+			continue;
+		}
+		e = gf_sk_group_select(w->group, 10000, GF_SK_SELECT_READ);
+		if (e) continue;
+
+		for (i=0; i<nb_free; i++)
+			bufs[i] = w->slab + (start+i) * GF_ATSC_DGRAM_SIZE;
+		e = gf_sk_receive_batch(w->sock, bufs, GF_ATSC_DGRAM_SIZE, &w->sizes[start], nb_free, &nb_read);
+		if (e || !nb_read) continue;
+
+		gf_mx_p(w->mx);
+		w->count += nb_read;
+		gf_mx_v(w->mx);
+		w->nb_recv += nb_read;
+	}
+	return 0;
+}
+
+static void gf_atsc3_worker_del(GF_ATSCWorker *w)
+{
+	if (!w) return;
+	if (w->th) {
+		w->run = GF_FALSE;
+		gf_th_stop(w->th);
+		gf_th_del(w->th);
+	}
+	if (w->nb_recv) {
+		GF_LOG(w->nb_full ? GF_LOG_WARNING : GF_LOG_INFO, GF_LOG_ATSC, ("[ATSC3] Reception thread got "LLU" datagrams - buffer full %d times\n", w->nb_recv, w->nb_full));
+	}
+	if (w->group) gf_sk_group_del(w->group);
+	if (w->mx) gf_mx_del(w->mx);
+	if (w->slab) gf_free(w->slab);
+	gf_free(w);
+}
+
+static GF_ATSCWorker *gf_atsc3_worker_new(GF_Socket *sock)
+{
+	GF_ATSCWorker *w;
+	GF_SAFEALLOC(w, GF_ATSCWorker);
+	if (!w) return NULL;
+	w->sock = sock;
+	w->mx = gf_mx_new("ATSCWorker");
+	w->group = gf_sk_group_new();
+	w->slab = gf_malloc(GF_ATSC_WORKER_SLOTS * GF_ATSC_DGRAM_SIZE);
+	w->th = gf_th_new("ATSCWorker");
+	if (!w->mx || !w->group || !w->slab || !w->th) {
+		gf_atsc3_worker_del(w);
+		return NULL;
+	}
+	gf_sk_group_register(w->group, sock);
+	w->run = GF_TRUE;
+	if (gf_th_run(w->th, gf_atsc3_worker_run, w) != GF_OK) {
+		gf_th_del(w->th);
+		w->th = NULL;
+		gf_atsc3_worker_del(w);
+		return NULL;
+	}
+	return w;
+}
+
 static void gf_atsc3_route_session_del(GF_ATSCRouteSession *rs)
 {
+	gf_atsc3_worker_del(rs->worker);
 	if (rs->sock) gf_sk_del(rs->sock);
 	while (gf_list_count(rs->channels)) {
 		GF_ATSCLCTChannel *lc = gf_list_pop_back(rs->channels);
@@ -185,6 +310,7 @@ static void gf_atsc3_lct_obj_del(GF_LCTObject *o)
 
 static void gf_atsc3_service_del(GF_ATSCDmx *atscd, GF_ATSCService *s)
 {
+	gf_atsc3_worker_del(s->worker);
 	if (s->sock) {
 		gf_sk_group_unregister(atscd->active_sockets, s->sock);
 		gf_sk_del(s->sock);
@@ -208,6 +334,7 @@ static void gf_atsc3_service_del(GF_ATSCDmx *atscd, GF_ATSCService *s)
 GF_EXPORT
 void gf_atsc3_dmx_del(GF_ATSCDmx *atscd)
 {
+	u32 i;
 	if (atscd->buffer) gf_free(atscd->buffer);
 	if (atscd->unz_buffer) gf_free(atscd->unz_buffer);
 	if (atscd->sock) gf_sk_del(atscd->sock);
@@ -227,6 +354,26 @@ void gf_atsc3_dmx_del(GF_ATSCDmx *atscd)
 		}
 		gf_list_del(atscd->object_reservoir);
 	}
+	//data of held objects is now owned by the user
+	if (atscd->held_payloads) {
+		while (gf_list_count(atscd->held_payloads)) {
+			GF_ATSCPayload *p = gf_list_pop_back(atscd->held_payloads);
+			gf_free(p);
+		}
+		gf_list_del(atscd->held_payloads);
+	}
+	if (atscd->payload_pool) {
+		while (gf_list_count(atscd->payload_pool)) {
+			GF_ATSCPayload *p = gf_list_pop_back(atscd->payload_pool);
+			gf_free(p->data);
+			gf_free(p);
+		}
+		gf_list_del(atscd->payload_pool);
+	}
+	if (atscd->pool_mx) gf_mx_del(atscd->pool_mx);
+	for (i=0; i<GF_ATSC_BATCH; i++) {
+		if (atscd->rcv_bufs[i]) gf_free(atscd->rcv_bufs[i]);
+	}
 	if (atscd->bs) gf_bs_del(atscd->bs);
 	gf_free(atscd);
 }
@@ -234,6 +381,7 @@ void gf_atsc3_dmx_del(GF_ATSCDmx *atscd)
 GF_EXPORT
 GF_ATSCDmx *gf_atsc3_dmx_new(const char *ifce, const char *dir, u32 sock_buffer_size)
 {
+	u32 i;
 	GF_ATSCDmx *atscd;
 	GF_Err e;
 	GF_SAFEALLOC(atscd, GF_ATSCDmx);
@@ -268,6 +416,14 @@ GF_ATSCDmx *gf_atsc3_dmx_new(const char *ifce, const char *dir, u32 sock_buffer_
 		gf_atsc3_dmx_del(atscd);
 		return NULL;
 	}
+	atscd->held_payloads = gf_list_new();
+	atscd->payload_pool = gf_list_new();
+	atscd->pool_mx = gf_mx_new("ATSCPayloadPool");
+	if (!atscd->held_payloads || !atscd->payload_pool || !atscd->pool_mx) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ATSC3] Failed to allocate ATSC object buffer pool\n" ));
+		gf_atsc3_dmx_del(atscd);
+		return NULL;
+	}
 
 	if (!sock_buffer_size) sock_buffer_size = GF_ATSC_SOCK_SIZE;
 	atscd->unz_buffer_size = sock_buffer_size;
@@ -285,6 +441,14 @@ GF_ATSCDmx *gf_atsc3_dmx_new(const char *ifce, const char *dir, u32 sock_buffer_
 		gf_atsc3_dmx_del(atscd);
 		return NULL;
 	}
+	for (i=0; i<GF_ATSC_BATCH; i++) {
+		atscd->rcv_bufs[i] = gf_malloc(GF_ATSC_DGRAM_SIZE);
+		if (!atscd->rcv_bufs[i]) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ATSC3] Failed to allocate socket buffer\n"));
+			gf_atsc3_dmx_del(atscd);
+			return NULL;
+		}
+	}
 
 	atscd->active_sockets = gf_sk_group_new();
 	if (!atscd->active_sockets) {
@@ -317,20 +481,36 @@ GF_ATSCDmx *gf_atsc3_dmx_new(const char *ifce, const char *dir, u32 sock_buffer_
 	return atscd;
 }
 
+static void gf_atsc3_register_socket(GF_ATSCDmx *atscd, GF_Socket *sock, GF_ATSCWorker **worker, Bool do_register)
+{
+	if (atscd->threaded) {
+		if (! *worker && do_register) {
+			*worker = gf_atsc3_worker_new(sock);
+			if (! *worker) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_ATSC, ("[ATSC3] Failed to create reception thread, using demuxer thread\n"));
+			}
+		}
+		if (*worker) {
+			(*worker)->active = do_register;
+			return;
+		}
+	}
+	if (do_register) gf_sk_group_register(atscd->active_sockets, sock);
+	else gf_sk_group_unregister(atscd->active_sockets, sock);
+}
+
 static void gf_atsc3_register_service_sockets(GF_ATSCDmx *atscd, GF_ATSCService *s, Bool do_register)
 {
 	u32 i;
 	GF_ATSCRouteSession *rsess;
-	if (do_register) gf_sk_group_register(atscd->active_sockets, s->sock);
-	else gf_sk_group_unregister(atscd->active_sockets, s->sock);
+	gf_atsc3_register_socket(atscd, s->sock, &s->worker, do_register);
 
 	if (!s->secondary_sockets) return;
 
 	i=0;
 	while ((rsess = gf_list_enum(s->route_sessions, &i))) {
 		if (! rsess->sock) continue;
-		if (do_register) gf_sk_group_register(atscd->active_sockets, rsess->sock);
-		else gf_sk_group_unregister(atscd->active_sockets, rsess->sock);
+		gf_atsc3_register_socket(atscd, rsess->sock, &rsess->worker, do_register);
 	}
 }
 
@@ -488,7 +668,7 @@ static GF_Err gf_atsc3_dmx_process_slt(GF_ATSCDmx *atscd, GF_XMLNode *root)
 
 			//we are tuning, register socket
 			if (service->tune_mode != GF_ATSC_TUNE_OFF)
-				gf_sk_group_register(atscd->active_sockets, service->sock);
+				gf_atsc3_register_socket(atscd, service->sock, &service->worker, GF_TRUE);
 
 			gf_list_add(atscd->services, service);
 			if (atscd->on_event) atscd->on_event(atscd->udta, GF_ATSC_EVT_SERVICE_FOUND, service_id, NULL);
@@ -624,7 +804,9 @@ static GF_Err gf_atsc3_dmx_process_object(GF_ATSCDmx *atscd, GF_ATSCService *s,
 			finfo.toi = obj->toi;
 			finfo.corrupted = partial;
 			finfo.download_ms = obj->download_time_ms;
+			atscd->dispatch_obj = obj;
 			atscd->on_event(atscd->udta, is_init ? GF_ATSC_EVT_INIT_SEG : GF_ATSC_EVT_SEG, s->service_id, &finfo);
+			atscd->dispatch_obj = NULL;
 		}
 		return GF_OK;
 	}
@@ -924,6 +1106,18 @@ static GF_Err gf_atsc3_service_gather_object(GF_ATSCDmx *atscd, GF_ATSCService *
 
 	assert(obj->toi == toi);
 	assert(obj->tsi == tsi);
+	//object data was handed over to the user, get a released buffer
+	if (!obj->payload) {
+		GF_ATSCPayload *p;
+		gf_mx_p(atscd->pool_mx);
+		p = gf_list_pop_back(atscd->payload_pool);
+		gf_mx_v(atscd->pool_mx);
+		if (p) {
+			obj->payload = p->data;
+			obj->alloc_size = p->alloc_size;
+			gf_free(p);
+		}
+	}
 	if (start_offset + size > obj->alloc_size) {
 		obj->alloc_size = start_offset + size;
 		//use total size if available
@@ -1105,7 +1299,7 @@ static GF_Err gf_atsc3_service_setup_stsid(GF_ATSCDmx *atscd, GF_ATSCService *s,
 			gf_sk_set_buffer_size(rsess->sock, GF_FALSE, atscd->unz_buffer_size);
 			//gf_sk_set_block_mode(rsess->sock, GF_TRUE);
 			s->secondary_sockets++;
-			if (s->tune_mode == GF_ATSC_TUNE_ON) gf_sk_group_register(atscd->active_sockets, rsess->sock);
+			if (s->tune_mode == GF_ATSC_TUNE_ON) gf_atsc3_register_socket(atscd, rsess->sock, &rsess->worker, GF_TRUE);
 		}
 		gf_list_add(s->route_sessions, rsess);
 
@@ -1421,10 +1615,10 @@ enum
 	GF_LCT_EXT_TOL48 = 67,
 };
 
-static GF_Err gf_atsc3_dmx_process_service(GF_ATSCDmx *atscd, GF_ATSCService *s, GF_ATSCRouteSession *route_sess)
+static GF_Err gf_atsc3_dmx_process_lct(GF_ATSCDmx *atscd, GF_ATSCService *s, u8 *data, u32 nb_read)
 {
 	GF_Err e;
-	u32 nb_read, v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cp, cc, tsi, toi, pos;
+	u32 v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cp, cc, tsi, toi, pos;
 	u32 /*a_G=0, a_U=0,*/ a_S=0, a_M=0/*, a_A=0, a_H=0, a_D=0*/;
 	u64 tol_size=0;
 	Bool in_order = GF_TRUE;
@@ -1432,21 +1626,14 @@ static GF_Err gf_atsc3_dmx_process_service(GF_ATSCDmx *atscd, GF_ATSCService *s,
 	GF_ATSCLCTChannel *rlct=NULL;
 	GF_LCTObject *gather_object=NULL;
 
-	if (route_sess) {
-		e = gf_sk_receive_no_select(route_sess->sock, atscd->buffer, atscd->buffer_size, &nb_read);
-	} else {
-		e = gf_sk_receive_no_select(s->sock, atscd->buffer, atscd->buffer_size, &nb_read);
-	}
-
-	if (e != GF_OK) return e;
-	assert(nb_read);
+	if (!nb_read) return GF_OK;
 
 	atscd->nb_packets++;
 	atscd->total_bytes_recv += nb_read;
 	atscd->last_pck_time = gf_sys_clock_high_res();
 	if (!atscd->first_pck_time) atscd->first_pck_time = atscd->last_pck_time;
 
-	e = gf_bs_reassign_buffer(atscd->bs, atscd->buffer, nb_read);
+	e = gf_bs_reassign_buffer(atscd->bs, data, nb_read);
 	if (e != GF_OK) return e;
 
 	//parse LCT header
@@ -1605,7 +1792,7 @@ static GF_Err gf_atsc3_dmx_process_service(GF_ATSCDmx *atscd, GF_ATSCService *s,
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_ATSC, ("[ATSC3] Service %d : LCT packet TSI %u TOI %u size %d startOffset %u TOL "LLU"\n", s->service_id, tsi, toi, nb_read-pos, start_offset, tol_size));
 
-	e = gf_atsc3_service_gather_object(atscd, s, tsi, toi, start_offset, atscd->buffer + pos, nb_read-pos, (u32) tol_size, B, in_order, rlct, &gather_object);
+	e = gf_atsc3_service_gather_object(atscd, s, tsi, toi, start_offset, data + pos, nb_read-pos, (u32) tol_size, B, in_order, rlct, &gather_object);
 
 	if (e==GF_EOS) {
 		if (!tsi) {
@@ -1626,6 +1813,41 @@ static GF_Err gf_atsc3_dmx_process_service(GF_ATSCDmx *atscd, GF_ATSCService *s,
 	return GF_OK;
 }
 
+static GF_Err gf_atsc3_dmx_process_service(GF_ATSCDmx *atscd, GF_ATSCService *s, GF_ATSCRouteSession *route_sess)
+{
+	u32 i, nb_read=0;
+	GF_Err e = gf_sk_receive_batch(route_sess ? route_sess->sock : s->sock, atscd->rcv_bufs, GF_ATSC_DGRAM_SIZE, atscd->rcv_sizes, GF_ATSC_BATCH, &nb_read);
+	if (e != GF_OK) return e;
+
+	for (i=0; i<nb_read; i++) {
+		e = gf_atsc3_dmx_process_lct(atscd, s, atscd->rcv_bufs[i], atscd->rcv_sizes[i]);
+		if (e) break;
+	}
+	return e;
+}
+
+static u32 gf_atsc3_dmx_process_worker(GF_ATSCDmx *atscd, GF_ATSCService *s, GF_ATSCWorker *w, Bool discard)
+{
+	u32 i, first, count;
+	gf_mx_p(w->mx);
+	first = w->first;
+	count = w->count;
+	gf_mx_v(w->mx);
+	if (!count) return 0;
+
+	//slots are not modified by the reception thread until we release them
+	for (i=0; i<count && !discard; i++) {
+		u32 slot = (first + i) % GF_ATSC_WORKER_SLOTS;
+		gf_atsc3_dmx_process_lct(atscd, s, w->slab + slot * GF_ATSC_DGRAM_SIZE, w->sizes[slot]);
+	}
+
+	gf_mx_p(w->mx);
+	w->first = (first + count) % GF_ATSC_WORKER_SLOTS;
+	w->count -= count;
+	gf_mx_v(w->mx);
+	return count;
+}
+
 static GF_Err gf_atsc3_dmx_process_lls(GF_ATSCDmx *atscd)
 {
 	u32 read;
@@ -1713,14 +1935,14 @@ static GF_Err gf_atsc3_dmx_process_lls(GF_ATSCDmx *atscd)
 GF_EXPORT
 GF_Err gf_atsc3_dmx_process(GF_ATSCDmx *atscd)
 {
-	u32 i, count;
-	GF_Err e;
+	u32 i, count, nb_queued=0;
+	GF_Err e, sel_e;
 
-	//check all active sockets
-	e = gf_sk_group_select(atscd->active_sockets, 10, GF_SK_SELECT_READ);
-	if (e) return e;
+	//check all active sockets - in threaded mode, only the LLS socket is usually in this group
+	sel_e = gf_sk_group_select(atscd->active_sockets, 10, GF_SK_SELECT_READ);
+	if (sel_e && !atscd->threaded) return sel_e;
 
-	if (gf_sk_group_sock_is_set(atscd->active_sockets, atscd->sock, GF_SK_SELECT_READ)) {
+	if (!sel_e && gf_sk_group_sock_is_set(atscd->active_sockets, atscd->sock, GF_SK_SELECT_READ)) {
 		e = gf_atsc3_dmx_process_lls(atscd);
 		if (e) return e;
 	}
@@ -1730,27 +1952,94 @@ GF_Err gf_atsc3_dmx_process(GF_ATSCDmx *atscd)
 		u32 j;
 		GF_ATSCRouteSession *rsess;
 		GF_ATSCService *s = (GF_ATSCService *)gf_list_get(atscd->services, i);
+
+		if (s->worker)
+			nb_queued += gf_atsc3_dmx_process_worker(atscd, s, s->worker, (s->tune_mode==GF_ATSC_TUNE_OFF) ? GF_TRUE : GF_FALSE);
+
 		if (s->tune_mode==GF_ATSC_TUNE_OFF) continue;
 
-		if (gf_sk_group_sock_is_set(atscd->active_sockets, s->sock, GF_SK_SELECT_READ)) {
+		if (!sel_e && gf_sk_group_sock_is_set(atscd->active_sockets, s->sock, GF_SK_SELECT_READ)) {
 			e = gf_atsc3_dmx_process_service(atscd, s, NULL);
 			if (e) return e;
 		}
-		if (s->tune_mode!=GF_ATSC_TUNE_ON) continue;
 		if (!s->secondary_sockets) continue;
 
 		j=0;
 		while ((rsess = (GF_ATSCRouteSession *)gf_list_enum(s->route_sessions, &j) )) {
-			if (gf_sk_group_sock_is_set(atscd->active_sockets, rsess->sock, GF_SK_SELECT_READ)) {
+			if (rsess->worker)
+				nb_queued += gf_atsc3_dmx_process_worker(atscd, s, rsess->worker, (s->tune_mode!=GF_ATSC_TUNE_ON) ? GF_TRUE : GF_FALSE);
+
+			if (s->tune_mode!=GF_ATSC_TUNE_ON) continue;
+			if (!sel_e && gf_sk_group_sock_is_set(atscd->active_sockets, rsess->sock, GF_SK_SELECT_READ)) {
 				e = gf_atsc3_dmx_process_service(atscd, s, rsess);
 				if (e) return e;
 			}
 		}
 
 	}
+	if (sel_e && !nb_queued) return sel_e;
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_atsc3_set_threaded(GF_ATSCDmx *atscd, Bool threaded)
+{
+	if (!atscd) return GF_BAD_PARAM;
+	if (gf_list_count(atscd->services)) return GF_BAD_PARAM;
+	atscd->threaded = threaded;
 	return GF_OK;
 }
 
+GF_EXPORT
+u8 *gf_atsc3_dmx_hold_object_data(GF_ATSCDmx *atscd, GF_ATSCEventFileInfo *finfo)
+{
+	GF_ATSCPayload *p;
+	GF_LCTObject *obj;
+	if (!atscd || !finfo) return NULL;
+	obj = atscd->dispatch_obj;
+	if (!obj || !obj->payload || (finfo->data != (u8 *) obj->payload)) return NULL;
+
+	GF_SAFEALLOC(p, GF_ATSCPayload);
+	if (!p) return NULL;
+	p->data = obj->payload;
+	p->alloc_size = obj->alloc_size;
+	gf_mx_p(atscd->pool_mx);
+	gf_list_add(atscd->held_payloads, p);
+	gf_mx_v(atscd->pool_mx);
+
+	obj->payload = NULL;
+	obj->alloc_size = 0;
+	return p->data;
+}
+
+GF_EXPORT
+void gf_atsc3_dmx_release_object_data(GF_ATSCDmx *atscd, u8 *data)
+{
+	u32 i, count;
+	GF_ATSCPayload *p = NULL;
+	if (!atscd || !data) return;
+
+	gf_mx_p(atscd->pool_mx);
+	count = gf_list_count(atscd->held_payloads);
+	for (i=0; i<count; i++) {
+		p = gf_list_get(atscd->held_payloads, i);
+		if (p->data == data) {
+			gf_list_rem(atscd->held_payloads, i);
+			break;
+		}
+		p = NULL;
+	}
+	if (!p) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ATSC, ("[ATSC3] Released object data %p not held by demuxer\n", data));
+	} else if (gf_list_count(atscd->payload_pool) < GF_ATSC_MAX_POOL) {
+		gf_list_add(atscd->payload_pool, p);
+	} else {
+		gf_free(p->data);
+		gf_free(p);
+	}
+	gf_mx_v(atscd->pool_mx);
+}
+
 GF_EXPORT
 GF_Err gf_atsc3_set_callback(GF_ATSCDmx *atscd, void (*on_event)(void *udta, GF_ATSCEventType evt, u32 evt_param, GF_ATSCEventFileInfo *info), void *udta)
 {
@@ -95,6 +95,8 @@ struct __dash_client
 	u32 reload_count, last_update_time;
 	/*signature of last MPD*/
 	u8 lastMPDSignature[GF_SHA1_DIGEST_SIZE];
+	/*DOM of last MPD, only kept if the MPD can be updated through MPD patches*/
+	GF_XMLNode *mpd_dom;
 	/*mime type of media segments (m3u8)*/
 	char *mimeTypeForM3U8Segments;
 
@@ -1667,7 +1669,7 @@ static u32 gf_dash_purge_segment_timeline(GF_DASH_Group *group, Double min_start
 		}
 		start_time += ent->duration;
 		gf_list_rem(timeline->entries, 0);
-		gf_free(ent);
+		gf_mpd_segment_entry_free(ent);
 		nb_removed++;
 	}
 	if (nb_removed) {
@@ -1801,6 +1803,76 @@ static void gf_dash_mark_group_done(GF_DASH_Group *group)
 	group->done = GF_TRUE;
 }
 
+/*keeps the MPD DOM if the MPD signals a patch location, detaching it from the parser*/
+static void gf_dash_store_mpd_dom(GF_DashClient *dash, GF_DOMParser *mpd_parser)
+{
+	u32 i=0;
+	GF_XMLNode *child, *root;
+	if (dash->mpd_dom) {
+		gf_xml_dom_node_del(dash->mpd_dom);
+		dash->mpd_dom = NULL;
+	}
+	root = gf_xml_dom_get_root(mpd_parser);
+	if (!root || dash->is_smooth) return;
+	while ((child = gf_list_enum(root->content, &i))) {
+		if ((child->type == GF_XML_NODE_TYPE) && !strcmp(child->name, "PatchLocation")) {
+			dash->mpd_dom = gf_xml_dom_detach_root(mpd_parser);
+			return;
+		}
+	}
+}
+
+/*fetches the MPD patch and applies it on the DOM of the current MPD
+returns GF_EOS if the MPD is unchanged, GF_OK and the new MPD if the patch was applied, or an error if a full MPD fetch is required*/
+static GF_Err gf_dash_update_manifest_patch(GF_DashClient *dash, GF_MPD **out_mpd)
+{
+	GF_Err e;
+	char *url;
+	const char *local_url;
+	GF_DOMParser *patch_parser;
+	GF_MPD *new_mpd;
+	GF_MPD_PatchLocation *pl = gf_list_get(dash->mpd->patch_locations, 0);
+
+	if (!pl || !dash->mpd->ID) return GF_NOT_SUPPORTED;
+	if (pl->ttl && dash->mpd->publishTime && (gf_net_get_utc() > dash->mpd->publishTime + pl->ttl)) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] MPD patch location expired\n"));
+		return GF_NOT_FOUND;
+	}
+
+	url = gf_url_concatenate(dash->base_url, pl->url);
+	if (!url) return GF_OUT_OF_MEM;
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Fetching MPD patch %s\n", url));
+	e = gf_dash_download_resource(dash, &(dash->mpd_dnload), url, 0, 0, 0, NULL);
+	gf_free(url);
+	if (e) return e;
+
+	local_url = dash->dash_io->get_cache_name(dash->dash_io, dash->mpd_dnload);
+	if (!local_url) return GF_IO_ERR;
+
+	patch_parser = gf_xml_dom_new();
+	e = gf_xml_dom_parse(patch_parser, local_url, NULL, NULL);
+	if (!e)
+		e = gf_mpd_apply_patch(dash->mpd_dom, gf_xml_dom_get_root(patch_parser));
+	gf_xml_dom_del(patch_parser);
+	gf_file_delete(local_url);
+	if (e) return e;
+
+	//the patched DOM is kept for the next patch
+	new_mpd = gf_mpd_new();
+	e = gf_mpd_init_from_dom(dash->mpd_dom, new_mpd, dash->base_url);
+	if (e) {
+		gf_mpd_del(new_mpd);
+		return e;
+	}
+	if (dash->ignore_xlink)
+		dash_purge_xlink(new_mpd);
+	if (dash->split_adaptation_set)
+		gf_mpd_split_adaptation_sets(new_mpd);
+
+	*out_mpd = new_mpd;
+	return GF_OK;
+}
+
 static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 {
 	GF_Err e;
@@ -1810,13 +1882,37 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 	GF_DOMParser *mpd_parser;
 	u8 signature[GF_SHA1_DIGEST_SIZE];
 	GF_MPD_Period *period, *new_period;
-	const char *local_url;
+	const char *local_url=NULL;
 	char mime[128];
-	char * purl;
+	char * purl=NULL;
 	Double timeline_start_time;
 	GF_MPD *new_mpd=NULL;
 	Bool fetch_only = GF_FALSE;
 
+	if (dash->mpd_dom && dash->mpd_dnload) {
+		e = gf_dash_update_manifest_patch(dash, &new_mpd);
+		if (e==GF_EOS) {
+			dash->reload_count++;
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] MPD patch did not change MPD for %d consecutive reloads\n", dash->reload_count));
+			dash->last_update_time = gf_sys_clock();
+			dash->mpd_fetch_time = dash_get_fetch_time(dash);
+			return GF_OK;
+		}
+		if (e) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Cannot update MPD through patch: %s - fetching full MPD\n", gf_error_to_string(e)));
+			gf_xml_dom_node_del(dash->mpd_dom);
+			dash->mpd_dom = NULL;
+		} else {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] MPD updated through patch\n"));
+			force_timeline_setup = dash->in_error;
+			dash->in_error = GF_FALSE;
+			dash->reload_count = 0;
+			//the next full MPD fetch shall not be compared with the MPD prior to the patches
+			memset(dash->lastMPDSignature, 0, GF_SHA1_DIGEST_SIZE);
+			goto mpd_updated;
+		}
+	}
+
 	if (!dash->mpd_dnload) {
 		local_url = purl = NULL;
 		if (!gf_list_count(dash->mpd->locations)) {
@@ -1914,6 +2010,7 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 		purl = NULL;
 	}
 
+mpd_updated:
 	fetch_time = dash_get_fetch_time(dash);
 
 	// parse the mpd file for filling the GF_MPD structure. Note: for m3u8, MPD has been fetched above
@@ -1955,21 +2052,38 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 		memcpy(dash->lastMPDSignature, signature, GF_SHA1_DIGEST_SIZE);
 
 		/* It means we have to reparse the file ... */
-		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
-		if (e != GF_OK) {
-			gf_xml_dom_del(mpd_parser);
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in XML parsing %s\n", gf_error_to_string(e)));
-			return GF_NON_COMPLIANT_BITSTREAM;
+		/* parse the MPD with SAX when no DOM is needed for patches, sharing the unchanged SegmentTimeline entries with the current MPD*/
+		if (!dash->is_smooth && !gf_list_count(dash->mpd->patch_locations)) {
+			new_mpd = gf_mpd_new();
+			e = gf_mpd_init_from_file(local_url, new_mpd, purl, dash->mpd);
+			if (e) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in MPD creation %s\n", gf_error_to_string(e)));
+				gf_mpd_del(new_mpd);
+				return GF_NON_COMPLIANT_BITSTREAM;
+			}
+			//PatchLocation added in this version, parse again to keep the DOM
+			if (gf_list_count(new_mpd->patch_locations)) {
+				gf_mpd_del(new_mpd);
+				new_mpd = NULL;
+			}
 		}
-		new_mpd = gf_mpd_new();
-		e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), new_mpd, purl);
-		gf_xml_dom_del(mpd_parser);
-		if (e) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in MPD creation %s\n", gf_error_to_string(e)));
-			gf_mpd_del(new_mpd);
-			return GF_NON_COMPLIANT_BITSTREAM;
+		if (!new_mpd) {
+			mpd_parser = gf_xml_dom_new();
+			e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
+			if (e != GF_OK) {
+				gf_xml_dom_del(mpd_parser);
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in XML parsing %s\n", gf_error_to_string(e)));
+				return GF_NON_COMPLIANT_BITSTREAM;
+			}
+			new_mpd = gf_mpd_new();
+			e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), new_mpd, purl);
+			if (!e) gf_dash_store_mpd_dom(dash, mpd_parser);
+			gf_xml_dom_del(mpd_parser);
+			if (e) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in MPD creation %s\n", gf_error_to_string(e)));
+				gf_mpd_del(new_mpd);
+				return GF_NON_COMPLIANT_BITSTREAM;
+			}
 		}
 		if (dash->ignore_xlink)
 			dash_purge_xlink(new_mpd);
@@ -7405,6 +7519,7 @@ GF_Err gf_dash_open(GF_DashClient *dash, const char *manifest_url)
 			e = gf_mpd_init_smooth_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
 		} else {
 			e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
+			if (!e) gf_dash_store_mpd_dom(dash, mpd_parser);
 		}
 		gf_xml_dom_del(mpd_parser);
 
@@ -7493,6 +7608,9 @@ void gf_dash_close(GF_DashClient *dash)
 	if (dash->mpd)
 		gf_mpd_del(dash->mpd);
 	dash->mpd = NULL;
+	if (dash->mpd_dom)
+		gf_xml_dom_node_del(dash->mpd_dom);
+	dash->mpd_dom = NULL;
 
 	if (dash->dash_state != GF_DASH_STATE_CONNECTING)
 		gf_dash_reset_groups(dash);
@@ -351,12 +351,43 @@ static void gf_mpd_parse_segment_base_generic(GF_MPD *mpd, GF_MPD_SegmentBase *s
 	}
 }
 
+static void gf_mpd_parse_segment_timeline_entry(GF_MPD_SegmentTimelineEntry *seg_tl_ent, const char *name, const char *value)
+{
+	if (!strcmp(name, "t"))
+		seg_tl_ent->start_time = gf_mpd_parse_long_int(value);
+	else if (!strcmp(name, "d"))
+		seg_tl_ent->duration = gf_mpd_parse_int(value);
+	else if (!strcmp(name, "r")) {
+		seg_tl_ent->repeat_count = gf_mpd_parse_int(value);
+		if (seg_tl_ent->repeat_count == (u32)-1)
+			seg_tl_ent->repeat_count--;
+	}
+}
+
+typedef struct
+{
+	GF_XMLNode *node;
+	GF_MPD_SegmentTimeline *timeline;
+} GF_MPD_SAXTimeline;
+
 static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XMLNode *root)
 {
 	u32 i, j;
 	GF_XMLAttribute *att;
 	GF_XMLNode *child;
 	GF_MPD_SegmentTimeline *seg;
+	GF_MPD_SAXTimeline *sax_tl;
+
+	//timeline already parsed by the SAX loader
+	i = 0;
+	while ((sax_tl = gf_list_enum(mpd->sax_timelines, &i))) {
+		if (sax_tl->node != root) continue;
+		seg = sax_tl->timeline;
+		gf_list_rem(mpd->sax_timelines, i-1);
+		gf_free(sax_tl);
+		return seg;
+	}
+
 	GF_SAFEALLOC(seg, GF_MPD_SegmentTimeline);
 	if (!seg) return NULL;
 	seg->entries = gf_list_new();
@@ -372,15 +403,7 @@ static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XML
 
 			j = 0;
 			while ( (att = gf_list_enum(child->attributes, &j)) ) {
-				if (!strcmp(att->name, "t"))
-					seg_tl_ent->start_time = gf_mpd_parse_long_int(att->value);
-				else if (!strcmp(att->name, "d"))
-					seg_tl_ent->duration = gf_mpd_parse_int(att->value);
-				else if (!strcmp(att->name, "r")) {
-					seg_tl_ent->repeat_count = gf_mpd_parse_int(att->value);
-					if (seg_tl_ent->repeat_count == (u32)-1)
-						seg_tl_ent->repeat_count--;
-				}
+				gf_mpd_parse_segment_timeline_entry(seg_tl_ent, att->name, att->value);
 			}
 		}
 	}
@@ -538,19 +561,28 @@ static GF_Err gf_mpd_parse_content_component(GF_List *comps, GF_XMLNode *root)
 	return GF_OK;
 }
 
-#define MPD_STORE_EXTENSION_ATTR(_elem)	\
+//extensions are moved out of the DOM, or copied if the DOM is kept to be parsed again (MPD patch)
+#define MPD_STORE_EXTENSION_ATTR(_elem, _keep_dom)	\
 			if (!_elem->attributes) _elem->attributes = gf_list_new();	\
-			i--;	\
-			gf_list_rem(root->attributes, i);	\
-			gf_list_add(_elem->attributes, att);	\
+			if (_keep_dom) {	\
+				gf_list_add(_elem->attributes, gf_xml_dom_create_attribute(att->name, att->value));	\
+			} else {	\
+				i--;	\
+				gf_list_rem(root->attributes, i);	\
+				gf_list_add(_elem->attributes, att);	\
+			}	\
 
-#define MPD_STORE_EXTENSION_NODE(_elem)	\
+#define MPD_STORE_EXTENSION_NODE(_elem, _keep_dom)	\
 		if (!_elem->children) _elem->children = gf_list_new();	\
-		i--;	\
-		gf_list_rem(root->content, i);	\
-		gf_list_add(_elem->children, child);	\
+		if (_keep_dom) {	\
+			gf_list_add(_elem->children, gf_xml_dom_node_clone(child));	\
+		} else {	\
+			i--;	\
+			gf_list_rem(root->content, i);	\
+			gf_list_add(_elem->children, child);	\
+		}	\
 
-static GF_Err gf_mpd_parse_descriptor_ex(GF_List *container, GF_MPD_Descriptor **out_ptr, GF_XMLNode *root)
+static GF_Err gf_mpd_parse_descriptor_ex(GF_MPD *mpd, GF_List *container, GF_MPD_Descriptor **out_ptr, GF_XMLNode *root)
 {
 	GF_XMLAttribute *att;
 	GF_XMLNode *child;
@@ -565,7 +597,7 @@ static GF_Err gf_mpd_parse_descriptor_ex(GF_List *container, GF_MPD_Descriptor *
 		else if (!strcmp(att->name, "value")) mpd_desc->value = gf_mpd_parse_string(att->value);
 		else if (!strcmp(att->name, "id")) mpd_desc->id = gf_mpd_parse_string(att->value);
 		else {
-			MPD_STORE_EXTENSION_ATTR(mpd_desc)
+			MPD_STORE_EXTENSION_ATTR(mpd_desc, mpd->keep_dom)
 		}
 	}
 	if (container)
@@ -580,18 +612,18 @@ static GF_Err gf_mpd_parse_descriptor_ex(GF_List *container, GF_MPD_Descriptor *
 	while ( (child = gf_list_enum(root->content, &i))) {
 		if (child->type != GF_XML_NODE_TYPE) continue;
 
-		MPD_STORE_EXTENSION_NODE(mpd_desc)
+		MPD_STORE_EXTENSION_NODE(mpd_desc, mpd->keep_dom)
 
 	}
 	return GF_OK;
 }
 
-static GF_Err gf_mpd_parse_descriptor(GF_List *container, GF_XMLNode *root)
+static GF_Err gf_mpd_parse_descriptor(GF_MPD *mpd, GF_List *container, GF_XMLNode *root)
 {
-	return gf_mpd_parse_descriptor_ex(container, NULL, root);
+	return gf_mpd_parse_descriptor_ex(mpd, container, NULL, root);
 }
 
-GF_MPD_ProducerReferenceTime *gf_mpd_parse_produce_ref_time(GF_XMLNode *root)
+GF_MPD_ProducerReferenceTime *gf_mpd_parse_produce_ref_time(GF_MPD *mpd, GF_XMLNode *root)
 {
 	GF_XMLAttribute *att;
 	GF_XMLNode *child;
@@ -617,7 +649,7 @@ GF_MPD_ProducerReferenceTime *gf_mpd_parse_produce_ref_time(GF_XMLNode *root)
 	while ( (child = gf_list_enum(root->content, &i))) {
 		if (child->type != GF_XML_NODE_TYPE) continue;
 		if (!strcmp(child->name, "UTCTiming"))
-			gf_mpd_parse_descriptor_ex(NULL, &pref->utc_timing, child);
+			gf_mpd_parse_descriptor_ex(mpd, NULL, &pref->utc_timing, child);
 	}
 	return pref;
 }
@@ -665,22 +697,22 @@ static void gf_mpd_parse_common_representation(GF_MPD *mpd, GF_MPD_CommonAttribu
 	while ( (child = gf_list_enum(root->content, &i))) {
 		if (!gf_mpd_valid_child(mpd, child)) continue;
 		if (!strcmp(child->name, "FramePacking")) {
-			gf_mpd_parse_descriptor(com->frame_packing, child);
+			gf_mpd_parse_descriptor(mpd, com->frame_packing, child);
 		}
 		else if (!strcmp(child->name, "AudioChannelConfiguration")) {
-			gf_mpd_parse_descriptor(com->audio_channels, child);
+			gf_mpd_parse_descriptor(mpd, com->audio_channels, child);
 		}
 		else if (!strcmp(child->name, "ContentProtection")) {
-			gf_mpd_parse_descriptor(com->content_protection, child);
+			gf_mpd_parse_descriptor(mpd, com->content_protection, child);
 		}
 		else if (!strcmp(child->name, "EssentialProperty")) {
-			gf_mpd_parse_descriptor(com->essential_properties, child);
+			gf_mpd_parse_descriptor(mpd, com->essential_properties, child);
 		}
 		else if (!strcmp(child->name, "SupplementalProperty")) {
-			gf_mpd_parse_descriptor(com->supplemental_properties, child);
+			gf_mpd_parse_descriptor(mpd, com->supplemental_properties, child);
 		}
 		else if (!strcmp(child->name, "ProducerReferenceTime")) {
-			GF_MPD_ProducerReferenceTime *pref = gf_mpd_parse_produce_ref_time(child);
+			GF_MPD_ProducerReferenceTime *pref = gf_mpd_parse_produce_ref_time(mpd, child);
 			if (pref) {
 				if (!com->producer_reference_time) com->producer_reference_time = gf_list_new();
 				gf_list_add(com->producer_reference_time, pref);
@@ -922,19 +954,19 @@ static GF_Err gf_mpd_parse_adaptation_set(GF_MPD *mpd, GF_List *container, GF_XM
 	while ( (child = gf_list_enum(root->content, &i))) {
 		if (!gf_mpd_valid_child(mpd, child)) continue;
 		if (!strcmp(child->name, "Accessibility")) {
-			e = gf_mpd_parse_descriptor(set->accessibility, child);
+			e = gf_mpd_parse_descriptor(mpd, set->accessibility, child);
 			if (e) return e;
 		}
 		else if (!strcmp(child->name, "Role")) {
-			e = gf_mpd_parse_descriptor(set->role, child);
+			e = gf_mpd_parse_descriptor(mpd, set->role, child);
 			if (e) return e;
 		}
 		else if (!strcmp(child->name, "Rating")) {
-			e = gf_mpd_parse_descriptor(set->rating, child);
+			e = gf_mpd_parse_descriptor(mpd, set->rating, child);
 			if (e) return e;
 		}
 		else if (!strcmp(child->name, "Viewpoint")) {
-			e = gf_mpd_parse_descriptor(set->viewpoint, child);
+			e = gf_mpd_parse_descriptor(mpd, set->viewpoint, child);
 			if (e) return e;
 		}
 		else if (!strcmp(child->name, "BaseURL")) {
@@ -1073,6 +1105,13 @@ void gf_mpd_string_free(void *_item)
 	if (_item) gf_free(_item);
 }
 
+void gf_mpd_patch_location_free(void *_item)
+{
+	GF_MPD_PatchLocation *ptr = (GF_MPD_PatchLocation *)_item;
+	if (ptr->url) gf_free(ptr->url);
+	gf_free(ptr);
+}
+
 void gf_mpd_prog_info_free(void *_item)
 {
 	GF_MPD_ProgramInfo *ptr = (GF_MPD_ProgramInfo *)_item;
@@ -1104,7 +1143,13 @@ void gf_mpd_segment_base_free(void *_item)
 
 void gf_mpd_segment_entry_free(void *_item)
 {
-	gf_free(_item);
+	GF_MPD_SegmentTimelineEntry *ptr = (GF_MPD_SegmentTimelineEntry *)_item;
+	//shared with the timeline of another version of the MPD
+	if (ptr->nb_refs) {
+		ptr->nb_refs--;
+		return;
+	}
+	gf_free(ptr);
 }
 void gf_mpd_segment_timeline_free(void *_item)
 {
@@ -1336,6 +1381,7 @@ void gf_mpd_del(GF_MPD *mpd)
 	gf_mpd_del_list(mpd->program_infos, gf_mpd_prog_info_free, 0);
 	gf_mpd_del_list(mpd->base_URLs, gf_mpd_base_url_free, 0);
 	gf_mpd_del_list(mpd->locations, gf_mpd_string_free, 0);
+	gf_mpd_del_list(mpd->patch_locations, gf_mpd_patch_location_free, 0);
 	gf_mpd_del_list(mpd->metrics, NULL/*TODO*/, 0);
 	gf_mpd_del_list(mpd->periods, gf_mpd_period_free, 0);
 	if (mpd->profiles) gf_free(mpd->profiles);
@@ -1356,6 +1402,15 @@ GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *defau
 	GF_XMLNode *child;
 
 	if (!root || !mpd) return GF_BAD_PARAM;
+	//the DOM of MPDs with a PatchLocation is kept by the client and parsed again after each patch
+	mpd->keep_dom = GF_FALSE;
+	i=0;
+	while ((child = gf_list_enum(root->content, &i))) {
+		if ((child->type == GF_XML_NODE_TYPE) && !strcmp(child->name, "PatchLocation")) {
+			mpd->keep_dom = GF_TRUE;
+			break;
+		}
+	}
 	i=0;
 	while ((att = gf_list_enum(root->attributes, &i))) {
 		if (!strcmp(att->name, "xmlns")) {
@@ -1419,7 +1474,7 @@ GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *defau
 		} else if (!strcmp(att->name, "gpac:mpd_time")) {
 			mpd->gpac_mpd_time = gf_mpd_parse_long_int(att->value);
 		} else {
-			MPD_STORE_EXTENSION_ATTR(mpd)
+			MPD_STORE_EXTENSION_ATTR(mpd, mpd->keep_dom)
 		}
 	}
 	if (mpd->type == GF_MPD_TYPE_STATIC)
@@ -1436,6 +1491,17 @@ GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *defau
 		} else if (!strcmp(child->name, "Location")) {
 			char *str = gf_mpd_parse_text_content(child);
 			if (str) gf_list_add(mpd->locations, str);
+		} else if (!strcmp(child->name, "PatchLocation")) {
+			GF_MPD_PatchLocation *pl;
+			u32 j=0;
+			GF_SAFEALLOC(pl, GF_MPD_PatchLocation);
+			if (!pl) return GF_OUT_OF_MEM;
+			pl->url = gf_mpd_parse_text_content(child);
+			while ((att = gf_list_enum(child->attributes, &j))) {
+				if (!strcmp(att->name, "ttl")) pl->ttl = (u64) (gf_mpd_parse_double(att->value) * 1000);
+			}
+			if (pl->url) gf_list_add(mpd->patch_locations, pl);
+			else gf_free(pl);
 		} else if (!strcmp(child->name, "Period")) {
 			e = gf_mpd_parse_period(mpd, child);
 			if (e) return e;
@@ -1445,9 +1511,9 @@ GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *defau
 			e = gf_mpd_parse_base_url(mpd->base_URLs, child);
 			if (e) return e;
 		} else if (!strcmp(child->name, "UTCTiming")) {
-			gf_mpd_parse_descriptor(mpd->utc_timings, child);
+			gf_mpd_parse_descriptor(mpd, mpd->utc_timings, child);
 		} else {
-			MPD_STORE_EXTENSION_NODE(mpd)
+			MPD_STORE_EXTENSION_NODE(mpd, mpd->keep_dom)
 		}
 	}
 
@@ -1461,6 +1527,7 @@ static void gf_mpd_init_struct(GF_MPD *mpd)
 	mpd->program_infos = gf_list_new();
 	mpd->base_URLs = gf_list_new();
 	mpd->locations = gf_list_new();
+	mpd->patch_locations = gf_list_new();
 	mpd->metrics = gf_list_new();
 	mpd->utc_timings = gf_list_new();
 }
@@ -1480,6 +1547,621 @@ GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_b
 	return gf_mpd_complete_from_dom(root, mpd, default_base_url);
 }
 
+typedef struct
+{
+	GF_SAXParser *sax;
+	GF_Err e;
+	GF_List *stack;
+	GF_XMLNode *root;
+	//parsed SegmentTimeline, in document order
+	GF_List *timelines;
+	//SegmentTimeline being parsed, depth of its children being skipped and end time of its last entry
+	GF_MPD_SAXTimeline *tl;
+	u32 skip_depth;
+	u64 tl_time;
+
+	//elements of the previous MPD matching the ones being parsed
+	GF_MPD *prev_mpd;
+	GF_MPD_Period *prev_period;
+	GF_MPD_AdaptationSet *prev_set;
+	GF_MPD_Representation *prev_rep;
+	u32 nb_periods, nb_sets;
+	//timeline of the previous MPD matching the one being parsed, index and start time of its next entry
+	GF_MPD_SegmentTimeline *prev_tl;
+	u32 prev_idx;
+	u64 prev_time;
+	//timelines of the previous MPD already matched, so that an entry is never shared by two timelines of the new MPD
+	GF_List *prev_timelines;
+	u32 nb_shared;
+} GF_MPD_SAXLoader;
+
+static void mpd_sax_error(GF_MPD_SAXLoader *ld, GF_Err e)
+{
+	ld->e = e;
+	gf_xml_sax_suspend(ld->sax, GF_TRUE);
+}
+
+static const char *mpd_sax_get_att(const GF_XMLAttribute *attributes, u32 nb_attributes, const char *name)
+{
+	u32 i;
+	for (i=0; i<nb_attributes; i++) {
+		if (!strcmp(attributes[i].name, name)) return attributes[i].value;
+	}
+	return NULL;
+}
+
+//locates the element of the previous MPD matching the Period, AdaptationSet or Representation starting
+static void mpd_sax_locate_prev(GF_MPD_SAXLoader *ld, const char *node_name, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	const char *id = mpd_sax_get_att(attributes, nb_attributes, "id");
+
+	if (!strcmp(node_name, "Period")) {
+		GF_MPD_Period *period;
+		ld->prev_period = NULL;
+		if (id) {
+			i = 0;
+			while ((period = gf_list_enum(ld->prev_mpd->periods, &i))) {
+				if (period->ID && !strcmp(period->ID, id)) {
+					ld->prev_period = period;
+					break;
+				}
+			}
+		} else {
+			ld->prev_period = gf_list_get(ld->prev_mpd->periods, ld->nb_periods);
+		}
+		ld->nb_periods++;
+		ld->nb_sets = 0;
+		ld->prev_set = NULL;
+		ld->prev_rep = NULL;
+	}
+	else if (!strcmp(node_name, "AdaptationSet")) {
+		GF_MPD_AdaptationSet *set;
+		ld->prev_set = NULL;
+		ld->prev_rep = NULL;
+		if (!ld->prev_period) return;
+		if (id) {
+			i = 0;
+			while ((set = gf_list_enum(ld->prev_period->adaptation_sets, &i))) {
+				if (set->id == (u32) atoi(id)) {
+					ld->prev_set = set;
+					break;
+				}
+			}
+		} else {
+			ld->prev_set = gf_list_get(ld->prev_period->adaptation_sets, ld->nb_sets);
+		}
+		ld->nb_sets++;
+	}
+	else if (!strcmp(node_name, "Representation")) {
+		GF_MPD_Representation *rep;
+		ld->prev_rep = NULL;
+		//representations may have been reordered, only match them by ID
+		if (!ld->prev_set || !id) return;
+		i = 0;
+		while ((rep = gf_list_enum(ld->prev_set->representations, &i))) {
+			if (rep->id && !strcmp(rep->id, id)) {
+				ld->prev_rep = rep;
+				break;
+			}
+		}
+	}
+}
+
+//gets the timeline of the previous MPD at the same place as the SegmentTimeline starting
+static GF_MPD_SegmentTimeline *mpd_sax_get_prev_timeline(GF_MPD_SAXLoader *ld)
+{
+	GF_MPD_SegmentList *seg_list = NULL;
+	GF_MPD_SegmentTemplate *seg_template = NULL;
+	GF_MPD_SegmentTimeline *prev_tl = NULL;
+	u32 count = gf_list_count(ld->stack);
+	GF_XMLNode *seg = gf_list_get(ld->stack, count-1);
+	GF_XMLNode *parent = (count>1) ? gf_list_get(ld->stack, count-2) : NULL;
+	if (!seg || !parent) return NULL;
+
+	if (!strcmp(parent->name, "Representation")) {
+		if (!ld->prev_rep) return NULL;
+		seg_list = ld->prev_rep->segment_list;
+		seg_template = ld->prev_rep->segment_template;
+	} else if (!strcmp(parent->name, "AdaptationSet")) {
+		if (!ld->prev_set) return NULL;
+		seg_list = ld->prev_set->segment_list;
+		seg_template = ld->prev_set->segment_template;
+	} else if (!strcmp(parent->name, "Period")) {
+		if (!ld->prev_period) return NULL;
+		seg_list = ld->prev_period->segment_list;
+		seg_template = ld->prev_period->segment_template;
+	}
+	if (!strcmp(seg->name, "SegmentTemplate")) prev_tl = seg_template ? seg_template->segment_timeline : NULL;
+	else if (!strcmp(seg->name, "SegmentList")) prev_tl = seg_list ? seg_list->segment_timeline : NULL;
+
+	if (!prev_tl || (gf_list_find(ld->prev_timelines, prev_tl)>=0)) return NULL;
+	gf_list_add(ld->prev_timelines, prev_tl);
+	return prev_tl;
+}
+
+//gets the entry of the previous timeline identical to the new one starting at the same time, if any
+static GF_MPD_SegmentTimelineEntry *mpd_sax_get_prev_entry(GF_MPD_SAXLoader *ld, GF_MPD_SegmentTimelineEntry *ent, u64 start)
+{
+	GF_MPD_SegmentTimelineEntry *prev;
+	while ((prev = gf_list_get(ld->prev_tl->entries, ld->prev_idx))) {
+		u64 prev_start = prev->start_time ? prev->start_time : ld->prev_time;
+		//open-ended repeat, we cannot compute timing past this entry
+		if ((s32) prev->repeat_count < 0) {
+			ld->prev_tl = NULL;
+			return NULL;
+		}
+		if (prev_start > start) return NULL;
+		ld->prev_idx++;
+		ld->prev_time = prev_start + (u64) prev->duration * (prev->repeat_count + 1);
+		if (prev_start < start) continue;
+
+		if ((prev->start_time == ent->start_time) && (prev->duration == ent->duration) && (prev->repeat_count == ent->repeat_count))
+			return prev;
+		return NULL;
+	}
+	return NULL;
+}
+
+static void mpd_sax_parse_entry(GF_MPD_SAXLoader *ld, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	u64 start;
+	Bool has_start = GF_FALSE;
+	GF_MPD_SegmentTimelineEntry s, *ent = NULL;
+
+	memset(&s, 0, sizeof(GF_MPD_SegmentTimelineEntry));
+	for (i=0; i<nb_attributes; i++) {
+		gf_mpd_parse_segment_timeline_entry(&s, attributes[i].name, attributes[i].value);
+		if (!strcmp(attributes[i].name, "t")) has_start = GF_TRUE;
+	}
+	start = has_start ? s.start_time : ld->tl_time;
+	if ((s32) s.repeat_count < 0) ld->prev_tl = NULL;
+
+	if (ld->prev_tl) ent = mpd_sax_get_prev_entry(ld, &s, start);
+	if (ent) {
+		ent->nb_refs++;
+		ld->nb_shared++;
+	} else {
+		GF_SAFEALLOC(ent, GF_MPD_SegmentTimelineEntry);
+		if (!ent) {
+			mpd_sax_error(ld, GF_OUT_OF_MEM);
+			return;
+		}
+		*ent = s;
+	}
+	gf_list_add(ld->tl->timeline->entries, ent);
+	ld->tl_time = start + (u64) s.duration * (s.repeat_count + 1);
+}
+
+static void mpd_sax_node_start(void *sax_cbck, const char *node_name, const char *name_space, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	GF_XMLNode *node;
+	GF_MPD_SAXLoader *ld = (GF_MPD_SAXLoader *)sax_cbck;
+
+	if (ld->e) return;
+
+	//S entries are parsed directly, other children of SegmentTimeline are ignored as done by the DOM parsing
+	if (ld->tl) {
+		if (!ld->skip_depth && !strcmp(node_name, "S")) {
+			GF_XMLNode *tl_node = ld->tl->node;
+			if ((!name_space && !tl_node->ns) || (name_space && tl_node->ns && !strcmp(name_space, tl_node->ns)))
+				mpd_sax_parse_entry(ld, attributes, nb_attributes);
+		}
+		ld->skip_depth++;
+		return;
+	}
+	//only one root element
+	if (ld->root && !gf_list_count(ld->stack)) {
+		gf_xml_sax_suspend(ld->sax, GF_TRUE);
+		return;
+	}
+
+	if (ld->prev_mpd) mpd_sax_locate_prev(ld, node_name, attributes, nb_attributes);
+
+	GF_SAFEALLOC(node, GF_XMLNode);
+	if (!node) {
+		mpd_sax_error(ld, GF_OUT_OF_MEM);
+		return;
+	}
+	node->attributes = gf_list_new();
+	node->content = gf_list_new();
+	node->name = gf_strdup(node_name);
+	if (name_space) node->ns = gf_strdup(name_space);
+	for (i=0; i<nb_attributes; i++) {
+		GF_XMLAttribute *att = gf_xml_dom_create_attribute(attributes[i].name, attributes[i].value);
+		if (!att) {
+			gf_xml_dom_node_del(node);
+			mpd_sax_error(ld, GF_OUT_OF_MEM);
+			return;
+		}
+		gf_list_add(node->attributes, att);
+	}
+
+	if (!strcmp(node_name, "SegmentTimeline")) {
+		GF_MPD_SAXTimeline *sax_tl;
+		GF_SAFEALLOC(sax_tl, GF_MPD_SAXTimeline);
+		if (sax_tl) {
+			GF_SAFEALLOC(sax_tl->timeline, GF_MPD_SegmentTimeline);
+		}
+		if (!sax_tl || !sax_tl->timeline) {
+			if (sax_tl) gf_free(sax_tl);
+			gf_xml_dom_node_del(node);
+			mpd_sax_error(ld, GF_OUT_OF_MEM);
+			return;
+		}
+		sax_tl->timeline->entries = gf_list_new();
+		sax_tl->node = node;
+		gf_list_add(ld->timelines, sax_tl);
+		ld->tl = sax_tl;
+		ld->skip_depth = 0;
+		ld->tl_time = 0;
+		ld->prev_tl = ld->prev_mpd ? mpd_sax_get_prev_timeline(ld) : NULL;
+		ld->prev_idx = 0;
+		ld->prev_time = 0;
+	}
+
+	if (!ld->root) ld->root = node;
+	gf_list_add(ld->stack, node);
+}
+
+static void mpd_sax_node_end(void *sax_cbck, const char *node_name, const char *name_space)
+{
+	GF_XMLNode *node, *parent;
+	GF_MPD_SAXLoader *ld = (GF_MPD_SAXLoader *)sax_cbck;
+
+	if (ld->e) return;
+	if (ld->tl) {
+		if (ld->skip_depth) {
+			ld->skip_depth--;
+			return;
+		}
+		ld->tl = NULL;
+	}
+
+	node = gf_list_pop_back(ld->stack);
+	if (!node || strcmp(node->name, node_name)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Invalid node stack: closing node is %s but %s was expected\n", node_name, node ? node->name : "unknown"));
+		if (node == ld->root) ld->root = NULL;
+		gf_xml_dom_node_del(node);
+		mpd_sax_error(ld, GF_NON_COMPLIANT_BITSTREAM);
+		return;
+	}
+	parent = gf_list_last(ld->stack);
+	if (parent) gf_list_add(parent->content, node);
+}
+
+static void mpd_sax_text(void *sax_cbck, const char *content, Bool is_cdata)
+{
+	GF_XMLNode *node, *parent;
+	GF_MPD_SAXLoader *ld = (GF_MPD_SAXLoader *)sax_cbck;
+
+	if (ld->e || ld->tl) return;
+	parent = gf_list_last(ld->stack);
+	if (!parent) return;
+
+	GF_SAFEALLOC(node, GF_XMLNode);
+	if (!node) {
+		mpd_sax_error(ld, GF_OUT_OF_MEM);
+		return;
+	}
+	node->type = is_cdata ? GF_XML_CDATA_TYPE : GF_XML_TEXT_TYPE;
+	node->name = gf_strdup(content);
+	gf_list_add(parent->content, node);
+}
+
+GF_EXPORT
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *base_url, GF_MPD *prev_mpd)
+{
+	GF_Err e;
+	GF_XMLNode *node;
+	GF_MPD_SAXTimeline *sax_tl;
+	GF_MPD_SAXLoader ld;
+
+	if (!file || !mpd) return GF_BAD_PARAM;
+
+	memset(&ld, 0, sizeof(GF_MPD_SAXLoader));
+	ld.prev_mpd = prev_mpd;
+	ld.prev_timelines = gf_list_new();
+	ld.stack = gf_list_new();
+	ld.timelines = gf_list_new();
+	ld.sax = gf_xml_sax_new(mpd_sax_node_start, mpd_sax_node_end, mpd_sax_text, &ld);
+	if (!ld.prev_timelines || !ld.stack || !ld.timelines || !ld.sax) {
+		e = GF_OUT_OF_MEM;
+	} else {
+		e = gf_xml_sax_parse_file(ld.sax, file, NULL);
+		if (e<0) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Failed to parse %s: %s (line %d)\n", file, gf_xml_sax_get_error(ld.sax), gf_xml_sax_get_line(ld.sax)));
+		} else {
+			e = ld.e;
+		}
+	}
+	//unclosed elements
+	while ((node = gf_list_pop_back(ld.stack))) {
+		if (node == ld.root) ld.root = NULL;
+		gf_xml_dom_node_del(node);
+		if (!e) e = GF_NON_COMPLIANT_BITSTREAM;
+	}
+	if (!e && !ld.root) e = GF_NON_COMPLIANT_BITSTREAM;
+
+	if (!e) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[MPD] %d SegmentTimeline entries shared with the previous MPD\n", ld.nb_shared));
+		mpd->sax_timelines = ld.timelines;
+		e = gf_mpd_init_from_dom(ld.root, mpd, base_url);
+		mpd->sax_timelines = NULL;
+	}
+
+	//timelines not used by the MPD
+	while ((sax_tl = gf_list_pop_back(ld.timelines))) {
+		gf_mpd_segment_timeline_free(sax_tl->timeline);
+		gf_free(sax_tl);
+	}
+	gf_list_del(ld.timelines);
+	gf_list_del(ld.prev_timelines);
+	gf_list_del(ld.stack);
+	if (ld.sax) gf_xml_sax_del(ld.sax);
+	if (ld.root) gf_xml_dom_node_del(ld.root);
+	return e;
+}
+
+static const char *gf_mpd_patch_get_att(GF_XMLNode *node, const char *name)
+{
+	u32 i=0;
+	GF_XMLAttribute *att;
+	while ((att = gf_list_enum(node->attributes, &i))) {
+		const char *att_name = strchr(att->name, ':');
+		if (!strcmp(att->name, name)) return att->value;
+		//prefixed attribute
+		if (att_name && strncmp(att->name, "xmlns:", 6) && !strcmp(att_name+1, name)) return att->value;
+	}
+	return NULL;
+}
+
+static char *gf_mpd_patch_get_text(GF_XMLNode *node)
+{
+	u32 i=0;
+	char *text = NULL;
+	GF_XMLNode *child;
+	while ((child = gf_list_enum(node->content, &i))) {
+		if ((child->type == GF_XML_TEXT_TYPE) || (child->type == GF_XML_CDATA_TYPE))
+			gf_dynstrcat(&text, child->name, NULL);
+	}
+	return text;
+}
+
+/*resolves a patch selector, restricted to absolute paths of element names with [@att='val'] or [pos] predicates and an optional final @att step*/
+static GF_XMLNode *gf_mpd_patch_select(GF_XMLNode *root, const char *sel, GF_XMLNode **parent, char szAtt[100])
+{
+	GF_XMLNode *cur = NULL, *par = NULL;
+	szAtt[0] = 0;
+	*parent = NULL;
+
+	while (sel[0] == '/') {
+		char szName[100];
+		u32 len, i, count, nb_match, pos=0, nb_preds=0;
+		char szPredAtt[2][100], *pred_val[2];
+		GF_List *candidates;
+		sel++;
+		len = (u32) strcspn(sel, "/[");
+		if (!len || (len>=100)) return NULL;
+		//attribute selection, must be last step
+		if (sel[0]=='@') {
+			if (!cur || sel[len]) return NULL;
+			strncpy(szAtt, sel+1, len-1);
+			szAtt[len-1] = 0;
+			*parent = par;
+			return cur;
+		}
+		strncpy(szName, sel, len);
+		szName[len] = 0;
+		//ignore namespace prefixes
+		if (strchr(szName, ':')) memmove(szName, strchr(szName, ':')+1, strlen(strchr(szName, ':')));
+		sel += len;
+
+		memset(pred_val, 0, sizeof(pred_val));
+		while (sel[0]=='[') {
+			const char *end = strchr(sel, ']');
+			if (!end) goto err;
+			sel++;
+			if (sel[0]=='@') {
+				const char *eq = strchr(sel, '=');
+				char quote;
+				if (!eq || (eq>end) || (nb_preds==2) || (eq-sel-1 >= 100)) goto err;
+				strncpy(szPredAtt[nb_preds], sel+1, eq-sel-1);
+				szPredAtt[nb_preds][eq-sel-1] = 0;
+				eq++;
+				quote = eq[0];
+				if ((quote!='\'') && (quote!='"')) goto err;
+				end = strchr(eq+1, quote);
+				if (!end) goto err;
+				pred_val[nb_preds] = gf_malloc(end - eq);
+				if (!pred_val[nb_preds]) goto err;
+				strncpy(pred_val[nb_preds], eq+1, end-eq-1);
+				pred_val[nb_preds][end-eq-1] = 0;
+				nb_preds++;
+				end = strchr(end, ']');
+				if (!end) goto err;
+			} else {
+				pos = atoi(sel);
+				if (!pos) goto err;
+			}
+			sel = end+1;
+		}
+
+		if (!cur) {
+			candidates = NULL;
+			count = 1;
+		} else {
+			candidates = cur->content;
+			count = gf_list_count(candidates);
+		}
+		nb_match = 0;
+		par = cur;
+		cur = NULL;
+		for (i=0; i<count; i++) {
+			GF_XMLNode *n = candidates ? gf_list_get(candidates, i) : root;
+			u32 j;
+			if (n->type != GF_XML_NODE_TYPE) continue;
+			if (strcmp(n->name, szName)) continue;
+			for (j=0; j<nb_preds; j++) {
+				const char *val = gf_mpd_patch_get_att(n, szPredAtt[j]);
+				if (!val || strcmp(val, pred_val[j])) break;
+			}
+			if (j<nb_preds) continue;
+			nb_match++;
+			if (pos && (nb_match != pos)) continue;
+			cur = n;
+			break;
+		}
+		for (i=0; i<nb_preds; i++) gf_free(pred_val[i]);
+		if (!cur) return NULL;
+		continue;
+
+err:
+		for (i=0; i<nb_preds; i++) gf_free(pred_val[i]);
+		return NULL;
+	}
+	if (sel[0]) return NULL;
+	*parent = par;
+	return cur;
+}
+
+static void gf_mpd_patch_set_att(GF_XMLNode *node, const char *name, char *value)
+{
+	u32 i=0;
+	GF_XMLAttribute *att;
+	while ((att = gf_list_enum(node->attributes, &i))) {
+		if (strcmp(att->name, name)) continue;
+		gf_free(att->value);
+		att->value = value;
+		return;
+	}
+	GF_SAFEALLOC(att, GF_XMLAttribute);
+	if (!att) {
+		gf_free(value);
+		return;
+	}
+	att->name = gf_strdup(name);
+	att->value = value;
+	if (!node->attributes) node->attributes = gf_list_new();
+	gf_list_add(node->attributes, att);
+}
+
+static GF_Err gf_mpd_patch_op(GF_XMLNode *root, GF_XMLNode *op)
+{
+	GF_XMLNode *target, *parent, *child;
+	char szAtt[100];
+	const char *sel = gf_mpd_patch_get_att(op, "sel");
+	if (!sel) return GF_NON_COMPLIANT_BITSTREAM;
+
+	target = gf_mpd_patch_select(root, sel, &parent, szAtt);
+	if (!target) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[MPD] Patch selector %s not found or not supported\n", sel));
+		return GF_NOT_FOUND;
+	}
+
+	if (!strcmp(op->name, "remove")) {
+		if (szAtt[0]) {
+			u32 i=0;
+			GF_XMLAttribute *att;
+			while ((att = gf_list_enum(target->attributes, &i))) {
+				if (strcmp(att->name, szAtt)) continue;
+				gf_list_rem(target->attributes, i-1);
+				gf_free(att->name);
+				gf_free(att->value);
+				gf_free(att);
+				return GF_OK;
+			}
+			return GF_NOT_FOUND;
+		}
+		if (!parent) return GF_NON_COMPLIANT_BITSTREAM;
+		gf_list_del_item(parent->content, target);
+		gf_xml_dom_node_del(target);
+		return GF_OK;
+	}
+	if (!strcmp(op->name, "replace")) {
+		if (szAtt[0]) {
+			char *val = gf_mpd_patch_get_text(op);
+			gf_mpd_patch_set_att(target, szAtt, val ? val : gf_strdup(""));
+			return GF_OK;
+		}
+		if (!parent) return GF_NON_COMPLIANT_BITSTREAM;
+		while ((child = gf_list_pop_front(op->content))) {
+			if (child->type == GF_XML_NODE_TYPE) break;
+			gf_xml_dom_node_del(child);
+		}
+		if (!child) return GF_NON_COMPLIANT_BITSTREAM;
+		gf_list_insert(parent->content, child, gf_list_find(parent->content, target));
+		gf_list_del_item(parent->content, target);
+		gf_xml_dom_node_del(target);
+		return GF_OK;
+	}
+	if (!strcmp(op->name, "add")) {
+		GF_List *dst;
+		s32 idx;
+		const char *pos = gf_mpd_patch_get_att(op, "pos");
+		const char *type = gf_mpd_patch_get_att(op, "type");
+		if (szAtt[0]) return GF_NON_COMPLIANT_BITSTREAM;
+		if (type && (type[0]=='@')) {
+			char *val = gf_mpd_patch_get_text(op);
+			gf_mpd_patch_set_att(target, type+1, val ? val : gf_strdup(""));
+			return GF_OK;
+		}
+		if (!pos) {
+			dst = target->content;
+			idx = gf_list_count(dst);
+		} else if (!strcmp(pos, "prepend")) {
+			dst = target->content;
+			idx = 0;
+		} else if (!parent) {
+			return GF_NON_COMPLIANT_BITSTREAM;
+		} else {
+			dst = parent->content;
+			idx = gf_list_find(dst, target);
+			if (!strcmp(pos, "after")) idx++;
+		}
+		//move nodes from the patch
+		while ((child = gf_list_pop_front(op->content))) {
+			gf_list_insert(dst, child, idx);
+			idx++;
+		}
+		return GF_OK;
+	}
+	GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[MPD] Unknown patch operation %s\n", op->name));
+	return GF_NOT_SUPPORTED;
+}
+
+GF_EXPORT
+GF_Err gf_mpd_apply_patch(GF_XMLNode *root, GF_XMLNode *patch)
+{
+	u32 i;
+	GF_XMLNode *op;
+	const char *mpd_id, *patch_id, *orig_time, *pub_time, *cur_time;
+	if (!root || !patch || strcmp(patch->name, "Patch")) return GF_BAD_PARAM;
+
+	mpd_id = gf_mpd_patch_get_att(root, "id");
+	patch_id = gf_mpd_patch_get_att(patch, "mpdId");
+	orig_time = gf_mpd_patch_get_att(patch, "originalPublishTime");
+	pub_time = gf_mpd_patch_get_att(patch, "publishTime");
+	cur_time = gf_mpd_patch_get_att(root, "publishTime");
+	if (!mpd_id || !patch_id || !orig_time || !cur_time || strcmp(mpd_id, patch_id)) return GF_NOT_FOUND;
+	if (gf_mpd_parse_date(orig_time) != gf_mpd_parse_date(cur_time)) return GF_NOT_FOUND;
+	if (pub_time && (gf_mpd_parse_date(pub_time) == gf_mpd_parse_date(cur_time))) return GF_EOS;
+
+	i=0;
+	while ((op = gf_list_enum(patch->content, &i))) {
+		GF_Err e;
+		if (op->type != GF_XML_NODE_TYPE) continue;
+		e = gf_mpd_patch_op(root, op);
+		if (e) return e;
+	}
+	//make sure the next patch applies, whether the patch updated the publish time or not
+	if (pub_time)
+		gf_mpd_patch_set_att(root, "publishTime", gf_strdup(pub_time));
+	return GF_OK;
+}
+
 static GF_Err gf_m3u8_fill_mpd_struct(MasterPlaylist *pl, const char *m3u8_file, const char *src_base_url, const char *mpd_file, char *title, Double update_interval,
                                       char *mimeTypeForM3U8Segments, Bool do_import, Bool use_mpd_templates, Bool use_segment_timeline, Bool is_end, u32 max_dur, GF_MPD *mpd, Bool parse_sub_playlist)
 {
@@ -3603,6 +4285,7 @@ GF_Err gf_mpd_write(GF_MPD const * const mpd, FILE *out, Bool compact)
 	u32 i, count;
 	s32 indent = compact ? GF_INT_MIN : 0;
 	GF_MPD_ProgramInfo *info;
+	GF_MPD_PatchLocation *pl;
 	char *text;
 
 	if (!mpd->xml_namespace) {
@@ -3711,6 +4394,15 @@ GF_Err gf_mpd_write(GF_MPD const * const mpd, FILE *out, Bool compact)
 		gf_mpd_lf(out, indent);
 	}
 
+	i=0;
+	while ((pl = (GF_MPD_PatchLocation *)gf_list_enum(mpd->patch_locations, &i))) {
+		gf_mpd_nl(out, indent+1);
+		if (pl->ttl) gf_fprintf(out, "<PatchLocation ttl=\"%g\">", ((Double) pl->ttl) / 1000);
+		else gf_fprintf(out, "<PatchLocation>");
+		gf_xml_dump_string(out, NULL, pl->url, "</PatchLocation>");
+		gf_mpd_lf(out, indent);
+	}
+
 	if (gf_list_count(mpd->utc_timings))
 		gf_mpd_print_descriptors(out, mpd->utc_timings, "UTCTiming", indent+1);
 	/*
@@ -249,6 +249,7 @@ struct JSRuntime {
     JSMallocFunctions mf;
     JSMallocState malloc_state;
     const char *rt_info;
+    void *user_opaque;
 
     int atom_hash_size; /* power of two */
     int atom_count;
@@ -2042,6 +2043,16 @@ void JS_SetContextOpaque(JSContext *ctx, void *opaque)
     ctx->user_opaque = opaque;
 }
 
+void *JS_GetRuntimeOpaque(JSRuntime *rt)
+{
+    return rt->user_opaque;
+}
+
+void JS_SetRuntimeOpaque(JSRuntime *rt, void *opaque)
+{
+    rt->user_opaque = opaque;
+}
+
 /* set the new value and free the old value after (freeing the value
    can reallocate the object data) */
 static inline void set_value(JSContext *ctx, JSValue *pval, JSValue new_val)
@@ -353,6 +353,8 @@ JSContext *JS_NewContext(JSRuntime *rt);
 void JS_FreeContext(JSContext *s);
 void *JS_GetContextOpaque(JSContext *ctx);
 void JS_SetContextOpaque(JSContext *ctx, void *opaque);
+void *JS_GetRuntimeOpaque(JSRuntime *rt);
+void JS_SetRuntimeOpaque(JSRuntime *rt, void *opaque);
 JSRuntime *JS_GetRuntime(JSContext *ctx);
 void JS_SetMaxStackSize(JSContext *ctx, size_t stack_size);
 void JS_SetClassProto(JSContext *ctx, JSClassID class_id, JSValue obj);
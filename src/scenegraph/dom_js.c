@@ -2437,8 +2437,8 @@ static JSValue event_getProperty(JSContext *c, JSValueConst obj, int magic)
 
 
 #define SETUP_JSCLASS(_class, _name, _proto_funcs, _construct, _finalize, _proto_class_id) \
-	if (! _class.class_id) {\
-		JS_NewClassID(&(_class.class_id)); \
+	if (! JS_IsRegisteredClass(jsrt, _class.class_id)) {\
+		gf_js_new_class_id(&(_class.class_id)); \
 		_class.class.class_name = _name; \
 		_class.class.finalizer = _finalize;\
 		JS_NewClass(jsrt, _class.class_id, &(_class.class));\
@@ -44,11 +44,17 @@
 #define JS_CHECK_STRING(_v) (JS_IsString(_v) || JS_IsNull(_v))
 
 struct JSContext *gf_js_create_context();
+/*creates a context in a dedicated runtime, not shared with other contexts and with its own lock. The runtime is destroyed with the context*/
+struct JSContext *gf_js_create_isolated_context();
 void gf_js_delete_context(struct JSContext *);
 #ifdef GPAC_HAS_QJS
 void gf_js_lock(struct JSContext *c, Bool LockIt);
 Bool gf_js_try_lock(struct JSContext *c);
 void gf_js_call_gc(struct JSContext *c);
+/*process-wide lock for data shared by all runtimes (class IDs, module globals). The lock is created by gf_sys_init and destroyed by gf_sys_close*/
+void gf_js_global_lock(Bool LockIt);
+/*allocates a class ID if not yet done, under the global lock since modules may be loaded concurrently in several runtimes*/
+void gf_js_new_class_id(JSClassID *class_id);
 #endif /* GPAC_HAS_QJS */
 
 /* throws an error with integer property 'code' set to err*/
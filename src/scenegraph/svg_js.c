@@ -2063,7 +2063,7 @@ Bool is_svg_element_class(JSContext *c, JSValue obj)
 
 #define SETUP_JSCLASS(_class, _name, _proto_funcs, _construct, _finalize, _proto_class_id) \
 	if (!_class.class_id) {\
-		JS_NewClassID(&(_class.class_id)); \
+		gf_js_new_class_id(&(_class.class_id)); \
 		_class.class.class_name = _name; \
 		_class.class.finalizer = _finalize;\
 		JS_NewClass(jsrt, _class.class_id, &(_class.class));\
@@ -344,8 +344,82 @@ JSContext *gf_js_create_context()
 	return ctx;
 }
 
+JSContext *gf_js_create_isolated_context()
+{
+	GF_JSRuntime *iso_rt;
+	GF_SAFEALLOC(iso_rt, GF_JSRuntime);
+	if (!iso_rt) return NULL;
+
+	iso_rt->js_runtime = JS_NewRuntime();
+	if (!iso_rt->js_runtime) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_SCRIPT, ("[ECMAScript] Cannot allocate ECMAScript runtime\n"));
+		gf_free(iso_rt);
+		return NULL;
+	}
+	iso_rt->mx = gf_mx_new("JavaScriptIsolated");
+	iso_rt->nb_inst = 1;
+	//runtime opaque is only set for isolated runtimes, used to retrieve the runtime mutex
+	JS_SetRuntimeOpaque(iso_rt->js_runtime, iso_rt);
+	JS_SetModuleLoaderFunc(iso_rt->js_runtime, NULL, qjs_module_loader, NULL);
+
+	iso_rt->ctx = JS_NewContext(iso_rt->js_runtime);
+	if (!iso_rt->ctx) {
+		JS_FreeRuntime(iso_rt->js_runtime);
+		gf_mx_del(iso_rt->mx);
+		gf_free(iso_rt);
+		return NULL;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_SCRIPT, ("[ECMAScript] Isolated ECMAScript runtime allocated %p\n", iso_rt->js_runtime));
+	return iso_rt->ctx;
+}
+
+//created at library init, runtimes may be created concurrently by filters running on different threads
+static GF_Mutex *js_global_mx = NULL;
+
+void gf_js_global_init()
+{
+	if (!js_global_mx) js_global_mx = gf_mx_new("JavaScriptGlobal");
+}
+
+void gf_js_global_del()
+{
+	gf_mx_del(js_global_mx);
+	js_global_mx = NULL;
+}
+
+void gf_js_global_lock(Bool LockIt)
+{
+	if (LockIt) gf_mx_p(js_global_mx);
+	else gf_mx_v(js_global_mx);
+}
+
+void gf_js_new_class_id(JSClassID *class_id)
+{
+	gf_js_global_lock(GF_TRUE);
+	JS_NewClassID(class_id);
+	gf_js_global_lock(GF_FALSE);
+}
+
+static GF_JSRuntime *gf_js_get_ctx_runtime(JSContext *c)
+{
+	if (c) {
+		GF_JSRuntime *iso_rt = JS_GetRuntimeOpaque(JS_GetRuntime(c));
+		if (iso_rt) return iso_rt;
+	}
+	return js_rt;
+}
+
 void gf_js_delete_context(JSContext *ctx)
 {
+	GF_JSRuntime *iso_rt = JS_GetRuntimeOpaque(JS_GetRuntime(ctx));
+	if (iso_rt) {
+		gf_js_call_gc(ctx);
+		JS_FreeContext(ctx);
+		JS_FreeRuntime(iso_rt->js_runtime);
+		gf_mx_del(iso_rt->mx);
+		gf_free(iso_rt);
+		return;
+	}
 	gf_js_call_gc(ctx);
 
 	gf_list_del_item(js_rt->allocated_contexts, ctx);
@@ -390,7 +464,7 @@ static JSValue vrml_event_remove_listener(JSContext *c, JSValueConst this_val, i
 void gf_js_call_gc(JSContext *c)
 {
 	gf_js_lock(c, 1);
-	JS_RunGC(js_rt->js_runtime);
+	JS_RunGC(JS_GetRuntime(c));
 	gf_js_lock(c, 0);
 }
 
@@ -3171,7 +3245,7 @@ static void field_gc_mark(JSRuntime *rt, JSValueConst val, JS_MarkFunc *mark_fun
 #define SETUP_JSCLASS_BASIC(_class, _name) \
 	/*classes are global to runtime*/\
 	if (!_class.class_id) {\
-		JS_NewClassID(&(_class.class_id)); \
+		gf_js_new_class_id(&(_class.class_id)); \
 		_class.class.class_name = _name; \
 		JS_NewClass(js_rt->js_runtime, _class.class_id, &(_class.class));\
 	}\
@@ -3179,7 +3253,7 @@ static void field_gc_mark(JSRuntime *rt, JSValueConst val, JS_MarkFunc *mark_fun
 #define SETUP_JSCLASS(_class, _name, _proto_funcs, _construct, _finalize, _exotic) \
 	/*classes are global to runtime*/\
 	if (!_class.class_id) {\
-		JS_NewClassID(&(_class.class_id)); \
+		gf_js_new_class_id(&(_class.class_id)); \
 		_class.class.class_name = _name; \
 		_class.class.finalizer = _finalize;\
 		_class.class.exotic = _exotic;\
@@ -4731,12 +4805,13 @@ Bool gf_sg_has_scripting()
 GF_EXPORT
 void gf_js_lock(struct JSContext *cx, Bool LockIt)
 {
-	if (!js_rt) return;
+	GF_JSRuntime *rt = gf_js_get_ctx_runtime(cx);
+	if (!rt) return;
 
 	if (LockIt) {
-		gf_mx_p(js_rt->mx);
+		gf_mx_p(rt->mx);
 	} else {
-		gf_mx_v(js_rt->mx);
+		gf_mx_v(rt->mx);
 	}
 }
 
@@ -4744,7 +4819,7 @@ GF_EXPORT
 Bool gf_js_try_lock(struct JSContext *cx)
 {
 	assert(cx);
-	if (gf_mx_try_lock(js_rt->mx)) {
+	if (gf_mx_try_lock(gf_js_get_ctx_runtime(cx)->mx)) {
 		return 1;
 	}
 	return 0;
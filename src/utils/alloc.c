@@ -425,34 +425,91 @@ static char *(*gf_mem_strdup_proto)(const char *str, const char *filename, int l
 #endif
 #endif
 
+#if defined(_MSC_VER)
+#define GF_MEM_TLS	__declspec(thread)
+#else
+#define GF_MEM_TLS	__thread
+#endif
+
+#include <gpac/tools.h>
+
+/*time spent in allocator calls by the calling thread, only measured when enabled (filter session profiler)*/
+static int gf_mem_timing_enabled = 0;
+static GF_MEM_TLS u64 gf_mem_thread_time = 0;
+
 MY_GF_EXPORT void *gf_mem_malloc(size_t size, const char *filename, int line)
 {
+	if (gf_mem_timing_enabled) {
+		void *ptr;
+		u64 start = gf_sys_clock_high_res();
+		ptr = gf_mem_malloc_proto(size, filename, line);
+		gf_mem_thread_time += gf_sys_clock_high_res() - start;
+		return ptr;
+	}
 	return gf_mem_malloc_proto(size, filename, line);
 }
 
 MY_GF_EXPORT void *gf_mem_calloc(size_t num, size_t size_of, const char *filename, int line)
 {
+	if (gf_mem_timing_enabled) {
+		void *ptr;
+		u64 start = gf_sys_clock_high_res();
+		ptr = gf_mem_calloc_proto(num, size_of, filename, line);
+		gf_mem_thread_time += gf_sys_clock_high_res() - start;
+		return ptr;
+	}
 	return gf_mem_calloc_proto(num, size_of, filename, line);
 }
 
 MY_GF_EXPORT
 void *gf_mem_realloc(void *ptr, size_t size, const char *filename, int line)
 {
+	if (gf_mem_timing_enabled) {
+		u64 start = gf_sys_clock_high_res();
+		ptr = gf_mem_realloc_proto(ptr, size, filename, line);
+		gf_mem_thread_time += gf_sys_clock_high_res() - start;
+		return ptr;
+	}
 	return gf_mem_realloc_proto(ptr, size, filename, line);
 }
 
 MY_GF_EXPORT
 void gf_mem_free(void *ptr, const char *filename, int line)
 {
+	if (gf_mem_timing_enabled) {
+		u64 start = gf_sys_clock_high_res();
+		gf_mem_free_proto(ptr, filename, line);
+		gf_mem_thread_time += gf_sys_clock_high_res() - start;
+		return;
+	}
 	gf_mem_free_proto(ptr, filename, line);
 }
 
 MY_GF_EXPORT
 char *gf_mem_strdup(const char *str, const char *filename, int line)
 {
+	if (gf_mem_timing_enabled) {
+		char *ptr;
+		u64 start = gf_sys_clock_high_res();
+		ptr = gf_mem_strdup_proto(str, filename, line);
+		gf_mem_thread_time += gf_sys_clock_high_res() - start;
+		return ptr;
+	}
 	return gf_mem_strdup_proto(str, filename, line);
 }
 
+MY_GF_EXPORT
+void gf_mem_enable_timing(unsigned int enable)
+{
+	gf_mem_timing_enabled = enable ? 1 : 0;
+}
+
+MY_GF_EXPORT
+u64 gf_mem_get_thread_time()
+{
+	return gf_mem_thread_time;
+}
+
 MY_GF_EXPORT
 void gf_mem_enable_tracker(unsigned int enable_backtrace)
 {
@@ -27,6 +27,7 @@
 #include <gpac/tools.h>
 #include <gpac/constants.h>
 #include <gpac/color.h>
+#include <gpac/internal/simd_dev.h>
 
 #ifndef GPAC_DISABLE_PLAYER
 
@@ -80,6 +81,147 @@ static void yuv2rgb_init(void)
 	}
 }
 
+#ifdef GPAC_HAS_SSE2
+
+/* SSE2 YUV -> RGB conversion, 8 pixels per iteration
+
+Uses the same fixed-point coefficients as the tables above with 32-bit intermediates and saturating packs,
+so the output is bit-exact with the table-based code. Loaders return the number of converted pixels (multiple of 8),
+remaining pixels are converted by the regular code*/
+
+#define YUV_SSE2_COEFS(_a, _b)	_mm_set_epi16(_b, _a, _b, _a, _b, _a, _b, _a)
+
+/*y, u, v: 8 signed 16-bit samples with offsets removed, a: 8 16-bit alpha values*/
+static GFINLINE void yuv2rgba_8px_sse2(u8 *dst, __m128i y, __m128i u, __m128i v, __m128i a)
+{
+	__m128i r_lo, r_hi, g_lo, g_hi, b_lo, b_hi, rg, ba;
+	const __m128i c_r = YUV_SSE2_COEFS(FIX_OUT(1.164), FIX_OUT(1.596));
+	const __m128i c_b = YUV_SSE2_COEFS(FIX_OUT(1.164), FIX_OUT(2.018));
+	const __m128i c_gu = YUV_SSE2_COEFS(FIX_OUT(1.164), -FIX_OUT(0.391));
+	const __m128i c_gv = YUV_SSE2_COEFS(0, -FIX_OUT(0.813));
+	__m128i yu_lo = _mm_unpacklo_epi16(y, u);
+	__m128i yu_hi = _mm_unpackhi_epi16(y, u);
+	__m128i yv_lo = _mm_unpacklo_epi16(y, v);
+	__m128i yv_hi = _mm_unpackhi_epi16(y, v);
+
+	r_lo = _mm_srai_epi32(_mm_madd_epi16(yv_lo, c_r), SCALEBITS_OUT);
+	r_hi = _mm_srai_epi32(_mm_madd_epi16(yv_hi, c_r), SCALEBITS_OUT);
+	g_lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_lo, c_gu), _mm_madd_epi16(yv_lo, c_gv)), SCALEBITS_OUT);
+	g_hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_hi, c_gu), _mm_madd_epi16(yv_hi, c_gv)), SCALEBITS_OUT);
+	b_lo = _mm_srai_epi32(_mm_madd_epi16(yu_lo, c_b), SCALEBITS_OUT);
+	b_hi = _mm_srai_epi32(_mm_madd_epi16(yu_hi, c_b), SCALEBITS_OUT);
+
+	//r0..r7 g0..g7 and b0..b7 a0..a7, clipped to [0, 255]
+	rg = _mm_packus_epi16(_mm_packs_epi32(r_lo, r_hi), _mm_packs_epi32(g_lo, g_hi));
+	ba = _mm_packus_epi16(_mm_packs_epi32(b_lo, b_hi), a);
+	//r0 g0 r1 g1 ... and b0 a0 b1 a1 ...
+	rg = _mm_unpacklo_epi8(rg, _mm_srli_si128(rg, 8));
+	ba = _mm_unpacklo_epi8(ba, _mm_srli_si128(ba, 8));
+
+	_mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi16(rg, ba));
+	_mm_storeu_si128((__m128i *) (dst+16), _mm_unpackhi_epi16(rg, ba));
+}
+
+/*loads 8 samples as 16-bit values, 10-bit samples being scaled down to 8 bits*/
+static GFINLINE __m128i yuv_sse2_load_8(const u8 *src, Bool is_10)
+{
+	if (is_10) return _mm_srli_epi16(_mm_loadu_si128((const __m128i *) src), 2);
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) src), _mm_setzero_si128());
+}
+
+/*loads 4 chroma samples as 16-bit values, each sample being used for 2 pixels*/
+static GFINLINE __m128i yuv_sse2_load_4x2(const u8 *src, Bool is_10)
+{
+	__m128i c;
+	if (is_10) {
+		c = _mm_srli_epi16(_mm_loadl_epi64((const __m128i *) src), 2);
+	} else {
+		s32 v;
+		memcpy(&v, src, 4);
+		c = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v), _mm_setzero_si128());
+	}
+	return _mm_unpacklo_epi16(c, c);
+}
+
+/*converts two lines of planar YUV (8 or 10 bits). uv_stride is 0 if both lines share the same chroma line, sub_x is set for horizontally subsampled chroma and a_src may be NULL*/
+static u32 yuv_load_lines_planar_sse2(u8 *dst, s32 dststride, const u8 *y_src, const u8 *u_src, const u8 *v_src, const u8 *a_src, s32 y_stride, s32 uv_stride, u32 width, Bool is_10, Bool sub_x)
+{
+	u32 x;
+	u32 bps = is_10 ? 2 : 1;
+	const __m128i off_y = _mm_set1_epi16(16);
+	const __m128i off_uv = _mm_set1_epi16(128);
+	const __m128i opaque = _mm_set1_epi16(0xFF);
+
+	for (x=0; x+8 <= width; x+=8) {
+		__m128i y, u, v, a;
+		u32 yx = x*bps;
+		u32 cx = (sub_x ? x/2 : x) * bps;
+
+		if (sub_x) {
+			u = yuv_sse2_load_4x2(u_src + cx, is_10);
+			v = yuv_sse2_load_4x2(v_src + cx, is_10);
+		} else {
+			u = yuv_sse2_load_8(u_src + cx, is_10);
+			v = yuv_sse2_load_8(v_src + cx, is_10);
+		}
+		y = _mm_sub_epi16(yuv_sse2_load_8(y_src + yx, is_10), off_y);
+		a = a_src ? yuv_sse2_load_8(a_src + yx, GF_FALSE) : opaque;
+		u = _mm_sub_epi16(u, off_uv);
+		v = _mm_sub_epi16(v, off_uv);
+		yuv2rgba_8px_sse2(dst + 4*x, y, u, v, a);
+
+		if (uv_stride) {
+			if (sub_x) {
+				u = yuv_sse2_load_4x2(u_src + uv_stride + cx, is_10);
+				v = yuv_sse2_load_4x2(v_src + uv_stride + cx, is_10);
+			} else {
+				u = yuv_sse2_load_8(u_src + uv_stride + cx, is_10);
+				v = yuv_sse2_load_8(v_src + uv_stride + cx, is_10);
+			}
+			u = _mm_sub_epi16(u, off_uv);
+			v = _mm_sub_epi16(v, off_uv);
+		}
+		y = _mm_sub_epi16(yuv_sse2_load_8(y_src + y_stride + yx, is_10), off_y);
+		a = a_src ? yuv_sse2_load_8(a_src + y_stride + yx, GF_FALSE) : opaque;
+		yuv2rgba_8px_sse2(dst + dststride + 4*x, y, u, v, a);
+	}
+	return x;
+}
+
+/*converts two lines of NV12/NV21, uv_src pointing to the first chroma byte*/
+static u32 yuv_load_lines_nv12_sse2(u8 *dst, s32 dststride, const u8 *y_src, const u8 *uv_src, s32 y_stride, u32 width, Bool is_nv21)
+{
+	u32 x;
+	const __m128i off_y = _mm_set1_epi16(16);
+	const __m128i off_uv = _mm_set1_epi16(128);
+	const __m128i opaque = _mm_set1_epi16(0xFF);
+
+	for (x=0; x+8 <= width; x+=8) {
+		__m128i y, u, v;
+		//c0 c1 c0 c1 c0 c1 c0 c1, duplicate each of c0 and c1 samples
+		__m128i uv = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (uv_src + x)), _mm_setzero_si128()), off_uv);
+		u = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+		v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+		if (is_nv21) {
+			__m128i t = u;
+			u = v;
+			v = t;
+		}
+		y = _mm_sub_epi16(yuv_sse2_load_8(y_src + x, GF_FALSE), off_y);
+		yuv2rgba_8px_sse2(dst + 4*x, y, u, v, opaque);
+		y = _mm_sub_epi16(yuv_sse2_load_8(y_src + y_stride + x, GF_FALSE), off_y);
+		yuv2rgba_8px_sse2(dst + dststride + 4*x, y, u, v, opaque);
+	}
+	return x;
+}
+
+#else
+
+#define yuv_load_lines_planar_sse2(_dst, _dststride, _y_src, _u_src, _v_src, _a_src, _y_stride, _uv_stride, _width, _is_10, _sub_x)	0
+#define yuv_load_lines_nv12_sse2(_dst, _dststride, _y_src, _uv_src, _y_stride, _width, _is_nv21)	0
+
+#endif //GPAC_HAS_SSE2
+
 static void yuv_load_lines_planar(unsigned char *dst, s32 dststride, unsigned char *y_src, unsigned char *u_src, unsigned char * v_src, s32 y_stride, s32 uv_stride, s32 width, Bool dst_yuv)
 {
 	u32 hw, x;
@@ -113,7 +255,12 @@ static void yuv_load_lines_planar(unsigned char *dst, s32 dststride, unsigned ch
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = yuv_load_lines_planar_sse2(dst, dststride, y_src, u_src, v_src, NULL, y_stride, 0, width, GF_FALSE, GF_TRUE);
+	y_src += x;
+	y_src2 += x;
+	dst += 4*x;
+	dst2 += 4*x;
+	for (x /= 2; x < hw; x++) {
 		s32 u, v;
 		s32 b_u, g_uv, r_v, rgb_y;
 
@@ -197,7 +344,16 @@ static void yuv422_load_lines_planar(unsigned char *dst, s32 dststride, unsigned
 		return;
 	}
 
-	for (x = 0; x < hw; x++) {
+	x = yuv_load_lines_planar_sse2(dst, dststride, y_src, u_src, v_src, NULL, y_stride, uv_stride, width, GF_FALSE, GF_TRUE);
+	y_src += x;
+	y_src2 += x;
+	u_src += x/2;
+	v_src += x/2;
+	u_src2 += x/2;
+	v_src2 += x/2;
+	dst += 4*x;
+	dst2 += 4*x;
+	for (x /= 2; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
 
 		b_u = B_U[*u_src];
@@ -296,7 +452,16 @@ static void yuv444_load_lines_planar(unsigned char *dst, s32 dststride, unsigned
 		return;
 	}
 
-	for (x = 0; x < hw; x++) {
+	x = yuv_load_lines_planar_sse2(dst, dststride, y_src, u_src, v_src, NULL, y_stride, uv_stride, width, GF_FALSE, GF_FALSE);
+	y_src += x;
+	y_src2 += x;
+	u_src += x;
+	v_src += x;
+	u_src2 += x;
+	v_src2 += x;
+	dst += 4*x;
+	dst2 += 4*x;
+	for (x /= 2; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
 
 
@@ -393,7 +558,12 @@ static void yuv_10_load_lines_planar(unsigned char *dst, s32 dststride, unsigned
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = yuv_load_lines_planar_sse2(dst, dststride, _y_src, _u_src, _v_src, NULL, y_stride, 0, width, GF_TRUE, GF_TRUE);
+	y_src += x;
+	y_src2 += x;
+	dst += 4*x;
+	dst2 += 4*x;
+	for (x /= 2; x < hw; x++) {
 		s32 u, v;
 		s32 b_u, g_uv, r_v, rgb_y;
 
@@ -480,7 +650,16 @@ static void yuv422_10_load_lines_planar(unsigned char *dst, s32 dststride, unsig
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = yuv_load_lines_planar_sse2(dst, dststride, _y_src, _u_src, _v_src, NULL, y_stride, uv_stride, width, GF_TRUE, GF_TRUE);
+	y_src += x;
+	y_src2 += x;
+	u_src += x/2;
+	v_src += x/2;
+	u_src2 += x/2;
+	v_src2 += x/2;
+	dst += 4*x;
+	dst2 += 4*x;
+	for (x /= 2; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
 
 		b_u = B_U[*u_src >> 2];
@@ -580,7 +759,16 @@ static void yuv444_10_load_lines_planar(unsigned char *dst, s32 dststride, unsig
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = yuv_load_lines_planar_sse2(dst, dststride, _y_src, _u_src, _v_src, NULL, y_stride, uv_stride, width, GF_TRUE, GF_FALSE);
+	y_src += x;
+	y_src2 += x;
+	u_src += x;
+	v_src += x;
+	u_src2 += x;
+	v_src2 += x;
+	dst += 4*x;
+	dst2 += 4*x;
+	for (x /= 2; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
 
 
@@ -734,7 +922,14 @@ static void yuva_load_lines(unsigned char *dst, s32 dststride, unsigned char *y_
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = yuv_load_lines_planar_sse2(dst, dststride, y_src, u_src, v_src, a_src, y_stride, 0, width, GF_FALSE, GF_TRUE);
+	y_src += x;
+	y_src2 += x;
+	a_src += x;
+	a_src2 += x;
+	dst += 4*x;
+	dst2 += 4*x;
+	for (x /= 2; x < hw; x++) {
 		s32 u, v;
 		s32 b_u, g_uv, r_v, rgb_y;
 
@@ -1740,7 +1935,12 @@ static void gf_yuv_load_lines_nv12_nv21(unsigned char *dst, s32 dststride, unsig
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = yuv_load_lines_nv12_sse2(dst, dststride, y_src, MIN(u_src, v_src), y_stride, width, (v_src < u_src) ? GF_TRUE : GF_FALSE);
+	y_src += x;
+	y_src2 += x;
+	dst += 4*x;
+	dst2 += 4*x;
+	for (x /= 2; x < hw; x++) {
 		s32 u, v;
 		s32 b_u, g_uv, r_v, rgb_y;
 
@@ -2527,19 +2727,6 @@ void gf_cmx_apply_fixed(GF_ColorMatrix *_this, Fixed *a, Fixed *r, Fixed *g, Fix
 #ifndef GPAC_DISABLE_PLAYER
 
 
-//intrinsic code segfaults on 32 bit, need to check why
-#if defined(GPAC_64_BITS)
-# if defined(WIN32) && !defined(__GNUC__)
-#  include <intrin.h>
-#  define GPAC_HAS_SSE2
-# else
-#  ifdef __SSE2__
-#   include <emmintrin.h>
-#   define GPAC_HAS_SSE2
-#  endif
-# endif
-#endif
-
 #ifdef GPAC_HAS_SSE2
 
 static GF_Err color_write_yv12_10_to_yuv_intrin(GF_VideoSurface *vs_dst, unsigned char *pY, unsigned char *pU, unsigned char*pV, u32 src_stride, u32 src_width, u32 src_height, const GF_Window *_src_wnd, Bool swap_uv)
@@ -0,0 +1,337 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / common tools sub-project
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/network.h>
+#include <gpac/thread.h>
+
+#ifndef GPAC_DISABLE_CORE_TOOLS
+
+#if !defined(WIN32) && !defined(_WIN32_WCE)
+#include <time.h>
+#include <errno.h>
+#endif
+
+//max number of queued datagrams
+#define PACER_MAX_ITEMS	4096
+//max number of datagrams sent in one call
+#define PACER_MAX_BATCH	64
+
+typedef struct
+{
+	GF_Socket *sock;
+	u64 time;
+	u32 size, alloc;
+	u8 *data;
+} GF_PacedItem;
+
+struct __tag_sock_pacer
+{
+	GF_Thread *th;
+	GF_Mutex *mx;
+	GF_Semaphore *sema;
+	Bool run, waiting;
+	//signaled after each batch of sent datagrams when a flush is pending
+	GF_Semaphore *flush_sema;
+	u32 nb_flush_waiters;
+
+	GF_PacedItem items[PACER_MAX_ITEMS];
+	u32 first, count;
+
+	u32 rate, spin_us;
+	//next token bucket send time, in nanoseconds to avoid drifting on rounding
+	u64 next_time_ns;
+	//send time of last queued item
+	u64 last_time;
+
+	u64 nb_sent, late_sum;
+	u32 late_max;
+};
+
+static void pacer_sleep_us(u64 us)
+{
+#if defined(WIN32) || defined(_WIN32_WCE)
+	//we don't mess with the system timer resolution, sleep granularity is 1 ms at best
+	if (us >= 1000) Sleep((DWORD) (us / 1000));
+#else
+	struct timespec ts;
+	ts.tv_sec = (time_t) (us / 1000000);
+	ts.tv_nsec = (long) ((us % 1000000) * 1000);
+	while (nanosleep(&ts, &ts) && (errno == EINTR)) {
+	}
+#endif
+}
+
+static u32 pacer_run(void *par)
+{
+	const u8 *buffers[PACER_MAX_BATCH];
+	u32 sizes[PACER_MAX_BATCH];
+	GF_SockPacer *pacer = (GF_SockPacer *) par;
+
+	while (1) {
+		u32 i, nb_items, nb_sent;
+		u64 now, time;
+		GF_Socket *sock;
+
+		gf_mx_p(pacer->mx);
+		if (!pacer->count) {
+			if (!pacer->run) {
+				gf_mx_v(pacer->mx);
+				break;
+			}
+			pacer->waiting = GF_TRUE;
+			gf_mx_v(pacer->mx);
+			gf_sema_wait_for(pacer->sema, 100);
+			continue;
+		}
+		time = pacer->items[pacer->first].time;
+		gf_mx_v(pacer->mx);
+
+		now = gf_sys_clock_high_res();
+		if (time > now + pacer->spin_us) {
+			pacer_sleep_us(time - now - pacer->spin_us);
+			now = gf_sys_clock_high_res();
+		}
+		while (now < time) {
+			now = gf_sys_clock_high_res();
+		}
+
+		//gather all due items on the same socket - the producer only appends to the queue, items
+		//we look at cannot be modified until we remove them
+		gf_mx_p(pacer->mx);
+		nb_items = 0;
+		sock = pacer->items[pacer->first].sock;
+		while (nb_items < pacer->count) {
+			GF_PacedItem *item = &pacer->items[(pacer->first + nb_items) % PACER_MAX_ITEMS];
+			if (item->sock != sock) break;
+			if (item->time > now) break;
+			if (nb_items == PACER_MAX_BATCH) break;
+			buffers[nb_items] = item->data;
+			sizes[nb_items] = item->size;
+			nb_items++;
+		}
+		gf_mx_v(pacer->mx);
+
+		nb_sent = 0;
+		while (nb_sent < nb_items) {
+			u32 nb_done = 0;
+			GF_Err e = gf_sk_send_batch(sock, buffers + nb_sent, sizes + nb_sent, nb_items - nb_sent, &nb_done);
+			nb_sent += nb_done;
+			if (e == GF_BUFFER_TOO_SMALL) continue;
+			if (e) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[SockPacer] Failed to send %d datagrams: %s\n", nb_items - nb_sent, gf_error_to_string(e) ));
+				break;
+			}
+		}
+
+		now = gf_sys_clock_high_res();
+		gf_mx_p(pacer->mx);
+		for (i=0; i<nb_items; i++) {
+			GF_PacedItem *item = &pacer->items[pacer->first];
+			u32 late = (now > item->time) ? (u32) (now - item->time) : 0;
+			pacer->late_sum += late;
+			if (late > pacer->late_max) pacer->late_max = late;
+			pacer->first = (pacer->first + 1) % PACER_MAX_ITEMS;
+			pacer->count--;
+		}
+		pacer->nb_sent += nb_items;
+		if (pacer->nb_flush_waiters)
+			gf_sema_notify(pacer->flush_sema, pacer->nb_flush_waiters);
+		gf_mx_v(pacer->mx);
+	}
+	return 0;
+}
+
+GF_EXPORT
+GF_SockPacer *gf_sk_pacer_new(u32 rate, u32 spin_us)
+{
+	GF_Err e;
+	GF_SockPacer *pacer;
+	GF_SAFEALLOC(pacer, GF_SockPacer);
+	if (!pacer) return NULL;
+	pacer->rate = rate;
+	pacer->spin_us = spin_us;
+	pacer->run = GF_TRUE;
+	pacer->mx = gf_mx_new("SockPacer");
+	pacer->sema = gf_sema_new(GF_INT_MAX, 0);
+	pacer->flush_sema = gf_sema_new(GF_INT_MAX, 0);
+	pacer->th = gf_th_new("SockPacer");
+	if (!pacer->mx || !pacer->sema || !pacer->flush_sema || !pacer->th) {
+		gf_sk_pacer_del(pacer);
+		return NULL;
+	}
+	e = gf_th_run(pacer->th, pacer_run, pacer);
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[SockPacer] Failed to start pacer thread: %s\n", gf_error_to_string(e) ));
+		gf_th_del(pacer->th);
+		pacer->th = NULL;
+		gf_sk_pacer_del(pacer);
+		return NULL;
+	}
+	//try to get real-time scheduling so that wake-ups are not delayed by other threads, this may fail depending on user privileges
+	gf_th_set_priority(pacer->th, GF_THREAD_PRIORITY_REALTIME_END);
+	return pacer;
+}
+
+GF_EXPORT
+void gf_sk_pacer_del(GF_SockPacer *pacer)
+{
+	u32 i;
+	if (!pacer) return;
+	if (pacer->th) {
+		gf_mx_p(pacer->mx);
+		pacer->run = GF_FALSE;
+		gf_mx_v(pacer->mx);
+		gf_sema_notify(pacer->sema, 1);
+		gf_th_stop(pacer->th);
+		gf_th_del(pacer->th);
+	}
+	if (pacer->nb_sent) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[SockPacer] Sent "LLU" datagrams - lateness average %d us max %d us\n", pacer->nb_sent, (u32) (pacer->late_sum / pacer->nb_sent), pacer->late_max));
+	}
+	for (i=0; i<PACER_MAX_ITEMS; i++) {
+		if (pacer->items[i].data) gf_free(pacer->items[i].data);
+	}
+	if (pacer->sema) gf_sema_del(pacer->sema);
+	if (pacer->flush_sema) gf_sema_del(pacer->flush_sema);
+	if (pacer->mx) gf_mx_del(pacer->mx);
+	gf_free(pacer);
+}
+
+GF_EXPORT
+void gf_sk_pacer_set_rate(GF_SockPacer *pacer, u32 rate)
+{
+	if (!pacer) return;
+	gf_mx_p(pacer->mx);
+	pacer->rate = rate;
+	gf_mx_v(pacer->mx);
+}
+
+GF_EXPORT
+GF_Err gf_sk_pacer_send(GF_SockPacer *pacer, GF_Socket *sock, const u8 *data, u32 size, u64 send_time)
+{
+	GF_PacedItem *item;
+	Bool notify = GF_FALSE;
+	if (!pacer || !sock || !data || !size) return GF_BAD_PARAM;
+
+	gf_mx_p(pacer->mx);
+	if (pacer->count == PACER_MAX_ITEMS) {
+		gf_mx_v(pacer->mx);
+		return GF_BUFFER_TOO_SMALL;
+	}
+	item = &pacer->items[(pacer->first + pacer->count) % PACER_MAX_ITEMS];
+	if (item->alloc < size) {
+		item->data = gf_realloc(item->data, size);
+		if (!item->data) {
+			item->alloc = 0;
+			gf_mx_v(pacer->mx);
+			return GF_OUT_OF_MEM;
+		}
+		item->alloc = size;
+	}
+	memcpy(item->data, data, size);
+	item->size = size;
+	item->sock = sock;
+
+	if (!send_time) {
+		u64 now_ns = gf_sys_clock_high_res() * 1000;
+		//token bucket with a single datagram depth: if we are late, don't try to catch up by bursting
+		if (pacer->next_time_ns < now_ns) pacer->next_time_ns = now_ns;
+		send_time = pacer->next_time_ns / 1000;
+		if (pacer->rate)
+			pacer->next_time_ns += ((u64) size) * 8 * 1000000000 / pacer->rate;
+	}
+	item->time = send_time;
+	pacer->last_time = send_time;
+	pacer->count++;
+	if (pacer->waiting) {
+		pacer->waiting = GF_FALSE;
+		notify = GF_TRUE;
+	}
+	gf_mx_v(pacer->mx);
+
+	if (notify) gf_sema_notify(pacer->sema, 1);
+	return GF_OK;
+}
+
+GF_EXPORT
+u64 gf_sk_pacer_get_delay(GF_SockPacer *pacer)
+{
+	u64 now, last;
+	if (!pacer) return 0;
+	gf_mx_p(pacer->mx);
+	last = pacer->count ? pacer->last_time : 0;
+	gf_mx_v(pacer->mx);
+	now = gf_sys_clock_high_res();
+	return (last > now) ? last - now : 0;
+}
+
+GF_EXPORT
+u32 gf_sk_pacer_get_free(GF_SockPacer *pacer)
+{
+	u32 nb_free;
+	if (!pacer) return 0;
+	gf_mx_p(pacer->mx);
+	nb_free = PACER_MAX_ITEMS - pacer->count;
+	gf_mx_v(pacer->mx);
+	return nb_free;
+}
+
+GF_EXPORT
+void gf_sk_pacer_flush(GF_SockPacer *pacer, GF_Socket *sock)
+{
+	if (!pacer) return;
+	gf_mx_p(pacer->mx);
+	while (1) {
+		u32 i;
+		Bool pending = GF_FALSE;
+		for (i=0; i<pacer->count; i++) {
+			GF_PacedItem *item = &pacer->items[(pacer->first + i) % PACER_MAX_ITEMS];
+			if (!sock || (item->sock == sock)) {
+				pending = GF_TRUE;
+				break;
+			}
+		}
+		if (!pending || !pacer->th) break;
+		pacer->nb_flush_waiters++;
+		gf_mx_v(pacer->mx);
+		gf_sema_wait_for(pacer->flush_sema, 100);
+		gf_mx_p(pacer->mx);
+		pacer->nb_flush_waiters--;
+	}
+	gf_mx_v(pacer->mx);
+}
+
+GF_EXPORT
+void gf_sk_pacer_get_stats(GF_SockPacer *pacer, u64 *nb_sent, u32 *late_avg, u32 *late_max)
+{
+	if (!pacer) return;
+	gf_mx_p(pacer->mx);
+	if (nb_sent) *nb_sent = pacer->nb_sent;
+	if (late_avg) *late_avg = pacer->nb_sent ? (u32) (pacer->late_sum / pacer->nb_sent) : 0;
+	if (late_max) *late_max = pacer->late_max;
+	gf_mx_v(pacer->mx);
+}
+
+#endif /*GPAC_DISABLE_CORE_TOOLS*/
@@ -1192,6 +1192,9 @@ GF_EXPORT
 GF_Err gf_sys_init(GF_MemTrackerType mem_tracker_type, const char *profile)
 {
 	if (!sys_init) {
+#ifdef GPAC_HAS_QJS
+		void gf_js_global_init();
+#endif
 #if defined (WIN32)
 #if defined(_WIN32_WCE)
 		MEMORYSTATUS ms;
@@ -1291,6 +1294,10 @@ GF_Err gf_sys_init(GF_MemTrackerType mem_tracker_type, const char *profile)
 
 		logs_mx = gf_mx_new("Logs");
 
+#ifdef GPAC_HAS_QJS
+		gf_js_global_init();
+#endif
+
 		gf_rand_init(GF_FALSE);
 		
 		gf_init_global_config(profile);
@@ -1319,6 +1326,9 @@ void gf_sys_close()
 {
 	if (sys_init > 0) {
 		void gf_sys_cleanup_help();
+#ifdef GPAC_HAS_QJS
+		void gf_js_global_del();
+#endif
 
 		GF_Mutex *old_log_mx;
 		sys_init --;
@@ -1351,6 +1361,10 @@ void gf_sys_close()
 
 		gf_sys_cleanup_help();
 
+#ifdef GPAC_HAS_QJS
+		gf_js_global_del();
+#endif
+
 		old_log_mx = logs_mx;
 		logs_mx = NULL;
 		gf_mx_del(old_log_mx);
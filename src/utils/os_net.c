@@ -25,6 +25,11 @@
 
 #ifndef GPAC_DISABLE_CORE_TOOLS
 
+/*sendmmsg/recvmmsg declarations*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #if defined(WIN32) || defined(_WIN32_WCE)
 
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
@@ -131,6 +136,15 @@ static int wsa_init = 0;
 typedef s32 SOCKET;
 #define closesocket(v) close(v)
 
+/*batched datagram I/O, and UDP segmentation offload (kernel 4.18+, runtime checked)*/
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define GPAC_HAS_MMSG
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT	103
+#endif
+#endif
+
 #endif /*WIN32||_WIN32_WCE*/
 
 
@@ -183,6 +197,8 @@ enum
 	/*socket is bound to a specific dest (server) or source (client) */
 	GF_SOCK_HAS_PEER = 1<<14,
 	GF_SOCK_IS_UN = 1<<15,
+	/*UDP segmentation offload is used for batched sends*/
+	GF_SOCK_HAS_GSO = 1<<16,
 };
 
 struct __tag_socket
@@ -887,7 +903,7 @@ GF_Err gf_sk_bind(GF_Socket *sock, const char *local_ip, u16 port, const char *p
 
 //send length bytes of a buffer
 GF_EXPORT
-GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
+GF_Err gf_sk_send_ex(GF_Socket *sock, const u8 *buffer, u32 length, u32 *written)
 {
 	u32 count;
 	s32 res;
@@ -898,6 +914,7 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 	fd_set Group;
 #endif
 
+	if (written) *written = 0;
 	//the socket must be bound or connected
 	if (!sock || !sock->socket)
 		return GF_BAD_PARAM;
@@ -967,10 +984,17 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 			}
 		}
 		count += res;
+		if (written) *written = count;
 	}
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
+{
+	return gf_sk_send_ex(sock, buffer, length, NULL);
+}
+
 
 GF_EXPORT
 u32 gf_sk_is_multicast_address(const char *multi_IPAdd)
@@ -1174,6 +1198,11 @@ GF_Err gf_sk_setup_multicast(GF_Socket *sock, const char *multi_IPAdd, u16 Multi
 			if (ret == SOCKET_ERROR) return GF_IP_CONNECTION_FAILURE;
 		}
 	}
+	/*send-only socket, still use the requested interface for outgoing traffic*/
+	else if (local_interface_ip) {
+		ret = setsockopt(sock->socket, IPPROTO_IP, IP_MULTICAST_IF, (void *) &local_add_id, sizeof(local_add_id));
+		if (ret == SOCKET_ERROR) return GF_IP_CONNECTION_FAILURE;
+	}
 
 	/*now join the multicast*/
 	M_req.imr_multiaddr.s_addr = inet_addr(multi_IPAdd);
@@ -1424,6 +1453,218 @@ GF_Err gf_sk_receive_no_select(GF_Socket *sock, u8 *buffer, u32 length, u32 *Byt
 	return gf_sk_receive_internal(sock, buffer, length, BytesRead, GF_FALSE);
 }
 
+/*max number of datagrams per batched system call*/
+#define GF_SK_MAX_BATCH	64
+/*max number of segments and payload bytes in a single UDP GSO send*/
+#define GF_SK_GSO_MAX_SEGS	64
+#define GF_SK_GSO_MAX_SIZE	65000
+/*max number of iovecs per batched send call*/
+#define GF_SK_MAX_IOV	256
+
+GF_EXPORT
+GF_Err gf_sk_enable_gso(GF_Socket *sock, Bool enable)
+{
+	if (!sock) return GF_BAD_PARAM;
+	if (!enable) {
+		sock->flags &= ~GF_SOCK_HAS_GSO;
+		return GF_OK;
+	}
+#ifdef GPAC_HAS_MMSG
+	if (sock->flags & (GF_SOCK_IS_TCP|GF_SOCK_IS_UN)) return GF_NOT_SUPPORTED;
+	sock->flags |= GF_SOCK_HAS_GSO;
+	return GF_OK;
+#else
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
+GF_EXPORT
+GF_Err gf_sk_send_batch(GF_Socket *sock, const u8 **buffers, const u32 *sizes, u32 nb_buffers, u32 *nb_sent)
+{
+#ifdef GPAC_HAS_MMSG
+	struct mmsghdr msgs[GF_SK_MAX_BATCH];
+	struct iovec iovs[GF_SK_MAX_IOV];
+	u32 nb_dgrams[GF_SK_MAX_BATCH];
+	char cbufs[GF_SK_MAX_BATCH][CMSG_SPACE(sizeof(u16))];
+#endif
+	GF_Err e;
+	u32 done = 0;
+
+	if (nb_sent) *nb_sent = 0;
+	if (!sock || !sock->socket || !buffers || !sizes) return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_MMSG
+	if (sock->flags & GF_SOCK_IS_TCP)
+		goto send_loop;
+
+	while (done < nb_buffers) {
+		s32 res;
+		u32 i, nb_msgs = 0, nb_iov = 0, pos = done;
+
+		memset(msgs, 0, sizeof(msgs));
+		while ((pos < nb_buffers) && (nb_msgs < GF_SK_MAX_BATCH) && (nb_iov < GF_SK_MAX_IOV)) {
+			struct msghdr *hdr = &msgs[nb_msgs].msg_hdr;
+			u32 k = 1;
+			u32 seg_size = sizes[pos];
+			u32 tot_size = seg_size;
+
+			//gather a run of equally-sized datagrams, the last one being possibly shorter
+			if ((sock->flags & GF_SOCK_HAS_GSO) && seg_size) {
+				while ((pos + k < nb_buffers) && (k < GF_SK_GSO_MAX_SEGS) && (nb_iov + k < GF_SK_MAX_IOV)) {
+					u32 next = sizes[pos + k];
+					if (!next || (next > seg_size) || (tot_size + next > GF_SK_GSO_MAX_SIZE)) break;
+					tot_size += next;
+					k++;
+					if (next < seg_size) break;
+				}
+			}
+			for (i=0; i<k; i++) {
+				iovs[nb_iov+i].iov_base = (void *) buffers[pos+i];
+				iovs[nb_iov+i].iov_len = sizes[pos+i];
+			}
+			hdr->msg_iov = &iovs[nb_iov];
+			hdr->msg_iovlen = k;
+			if (sock->flags & GF_SOCK_HAS_PEER) {
+				hdr->msg_name = &sock->dest_addr;
+				hdr->msg_namelen = sock->dest_addr_len;
+			}
+			if (k>1) {
+				struct cmsghdr *cm;
+				hdr->msg_control = cbufs[nb_msgs];
+				hdr->msg_controllen = CMSG_SPACE(sizeof(u16));
+				cm = CMSG_FIRSTHDR(hdr);
+				cm->cmsg_level = SOL_UDP;
+				cm->cmsg_type = UDP_SEGMENT;
+				cm->cmsg_len = CMSG_LEN(sizeof(u16));
+				*((u16 *) CMSG_DATA(cm)) = (u16) seg_size;
+			}
+			nb_dgrams[nb_msgs] = k;
+			nb_iov += k;
+			pos += k;
+			nb_msgs++;
+		}
+
+		res = sendmmsg(sock->socket, msgs, nb_msgs, 0);
+		if (res == SOCKET_ERROR) {
+			switch (res = LASTSOCKERROR) {
+			case EIO:
+			case EINVAL:
+			case ENOPROTOOPT:
+			case EOPNOTSUPP:
+				//segmentation offload not available for this socket, fallback to one datagram per message
+				if (sock->flags & GF_SOCK_HAS_GSO) {
+					GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] UDP segmentation offload not supported (%s), disabling\n", gf_errno_str(res)));
+					sock->flags &= ~GF_SOCK_HAS_GSO;
+					continue;
+				}
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] batch send failure: %s\n", gf_errno_str(res)));
+				return GF_IP_NETWORK_FAILURE;
+			case EAGAIN:
+				return GF_IP_SOCK_WOULD_BLOCK;
+			case ENOTCONN:
+			case ECONNRESET:
+			case EPIPE:
+				GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] batch send failure: %s\n", gf_errno_str(res)));
+				return GF_IP_CONNECTION_CLOSED;
+			case ENOBUFS:
+				GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] batch send failure: %s\n", gf_errno_str(res)));
+				return GF_BUFFER_TOO_SMALL;
+			default:
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] batch send failure: %s\n", gf_errno_str(res)));
+				return GF_IP_NETWORK_FAILURE;
+			}
+		}
+		for (i=0; i<(u32) res; i++) {
+			done += nb_dgrams[i];
+		}
+		if (nb_sent) *nb_sent = done;
+	}
+	return GF_OK;
+
+send_loop:
+#endif
+	while (done < nb_buffers) {
+		e = gf_sk_send(sock, buffers[done], sizes[done]);
+		if (e) return e;
+		done++;
+		if (nb_sent) *nb_sent = done;
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_sk_receive_batch(GF_Socket *sock, u8 **buffers, u32 buffer_size, u32 *sizes, u32 nb_buffers, u32 *nb_read)
+{
+	GF_Err e;
+	u32 i;
+#ifdef GPAC_HAS_MMSG
+	s32 res;
+	struct mmsghdr msgs[GF_SK_MAX_BATCH];
+	struct iovec iovs[GF_SK_MAX_BATCH];
+#endif
+
+	if (nb_read) *nb_read = 0;
+	if (!sock || !sock->socket || !buffers || !sizes || !nb_buffers) return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_MMSG
+	if (!(sock->flags & GF_SOCK_IS_TCP)) {
+		if (nb_buffers > GF_SK_MAX_BATCH) nb_buffers = GF_SK_MAX_BATCH;
+		memset(msgs, 0, sizeof(struct mmsghdr) * nb_buffers);
+		for (i=0; i<nb_buffers; i++) {
+			iovs[i].iov_base = buffers[i];
+			iovs[i].iov_len = buffer_size;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			//same behaviour as recvfrom: remote address is the sender of the last datagram
+			if (sock->flags & GF_SOCK_HAS_PEER) {
+				msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+				msgs[i].msg_hdr.msg_namelen = sizeof(sock->dest_addr);
+			}
+		}
+		res = recvmmsg(sock->socket, msgs, nb_buffers, MSG_DONTWAIT, NULL);
+		if (res == SOCKET_ERROR) {
+			switch (res = LASTSOCKERROR) {
+			case EAGAIN:
+			case EINTR:
+				return GF_IP_NETWORK_EMPTY;
+			case ENOTCONN:
+			case ECONNRESET:
+			case ECONNABORTED:
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading: %s\n", gf_errno_str(res)));
+				return GF_IP_CONNECTION_CLOSED;
+			default:
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading: %s\n", gf_errno_str(res)));
+				return GF_IP_NETWORK_FAILURE;
+			}
+		}
+		if (!res) return GF_IP_NETWORK_EMPTY;
+
+		for (i=0; i<(u32) res; i++) {
+			sizes[i] = msgs[i].msg_len;
+			if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] datagram truncated to %d bytes\n", buffer_size));
+			}
+		}
+		if (sock->flags & GF_SOCK_HAS_PEER)
+			sock->dest_addr_len = msgs[res-1].msg_hdr.msg_namelen;
+		if (nb_read) *nb_read = res;
+		return GF_OK;
+	}
+#endif
+
+	//generic path: one call per datagram, only drain further datagrams on non-blocking sockets
+	for (i=0; i<nb_buffers; i++) {
+		e = gf_sk_receive_internal(sock, buffers[i], buffer_size, &sizes[i], GF_FALSE);
+		if (e || !sizes[i]) {
+			if (!i) return e ? e : GF_IP_NETWORK_EMPTY;
+			break;
+		}
+		if (nb_read) *nb_read = i+1;
+		if (!(sock->flags & GF_SOCK_NON_BLOCKING) || (sock->flags & GF_SOCK_IS_TCP)) break;
+	}
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 {
@@ -49,66 +49,74 @@ static GF_Err gf_xml_sax_parse_intern(GF_SAXParser *parser, char *current);
 static char *xml_translate_xml_string(char *str)
 {
 	char *value;
-	u32 size, i, j;
-	if (!str || !strlen(str)) return NULL;
-	value = (char *)gf_malloc(sizeof(char) * 500);
-	size = 500;
+	u32 size, i, j, len;
+	if (!str) return NULL;
+	len = (u32) strlen(str);
+	if (!len) return NULL;
+	/*translated string is never longer than the source, entities only shrink*/
+	size = len + 21;
+	value = (char *)gf_malloc(sizeof(char) * size);
+	if (!value) return NULL;
 	i = j = 0;
 	while (str[i]) {
+		/*copy up to next entity in one go*/
+		char *amp = strchr(str+i, '&');
+		u32 run = amp ? (u32) (amp - (str+i)) : len - i;
+		if (run) {
+			memcpy(value+j, str+i, sizeof(char)*run);
+			i += run;
+			j += run;
+		}
+		if (!amp) break;
+
 		if (j+20 >= size) {
 			size += 500;
 			value = (char *)gf_realloc(value, sizeof(char)*size);
 		}
-		if (str[i] == '&') {
-			if (str[i+1]=='#') {
-				char szChar[20], *end;
-				u16 wchar[2];
-				u32 val;
-				const unsigned short *srcp;
-				strncpy(szChar, str+i, 10);
-				szChar[10] = 0;
-				end = strchr(szChar, ';');
-				if (!end) break;
-				end[1] = 0;
-				i += (u32) strlen(szChar);
-				wchar[1] = 0;
-				if (szChar[2]=='x')
-					sscanf(szChar, "&#x%x;", &val);
-				else
-					sscanf(szChar, "&#%u;", &val);
-				wchar[0] = val;
-				srcp = wchar;
-				j += (u32) gf_utf8_wcstombs(&value[j], 20, &srcp);
-			}
-			else if (!strnicmp(&str[i], "&amp;", sizeof(char)*5)) {
-				value[j] = '&';
-				j++;
-				i+= 5;
-			}
-			else if (!strnicmp(&str[i], "&lt;", sizeof(char)*4)) {
-				value[j] = '<';
-				j++;
-				i+= 4;
-			}
-			else if (!strnicmp(&str[i], "&gt;", sizeof(char)*4)) {
-				value[j] = '>';
-				j++;
-				i+= 4;
-			}
-			else if (!strnicmp(&str[i], "&apos;", sizeof(char)*6)) {
-				value[j] = '\'';
-				j++;
-				i+= 6;
-			}
-			else if (!strnicmp(&str[i], "&quot;", sizeof(char)*6)) {
-				value[j] = '\"';
-				j++;
-				i+= 6;
-			} else {
-				value[j] = str[i];
-				j++;
-				i++;
-			}
+		if (str[i+1]=='#') {
+			char szChar[20], *end;
+			u16 wchar[2];
+			u32 val;
+			const unsigned short *srcp;
+			strncpy(szChar, str+i, 10);
+			szChar[10] = 0;
+			end = strchr(szChar, ';');
+			if (!end) break;
+			end[1] = 0;
+			i += (u32) strlen(szChar);
+			wchar[1] = 0;
+			if (szChar[2]=='x')
+				sscanf(szChar, "&#x%x;", &val);
+			else
+				sscanf(szChar, "&#%u;", &val);
+			wchar[0] = val;
+			srcp = wchar;
+			j += (u32) gf_utf8_wcstombs(&value[j], 20, &srcp);
+		}
+		else if (!strnicmp(&str[i], "&amp;", sizeof(char)*5)) {
+			value[j] = '&';
+			j++;
+			i+= 5;
+		}
+		else if (!strnicmp(&str[i], "&lt;", sizeof(char)*4)) {
+			value[j] = '<';
+			j++;
+			i+= 4;
+		}
+		else if (!strnicmp(&str[i], "&gt;", sizeof(char)*4)) {
+			value[j] = '>';
+			j++;
+			i+= 4;
+		}
+		else if (!strnicmp(&str[i], "&apos;", sizeof(char)*6)) {
+			value[j] = '\'';
+			j++;
+			i+= 6;
+		}
+		else if (!strnicmp(&str[i], "&quot;", sizeof(char)*6)) {
+			value[j] = '\"';
+			j++;
+			i+= 6;
 		} else {
 			value[j] = str[i];
 			j++;
@@ -195,7 +203,7 @@ struct _tag_sax_parser
 static GF_XMLSaxAttribute *xml_get_sax_attribute(GF_SAXParser *parser)
 {
 	if (parser->nb_attrs==parser->nb_alloc_attrs) {
-		parser->nb_alloc_attrs++;
+		parser->nb_alloc_attrs = parser->nb_alloc_attrs ? 2*parser->nb_alloc_attrs : 8;
 		parser->sax_attrs = (GF_XMLSaxAttribute *)gf_realloc(parser->sax_attrs, sizeof(GF_XMLSaxAttribute)*parser->nb_alloc_attrs);
 		parser->attrs = (GF_XMLAttribute *)gf_realloc(parser->attrs, sizeof(GF_XMLAttribute)*parser->nb_alloc_attrs);
 	}
@@ -206,6 +214,9 @@ static void xml_sax_swap(GF_SAXParser *parser)
 {
 	if (parser->current_pos && ((parser->sax_state==SAX_STATE_TEXT_CONTENT) || (parser->sax_state==SAX_STATE_COMMENT) ) ) {
 		if (parser->line_size >= parser->current_pos) {
+			/*only compact once consumed data is at least as large as pending data, otherwise parsing
+			a large document loaded in memory moves the remaining buffer at each node*/
+			if (parser->current_pos < parser->line_size - parser->current_pos) return;
 			parser->line_size -= parser->current_pos;
 			parser->file_pos += parser->current_pos;
 			if (parser->line_size) memmove(parser->buffer, parser->buffer + parser->current_pos, sizeof(char)*parser->line_size);
@@ -606,6 +617,23 @@ static char *xml_get_current_text(GF_SAXParser *parser)
 	return text;
 }
 
+/*locates next '<' in pending data and counts lines up to it, returns GF_FALSE if no markup is pending*/
+static Bool xml_sax_scan_markup(GF_SAXParser *parser, u32 *len)
+{
+	char *start = parser->buffer + parser->current_pos;
+	u32 size = parser->line_size - parser->current_pos;
+	char *end = memchr(start, '<', size);
+	char *nl = start;
+
+	if (end) size = (u32) (end - start);
+	while ((nl = memchr(nl, '\n', size - (u32) (nl - start))) != NULL) {
+		parser->line++;
+		nl++;
+	}
+	*len = size;
+	return end ? GF_TRUE : GF_FALSE;
+}
+
 static void xml_sax_skip_doctype(GF_SAXParser *parser)
 {
 	while (parser->current_pos < parser->line_size) {
@@ -692,11 +720,14 @@ static void xml_sax_parse_entity(GF_SAXParser *parser)
 	xml_sax_store_text(parser, i);
 }
 
-static void xml_sax_cdata(GF_SAXParser *parser)
+static Bool xml_sax_cdata(GF_SAXParser *parser)
 {
 	char *cd_end = strstr(parser->buffer + parser->current_pos, "]]>");
 	if (!cd_end) {
-		xml_sax_store_text(parser, parser->line_size - parser->current_pos);
+		/*keep the last 2 bytes pending, they may be the start of a "]]>" split across input strings*/
+		if (parser->line_size > parser->current_pos + 2)
+			xml_sax_store_text(parser, parser->line_size - parser->current_pos - 2);
+		return GF_FALSE;
 	} else {
 		u32 size = (u32) (cd_end - (parser->buffer + parser->current_pos));
 		xml_sax_store_text(parser, size);
@@ -705,6 +736,7 @@ static void xml_sax_cdata(GF_SAXParser *parser)
 		assert(parser->current_pos <= parser->line_size);
 		parser->sax_state = SAX_STATE_TEXT_CONTENT;
 	}
+	return GF_TRUE;
 }
 
 static Bool xml_sax_parse_comments(GF_SAXParser *parser)
@@ -748,21 +780,23 @@ restart:
 		case SAX_STATE_ELEMENT:
 			elt = NULL;
 			i=0;
-			while ((c = parser->buffer[parser->current_pos+i]) !='<') {
-				if ((parser->init_state==2) && (c ==']')) {
-					parser->sax_state = SAX_STATE_ATT_NAME;
-					parser->current_pos+=i+1;
-					goto restart;
-				}
-				i++;
-				if (c=='\n') parser->line++;
-
-				if (parser->current_pos+i==parser->line_size) {
-					if ((parser->line_size>=2*XML_INPUT_SIZE) && !parser->init_state)
-						parser->sax_state = SAX_STATE_SYNTAX_ERROR;
+			if (parser->init_state==2) {
+				while ((c = parser->buffer[parser->current_pos+i]) !='<') {
+					if (c ==']') {
+						parser->sax_state = SAX_STATE_ATT_NAME;
+						parser->current_pos+=i+1;
+						goto restart;
+					}
+					i++;
+					if (c=='\n') parser->line++;
 
-					goto exit;
+					if (parser->current_pos+i==parser->line_size) goto exit;
 				}
+			} else if (!xml_sax_scan_markup(parser, &i)) {
+				if ((parser->line_size - parser->current_pos >= 2*XML_INPUT_SIZE) && !parser->init_state)
+					parser->sax_state = SAX_STATE_SYNTAX_ERROR;
+
+				goto exit;
 			}
 			if (is_text && i) {
 				xml_sax_store_text(parser, i);
@@ -776,7 +810,7 @@ restart:
 			cdata_sep = 0;
 			while (1) {
 				c = parser->buffer[parser->current_pos+1+i];
-				if (!strncmp(parser->buffer+parser->current_pos+1+i, "!--", 3)) {
+				if ((c=='!') && !strncmp(parser->buffer+parser->current_pos+1+i, "!--", 3)) {
 					parser->sax_state = SAX_STATE_COMMENT;
 					i += 3;
 					break;
@@ -860,8 +894,11 @@ restart:
 			else if (!strcmp(elt, "!DOCTYPE")) parser->init_state = 2;
 			else if (!strcmp(elt, "!ENTITY")) parser->sax_state = SAX_STATE_ENTITY;
 			else if (!strcmp(elt, "!ATTLIST") || !strcmp(elt, "!ELEMENT")) parser->sax_state = SAX_STATE_SKIP_DOCTYPE;
-			else if (!strcmp(elt, "![CDATA["))
+			else if (!strcmp(elt, "![CDATA[")) {
+				/*text before the CDATA section is not part of it*/
+				xml_sax_flush_text(parser);
 				parser->sax_state = SAX_STATE_CDATA;
+			}
 			else if (elt[0]=='?') {
 				i--;
 				parser->sax_state = SAX_STATE_XML_PROC;
@@ -912,7 +949,8 @@ restart:
 			xml_sax_skip_xml_proc(parser);
 			break;
 		case SAX_STATE_CDATA:
-			xml_sax_cdata(parser);
+			if (!xml_sax_cdata(parser))
+				goto exit;
 			break;
 		case SAX_STATE_SYNTAX_ERROR:
 			return GF_CORRUPTED_DATA;
@@ -1645,6 +1683,50 @@ void gf_xml_dom_node_del(GF_XMLNode *node)
 	gf_free(node);
 }
 
+GF_EXPORT
+GF_XMLNode *gf_xml_dom_node_clone(GF_XMLNode *node)
+{
+	u32 i, count;
+	GF_XMLNode *clone;
+	if (!node) return NULL;
+
+	GF_SAFEALLOC(clone, GF_XMLNode);
+	if (!clone) return NULL;
+	clone->type = node->type;
+	if (node->name) clone->name = gf_strdup(node->name);
+	if (node->ns) clone->ns = gf_strdup(node->ns);
+
+	if (node->attributes) {
+		clone->attributes = gf_list_new();
+		count = gf_list_count(node->attributes);
+		for (i=0; i<count; i++) {
+			GF_XMLAttribute *att = (GF_XMLAttribute *)gf_list_get(node->attributes, i);
+			GF_XMLAttribute *c_att;
+			GF_SAFEALLOC(c_att, GF_XMLAttribute);
+			if (!c_att) {
+				gf_xml_dom_node_del(clone);
+				return NULL;
+			}
+			if (att->name) c_att->name = gf_strdup(att->name);
+			if (att->value) c_att->value = gf_strdup(att->value);
+			gf_list_add(clone->attributes, c_att);
+		}
+	}
+	if (node->content) {
+		clone->content = gf_list_new();
+		count = gf_list_count(node->content);
+		for (i=0; i<count; i++) {
+			GF_XMLNode *child = gf_xml_dom_node_clone((GF_XMLNode *)gf_list_get(node->content, i));
+			if (!child) {
+				gf_xml_dom_node_del(clone);
+				return NULL;
+			}
+			gf_list_add(clone->content, child);
+		}
+	}
+	return clone;
+}
+
 static void on_dom_node_start(void *cbk, const char *name, const char *ns, const GF_XMLAttribute *attributes, u32 nb_attributes)
 {
 	u32 i;
@@ -1783,14 +1865,14 @@ void gf_xml_dom_del(GF_DOMParser *parser)
 	gf_free(parser);
 }
 
-#if 0 //unused
+GF_EXPORT
 GF_XMLNode *gf_xml_dom_detach_root(GF_DOMParser *parser)
 {
 	GF_XMLNode *root = parser->root;
+	if (root) gf_list_del_item(parser->root_nodes, root);
 	parser->root = NULL;
 	return root;
 }
-#endif
 
 static void dom_on_progress(void *cbck, u64 done, u64 tot)
 {
@@ -1874,11 +1956,10 @@ static void gf_xml_dom_node_serialize(GF_XMLNode *node, Bool content_only, char
 #define SET_STRING(v)	\
 	vlen = (u32) strlen(v);	\
 	if (vlen+ (*size) >= (*alloc_size)) {	\
-		(*alloc_size) += 1024;	\
+		(*alloc_size) = 2 * (vlen + (*size)) + 1024;	\
 		(*str) = gf_realloc((*str), (*alloc_size));	\
-		(*str)[(*size)] = 0;	\
 	}	\
-	strcat((*str), v);	\
+	memcpy((*str) + (*size), v, vlen+1);	\
 	*size += vlen;	\
 
 	switch (node->type) {